@@ -23,7 +23,7 @@ NETCDF_LIBS=-lnetcdf
 MATIO_LIBS=-lmatio
 
 CPP_FLAGS_CPP11=-std=c++11
-CPP_HW_ARCHITECTURE=-march=native # set this to -march=corei7 if you see AVX related errors when CPP11COMPILER=yes
+CPP_HW_ARCHITECTURE= # plain backend picks SSE2/AVX2/AVX-512 kernels at runtime, set this to -march=native for a binary tuned for the build machine only
 CPP_FLAGS_COMMON=-ffast-math $(CPP_HW_ARCHITECTURE) -mfpmath=sse -msse2 # -mavx
 CPP_FLAGS_DEBUG_MODE=-g
 CPP_FLAGS_RELEASE_MODE=-O3
@@ -0,0 +1,913 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include "engine_checker.h"
+
+#include <nnforge/convolution_layer.h>
+#include <nnforge/sparse_convolution_layer.h>
+#include <nnforge/grouped_convolution_layer.h>
+#include <nnforge/hyperbolic_tangent_layer.h>
+#include <nnforge/sigmoid_layer.h>
+#include <nnforge/rectified_linear_layer.h>
+#include <nnforge/absolute_layer.h>
+#include <nnforge/max_subsampling_layer.h>
+#include <nnforge/average_subsampling_layer.h>
+#include <nnforge/softmax_layer.h>
+#include <nnforge/local_contrast_subtractive_layer.h>
+#include <nnforge/dropout_layer.h>
+#include <nnforge/neural_network_exception.h>
+#include <nnforge/mse_error_function.h>
+#include <nnforge/supervised_data_stream_reader.h>
+#include <nnforge/supervised_data_stream_writer.h>
+#include <nnforge/unsupervised_data_stream_reader.h>
+#include <nnforge/unsupervised_data_stream_writer.h>
+#include <nnforge/supervised_shuffle_entries_data_reader.h>
+#include <nnforge/supervised_transformed_input_data_reader.h>
+#include <nnforge/unsupervised_transformed_input_data_reader.h>
+#include <nnforge/convert_data_type_transformer.h>
+#include <nnforge/plain/layer_tester_plain_factory.h>
+#include <nnforge/plain/layer_updater_plain_factory.h>
+#include <nnforge/plain/network_tester_plain.h>
+#include <nnforge/plain/network_updater_plain.h>
+
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <boost/format.hpp>
+
+// Odd count of threads makes the work split unevenly
+const int engine_checker::thread_count = 3;
+const float engine_checker::max_relative_difference = 1.0e-4F;
+
+engine_checker::engine_checker()
+	: generator(nnforge::rnd::get_random_generator(47))
+	, plain_config(new nnforge::plain::plain_running_configuration(thread_count, 0.5F))
+	, check_count(0)
+	, failed_check_count(0)
+{
+}
+
+engine_checker::~engine_checker()
+{
+}
+
+unsigned int engine_checker::run()
+{
+	check_all_layers();
+
+	check_all_networks();
+
+	check_read_batch();
+
+	std::cout << (boost::format("%1% of %2% comparisons failed") % failed_check_count % check_count).str() << std::endl;
+
+	return failed_check_count;
+}
+
+void engine_checker::check_all_layers()
+{
+	const std::vector<unsigned int> no_padding;
+
+	// Fully connected
+	check_convolution("convolution 6x5 fully connected", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(6, 5), 10, 20)), nnforge::layer_configuration_specific(10, get_sizes(6, 5)), 5);
+	check_convolution("convolution 1 fully connected", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(1), 300, 70)), nnforge::layer_configuration_specific(300, get_sizes(1)), 9);
+	// 1x1
+	check_convolution("convolution 1x1", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(1, 1), 16, 24)), nnforge::layer_configuration_specific(16, get_sizes(9, 7)), 3);
+	check_convolution("convolution 1x1x1", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(1, 1, 1), 8, 8)), nnforge::layer_configuration_specific(8, get_sizes(5, 4, 3)), 2);
+	check_convolution("convolution 1x1 strided", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(1, 1), 16, 24, no_padding, no_padding, get_sizes(2, 2))), nnforge::layer_configuration_specific(16, get_sizes(9, 7)), 3);
+	// Winograd
+	check_convolution("convolution 3x3 Winograd", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3, 3), 6, 7, get_sizes(1, 1), get_sizes(1, 1))), nnforge::layer_configuration_specific(6, get_sizes(19, 13)), 2);
+	check_convolution("convolution 3x3 Winograd asymmetric padding", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3, 3), 4, 5, get_sizes(0, 2), get_sizes(2, 1))), nnforge::layer_configuration_specific(4, get_sizes(10, 5)), 3);
+	check_convolution("convolution 3x3 Winograd 32 feature maps", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3, 3), 32, 32, get_sizes(1, 1), get_sizes(1, 1))), nnforge::layer_configuration_specific(32, get_sizes(24, 20)), 1);
+	// FFT
+	check_convolution("convolution 9x9 FFT", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(9, 9), 4, 6)), nnforge::layer_configuration_specific(4, get_sizes(30, 30)), 2);
+	check_convolution("convolution 11x11 FFT padded", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(11, 11), 3, 8, get_sizes(5, 5), get_sizes(5, 5))), nnforge::layer_configuration_specific(3, get_sizes(24, 20)), 2);
+	check_convolution("convolution 81 FFT", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(81), 2, 3, get_sizes(40), get_sizes(10))), nnforge::layer_configuration_specific(2, get_sizes(100)), 5);
+	// GEMM
+	check_convolution("convolution 4x4 GEMM", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(4, 4), 6, 8, get_sizes(1, 1), get_sizes(1, 1))), nnforge::layer_configuration_specific(6, get_sizes(15, 14)), 3);
+	check_convolution("convolution 4x4 GEMM strided", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(4, 4), 6, 8, get_sizes(1, 1), get_sizes(1, 1), get_sizes(4, 3))), nnforge::layer_configuration_specific(6, get_sizes(15, 14)), 3);
+	check_convolution("convolution 3x3 GEMM strided", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3, 3), 16, 16, no_padding, no_padding, get_sizes(2, 2))), nnforge::layer_configuration_specific(16, get_sizes(16, 16)), 2);
+	check_convolution("convolution 3x3x3 GEMM", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3, 3, 3), 3, 5, get_sizes(1, 1, 1), get_sizes(1, 1, 1))), nnforge::layer_configuration_specific(3, get_sizes(7, 6, 5)), 2);
+	check_convolution("convolution 7 GEMM", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(7), 5, 12, get_sizes(3), get_sizes(3), get_sizes(4))), nnforge::layer_configuration_specific(5, get_sizes(40)), 4);
+	// Direct specialized on window size
+	check_convolution("convolution 5x5 direct", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(5, 5), 1, 3, get_sizes(2, 2), get_sizes(2, 2))), nnforge::layer_configuration_specific(1, get_sizes(31, 27)), 4);
+	check_convolution("convolution 3x3 direct strided", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3, 3), 1, 2, no_padding, no_padding, get_sizes(2, 3))), nnforge::layer_configuration_specific(1, get_sizes(9, 9)), 2);
+	check_convolution("convolution 3 direct", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3), 2, 3, get_sizes(1), get_sizes(1))), nnforge::layer_configuration_specific(2, get_sizes(40)), 4);
+	// Generic direct
+	check_convolution("convolution 3x3x3 generic", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3, 3, 3), 2, 3, get_sizes(1, 1, 1), get_sizes(1, 1, 1))), nnforge::layer_configuration_specific(2, get_sizes(6, 5, 4)), 2);
+	check_convolution("convolution 2x2 generic strided", nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(2, 2), 2, 3, no_padding, no_padding, get_sizes(2, 2))), nnforge::layer_configuration_specific(2, get_sizes(9, 8)), 3);
+
+	check_convolution("grouped convolution 3x3", nnforge::const_layer_smart_ptr(new nnforge::grouped_convolution_layer(get_sizes(3, 3), 8, 12, 4, get_sizes(1, 1), get_sizes(1, 1))), nnforge::layer_configuration_specific(8, get_sizes(11, 9)), 3);
+	check_convolution("depthwise convolution 3x3 strided", nnforge::const_layer_smart_ptr(new nnforge::grouped_convolution_layer(get_sizes(3, 3), 6, 6, 6, get_sizes(1, 1), get_sizes(1, 1), get_sizes(2, 2))), nnforge::layer_configuration_specific(6, get_sizes(13, 10)), 2);
+	check_convolution("grouped convolution 5", nnforge::const_layer_smart_ptr(new nnforge::grouped_convolution_layer(get_sizes(5), 4, 8, 2, get_sizes(2), get_sizes(2))), nnforge::layer_configuration_specific(4, get_sizes(30)), 3);
+
+	check_convolution("sparse convolution 3x3", nnforge::const_layer_smart_ptr(new nnforge::sparse_convolution_layer(get_sizes(3, 3), 8, 10, 30U, get_sizes(1, 1), get_sizes(1, 1))), nnforge::layer_configuration_specific(8, get_sizes(12, 10)), 3);
+	check_convolution("sparse convolution 5x5 strided", nnforge::const_layer_smart_ptr(new nnforge::sparse_convolution_layer(get_sizes(5, 5), 6, 8, 20U, no_padding, no_padding, get_sizes(2, 2))), nnforge::layer_configuration_specific(6, get_sizes(17, 15)), 2);
+	check_convolution("sparse convolution 1x1", nnforge::const_layer_smart_ptr(new nnforge::sparse_convolution_layer(get_sizes(1, 1), 16, 16, 64U)), nnforge::layer_configuration_specific(16, get_sizes(7, 7)), 2);
+	check_convolution("sparse convolution 3", nnforge::const_layer_smart_ptr(new nnforge::sparse_convolution_layer(get_sizes(3), 5, 7, 15U, get_sizes(1), get_sizes(1))), nnforge::layer_configuration_specific(5, get_sizes(33)), 3);
+
+	// The small configuration has tails not filling SIMD registers, the large one is split between the threads
+	const nnforge::layer_configuration_specific activation_configurations[] = {
+		nnforge::layer_configuration_specific(5, get_sizes(13, 11)),
+		nnforge::layer_configuration_specific(16, get_sizes(32, 32))};
+	for(unsigned int i = 0; i < sizeof(activation_configurations) / sizeof(activation_configurations[0]); ++i)
+	{
+		check_activation("hyperbolic tangent", nnforge::const_layer_smart_ptr(new nnforge::hyperbolic_tangent_layer()), reference_layers::activation_hyperbolic_tangent, activation_configurations[i], 7);
+		check_activation("sigmoid", nnforge::const_layer_smart_ptr(new nnforge::sigmoid_layer()), reference_layers::activation_sigmoid, activation_configurations[i], 7);
+		check_activation("rectified linear", nnforge::const_layer_smart_ptr(new nnforge::rectified_linear_layer()), reference_layers::activation_rectified_linear, activation_configurations[i], 7);
+		check_activation("absolute", nnforge::const_layer_smart_ptr(new nnforge::absolute_layer()), reference_layers::activation_absolute, activation_configurations[i], 7);
+	}
+
+	check_subsampling("max subsampling 2x2", true, get_sizes(2, 2), nnforge::layer_configuration_specific(5, get_sizes(16, 12)), 3);
+	check_subsampling("max subsampling 3x2", true, get_sizes(3, 2), nnforge::layer_configuration_specific(4, get_sizes(20, 17)), 2);
+	check_subsampling("max subsampling 2", true, get_sizes(2), nnforge::layer_configuration_specific(3, get_sizes(33)), 5);
+	check_subsampling("max subsampling 2x2x2", true, get_sizes(2, 2, 2), nnforge::layer_configuration_specific(2, get_sizes(8, 6, 4)), 2);
+	check_subsampling("average subsampling 2x2", false, get_sizes(2, 2), nnforge::layer_configuration_specific(5, get_sizes(16, 12)), 3);
+	check_subsampling("average subsampling 3x2", false, get_sizes(3, 2), nnforge::layer_configuration_specific(4, get_sizes(20, 17)), 2);
+	check_subsampling("average subsampling 3", false, get_sizes(3), nnforge::layer_configuration_specific(3, get_sizes(31)), 5);
+
+	check_softmax("softmax", nnforge::layer_configuration_specific(10), 9);
+	check_softmax("softmax 13x11", nnforge::layer_configuration_specific(7, get_sizes(13, 11)), 3);
+
+	std::vector<unsigned int> feature_maps_affected;
+	feature_maps_affected.push_back(0);
+	check_local_contrast_subtractive("local contrast subtractive 5x5", get_sizes(5, 5), feature_maps_affected, nnforge::layer_configuration_specific(3, get_sizes(16, 14)), 3);
+	feature_maps_affected.push_back(2);
+	check_local_contrast_subtractive("local contrast subtractive 9x7", get_sizes(9, 7), feature_maps_affected, nnforge::layer_configuration_specific(3, get_sizes(20, 17)), 2);
+	feature_maps_affected.push_back(1);
+	check_local_contrast_subtractive("local contrast subtractive 5x5 small input", get_sizes(5, 5), feature_maps_affected, nnforge::layer_configuration_specific(3, get_sizes(6, 5)), 3);
+	feature_maps_affected.assign(1, 1);
+	check_local_contrast_subtractive("local contrast subtractive 7", get_sizes(7), feature_maps_affected, nnforge::layer_configuration_specific(2, get_sizes(30)), 3);
+
+	check_dropout(0.3F, nnforge::layer_configuration_specific(8, get_sizes(16, 16)), 64);
+	check_dropout(0.5F, nnforge::layer_configuration_specific(3, get_sizes(37)), 5);
+}
+
+void engine_checker::check_all_networks()
+{
+	{
+		nnforge::network_schema_smart_ptr schema(new nnforge::network_schema());
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3, 3), 4, 8, get_sizes(1, 1), get_sizes(1, 1))));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::rectified_linear_layer()));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::average_subsampling_layer(get_sizes(2, 2))));
+		check_network("fused convolution 3x3, rectified linear, average subsampling 2x2", schema, nnforge::layer_configuration_specific(4, get_sizes(20, 18)), 5, false);
+	}
+	{
+		nnforge::network_schema_smart_ptr schema(new nnforge::network_schema());
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(5, 5), 3, 16)));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::hyperbolic_tangent_layer()));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::absolute_layer()));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::average_subsampling_layer(get_sizes(2, 2))));
+		check_network("fused convolution 5x5, hyperbolic tangent, absolute, average subsampling 2x2", schema, nnforge::layer_configuration_specific(3, get_sizes(31, 29)), 3, false);
+	}
+	{
+		nnforge::network_schema_smart_ptr schema(new nnforge::network_schema());
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3), 4, 8, get_sizes(1), get_sizes(1))));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::hyperbolic_tangent_layer()));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::average_subsampling_layer(get_sizes(2))));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(16), 8, 5)));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::softmax_layer()));
+		check_network("fused convolution 3, hyperbolic tangent, average subsampling 2, fully connected, softmax", schema, nnforge::layer_configuration_specific(4, get_sizes(33)), 7, false);
+	}
+	for(int blocked_layout = 0; blocked_layout < 2; ++blocked_layout)
+	{
+		nnforge::network_schema_smart_ptr schema(new nnforge::network_schema());
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3, 3), 8, 16, get_sizes(1, 1), get_sizes(1, 1))));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::rectified_linear_layer()));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3, 3), 16, 16, get_sizes(1, 1), get_sizes(1, 1))));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::hyperbolic_tangent_layer()));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::max_subsampling_layer(get_sizes(2, 2))));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::convolution_layer(get_sizes(3, 3), 16, 16, get_sizes(1, 1), get_sizes(1, 1))));
+		schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::rectified_linear_layer()));
+		check_network(blocked_layout ? "blocked layout" : "planar layout", schema, nnforge::layer_configuration_specific(8, get_sizes(20, 16)), 3, (blocked_layout != 0));
+	}
+
+	check_local_contrast_subtractive_training("local contrast subtractive 5, convolution 3, hyperbolic tangent training", get_sizes(16), 12);
+	check_local_contrast_subtractive_training("local contrast subtractive 5x5, convolution 3x3, hyperbolic tangent training", get_sizes(16, 16), 12);
+}
+
+void engine_checker::check_convolution(
+	const std::string& name,
+	nnforge::const_layer_smart_ptr layer,
+	const nnforge::layer_configuration_specific& input_configuration_specific,
+	unsigned int entry_count)
+{
+	const nnforge::layer_configuration_specific output_configuration_specific = layer->get_output_layer_configuration_specific(input_configuration_specific);
+	nnforge::layer_data_smart_ptr data = layer->create_layer_data();
+	nnforge::layer_data_custom_smart_ptr data_custom = layer->create_layer_data_custom();
+	randomize(layer, *data, *data_custom);
+
+	const reference_layers::convolution_geometry geometry = get_geometry(layer, input_configuration_specific);
+	const std::vector<float> dense_weights = get_dense_weights(layer, *data, *data_custom, geometry);
+	const std::vector<float> input = get_random_values(input_configuration_specific.get_neuron_count() * entry_count, 1.0F);
+	const std::vector<float> output_errors = get_random_values(output_configuration_specific.get_neuron_count() * entry_count, 1.0F);
+
+	std::vector<float> expected_output;
+	reference_layers::convolution_forward(geometry, dense_weights, (*data)[1], input, expected_output, entry_count);
+	std::vector<float> expected_input_errors;
+	reference_layers::convolution_backprop(geometry, dense_weights, output_errors, expected_input_errors, entry_count);
+	std::vector<float> dense_weights_gradient(dense_weights.size(), 0.0F);
+	std::vector<float> expected_biases_gradient(output_configuration_specific.feature_map_count, 0.0F);
+	reference_layers::convolution_gradient(geometry, input, output_errors, dense_weights_gradient, expected_biases_gradient, entry_count);
+
+	report(name, "tester output", reference_layers::get_difference(run_tester(layer, input_configuration_specific, data, data_custom, input, entry_count), expected_output), max_relative_difference);
+	updater_result res = run_updater(layer, input_configuration_specific, data, data_custom, input, output_errors, entry_count, true);
+	report(name, "updater output", reference_layers::get_difference(res.output, expected_output), max_relative_difference);
+	report(name, "input errors", reference_layers::get_difference(res.input_errors, expected_input_errors), max_relative_difference);
+	report(name, "weights gradient", reference_layers::get_difference((*res.gradient)[0], get_layer_weights(layer, dense_weights_gradient, *data_custom, geometry)), max_relative_difference);
+	report(name, "biases gradient", reference_layers::get_difference((*res.gradient)[1], expected_biases_gradient), max_relative_difference);
+}
+
+void engine_checker::check_activation(
+	const std::string& name,
+	nnforge::const_layer_smart_ptr layer,
+	reference_layers::activation_type type,
+	const nnforge::layer_configuration_specific& input_configuration_specific,
+	unsigned int entry_count)
+{
+	const std::vector<float> input = get_random_values(input_configuration_specific.get_neuron_count() * entry_count, 3.0F);
+	const std::vector<float> output_errors = get_random_values(input.size(), 1.0F);
+
+	std::vector<float> expected_output;
+	reference_layers::activation_forward(type, input, expected_output);
+	std::vector<float> expected_input_errors;
+	reference_layers::activation_backprop(type, input, expected_output, output_errors, expected_input_errors);
+
+	const std::string full_name = (boost::format("%1% %2% neurons") % name % input.size()).str();
+	report(full_name, "tester output", reference_layers::get_difference(run_tester(layer, input_configuration_specific, nnforge::const_layer_data_smart_ptr(), nnforge::const_layer_data_custom_smart_ptr(), input, entry_count), expected_output), max_relative_difference);
+	updater_result res = run_updater(layer, input_configuration_specific, nnforge::const_layer_data_smart_ptr(), nnforge::const_layer_data_custom_smart_ptr(), input, output_errors, entry_count, true);
+	report(full_name, "updater output", reference_layers::get_difference(res.output, expected_output), max_relative_difference);
+	report(full_name, "input errors", reference_layers::get_difference(res.input_errors, expected_input_errors), max_relative_difference);
+}
+
+void engine_checker::check_subsampling(
+	const std::string& name,
+	bool is_max,
+	const std::vector<unsigned int>& subsampling_sizes,
+	const nnforge::layer_configuration_specific& input_configuration_specific,
+	unsigned int entry_count)
+{
+	nnforge::const_layer_smart_ptr layer;
+	if (is_max)
+		layer = nnforge::const_layer_smart_ptr(new nnforge::max_subsampling_layer(subsampling_sizes));
+	else
+		layer = nnforge::const_layer_smart_ptr(new nnforge::average_subsampling_layer(subsampling_sizes));
+	const nnforge::layer_configuration_specific output_configuration_specific = layer->get_output_layer_configuration_specific(input_configuration_specific);
+
+	const std::vector<float> input = get_random_values(input_configuration_specific.get_neuron_count() * entry_count, 1.0F);
+	const std::vector<float> output_errors = get_random_values(output_configuration_specific.get_neuron_count() * entry_count, 1.0F);
+
+	std::vector<float> expected_output;
+	reference_layers::subsampling_forward(is_max, subsampling_sizes, input_configuration_specific, input, expected_output, entry_count);
+	std::vector<float> expected_input_errors;
+	reference_layers::subsampling_backprop(is_max, subsampling_sizes, input_configuration_specific, input, output_errors, expected_input_errors, entry_count);
+
+	report(name, "tester output", reference_layers::get_difference(run_tester(layer, input_configuration_specific, nnforge::const_layer_data_smart_ptr(), nnforge::const_layer_data_custom_smart_ptr(), input, entry_count), expected_output), max_relative_difference);
+	updater_result res = run_updater(layer, input_configuration_specific, nnforge::const_layer_data_smart_ptr(), nnforge::const_layer_data_custom_smart_ptr(), input, output_errors, entry_count, true);
+	report(name, "updater output", reference_layers::get_difference(res.output, expected_output), max_relative_difference);
+	report(name, "input errors", reference_layers::get_difference(res.input_errors, expected_input_errors), max_relative_difference);
+}
+
+void engine_checker::check_softmax(
+	const std::string& name,
+	const nnforge::layer_configuration_specific& input_configuration_specific,
+	unsigned int entry_count)
+{
+	nnforge::const_layer_smart_ptr layer(new nnforge::softmax_layer());
+
+	const std::vector<float> input = get_random_values(input_configuration_specific.get_neuron_count() * entry_count, 3.0F);
+	const std::vector<float> output_errors = get_random_values(input.size(), 1.0F);
+
+	std::vector<float> expected_output;
+	reference_layers::softmax_forward(input_configuration_specific, input, expected_output, entry_count);
+	std::vector<float> expected_input_errors;
+	reference_layers::softmax_backprop(input_configuration_specific, expected_output, output_errors, expected_input_errors, entry_count);
+
+	report(name, "tester output", reference_layers::get_difference(run_tester(layer, input_configuration_specific, nnforge::const_layer_data_smart_ptr(), nnforge::const_layer_data_custom_smart_ptr(), input, entry_count), expected_output), max_relative_difference);
+	updater_result res = run_updater(layer, input_configuration_specific, nnforge::const_layer_data_smart_ptr(), nnforge::const_layer_data_custom_smart_ptr(), input, output_errors, entry_count, true);
+	report(name, "updater output", reference_layers::get_difference(res.output, expected_output), max_relative_difference);
+	report(name, "input errors", reference_layers::get_difference(res.input_errors, expected_input_errors), max_relative_difference);
+}
+
+void engine_checker::check_local_contrast_subtractive(
+	const std::string& name,
+	const std::vector<unsigned int>& window_sizes,
+	const std::vector<unsigned int>& feature_maps_affected,
+	const nnforge::layer_configuration_specific& input_configuration_specific,
+	unsigned int entry_count)
+{
+	nnforge_shared_ptr<nnforge::local_contrast_subtractive_layer> layer(new nnforge::local_contrast_subtractive_layer(window_sizes, feature_maps_affected, input_configuration_specific.feature_map_count));
+
+	const std::vector<float> input = get_random_values(input_configuration_specific.get_neuron_count() * entry_count, 1.0F);
+	const std::vector<float> output_errors = get_random_values(input.size(), 1.0F);
+
+	std::vector<float> expected_output;
+	reference_layers::local_contrast_subtractive_forward(*layer, input_configuration_specific, input, expected_output, entry_count);
+	std::vector<float> expected_input_errors;
+	reference_layers::local_contrast_subtractive_backprop(*layer, input_configuration_specific, output_errors, expected_input_errors, entry_count);
+
+	report(name, "tester output", reference_layers::get_difference(run_tester(layer, input_configuration_specific, nnforge::const_layer_data_smart_ptr(), nnforge::const_layer_data_custom_smart_ptr(), input, entry_count), expected_output), max_relative_difference);
+	updater_result res = run_updater(layer, input_configuration_specific, nnforge::const_layer_data_smart_ptr(), nnforge::const_layer_data_custom_smart_ptr(), input, output_errors, entry_count, true);
+	report(name, "updater output", reference_layers::get_difference(res.output, expected_output), max_relative_difference);
+	report(name, "input errors", reference_layers::get_difference(res.input_errors, expected_input_errors), max_relative_difference);
+}
+
+void engine_checker::check_network(
+	const std::string& name,
+	nnforge::network_schema_smart_ptr schema,
+	const nnforge::layer_configuration_specific& input_configuration_specific,
+	unsigned int entry_count,
+	bool blocked_layout)
+{
+	const nnforge::const_layer_list& layer_list = *schema;
+	nnforge::network_data_smart_ptr data(new nnforge::network_data(layer_list));
+	for(unsigned int i = 0; i < layer_list.size(); ++i)
+		randomize(layer_list[i], *data->data_list[i], *data->data_custom_list[i]);
+
+	const std::vector<float> input = get_random_values(input_configuration_specific.get_neuron_count() * entry_count, 1.0F);
+	const std::vector<float> expected_output = run_reference_network(schema, data, input_configuration_specific, input, entry_count);
+
+	nnforge_shared_ptr<std::ostringstream> input_stream(new std::ostringstream(std::ios_base::binary));
+	{
+		nnforge::unsupervised_data_stream_writer writer(input_stream, input_configuration_specific);
+		for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+			writer.write(&input[entry_id * input_configuration_specific.get_neuron_count()]);
+	}
+	nnforge::unsupervised_data_stream_reader reader(nnforge_shared_ptr<std::istream>(new std::istringstream(input_stream->str(), std::ios_base::binary)));
+
+	nnforge::plain::plain_running_configuration_const_smart_ptr network_plain_config(new nnforge::plain::plain_running_configuration(thread_count, 0.5F, blocked_layout));
+	nnforge::plain::network_tester_plain tester(schema, network_plain_config);
+	tester.set_data(data);
+	nnforge::output_neuron_value_set_smart_ptr res = tester.run(reader, 1);
+
+	std::vector<float> output;
+	for(std::vector<std::vector<float> >::const_iterator it = res->neuron_value_list.begin(); it != res->neuron_value_list.end(); ++it)
+		output.insert(output.end(), it->begin(), it->end());
+
+	report(name, "network tester output", reference_layers::get_difference(output, expected_output), max_relative_difference);
+}
+
+void engine_checker::check_dropout(
+	float dropout_rate,
+	const nnforge::layer_configuration_specific& input_configuration_specific,
+	unsigned int entry_count)
+{
+	nnforge::const_layer_smart_ptr layer(new nnforge::dropout_layer(dropout_rate));
+	const unsigned int neuron_count = input_configuration_specific.get_neuron_count() * entry_count;
+	const float keep_rate = 1.0F - dropout_rate;
+
+	updater_result res = run_updater(layer, input_configuration_specific, nnforge::const_layer_data_smart_ptr(), nnforge::const_layer_data_custom_smart_ptr(), std::vector<float>(neuron_count, 1.0F), std::vector<float>(neuron_count, 1.0F), entry_count, false);
+
+	unsigned int kept_count = 0;
+	unsigned int wrong_count = 0;
+	for(unsigned int i = 0; i < neuron_count; ++i)
+	{
+		if (res.output[i] != 0.0F)
+		{
+			++kept_count;
+			if (fabsf(res.output[i] * keep_rate - 1.0F) > 1.0e-6F)
+				++wrong_count;
+		}
+		// Errors are backpropagated through the neurons kept only, with the same multiplier
+		if (res.input_errors[i] != res.output[i])
+			++wrong_count;
+	}
+	float standard_deviation = sqrtf(keep_rate * dropout_rate / static_cast<float>(neuron_count));
+
+	const std::string name = (boost::format("dropout %1% %2% neurons") % dropout_rate % neuron_count).str();
+	report(name, "neurons with wrong values or errors", static_cast<float>(wrong_count), 0.0F);
+	report(name, "keep rate deviation in standard deviations", fabsf(static_cast<float>(kept_count) / static_cast<float>(neuron_count) - keep_rate) / standard_deviation, 5.0F);
+}
+
+void engine_checker::check_read_batch()
+{
+	const nnforge::layer_configuration_specific input_configuration_specific(3, get_sizes(5, 5));
+	const nnforge::layer_configuration_specific output_configuration_specific(4);
+	const unsigned int entry_count = 103;
+
+	nnforge_shared_ptr<std::ostringstream> supervised_stream(new std::ostringstream(std::ios_base::binary));
+	nnforge_shared_ptr<std::ostringstream> unsupervised_stream(new std::ostringstream(std::ios_base::binary));
+	{
+		nnforge::supervised_data_stream_writer supervised_writer(supervised_stream, input_configuration_specific, output_configuration_specific);
+		nnforge::unsupervised_data_stream_writer unsupervised_writer(unsupervised_stream, input_configuration_specific);
+		nnforge_uniform_int_distribution<int> byte_distribution(0, 255);
+		std::vector<unsigned char> input(input_configuration_specific.get_neuron_count());
+		for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+		{
+			for(std::vector<unsigned char>::iterator it = input.begin(); it != input.end(); ++it)
+				*it = static_cast<unsigned char>(byte_distribution(generator));
+			std::vector<float> output = get_random_values(output_configuration_specific.get_neuron_count(), 1.0F);
+			supervised_writer.write(&input[0], &output[0]);
+			unsupervised_writer.write(&input[0]);
+		}
+	}
+	const std::string supervised_data = supervised_stream->str();
+	const std::string unsupervised_data = unsupervised_stream->str();
+
+	const char * supervised_reader_names[] = {"stream reader", "shuffle entries reader", "transformed input reader"};
+	for(unsigned int reader_id = 0; reader_id < sizeof(supervised_reader_names) / sizeof(supervised_reader_names[0]); ++reader_id)
+	{
+		nnforge::supervised_data_reader_smart_ptr readers[2];
+		for(unsigned int i = 0; i < 2; ++i)
+		{
+			readers[i] = nnforge::supervised_data_reader_smart_ptr(new nnforge::supervised_data_stream_reader(nnforge_shared_ptr<std::istream>(new std::istringstream(supervised_data, std::ios_base::binary))));
+			if (reader_id == 1)
+				readers[i] = nnforge::supervised_data_reader_smart_ptr(new nnforge::supervised_shuffle_entries_data_reader(readers[i], 10));
+			else if (reader_id == 2)
+				readers[i] = nnforge::supervised_data_reader_smart_ptr(new nnforge::supervised_transformed_input_data_reader(readers[i], nnforge::data_transformer_smart_ptr(new nnforge::convert_data_type_transformer())));
+		}
+		report(supervised_reader_names[reader_id], "entries different with read_batch", static_cast<float>(get_read_batch_mismatch_count(*readers[0], *readers[1])), 0.0F);
+	}
+
+	const char * unsupervised_reader_names[] = {"unsupervised stream reader", "unsupervised transformed input reader"};
+	for(unsigned int reader_id = 0; reader_id < sizeof(unsupervised_reader_names) / sizeof(unsupervised_reader_names[0]); ++reader_id)
+	{
+		nnforge::unsupervised_data_reader_smart_ptr readers[2];
+		for(unsigned int i = 0; i < 2; ++i)
+		{
+			readers[i] = nnforge::unsupervised_data_reader_smart_ptr(new nnforge::unsupervised_data_stream_reader(nnforge_shared_ptr<std::istream>(new std::istringstream(unsupervised_data, std::ios_base::binary))));
+			if (reader_id == 1)
+				readers[i] = nnforge::unsupervised_data_reader_smart_ptr(new nnforge::unsupervised_transformed_input_data_reader(readers[i], nnforge::data_transformer_smart_ptr(new nnforge::convert_data_type_transformer())));
+		}
+		report(unsupervised_reader_names[reader_id], "entries different with read_batch", static_cast<float>(get_read_batch_mismatch_count(*readers[0], *readers[1])), 0.0F);
+	}
+}
+
+void engine_checker::check_local_contrast_subtractive_training(
+	const std::string& name,
+	const std::vector<unsigned int>& input_sizes,
+	unsigned int entry_count)
+{
+	const float learning_rate = 0.1F;
+	const unsigned int dimension_count = static_cast<unsigned int>(input_sizes.size());
+	const nnforge::layer_configuration_specific input_configuration_specific(3, input_sizes);
+
+	std::vector<unsigned int> feature_maps_affected(1, 0);
+	nnforge_shared_ptr<nnforge::local_contrast_subtractive_layer> local_contrast_subtractive(new nnforge::local_contrast_subtractive_layer(std::vector<unsigned int>(dimension_count, 5), feature_maps_affected, 3));
+	nnforge::const_layer_smart_ptr convolution(new nnforge::convolution_layer(std::vector<unsigned int>(dimension_count, 3), 3, 8));
+	nnforge::network_schema_smart_ptr schema(new nnforge::network_schema());
+	schema->add_layer(local_contrast_subtractive);
+	schema->add_layer(convolution);
+	schema->add_layer(nnforge::const_layer_smart_ptr(new nnforge::hyperbolic_tangent_layer()));
+
+	const nnforge::const_layer_list& layer_list = *schema;
+	nnforge::network_data_smart_ptr data(new nnforge::network_data(layer_list));
+	for(unsigned int i = 0; i < layer_list.size(); ++i)
+		randomize(layer_list[i], *data->data_list[i], *data->data_custom_list[i]);
+	const nnforge::layer_data original_convolution_data = *data->data_list[1];
+
+	const nnforge::layer_configuration_specific convolution_input_configuration_specific = local_contrast_subtractive->get_output_layer_configuration_specific(input_configuration_specific);
+	const nnforge::layer_configuration_specific output_configuration_specific = convolution->get_output_layer_configuration_specific(convolution_input_configuration_specific);
+	const std::vector<float> input = get_random_values(input_configuration_specific.get_neuron_count() * entry_count, 1.0F);
+	const std::vector<float> target = get_random_values(output_configuration_specific.get_neuron_count() * entry_count, 1.0F);
+
+	// MSE gradient is target - output, the update is the gradient averaged over the batch multiplied by the learning rate
+	std::vector<float> convolution_input;
+	reference_layers::local_contrast_subtractive_forward(*local_contrast_subtractive, input_configuration_specific, input, convolution_input, entry_count);
+	const reference_layers::convolution_geometry geometry = get_geometry(convolution, convolution_input_configuration_specific);
+	std::vector<float> convolution_output;
+	reference_layers::convolution_forward(geometry, original_convolution_data[0], original_convolution_data[1], convolution_input, convolution_output, entry_count);
+	std::vector<float> output;
+	reference_layers::activation_forward(reference_layers::activation_hyperbolic_tangent, convolution_output, output);
+	std::vector<float> output_errors(output.size());
+	double expected_error = 0.0;
+	for(unsigned int i = 0; i < output.size(); ++i)
+	{
+		output_errors[i] = target[i] - output[i];
+		expected_error += 0.5 * static_cast<double>(output_errors[i]) * static_cast<double>(output_errors[i]);
+	}
+	expected_error /= static_cast<double>(entry_count);
+	std::vector<float> convolution_output_errors;
+	reference_layers::activation_backprop(reference_layers::activation_hyperbolic_tangent, convolution_output, output, output_errors, convolution_output_errors);
+	std::vector<float> expected_weights_gradient(original_convolution_data[0].size(), 0.0F);
+	std::vector<float> expected_biases_gradient(original_convolution_data[1].size(), 0.0F);
+	reference_layers::convolution_gradient(geometry, convolution_input, convolution_output_errors, expected_weights_gradient, expected_biases_gradient, entry_count);
+
+	nnforge_shared_ptr<std::ostringstream> data_stream(new std::ostringstream(std::ios_base::binary));
+	{
+		nnforge::supervised_data_stream_writer writer(data_stream, input_configuration_specific, output_configuration_specific);
+		for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+			writer.write(&input[entry_id * input_configuration_specific.get_neuron_count()], &target[entry_id * output_configuration_specific.get_neuron_count()]);
+	}
+	nnforge::supervised_data_stream_reader reader(nnforge_shared_ptr<std::istream>(new std::istringstream(data_stream->str(), std::ios_base::binary)));
+
+	std::vector<std::vector<float> > learning_rates;
+	for(nnforge::layer_data_list::const_iterator it = data->data_list.begin(); it != data->data_list.end(); ++it)
+		learning_rates.push_back(std::vector<float>((*it)->size(), learning_rate));
+
+	nnforge::plain::network_updater_plain updater(schema, nnforge::const_error_function_smart_ptr(new nnforge::mse_error_function()), plain_config);
+	std::pair<nnforge::testing_result_smart_ptr, nnforge::training_stat_smart_ptr> res = updater.update(reader, learning_rates, data, entry_count, 0.0F, 0.0F, true);
+
+	std::vector<float> weights_gradient(expected_weights_gradient.size());
+	std::vector<float> biases_gradient(expected_biases_gradient.size());
+	const float mult = static_cast<float>(entry_count) / learning_rate;
+	for(unsigned int i = 0; i < weights_gradient.size(); ++i)
+		weights_gradient[i] = ((*data->data_list[1])[0][i] - original_convolution_data[0][i]) * mult;
+	for(unsigned int i = 0; i < biases_gradient.size(); ++i)
+		biases_gradient[i] = ((*data->data_list[1])[1][i] - original_convolution_data[1][i]) * mult;
+
+	// The weights updated are rounded to float, the gradient restored from them is less precise
+	report(name, "error", reference_layers::get_difference(std::vector<float>(1, res.first->get_error()), std::vector<float>(1, static_cast<float>(expected_error))), max_relative_difference);
+	report(name, "weights gradient", reference_layers::get_difference(weights_gradient, expected_weights_gradient), max_relative_difference * 10.0F);
+	report(name, "biases gradient", reference_layers::get_difference(biases_gradient, expected_biases_gradient), max_relative_difference * 10.0F);
+}
+
+std::vector<float> engine_checker::run_tester(
+	nnforge::const_layer_smart_ptr layer,
+	const nnforge::layer_configuration_specific& input_configuration_specific,
+	nnforge::const_layer_data_smart_ptr data,
+	nnforge::const_layer_data_custom_smart_ptr data_custom,
+	const std::vector<float>& input,
+	unsigned int entry_count) const
+{
+	nnforge::plain::const_layer_tester_plain_smart_ptr tester = nnforge::plain::single_layer_tester_plain_factory::get_const_instance().get_tester_plain_layer(layer->get_uuid());
+	const nnforge::layer_configuration_specific output_configuration_specific = layer->get_output_layer_configuration_specific(input_configuration_specific);
+	const unsigned int output_elem_count = output_configuration_specific.get_neuron_count() * entry_count;
+
+	nnforge::plain::additional_buffer_smart_ptr input_buffer(new nnforge::plain::additional_buffer(input.begin(), input.end()));
+	// The first call only sizes the arena
+	nnforge::plain::additional_buffer_smart_ptr layer_output_buffer(new nnforge::plain::additional_buffer(output_elem_count));
+	nnforge::plain::buffer_arena_plain arena(false);
+	tester->allocate_additional_buffers(entry_count, layer_output_buffer, arena, layer, input_configuration_specific, output_configuration_specific, plain_config);
+	arena.allocate();
+	nnforge::plain::additional_buffer_set additional_buffers = tester->allocate_additional_buffers(
+		entry_count,
+		layer_output_buffer,
+		arena,
+		layer,
+		input_configuration_specific,
+		output_configuration_specific,
+		plain_config);
+
+	tester->test(
+		input_buffer,
+		additional_buffers,
+		plain_config,
+		layer,
+		tester->get_data(data, layer, input_configuration_specific, output_configuration_specific, plain_config),
+		tester->get_data_custom(data_custom, layer, input_configuration_specific, output_configuration_specific, plain_config),
+		input_configuration_specific,
+		output_configuration_specific,
+		entry_count);
+
+	nnforge::plain::additional_buffer_smart_ptr output_buffer = tester->get_output_buffer(input_buffer, additional_buffers);
+	return std::vector<float>(output_buffer->begin(), output_buffer->begin() + output_elem_count);
+}
+
+engine_checker::updater_result engine_checker::run_updater(
+	nnforge::const_layer_smart_ptr layer,
+	const nnforge::layer_configuration_specific& input_configuration_specific,
+	nnforge::const_layer_data_smart_ptr data,
+	nnforge::const_layer_data_custom_smart_ptr data_custom,
+	const std::vector<float>& input,
+	const std::vector<float>& output_errors,
+	unsigned int entry_count,
+	bool force_deterministic) const
+{
+	nnforge::plain::const_layer_updater_plain_smart_ptr updater = nnforge::plain::single_layer_updater_plain_factory::get_const_instance().get_updater_plain_layer(layer->get_uuid());
+	const nnforge::layer_configuration_specific output_configuration_specific = layer->get_output_layer_configuration_specific(input_configuration_specific);
+	const unsigned int input_elem_count = input_configuration_specific.get_neuron_count() * entry_count;
+	const unsigned int output_elem_count = output_configuration_specific.get_neuron_count() * entry_count;
+
+	// The first call only sizes the arena
+	nnforge::plain::buffer_arena_plain arena(false);
+	updater->allocate_additional_buffers(entry_count, arena, layer, input_configuration_specific, output_configuration_specific, plain_config, true);
+	arena.allocate();
+	nnforge::plain::updater_additional_buffer_set buffers = updater->allocate_additional_buffers(
+		entry_count,
+		arena,
+		layer,
+		input_configuration_specific,
+		output_configuration_specific,
+		plain_config,
+		true);
+	updater->update_data_derived_buffers(
+		buffers.additional_buffers,
+		plain_config,
+		layer,
+		data,
+		input_configuration_specific,
+		output_configuration_specific);
+
+	nnforge::plain::const_additional_buffer_smart_ptr input_buffer(new nnforge::plain::additional_buffer(input.begin(), input.end()));
+	updater->test(
+		input_buffer,
+		buffers.output_neurons_buffer,
+		buffers.additional_buffers,
+		plain_config,
+		layer,
+		data,
+		data_custom,
+		input_configuration_specific,
+		output_configuration_specific,
+		entry_count,
+		0,
+		force_deterministic);
+
+	updater_result res;
+	res.output.assign(buffers.output_neurons_buffer->begin(), buffers.output_neurons_buffer->begin() + output_elem_count);
+
+	// Gradient first, in-place updaters overwrite output errors with input errors
+	if (!layer->is_empty_data())
+	{
+		res.gradient = layer->create_layer_data();
+		updater->update_weights(
+			input_buffer,
+			nnforge::plain::const_additional_buffer_smart_ptr(new nnforge::plain::additional_buffer(output_errors.begin(), output_errors.end())),
+			buffers.additional_buffers,
+			res.gradient,
+			data_custom,
+			plain_config,
+			layer,
+			input_configuration_specific,
+			output_configuration_specific,
+			entry_count,
+			0,
+			force_deterministic);
+	}
+
+	nnforge::plain::additional_buffer_smart_ptr output_errors_buffer(new nnforge::plain::additional_buffer(output_errors.begin(), output_errors.end()));
+	nnforge::plain::additional_buffer_smart_ptr input_errors_buffer = buffers.input_errors_buffer ? buffers.input_errors_buffer : output_errors_buffer;
+	updater->backprop(
+		input_errors_buffer,
+		input_buffer,
+		output_errors_buffer,
+		buffers.output_neurons_buffer,
+		buffers.additional_buffers,
+		plain_config,
+		layer,
+		data,
+		data_custom,
+		input_configuration_specific,
+		output_configuration_specific,
+		entry_count,
+		force_deterministic);
+	res.input_errors.assign(input_errors_buffer->begin(), input_errors_buffer->begin() + input_elem_count);
+
+	return res;
+}
+
+std::vector<float> engine_checker::run_reference_network(
+	nnforge::network_schema_smart_ptr schema,
+	nnforge::network_data_smart_ptr data,
+	const nnforge::layer_configuration_specific& input_configuration_specific,
+	const std::vector<float>& input,
+	unsigned int entry_count) const
+{
+	const nnforge::const_layer_list& layer_list = *schema;
+	std::vector<float> current_input = input;
+	std::vector<float> current_output;
+	nnforge::layer_configuration_specific current_configuration_specific = input_configuration_specific;
+	for(unsigned int layer_id = 0; layer_id < layer_list.size(); ++layer_id)
+	{
+		nnforge::const_layer_smart_ptr layer = layer_list[layer_id];
+		const boost::uuids::uuid& uuid = layer->get_uuid();
+		if ((uuid == nnforge::convolution_layer::layer_guid) || (uuid == nnforge::grouped_convolution_layer::layer_guid) || (uuid == nnforge::sparse_convolution_layer::layer_guid))
+		{
+			const reference_layers::convolution_geometry geometry = get_geometry(layer, current_configuration_specific);
+			reference_layers::convolution_forward(
+				geometry,
+				get_dense_weights(layer, *data->data_list[layer_id], *data->data_custom_list[layer_id], geometry),
+				(*data->data_list[layer_id])[1],
+				current_input,
+				current_output,
+				entry_count);
+		}
+		else if (uuid == nnforge::hyperbolic_tangent_layer::layer_guid)
+			reference_layers::activation_forward(reference_layers::activation_hyperbolic_tangent, current_input, current_output);
+		else if (uuid == nnforge::sigmoid_layer::layer_guid)
+			reference_layers::activation_forward(reference_layers::activation_sigmoid, current_input, current_output);
+		else if (uuid == nnforge::rectified_linear_layer::layer_guid)
+			reference_layers::activation_forward(reference_layers::activation_rectified_linear, current_input, current_output);
+		else if (uuid == nnforge::absolute_layer::layer_guid)
+			reference_layers::activation_forward(reference_layers::activation_absolute, current_input, current_output);
+		else if (uuid == nnforge::max_subsampling_layer::layer_guid)
+			reference_layers::subsampling_forward(true, nnforge_dynamic_pointer_cast<const nnforge::max_subsampling_layer>(layer)->subsampling_sizes, current_configuration_specific, current_input, current_output, entry_count);
+		else if (uuid == nnforge::average_subsampling_layer::layer_guid)
+			reference_layers::subsampling_forward(false, nnforge_dynamic_pointer_cast<const nnforge::average_subsampling_layer>(layer)->subsampling_sizes, current_configuration_specific, current_input, current_output, entry_count);
+		else if (uuid == nnforge::softmax_layer::layer_guid)
+			reference_layers::softmax_forward(current_configuration_specific, current_input, current_output, entry_count);
+		else if (uuid == nnforge::local_contrast_subtractive_layer::layer_guid)
+			reference_layers::local_contrast_subtractive_forward(*nnforge_dynamic_pointer_cast<const nnforge::local_contrast_subtractive_layer>(layer), current_configuration_specific, current_input, current_output, entry_count);
+		else
+			throw nnforge::neural_network_exception((boost::format("No reference implementation for layer %1%") % layer_id).str());
+
+		current_configuration_specific = layer->get_output_layer_configuration_specific(current_configuration_specific);
+		current_input.swap(current_output);
+	}
+
+	return current_input;
+}
+
+void engine_checker::report(
+	const std::string& name,
+	const char * what,
+	float difference,
+	float max_difference)
+{
+	++check_count;
+	// NaN fails too
+	bool failed = !(difference <= max_difference);
+	if (failed)
+		++failed_check_count;
+
+	std::cout << name << ", " << what << ": " << difference << (failed ? " FAILED" : "") << std::endl;
+}
+
+std::vector<float> engine_checker::get_random_values(
+	size_t elem_count,
+	float max_abs_value)
+{
+	nnforge_uniform_real_distribution<float> distribution(-max_abs_value, max_abs_value);
+	std::vector<float> res(elem_count);
+	for(std::vector<float>::iterator it = res.begin(); it != res.end(); ++it)
+		*it = distribution(generator);
+
+	return res;
+}
+
+void engine_checker::randomize(
+	nnforge::const_layer_smart_ptr layer,
+	nnforge::layer_data& data,
+	nnforge::layer_data_custom& data_custom)
+{
+	layer->randomize_data(data, data_custom, generator);
+
+	// Biases are initialized with zeros
+	for(unsigned int part_id = 1; part_id < data.size(); ++part_id)
+		data[part_id] = get_random_values(data[part_id].size(), 0.5F);
+}
+
+unsigned int engine_checker::get_read_batch_mismatch_count(
+	nnforge::supervised_data_reader& entry_reader,
+	nnforge::supervised_data_reader& batch_reader)
+{
+	const size_t input_entry_size = entry_reader.get_input_configuration().get_neuron_count() * entry_reader.get_input_neuron_elem_size();
+	const unsigned int output_entry_elem_count = entry_reader.get_output_configuration().get_neuron_count();
+
+	unsigned int res = 0;
+	unsigned int batch_entry_count = 1;
+	while (true)
+	{
+		std::vector<unsigned char> batch_input(input_entry_size * batch_entry_count);
+		std::vector<float> batch_output(output_entry_elem_count * batch_entry_count);
+		unsigned int read_entry_count = batch_reader.read_batch(batch_entry_count, &batch_input[0], &batch_output[0]);
+
+		std::vector<unsigned char> input(input_entry_size);
+		std::vector<float> output(output_entry_elem_count);
+		for(unsigned int entry_id = 0; entry_id < read_entry_count; ++entry_id)
+		{
+			if (!entry_reader.read(&input[0], &output[0])
+				|| !std::equal(input.begin(), input.end(), batch_input.begin() + entry_id * input_entry_size)
+				|| !std::equal(output.begin(), output.end(), batch_output.begin() + entry_id * output_entry_elem_count))
+				++res;
+		}
+
+		if (read_entry_count < batch_entry_count)
+			break;
+
+		// Batches of 1 to 17 entries
+		batch_entry_count = batch_entry_count * 3 % 17 + 1;
+	}
+
+	// Entries left in the entry reader only
+	std::vector<unsigned char> input(input_entry_size);
+	std::vector<float> output(output_entry_elem_count);
+	while (entry_reader.read(&input[0], &output[0]))
+		++res;
+
+	return res;
+}
+
+unsigned int engine_checker::get_read_batch_mismatch_count(
+	nnforge::unsupervised_data_reader& entry_reader,
+	nnforge::unsupervised_data_reader& batch_reader)
+{
+	const size_t input_entry_size = entry_reader.get_input_configuration().get_neuron_count() * entry_reader.get_input_neuron_elem_size();
+
+	unsigned int res = 0;
+	unsigned int batch_entry_count = 1;
+	while (true)
+	{
+		std::vector<unsigned char> batch_input(input_entry_size * batch_entry_count);
+		unsigned int read_entry_count = batch_reader.read_batch(batch_entry_count, &batch_input[0]);
+
+		std::vector<unsigned char> input(input_entry_size);
+		for(unsigned int entry_id = 0; entry_id < read_entry_count; ++entry_id)
+		{
+			if (!entry_reader.read(&input[0])
+				|| !std::equal(input.begin(), input.end(), batch_input.begin() + entry_id * input_entry_size))
+				++res;
+		}
+
+		if (read_entry_count < batch_entry_count)
+			break;
+
+		// Batches of 1 to 17 entries
+		batch_entry_count = batch_entry_count * 3 % 17 + 1;
+	}
+
+	// Entries left in the entry reader only
+	std::vector<unsigned char> input(input_entry_size);
+	while (entry_reader.read(&input[0]))
+		++res;
+
+	return res;
+}
+
+std::vector<unsigned int> engine_checker::get_sizes(
+	unsigned int x,
+	unsigned int y,
+	unsigned int z)
+{
+	std::vector<unsigned int> res;
+	res.push_back(x);
+	if (y > 0)
+		res.push_back(y);
+	if (z > 0)
+		res.push_back(z);
+
+	return res;
+}
+
+reference_layers::convolution_geometry engine_checker::get_geometry(
+	nnforge::const_layer_smart_ptr layer,
+	const nnforge::layer_configuration_specific& input_configuration_specific)
+{
+	reference_layers::convolution_geometry res;
+	if (layer->get_uuid() == nnforge::convolution_layer::layer_guid)
+	{
+		nnforge_shared_ptr<const nnforge::convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const nnforge::convolution_layer>(layer);
+		res.window_sizes = layer_derived->window_sizes;
+		res.left_zero_padding = layer_derived->left_zero_padding;
+		res.strides = layer_derived->strides;
+	}
+	else if (layer->get_uuid() == nnforge::sparse_convolution_layer::layer_guid)
+	{
+		nnforge_shared_ptr<const nnforge::sparse_convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const nnforge::sparse_convolution_layer>(layer);
+		res.window_sizes = layer_derived->window_sizes;
+		res.left_zero_padding = layer_derived->left_zero_padding;
+		res.strides = layer_derived->strides;
+	}
+	else if (layer->get_uuid() == nnforge::grouped_convolution_layer::layer_guid)
+	{
+		nnforge_shared_ptr<const nnforge::grouped_convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const nnforge::grouped_convolution_layer>(layer);
+		res.window_sizes = layer_derived->window_sizes;
+		res.left_zero_padding = layer_derived->left_zero_padding;
+		res.strides = layer_derived->strides;
+	}
+	res.input_configuration_specific = input_configuration_specific;
+	res.output_configuration_specific = layer->get_output_layer_configuration_specific(input_configuration_specific);
+
+	return res;
+}
+
+std::vector<float> engine_checker::get_dense_weights(
+	nnforge::const_layer_smart_ptr layer,
+	const nnforge::layer_data& data,
+	const nnforge::layer_data_custom& data_custom,
+	const reference_layers::convolution_geometry& geometry)
+{
+	const unsigned int window_elem_count = nnforge::layer_configuration_specific(1, geometry.window_sizes).get_neuron_count();
+	const unsigned int input_feature_map_count = geometry.input_configuration_specific.feature_map_count;
+	const unsigned int output_feature_map_count = geometry.output_configuration_specific.feature_map_count;
+
+	if (layer->get_uuid() == nnforge::sparse_convolution_layer::layer_guid)
+		return reference_layers::sparse_to_dense(data[0], data_custom, input_feature_map_count, output_feature_map_count, window_elem_count);
+	if (layer->get_uuid() == nnforge::grouped_convolution_layer::layer_guid)
+		return reference_layers::grouped_to_dense(data[0], input_feature_map_count, output_feature_map_count, nnforge_dynamic_pointer_cast<const nnforge::grouped_convolution_layer>(layer)->group_count, window_elem_count);
+
+	return data[0];
+}
+
+std::vector<float> engine_checker::get_layer_weights(
+	nnforge::const_layer_smart_ptr layer,
+	const std::vector<float>& dense_weights,
+	const nnforge::layer_data_custom& data_custom,
+	const reference_layers::convolution_geometry& geometry)
+{
+	const unsigned int window_elem_count = nnforge::layer_configuration_specific(1, geometry.window_sizes).get_neuron_count();
+	const unsigned int input_feature_map_count = geometry.input_configuration_specific.feature_map_count;
+	const unsigned int output_feature_map_count = geometry.output_configuration_specific.feature_map_count;
+
+	if (layer->get_uuid() == nnforge::sparse_convolution_layer::layer_guid)
+		return reference_layers::dense_to_sparse(dense_weights, data_custom, input_feature_map_count, output_feature_map_count, window_elem_count);
+	if (layer->get_uuid() == nnforge::grouped_convolution_layer::layer_guid)
+		return reference_layers::dense_to_grouped(dense_weights, input_feature_map_count, output_feature_map_count, nnforge_dynamic_pointer_cast<const nnforge::grouped_convolution_layer>(layer)->group_count, window_elem_count);
+
+	return dense_weights;
+}
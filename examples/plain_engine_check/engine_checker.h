@@ -0,0 +1,199 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "reference_layers.h"
+
+#include <nnforge/layer.h>
+#include <nnforge/layer_configuration_specific.h>
+#include <nnforge/layer_data.h>
+#include <nnforge/layer_data_custom.h>
+#include <nnforge/network_schema.h>
+#include <nnforge/network_data.h>
+#include <nnforge/supervised_data_reader.h>
+#include <nnforge/unsupervised_data_reader.h>
+#include <nnforge/rnd.h>
+#include <nnforge/nn_types.h>
+#include <nnforge/plain/plain_running_configuration.h>
+
+#include <string>
+#include <vector>
+
+// Runs the plain testers and updaters on small problems hitting each engine and dispatch path of the plain backend,
+// and compares their results with the ones of reference_layers
+class engine_checker
+{
+public:
+	engine_checker();
+
+	~engine_checker();
+
+	// Returns the number of the comparisons failed
+	unsigned int run();
+
+private:
+	struct updater_result
+	{
+		std::vector<float> output;
+		std::vector<float> input_errors;
+		nnforge::layer_data_smart_ptr gradient;
+	};
+
+	void check_all_layers();
+
+	void check_all_networks();
+
+	// Convolution layers of any kind, their weights are converted to the dense ones of reference_layers
+	void check_convolution(
+		const std::string& name,
+		nnforge::const_layer_smart_ptr layer,
+		const nnforge::layer_configuration_specific& input_configuration_specific,
+		unsigned int entry_count);
+
+	void check_activation(
+		const std::string& name,
+		nnforge::const_layer_smart_ptr layer,
+		reference_layers::activation_type type,
+		const nnforge::layer_configuration_specific& input_configuration_specific,
+		unsigned int entry_count);
+
+	void check_subsampling(
+		const std::string& name,
+		bool is_max,
+		const std::vector<unsigned int>& subsampling_sizes,
+		const nnforge::layer_configuration_specific& input_configuration_specific,
+		unsigned int entry_count);
+
+	void check_softmax(
+		const std::string& name,
+		const nnforge::layer_configuration_specific& input_configuration_specific,
+		unsigned int entry_count);
+
+	void check_local_contrast_subtractive(
+		const std::string& name,
+		const std::vector<unsigned int>& window_sizes,
+		const std::vector<unsigned int>& feature_maps_affected,
+		const nnforge::layer_configuration_specific& input_configuration_specific,
+		unsigned int entry_count);
+
+	// Network tester output against the reference, with the blocked layout when blocked_layout is true
+	void check_network(
+		const std::string& name,
+		nnforge::network_schema_smart_ptr schema,
+		const nnforge::layer_configuration_specific& input_configuration_specific,
+		unsigned int entry_count,
+		bool blocked_layout);
+
+	// Keep rate, values kept and the errors backpropagated with the same mask
+	void check_dropout(
+		float dropout_rate,
+		const nnforge::layer_configuration_specific& input_configuration_specific,
+		unsigned int entry_count);
+
+	// Entries read with read and with read_batch in chunks of varying size are the same
+	void check_read_batch();
+
+	// Local contrast subtractive layer followed by the convolution and hyperbolic tangent trained for a single batch:
+	// the layer without weights runs in the tester, the weights updated are checked against the reference gradient
+	void check_local_contrast_subtractive_training(
+		const std::string& name,
+		const std::vector<unsigned int>& input_sizes,
+		unsigned int entry_count);
+
+	std::vector<float> run_tester(
+		nnforge::const_layer_smart_ptr layer,
+		const nnforge::layer_configuration_specific& input_configuration_specific,
+		nnforge::const_layer_data_smart_ptr data,
+		nnforge::const_layer_data_custom_smart_ptr data_custom,
+		const std::vector<float>& input,
+		unsigned int entry_count) const;
+
+	updater_result run_updater(
+		nnforge::const_layer_smart_ptr layer,
+		const nnforge::layer_configuration_specific& input_configuration_specific,
+		nnforge::const_layer_data_smart_ptr data,
+		nnforge::const_layer_data_custom_smart_ptr data_custom,
+		const std::vector<float>& input,
+		const std::vector<float>& output_errors,
+		unsigned int entry_count,
+		bool force_deterministic) const;
+
+	// Forward pass of reference_layers for the layers of the schema
+	std::vector<float> run_reference_network(
+		nnforge::network_schema_smart_ptr schema,
+		nnforge::network_data_smart_ptr data,
+		const nnforge::layer_configuration_specific& input_configuration_specific,
+		const std::vector<float>& input,
+		unsigned int entry_count) const;
+
+	void report(
+		const std::string& name,
+		const char * what,
+		float difference,
+		float max_difference);
+
+	std::vector<float> get_random_values(
+		size_t elem_count,
+		float max_abs_value);
+
+	// Randomizes the layer data as the layer does, biases are set to random values too
+	void randomize(
+		nnforge::const_layer_smart_ptr layer,
+		nnforge::layer_data& data,
+		nnforge::layer_data_custom& data_custom);
+
+	// Count of the entries different when read with read and with read_batch
+	static unsigned int get_read_batch_mismatch_count(
+		nnforge::supervised_data_reader& entry_reader,
+		nnforge::supervised_data_reader& batch_reader);
+
+	static unsigned int get_read_batch_mismatch_count(
+		nnforge::unsupervised_data_reader& entry_reader,
+		nnforge::unsupervised_data_reader& batch_reader);
+
+	// Dimension sizes, zeros are skipped
+	static std::vector<unsigned int> get_sizes(
+		unsigned int x,
+		unsigned int y = 0,
+		unsigned int z = 0);
+
+	static reference_layers::convolution_geometry get_geometry(
+		nnforge::const_layer_smart_ptr layer,
+		const nnforge::layer_configuration_specific& input_configuration_specific);
+
+	// Weights of the convolution layers laid out as reference_layers expects them
+	static std::vector<float> get_dense_weights(
+		nnforge::const_layer_smart_ptr layer,
+		const nnforge::layer_data& data,
+		const nnforge::layer_data_custom& data_custom,
+		const reference_layers::convolution_geometry& geometry);
+
+	// Inverse of get_dense_weights
+	static std::vector<float> get_layer_weights(
+		nnforge::const_layer_smart_ptr layer,
+		const std::vector<float>& dense_weights,
+		const nnforge::layer_data_custom& data_custom,
+		const reference_layers::convolution_geometry& geometry);
+
+	nnforge::random_generator generator;
+	nnforge::plain::plain_running_configuration_const_smart_ptr plain_config;
+	unsigned int check_count;
+	unsigned int failed_check_count;
+
+	static const int thread_count;
+	static const float max_relative_difference;
+};
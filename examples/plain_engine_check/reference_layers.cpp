@@ -0,0 +1,651 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include "reference_layers.h"
+
+#include <nnforge/hyperbolic_tangent_layer.h>
+#include <nnforge/neural_network_exception.h>
+
+#include <algorithm>
+#include <cmath>
+
+void reference_layers::convolution_forward(
+	const convolution_geometry& geometry,
+	const std::vector<float>& weights,
+	const std::vector<float>& biases,
+	const std::vector<float>& input,
+	std::vector<float>& output,
+	unsigned int entry_count)
+{
+	const std::vector<connection> connections = get_connections(geometry);
+	const unsigned int input_feature_map_count = geometry.input_configuration_specific.feature_map_count;
+	const unsigned int output_feature_map_count = geometry.output_configuration_specific.feature_map_count;
+	const unsigned int input_neuron_count_per_feature_map = geometry.input_configuration_specific.get_neuron_count_per_feature_map();
+	const unsigned int output_neuron_count_per_feature_map = geometry.output_configuration_specific.get_neuron_count_per_feature_map();
+	const unsigned int window_elem_count = static_cast<unsigned int>(weights.size()) / (input_feature_map_count * output_feature_map_count);
+
+	output.resize(entry_count * output_feature_map_count * output_neuron_count_per_feature_map);
+	std::vector<double> sums(output_neuron_count_per_feature_map);
+	for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+	{
+		for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+		{
+			std::fill(sums.begin(), sums.end(), static_cast<double>(biases[output_feature_map_id]));
+			for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count; ++input_feature_map_id)
+			{
+				const float * in = &input[(entry_id * input_feature_map_count + input_feature_map_id) * input_neuron_count_per_feature_map];
+				const float * w = &weights[(output_feature_map_id * input_feature_map_count + input_feature_map_id) * window_elem_count];
+				for(std::vector<connection>::const_iterator it = connections.begin(); it != connections.end(); ++it)
+					sums[it->output_offset] += static_cast<double>(w[it->window_offset]) * static_cast<double>(in[it->input_offset]);
+			}
+			float * out = &output[(entry_id * output_feature_map_count + output_feature_map_id) * output_neuron_count_per_feature_map];
+			for(unsigned int i = 0; i < output_neuron_count_per_feature_map; ++i)
+				out[i] = static_cast<float>(sums[i]);
+		}
+	}
+}
+
+void reference_layers::convolution_backprop(
+	const convolution_geometry& geometry,
+	const std::vector<float>& weights,
+	const std::vector<float>& output_errors,
+	std::vector<float>& input_errors,
+	unsigned int entry_count)
+{
+	const std::vector<connection> connections = get_connections(geometry);
+	const unsigned int input_feature_map_count = geometry.input_configuration_specific.feature_map_count;
+	const unsigned int output_feature_map_count = geometry.output_configuration_specific.feature_map_count;
+	const unsigned int input_neuron_count_per_feature_map = geometry.input_configuration_specific.get_neuron_count_per_feature_map();
+	const unsigned int output_neuron_count_per_feature_map = geometry.output_configuration_specific.get_neuron_count_per_feature_map();
+	const unsigned int window_elem_count = static_cast<unsigned int>(weights.size()) / (input_feature_map_count * output_feature_map_count);
+
+	input_errors.resize(entry_count * input_feature_map_count * input_neuron_count_per_feature_map);
+	std::vector<double> sums(input_neuron_count_per_feature_map);
+	for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+	{
+		for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count; ++input_feature_map_id)
+		{
+			std::fill(sums.begin(), sums.end(), 0.0);
+			for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+			{
+				const float * out_err = &output_errors[(entry_id * output_feature_map_count + output_feature_map_id) * output_neuron_count_per_feature_map];
+				const float * w = &weights[(output_feature_map_id * input_feature_map_count + input_feature_map_id) * window_elem_count];
+				for(std::vector<connection>::const_iterator it = connections.begin(); it != connections.end(); ++it)
+					sums[it->input_offset] += static_cast<double>(w[it->window_offset]) * static_cast<double>(out_err[it->output_offset]);
+			}
+			float * in_err = &input_errors[(entry_id * input_feature_map_count + input_feature_map_id) * input_neuron_count_per_feature_map];
+			for(unsigned int i = 0; i < input_neuron_count_per_feature_map; ++i)
+				in_err[i] = static_cast<float>(sums[i]);
+		}
+	}
+}
+
+void reference_layers::convolution_gradient(
+	const convolution_geometry& geometry,
+	const std::vector<float>& input,
+	const std::vector<float>& output_errors,
+	std::vector<float>& weights_gradient,
+	std::vector<float>& biases_gradient,
+	unsigned int entry_count)
+{
+	const std::vector<connection> connections = get_connections(geometry);
+	const unsigned int input_feature_map_count = geometry.input_configuration_specific.feature_map_count;
+	const unsigned int output_feature_map_count = geometry.output_configuration_specific.feature_map_count;
+	const unsigned int input_neuron_count_per_feature_map = geometry.input_configuration_specific.get_neuron_count_per_feature_map();
+	const unsigned int output_neuron_count_per_feature_map = geometry.output_configuration_specific.get_neuron_count_per_feature_map();
+	const unsigned int window_elem_count = static_cast<unsigned int>(weights_gradient.size()) / (input_feature_map_count * output_feature_map_count);
+
+	std::vector<double> sums(window_elem_count);
+	for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+	{
+		double bias_sum = 0.0;
+		for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+		{
+			const float * out_err = &output_errors[(entry_id * output_feature_map_count + output_feature_map_id) * output_neuron_count_per_feature_map];
+			for(unsigned int i = 0; i < output_neuron_count_per_feature_map; ++i)
+				bias_sum += static_cast<double>(out_err[i]);
+		}
+		biases_gradient[output_feature_map_id] += static_cast<float>(bias_sum);
+
+		for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count; ++input_feature_map_id)
+		{
+			std::fill(sums.begin(), sums.end(), 0.0);
+			for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+			{
+				const float * in = &input[(entry_id * input_feature_map_count + input_feature_map_id) * input_neuron_count_per_feature_map];
+				const float * out_err = &output_errors[(entry_id * output_feature_map_count + output_feature_map_id) * output_neuron_count_per_feature_map];
+				for(std::vector<connection>::const_iterator it = connections.begin(); it != connections.end(); ++it)
+					sums[it->window_offset] += static_cast<double>(in[it->input_offset]) * static_cast<double>(out_err[it->output_offset]);
+			}
+			float * w_grad = &weights_gradient[(output_feature_map_id * input_feature_map_count + input_feature_map_id) * window_elem_count];
+			for(unsigned int i = 0; i < window_elem_count; ++i)
+				w_grad[i] += static_cast<float>(sums[i]);
+		}
+	}
+}
+
+std::vector<float> reference_layers::grouped_to_dense(
+	const std::vector<float>& grouped_weights,
+	unsigned int input_feature_map_count,
+	unsigned int output_feature_map_count,
+	unsigned int group_count,
+	unsigned int window_elem_count)
+{
+	const unsigned int group_input_feature_map_count = input_feature_map_count / group_count;
+	const unsigned int group_output_feature_map_count = output_feature_map_count / group_count;
+
+	std::vector<float> res(output_feature_map_count * input_feature_map_count * window_elem_count, 0.0F);
+	for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+	{
+		unsigned int first_input_feature_map_id = (output_feature_map_id / group_output_feature_map_count) * group_input_feature_map_count;
+		std::copy(
+			grouped_weights.begin() + output_feature_map_id * group_input_feature_map_count * window_elem_count,
+			grouped_weights.begin() + (output_feature_map_id + 1) * group_input_feature_map_count * window_elem_count,
+			res.begin() + (output_feature_map_id * input_feature_map_count + first_input_feature_map_id) * window_elem_count);
+	}
+
+	return res;
+}
+
+std::vector<float> reference_layers::dense_to_grouped(
+	const std::vector<float>& dense_weights,
+	unsigned int input_feature_map_count,
+	unsigned int output_feature_map_count,
+	unsigned int group_count,
+	unsigned int window_elem_count)
+{
+	const unsigned int group_input_feature_map_count = input_feature_map_count / group_count;
+	const unsigned int group_output_feature_map_count = output_feature_map_count / group_count;
+
+	std::vector<float> res(output_feature_map_count * group_input_feature_map_count * window_elem_count);
+	for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+	{
+		unsigned int first_input_feature_map_id = (output_feature_map_id / group_output_feature_map_count) * group_input_feature_map_count;
+		std::vector<float>::const_iterator src_it = dense_weights.begin() + (output_feature_map_id * input_feature_map_count + first_input_feature_map_id) * window_elem_count;
+		std::copy(
+			src_it,
+			src_it + group_input_feature_map_count * window_elem_count,
+			res.begin() + output_feature_map_id * group_input_feature_map_count * window_elem_count);
+	}
+
+	return res;
+}
+
+std::vector<float> reference_layers::sparse_to_dense(
+	const std::vector<float>& sparse_weights,
+	const nnforge::layer_data_custom& data_custom,
+	unsigned int input_feature_map_count,
+	unsigned int output_feature_map_count,
+	unsigned int window_elem_count)
+{
+	const std::vector<int>& column_indices = data_custom[0];
+	const std::vector<int>& row_indices = data_custom[1];
+
+	std::vector<float> res(output_feature_map_count * input_feature_map_count * window_elem_count, 0.0F);
+	for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+	{
+		for(int connection_id = row_indices[output_feature_map_id]; connection_id < row_indices[output_feature_map_id + 1]; ++connection_id)
+		{
+			std::copy(
+				sparse_weights.begin() + connection_id * window_elem_count,
+				sparse_weights.begin() + (connection_id + 1) * window_elem_count,
+				res.begin() + (output_feature_map_id * input_feature_map_count + column_indices[connection_id]) * window_elem_count);
+		}
+	}
+
+	return res;
+}
+
+std::vector<float> reference_layers::dense_to_sparse(
+	const std::vector<float>& dense_weights,
+	const nnforge::layer_data_custom& data_custom,
+	unsigned int input_feature_map_count,
+	unsigned int output_feature_map_count,
+	unsigned int window_elem_count)
+{
+	const std::vector<int>& column_indices = data_custom[0];
+	const std::vector<int>& row_indices = data_custom[1];
+
+	std::vector<float> res(column_indices.size() * window_elem_count);
+	for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+	{
+		for(int connection_id = row_indices[output_feature_map_id]; connection_id < row_indices[output_feature_map_id + 1]; ++connection_id)
+		{
+			std::vector<float>::const_iterator src_it = dense_weights.begin() + (output_feature_map_id * input_feature_map_count + column_indices[connection_id]) * window_elem_count;
+			std::copy(
+				src_it,
+				src_it + window_elem_count,
+				res.begin() + connection_id * window_elem_count);
+		}
+	}
+
+	return res;
+}
+
+void reference_layers::activation_forward(
+	activation_type type,
+	const std::vector<float>& input,
+	std::vector<float>& output)
+{
+	output.resize(input.size());
+	for(unsigned int i = 0; i < input.size(); ++i)
+	{
+		float x = input[i];
+		switch (type)
+		{
+		case activation_hyperbolic_tangent:
+			output[i] = nnforge::hyperbolic_tangent_layer::major_multiplier * tanhf(nnforge::hyperbolic_tangent_layer::steepness * x);
+			break;
+		case activation_sigmoid:
+			output[i] = 1.0F / (1.0F + expf(-x));
+			break;
+		case activation_rectified_linear:
+			output[i] = std::max(x, 0.0F);
+			break;
+		case activation_absolute:
+			output[i] = fabsf(x);
+			break;
+		}
+	}
+}
+
+void reference_layers::activation_backprop(
+	activation_type type,
+	const std::vector<float>& input,
+	const std::vector<float>& output,
+	const std::vector<float>& output_errors,
+	std::vector<float>& input_errors)
+{
+	input_errors.resize(input.size());
+	for(unsigned int i = 0; i < input.size(); ++i)
+	{
+		float derivative = 0.0F;
+		switch (type)
+		{
+		case activation_hyperbolic_tangent:
+			{
+				float normalized_output = output[i] / nnforge::hyperbolic_tangent_layer::major_multiplier;
+				derivative = nnforge::hyperbolic_tangent_layer::major_multiplier * nnforge::hyperbolic_tangent_layer::steepness * (1.0F - normalized_output * normalized_output);
+			}
+			break;
+		case activation_sigmoid:
+			derivative = output[i] * (1.0F - output[i]);
+			break;
+		case activation_rectified_linear:
+			derivative = (input[i] > 0.0F) ? 1.0F : 0.0F;
+			break;
+		case activation_absolute:
+			derivative = (input[i] > 0.0F) ? 1.0F : -1.0F;
+			break;
+		}
+		input_errors[i] = output_errors[i] * derivative;
+	}
+}
+
+void reference_layers::subsampling_forward(
+	bool is_max,
+	const std::vector<unsigned int>& subsampling_sizes,
+	const nnforge::layer_configuration_specific& input_configuration_specific,
+	const std::vector<float>& input,
+	std::vector<float>& output,
+	unsigned int entry_count)
+{
+	std::vector<unsigned int> output_sizes(subsampling_sizes.size());
+	unsigned int output_neuron_count_per_feature_map = 1;
+	unsigned int window_elem_count = 1;
+	for(unsigned int i = 0; i < subsampling_sizes.size(); ++i)
+	{
+		output_sizes[i] = input_configuration_specific.dimension_sizes[i] / subsampling_sizes[i];
+		output_neuron_count_per_feature_map *= output_sizes[i];
+		window_elem_count *= subsampling_sizes[i];
+	}
+	const unsigned int feature_map_count = entry_count * input_configuration_specific.feature_map_count;
+	const unsigned int input_neuron_count_per_feature_map = input_configuration_specific.get_neuron_count_per_feature_map();
+
+	output.resize(feature_map_count * output_neuron_count_per_feature_map);
+	for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
+	{
+		const float * in = &input[feature_map_id * input_neuron_count_per_feature_map];
+		float * out = &output[feature_map_id * output_neuron_count_per_feature_map];
+		std::vector<unsigned int> output_position(subsampling_sizes.size(), 0);
+		do
+		{
+			float max_value = -1.0e+37F;
+			double sum = 0.0;
+			std::vector<unsigned int> window_position(subsampling_sizes.size(), 0);
+			do
+			{
+				std::vector<unsigned int> input_position(subsampling_sizes.size());
+				for(unsigned int i = 0; i < subsampling_sizes.size(); ++i)
+					input_position[i] = output_position[i] * subsampling_sizes[i] + window_position[i];
+				float val = in[input_configuration_specific.get_pos(input_position)];
+				max_value = std::max(max_value, val);
+				sum += static_cast<double>(val);
+			} while (next_position(window_position, subsampling_sizes));
+
+			nnforge::layer_configuration_specific output_configuration_specific(1, output_sizes);
+			out[output_configuration_specific.get_pos(output_position)] = is_max ? max_value : static_cast<float>(sum / static_cast<double>(window_elem_count));
+		} while (next_position(output_position, output_sizes));
+	}
+}
+
+void reference_layers::subsampling_backprop(
+	bool is_max,
+	const std::vector<unsigned int>& subsampling_sizes,
+	const nnforge::layer_configuration_specific& input_configuration_specific,
+	const std::vector<float>& input,
+	const std::vector<float>& output_errors,
+	std::vector<float>& input_errors,
+	unsigned int entry_count)
+{
+	std::vector<unsigned int> output_sizes(subsampling_sizes.size());
+	unsigned int output_neuron_count_per_feature_map = 1;
+	unsigned int window_elem_count = 1;
+	for(unsigned int i = 0; i < subsampling_sizes.size(); ++i)
+	{
+		output_sizes[i] = input_configuration_specific.dimension_sizes[i] / subsampling_sizes[i];
+		output_neuron_count_per_feature_map *= output_sizes[i];
+		window_elem_count *= subsampling_sizes[i];
+	}
+	const nnforge::layer_configuration_specific output_configuration_specific(1, output_sizes);
+	const unsigned int feature_map_count = entry_count * input_configuration_specific.feature_map_count;
+	const unsigned int input_neuron_count_per_feature_map = input_configuration_specific.get_neuron_count_per_feature_map();
+
+	// Neurons not covered by any window get zero errors
+	input_errors.assign(feature_map_count * input_neuron_count_per_feature_map, 0.0F);
+	for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
+	{
+		const float * in = &input[feature_map_id * input_neuron_count_per_feature_map];
+		const float * out_err = &output_errors[feature_map_id * output_neuron_count_per_feature_map];
+		float * in_err = &input_errors[feature_map_id * input_neuron_count_per_feature_map];
+		std::vector<unsigned int> output_position(subsampling_sizes.size(), 0);
+		do
+		{
+			float err = out_err[output_configuration_specific.get_pos(output_position)];
+			float max_value = -1.0e+37F;
+			unsigned int max_pos = 0;
+			std::vector<unsigned int> window_position(subsampling_sizes.size(), 0);
+			do
+			{
+				std::vector<unsigned int> input_position(subsampling_sizes.size());
+				for(unsigned int i = 0; i < subsampling_sizes.size(); ++i)
+					input_position[i] = output_position[i] * subsampling_sizes[i] + window_position[i];
+				unsigned int pos = input_configuration_specific.get_pos(input_position);
+				if (is_max)
+				{
+					if (in[pos] > max_value)
+					{
+						max_value = in[pos];
+						max_pos = pos;
+					}
+				}
+				else
+				{
+					in_err[pos] = err / static_cast<float>(window_elem_count);
+				}
+			} while (next_position(window_position, subsampling_sizes));
+
+			if (is_max)
+				in_err[max_pos] = err;
+		} while (next_position(output_position, output_sizes));
+	}
+}
+
+void reference_layers::softmax_forward(
+	const nnforge::layer_configuration_specific& configuration_specific,
+	const std::vector<float>& input,
+	std::vector<float>& output,
+	unsigned int entry_count)
+{
+	const unsigned int feature_map_count = configuration_specific.feature_map_count;
+	const unsigned int neuron_count_per_feature_map = configuration_specific.get_neuron_count_per_feature_map();
+
+	output.resize(input.size());
+	for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+	{
+		for(unsigned int neuron_id = 0; neuron_id < neuron_count_per_feature_map; ++neuron_id)
+		{
+			unsigned int offset = entry_id * feature_map_count * neuron_count_per_feature_map + neuron_id;
+			double max_value = -1.0e+37;
+			for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
+				max_value = std::max(max_value, static_cast<double>(input[offset + feature_map_id * neuron_count_per_feature_map]));
+			double sum = 0.0;
+			for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
+				sum += exp(static_cast<double>(input[offset + feature_map_id * neuron_count_per_feature_map]) - max_value);
+			for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
+			{
+				unsigned int pos = offset + feature_map_id * neuron_count_per_feature_map;
+				output[pos] = static_cast<float>(exp(static_cast<double>(input[pos]) - max_value) / sum);
+			}
+		}
+	}
+}
+
+void reference_layers::softmax_backprop(
+	const nnforge::layer_configuration_specific& configuration_specific,
+	const std::vector<float>& output,
+	const std::vector<float>& output_errors,
+	std::vector<float>& input_errors,
+	unsigned int entry_count)
+{
+	const unsigned int feature_map_count = configuration_specific.feature_map_count;
+	const unsigned int neuron_count_per_feature_map = configuration_specific.get_neuron_count_per_feature_map();
+
+	input_errors.resize(output.size());
+	for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+	{
+		for(unsigned int neuron_id = 0; neuron_id < neuron_count_per_feature_map; ++neuron_id)
+		{
+			unsigned int offset = entry_id * feature_map_count * neuron_count_per_feature_map + neuron_id;
+			double sum = 0.0;
+			for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
+			{
+				unsigned int pos = offset + feature_map_id * neuron_count_per_feature_map;
+				sum += static_cast<double>(output_errors[pos]) * static_cast<double>(output[pos]);
+			}
+			for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
+			{
+				unsigned int pos = offset + feature_map_id * neuron_count_per_feature_map;
+				input_errors[pos] = static_cast<float>(static_cast<double>(output[pos]) * (static_cast<double>(output_errors[pos]) - sum));
+			}
+		}
+	}
+}
+
+void reference_layers::local_contrast_subtractive_forward(
+	const nnforge::local_contrast_subtractive_layer& layer,
+	const nnforge::layer_configuration_specific& configuration_specific,
+	const std::vector<float>& input,
+	std::vector<float>& output,
+	unsigned int entry_count)
+{
+	const unsigned int neuron_count_per_feature_map = configuration_specific.get_neuron_count_per_feature_map();
+	const unsigned int dimension_count = static_cast<unsigned int>(layer.window_weights_list.size());
+
+	output = input;
+	std::vector<float> blurred[2];
+	blurred[0].resize(neuron_count_per_feature_map);
+	blurred[1].resize(neuron_count_per_feature_map);
+	for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+	{
+		for(std::vector<unsigned int>::const_iterator it = layer.feature_maps_affected.begin(); it != layer.feature_maps_affected.end(); ++it)
+		{
+			unsigned int offset = (entry_id * configuration_specific.feature_map_count + *it) * neuron_count_per_feature_map;
+			std::copy(input.begin() + offset, input.begin() + offset + neuron_count_per_feature_map, blurred[0].begin());
+			for(unsigned int dimension_id = 0; dimension_id < dimension_count; ++dimension_id)
+			{
+				blur(layer.window_weights_list[dimension_id], dimension_id, configuration_specific.dimension_sizes, &blurred[0][0], &blurred[1][0], false);
+				blurred[0].swap(blurred[1]);
+			}
+			for(unsigned int i = 0; i < neuron_count_per_feature_map; ++i)
+				output[offset + i] -= blurred[0][i];
+		}
+	}
+}
+
+void reference_layers::local_contrast_subtractive_backprop(
+	const nnforge::local_contrast_subtractive_layer& layer,
+	const nnforge::layer_configuration_specific& configuration_specific,
+	const std::vector<float>& output_errors,
+	std::vector<float>& input_errors,
+	unsigned int entry_count)
+{
+	const unsigned int neuron_count_per_feature_map = configuration_specific.get_neuron_count_per_feature_map();
+	const unsigned int dimension_count = static_cast<unsigned int>(layer.window_weights_list.size());
+
+	input_errors = output_errors;
+	std::vector<float> blurred[2];
+	blurred[0].resize(neuron_count_per_feature_map);
+	blurred[1].resize(neuron_count_per_feature_map);
+	for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+	{
+		for(std::vector<unsigned int>::const_iterator it = layer.feature_maps_affected.begin(); it != layer.feature_maps_affected.end(); ++it)
+		{
+			unsigned int offset = (entry_id * configuration_specific.feature_map_count + *it) * neuron_count_per_feature_map;
+			std::copy(output_errors.begin() + offset, output_errors.begin() + offset + neuron_count_per_feature_map, blurred[0].begin());
+			for(int dimension_id = static_cast<int>(dimension_count) - 1; dimension_id >= 0; --dimension_id)
+			{
+				blur(layer.window_weights_list[dimension_id], dimension_id, configuration_specific.dimension_sizes, &blurred[0][0], &blurred[1][0], true);
+				blurred[0].swap(blurred[1]);
+			}
+			for(unsigned int i = 0; i < neuron_count_per_feature_map; ++i)
+				input_errors[offset + i] -= blurred[0][i];
+		}
+	}
+}
+
+float reference_layers::get_difference(
+	const std::vector<float>& actual,
+	const std::vector<float>& expected)
+{
+	if (actual.size() != expected.size())
+		throw nnforge::neural_network_exception("Sizes of the values compared don't match");
+
+	float max_difference = 0.0F;
+	float max_expected = 1.0F;
+	for(unsigned int i = 0; i < expected.size(); ++i)
+	{
+		float difference = fabsf(actual[i] - expected[i]);
+		// NaN is the largest difference possible
+		if (!(difference <= max_difference))
+			max_difference = difference;
+		max_expected = std::max(max_expected, fabsf(expected[i]));
+	}
+
+	return max_difference / max_expected;
+}
+
+std::vector<reference_layers::connection> reference_layers::get_connections(const convolution_geometry& geometry)
+{
+	const std::vector<unsigned int>& input_sizes = geometry.input_configuration_specific.dimension_sizes;
+	const std::vector<unsigned int>& output_sizes = geometry.output_configuration_specific.dimension_sizes;
+	const unsigned int dimension_count = static_cast<unsigned int>(geometry.window_sizes.size());
+	const nnforge::layer_configuration_specific input_positions(1, input_sizes);
+	const nnforge::layer_configuration_specific output_positions(1, output_sizes);
+	const nnforge::layer_configuration_specific window_positions(1, geometry.window_sizes);
+
+	std::vector<connection> res;
+	std::vector<unsigned int> output_position(dimension_count, 0);
+	do
+	{
+		std::vector<unsigned int> window_position(dimension_count, 0);
+		do
+		{
+			std::vector<unsigned int> input_position(dimension_count);
+			bool inside = true;
+			for(unsigned int i = 0; i < dimension_count; ++i)
+			{
+				unsigned int stride = geometry.strides.empty() ? 1 : geometry.strides[i];
+				int pos = static_cast<int>(output_position[i] * stride + window_position[i]) - static_cast<int>(geometry.left_zero_padding[i]);
+				if ((pos < 0) || (pos >= static_cast<int>(input_sizes[i])))
+					inside = false;
+				input_position[i] = static_cast<unsigned int>(pos);
+			}
+			if (inside)
+			{
+				connection c;
+				c.output_offset = output_positions.get_pos(output_position);
+				c.input_offset = input_positions.get_pos(input_position);
+				c.window_offset = window_positions.get_pos(window_position);
+				res.push_back(c);
+			}
+		} while (next_position(window_position, geometry.window_sizes));
+	} while (next_position(output_position, output_sizes));
+
+	return res;
+}
+
+bool reference_layers::next_position(
+	std::vector<unsigned int>& position,
+	const std::vector<unsigned int>& sizes)
+{
+	for(unsigned int i = 0; i < position.size(); ++i)
+	{
+		if ((++position[i]) < sizes[i])
+			return true;
+		position[i] = 0;
+	}
+
+	return false;
+}
+
+void reference_layers::blur(
+	const std::vector<float>& window_weights,
+	unsigned int dimension_id,
+	const std::vector<unsigned int>& dimension_sizes,
+	const float * input,
+	float * output,
+	bool transpose)
+{
+	const nnforge::layer_configuration_specific positions(1, dimension_sizes);
+	const int size = static_cast<int>(dimension_sizes[dimension_id]);
+	const unsigned int neuron_count = positions.get_neuron_count();
+
+	if (transpose)
+		std::fill(output, output + neuron_count, 0.0F);
+
+	std::vector<unsigned int> position(dimension_sizes.size(), 0);
+	do
+	{
+		const unsigned int pos = positions.get_pos(position);
+		const int center = static_cast<int>(position[dimension_id]);
+		std::vector<unsigned int> source_position = position;
+		double sum = static_cast<double>(input[pos]) * static_cast<double>(window_weights[0]);
+		if (transpose)
+			output[pos] += static_cast<float>(sum);
+		for(int offset = 1; offset < static_cast<int>(window_weights.size()); ++offset)
+		{
+			for(int direction = -1; direction <= 1; direction += 2)
+			{
+				// Borders are mirrored: position -1 is 0, position size is size - 1
+				int source = center + direction * offset;
+				if (source < 0)
+					source = -1 - source;
+				else if (source >= size)
+					source = 2 * size - 1 - source;
+				source_position[dimension_id] = static_cast<unsigned int>(source);
+				const unsigned int source_pos = positions.get_pos(source_position);
+				if (transpose)
+					output[source_pos] += input[pos] * window_weights[offset];
+				else
+					sum += static_cast<double>(input[source_pos]) * static_cast<double>(window_weights[offset]);
+			}
+		}
+		if (!transpose)
+			output[pos] = static_cast<float>(sum);
+	} while (next_position(position, dimension_sizes));
+}
@@ -0,0 +1,195 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <nnforge/layer_configuration_specific.h>
+#include <nnforge/layer_data_custom.h>
+#include <nnforge/local_contrast_subtractive_layer.h>
+
+#include <vector>
+
+// Straightforward implementations of the layers, the plain engines are checked against them.
+// Buffers hold entries one after another, each entry holds feature maps one after another with x being the fastest dimension
+class reference_layers
+{
+public:
+	struct convolution_geometry
+	{
+		std::vector<unsigned int> window_sizes;
+		std::vector<unsigned int> left_zero_padding;
+		std::vector<unsigned int> strides;
+		nnforge::layer_configuration_specific input_configuration_specific;
+		nnforge::layer_configuration_specific output_configuration_specific;
+	};
+
+	enum activation_type
+	{
+		activation_hyperbolic_tangent,
+		activation_sigmoid,
+		activation_rectified_linear,
+		activation_absolute
+	};
+
+	// Weights are laid out as [output feature map][input feature map][window]
+	static void convolution_forward(
+		const convolution_geometry& geometry,
+		const std::vector<float>& weights,
+		const std::vector<float>& biases,
+		const std::vector<float>& input,
+		std::vector<float>& output,
+		unsigned int entry_count);
+
+	static void convolution_backprop(
+		const convolution_geometry& geometry,
+		const std::vector<float>& weights,
+		const std::vector<float>& output_errors,
+		std::vector<float>& input_errors,
+		unsigned int entry_count);
+
+	// Gradients are summed over the entries
+	static void convolution_gradient(
+		const convolution_geometry& geometry,
+		const std::vector<float>& input,
+		const std::vector<float>& output_errors,
+		std::vector<float>& weights_gradient,
+		std::vector<float>& biases_gradient,
+		unsigned int entry_count);
+
+	// Dense weights of grouped_convolution_layer, zero for the input feature maps of other groups
+	static std::vector<float> grouped_to_dense(
+		const std::vector<float>& grouped_weights,
+		unsigned int input_feature_map_count,
+		unsigned int output_feature_map_count,
+		unsigned int group_count,
+		unsigned int window_elem_count);
+
+	static std::vector<float> dense_to_grouped(
+		const std::vector<float>& dense_weights,
+		unsigned int input_feature_map_count,
+		unsigned int output_feature_map_count,
+		unsigned int group_count,
+		unsigned int window_elem_count);
+
+	// Dense weights of sparse_convolution_layer, zero for the feature maps not connected
+	static std::vector<float> sparse_to_dense(
+		const std::vector<float>& sparse_weights,
+		const nnforge::layer_data_custom& data_custom,
+		unsigned int input_feature_map_count,
+		unsigned int output_feature_map_count,
+		unsigned int window_elem_count);
+
+	static std::vector<float> dense_to_sparse(
+		const std::vector<float>& dense_weights,
+		const nnforge::layer_data_custom& data_custom,
+		unsigned int input_feature_map_count,
+		unsigned int output_feature_map_count,
+		unsigned int window_elem_count);
+
+	static void activation_forward(
+		activation_type type,
+		const std::vector<float>& input,
+		std::vector<float>& output);
+
+	static void activation_backprop(
+		activation_type type,
+		const std::vector<float>& input,
+		const std::vector<float>& output,
+		const std::vector<float>& output_errors,
+		std::vector<float>& input_errors);
+
+	// Max subsampling when is_max is true, average subsampling otherwise
+	static void subsampling_forward(
+		bool is_max,
+		const std::vector<unsigned int>& subsampling_sizes,
+		const nnforge::layer_configuration_specific& input_configuration_specific,
+		const std::vector<float>& input,
+		std::vector<float>& output,
+		unsigned int entry_count);
+
+	static void subsampling_backprop(
+		bool is_max,
+		const std::vector<unsigned int>& subsampling_sizes,
+		const nnforge::layer_configuration_specific& input_configuration_specific,
+		const std::vector<float>& input,
+		const std::vector<float>& output_errors,
+		std::vector<float>& input_errors,
+		unsigned int entry_count);
+
+	// Softmax over feature maps at each position
+	static void softmax_forward(
+		const nnforge::layer_configuration_specific& configuration_specific,
+		const std::vector<float>& input,
+		std::vector<float>& output,
+		unsigned int entry_count);
+
+	static void softmax_backprop(
+		const nnforge::layer_configuration_specific& configuration_specific,
+		const std::vector<float>& output,
+		const std::vector<float>& output_errors,
+		std::vector<float>& input_errors,
+		unsigned int entry_count);
+
+	// Affected feature maps get their Gaussian blur with mirrored borders subtracted, one dimension after another
+	static void local_contrast_subtractive_forward(
+		const nnforge::local_contrast_subtractive_layer& layer,
+		const nnforge::layer_configuration_specific& configuration_specific,
+		const std::vector<float>& input,
+		std::vector<float>& output,
+		unsigned int entry_count);
+
+	// The layer is linear, input errors are output errors multiplied by the transposed forward
+	static void local_contrast_subtractive_backprop(
+		const nnforge::local_contrast_subtractive_layer& layer,
+		const nnforge::layer_configuration_specific& configuration_specific,
+		const std::vector<float>& output_errors,
+		std::vector<float>& input_errors,
+		unsigned int entry_count);
+
+	// The largest absolute difference, divided by the largest absolute expected value when it exceeds 1
+	static float get_difference(
+		const std::vector<float>& actual,
+		const std::vector<float>& expected);
+
+private:
+	// Input and output neuron offsets within feature map and the window offset for each pair of neurons connected
+	struct connection
+	{
+		unsigned int output_offset;
+		unsigned int input_offset;
+		unsigned int window_offset;
+	};
+
+	static std::vector<connection> get_connections(const convolution_geometry& geometry);
+
+	// Moves position to the next one within sizes, x first; returns false after the last one
+	static bool next_position(
+		std::vector<unsigned int>& position,
+		const std::vector<unsigned int>& sizes);
+
+	// Applies the separable blur to a single feature map along dimension_id, or its transpose
+	static void blur(
+		const std::vector<float>& window_weights,
+		unsigned int dimension_id,
+		const std::vector<unsigned int>& dimension_sizes,
+		const float * input,
+		float * output,
+		bool transpose);
+
+	reference_layers();
+	~reference_layers();
+};
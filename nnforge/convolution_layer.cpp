@@ -26,8 +26,16 @@
 
 namespace nnforge
 {
-	// {5957B44F-699E-4DDB-836E-3FB3EEB54965}
+	// {6DF200FD-0DEE-47C3-AF95-27B678AC2CFD}
 	const boost::uuids::uuid convolution_layer::layer_guid =
+		{ 0x6d, 0xf2, 0x00, 0xfd
+		, 0x0d, 0xee
+		, 0x47, 0xc3
+		, 0xaf, 0x95
+		, 0x27, 0xb6, 0x78, 0xac, 0x2c, 0xfd };
+
+	// {5957B44F-699E-4DDB-836E-3FB3EEB54965}
+	const boost::uuids::uuid convolution_layer::layer_guid_v2 =
 		{ 0x59, 0x57, 0xb4, 0x4f
 		, 0x69, 0x9e
 		, 0x4d, 0xdb
@@ -47,7 +55,8 @@ namespace nnforge
 		unsigned int input_feature_map_count,
 		unsigned int output_feature_map_count,
 		const std::vector<unsigned int>& left_zero_padding,
-		const std::vector<unsigned int>& right_zero_padding)
+		const std::vector<unsigned int>& right_zero_padding,
+		const std::vector<unsigned int>& strides)
 		: window_sizes(window_sizes),
 		input_feature_map_count(input_feature_map_count),
 		output_feature_map_count(output_feature_map_count)
@@ -84,6 +93,19 @@ namespace nnforge
 					throw neural_network_exception((boost::format("right zero padding %1% of dimension (%2%) is greater or equal than layer window size (%3%)") % right_zero_padding[i] % i % window_sizes[i]).str());
 			this->right_zero_padding = right_zero_padding;
 		}
+
+		if ((strides.size() != 0) && (strides.size() != window_sizes.size()))
+			throw std::runtime_error((boost::format("Invalid dimension count %1% for strides") % strides.size()).str());
+
+		if (strides.empty())
+			this->strides.resize(window_sizes.size(), 1);
+		else
+		{
+			for(unsigned int i = 0; i < window_sizes.size(); i++)
+				if (strides[i] == 0)
+					throw neural_network_exception((boost::format("stride of dimension (%1%) for convolution layer may not be zero") % i).str());
+			this->strides = strides;
+		}
 	}
 
 	const boost::uuids::uuid& convolution_layer::get_uuid() const
@@ -123,7 +145,7 @@ namespace nnforge
 			if (total_input_dimension_size < window_sizes[i])
 				throw neural_network_exception((boost::format("Too small total dimension size (with padding) %1% of dimension (%2%) is smaller than layer window size (%3%)") % total_input_dimension_size % i % window_sizes[i]).str());
 
-			res.dimension_sizes.push_back(total_input_dimension_size + 1 - window_sizes[i]);
+			res.dimension_sizes.push_back((total_input_dimension_size - window_sizes[i]) / strides[i] + 1);
 		}
 
 		return res;
@@ -139,8 +161,8 @@ namespace nnforge
 		for(unsigned int i = 0; i < window_sizes.size(); ++i)
 			res.push_back(
 				std::make_pair(
-					static_cast<unsigned int>(std::max(0, static_cast<int>(output_rectangle_borders[i].first) - static_cast<int>(left_zero_padding[i]))),
-					(output_rectangle_borders[i].second + window_sizes[i] - 1) - left_zero_padding[i]
+					static_cast<unsigned int>(std::max(0, static_cast<int>(output_rectangle_borders[i].first * strides[i]) - static_cast<int>(left_zero_padding[i]))),
+					(output_rectangle_borders[i].second * strides[i] + window_sizes[i] - 1) - left_zero_padding[i]
 				)
 			);
 
@@ -157,6 +179,7 @@ namespace nnforge
 		binary_stream_to_write_to.write(reinterpret_cast<const char*>(&(*window_sizes.begin())), sizeof(unsigned int) * dimension_count);
 		binary_stream_to_write_to.write(reinterpret_cast<const char*>(&(*left_zero_padding.begin())), sizeof(unsigned int) * dimension_count);
 		binary_stream_to_write_to.write(reinterpret_cast<const char*>(&(*right_zero_padding.begin())), sizeof(unsigned int) * dimension_count);
+		binary_stream_to_write_to.write(reinterpret_cast<const char*>(&(*strides.begin())), sizeof(unsigned int) * dimension_count);
 	}
 
 	void convolution_layer::read(
@@ -178,6 +201,10 @@ namespace nnforge
 			binary_stream_to_read_from.read(reinterpret_cast<char*>(&(*left_zero_padding.begin())), sizeof(unsigned int) * dimension_count);
 			binary_stream_to_read_from.read(reinterpret_cast<char*>(&(*right_zero_padding.begin())), sizeof(unsigned int) * dimension_count);
 		}
+
+		strides.assign(dimension_count, 1);
+		if ((layer_read_guid != layer_guid_v1) && (layer_read_guid != layer_guid_v2))
+			binary_stream_to_read_from.read(reinterpret_cast<char*>(&(*strides.begin())), sizeof(unsigned int) * dimension_count);
 	}
 
 	data_config convolution_layer::get_data_config() const
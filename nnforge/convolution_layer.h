@@ -30,7 +30,8 @@ namespace nnforge
 			unsigned int input_feature_map_count,
 			unsigned int output_feature_map_count,
 			const std::vector<unsigned int>& left_zero_padding = std::vector<unsigned int>(),
-			const std::vector<unsigned int>& right_zero_padding = std::vector<unsigned int>());
+			const std::vector<unsigned int>& right_zero_padding = std::vector<unsigned int>(),
+			const std::vector<unsigned int>& strides = std::vector<unsigned int>());
 
 		virtual layer_smart_ptr clone() const;
 
@@ -65,6 +66,8 @@ namespace nnforge
 
 		static const boost::uuids::uuid layer_guid;
 
+		static const boost::uuids::uuid layer_guid_v2;
+
 		static const boost::uuids::uuid layer_guid_v1;
 
 	protected:
@@ -76,5 +79,6 @@ namespace nnforge
 		unsigned int output_feature_map_count;
 		std::vector<unsigned int> left_zero_padding;
 		std::vector<unsigned int> right_zero_padding;
+		std::vector<unsigned int> strides;
 	};
 }
@@ -57,6 +57,11 @@ namespace nnforge
 			bool zero_padding = (layer_derived->left_zero_padding == std::vector<unsigned int>(layer_derived->left_zero_padding.size(), 0))
 				&& (layer_derived->right_zero_padding == std::vector<unsigned int>(layer_derived->right_zero_padding.size(), 0));
 
+			bool unit_strides = (layer_derived->strides == std::vector<unsigned int>(layer_derived->strides.size(), 1));
+			// Strides don't matter when the window covers the whole input
+			if (!unit_strides && !(zero_padding && (layer_derived->window_sizes == input_configuration_specific.dimension_sizes)))
+				throw neural_network_exception("Strided sparse convolution is not supported by CUDA backend");
+
 			if (zero_padding && (output_configuration_specific.get_neuron_count() == output_configuration_specific.feature_map_count))
 			{
 				if (input_configuration_specific.dimension_sizes == output_configuration_specific.dimension_sizes)
@@ -74,15 +74,7 @@ namespace nnforge
 				cuda_config->set_device();
 				unsigned int input_neuron_count = reader->get_input_configuration().get_neuron_count();
 				size_t input_neuron_elem_size = reader->get_input_neuron_elem_size();
-				while(entries_read_count < entries_to_read_count)
-				{
-					bool entry_read = reader->read(input + (input_neuron_count * entries_read_count * input_neuron_elem_size));
-
-					if (!entry_read)
-						break;
-
-					entries_read_count++;
-				}
+				entries_read_count = reader->read_batch(entries_to_read_count, input);
 				POP_RANGE;
 
 				cuda_safe_call(cudaMemcpyAsync(
@@ -167,4 +167,19 @@ namespace nnforge
 	{
 		return flops;
 	}
+
+	void network_tester::calibrate(
+		supervised_data_reader& reader,
+		unsigned int max_entry_count)
+	{
+		set_input_configuration_specific(reader.get_input_configuration());
+
+		actual_calibrate(reader, max_entry_count);
+	}
+
+	void network_tester::actual_calibrate(
+		unsupervised_data_reader& reader,
+		unsigned int max_entry_count)
+	{
+	}
 }
@@ -78,6 +78,12 @@ namespace nnforge
 		// set_input_configuration_specific should be called prior to this method call for this method to succeed
 		float get_flops_for_single_entry() const;
 
+		// Collects the ranges of the layer inputs over up to max_entry_count entries of the reader, call it after set_data
+		// Backends with reduced precision inference use them to quantize the network, others ignore the call
+		void calibrate(
+			supervised_data_reader& reader,
+			unsigned int max_entry_count);
+
 	protected:
 		network_tester(network_schema_smart_ptr schema);
 
@@ -105,6 +111,11 @@ namespace nnforge
 		// The layer_config_list is guaranteed to be compatible with schema
 		virtual void layer_config_list_modified() = 0;
 
+		// The method is called when client calls calibrate. The default implementation does nothing
+		virtual void actual_calibrate(
+			unsupervised_data_reader& reader,
+			unsigned int max_entry_count);
+
 		void update_flops();
 
 	protected:
@@ -219,6 +219,7 @@ namespace nnforge
 			("test_validate_ann_index", boost::program_options::value<int>(&test_validate_ann_index)->default_value(-1), "Index of ANN to test/validate. -1 indicates all ANNs, batch mode.")
 			("test_validate_save_output", boost::program_options::value<bool>(&test_validate_save_output)->default_value(false), "Dump output neurons when doing validating/testing.")
 			("test_validate_load_output", boost::program_options::value<bool>(&test_validate_load_output)->default_value(false), "Load output neurons when doing validating/testing.")
+			("test_validate_calibration_entry_count", boost::program_options::value<unsigned int>(&test_validate_calibration_entry_count)->default_value(0), "Calibrate ANN on this amount of training entries before validating/testing, backends supporting it run the calibrated ANN with reduced precision. 0 indicates no calibration.")
 			("snapshot_data_set", boost::program_options::value<std::string>(&snapshot_data_set)->default_value("training"), "Type of the dataset to use for snapshots (training, validating, testing).")
 			("profile_updater_entry_count", boost::program_options::value<unsigned int>(&profile_updater_entry_count)->default_value(1), "The number of entries to process when profiling updater.")
 			("check_gradient_weights", boost::program_options::value<std::string>(&check_gradient_weights)->default_value("::"), "The set of weights to check for gradient, in the form Layer:WeightSet:WeightID.")
@@ -386,6 +387,7 @@ namespace nnforge
 			std::cout << "learning_rate_rise_rate" << "=" << learning_rate_rise_rate << std::endl;
 			std::cout << "batch_offset" << "=" << batch_offset << std::endl;
 			std::cout << "test_validate_ann_index" << "=" << test_validate_ann_index << std::endl;
+			std::cout << "test_validate_calibration_entry_count" << "=" << test_validate_calibration_entry_count << std::endl;
 			std::cout << "snapshot_data_set" << "=" << snapshot_data_set << std::endl;
 			std::cout << "profile_updater_entry_count" << "=" << profile_updater_entry_count << std::endl;
 			std::cout << "check_gradient_weights" << "=" << check_gradient_weights << std::endl;
@@ -644,6 +646,8 @@ namespace nnforge
 				}
 
 				tester->set_data(data);
+				if (test_validate_calibration_entry_count > 0)
+					tester->calibrate(*get_data_reader_for_training(true, false), test_validate_calibration_entry_count);
 
 				testing_complete_result_set testing_res(get_error_function(), actual_neuron_value_set);
 				tester->test(
@@ -691,6 +695,8 @@ namespace nnforge
 				}
 
 				tester->set_data(data);
+				if (test_validate_calibration_entry_count > 0)
+					tester->calibrate(*get_data_reader_for_training(true, false), test_validate_calibration_entry_count);
 
 				boost::chrono::steady_clock::time_point start = boost::chrono::high_resolution_clock::now();
 				output_neuron_value_set_smart_ptr new_res = tester->run(reader, sample_count);
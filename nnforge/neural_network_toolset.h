@@ -186,6 +186,7 @@ namespace nnforge
 		int test_validate_ann_index;
 		bool test_validate_save_output;
 		bool test_validate_load_output;
+		unsigned int test_validate_calibration_entry_count;
 		unsigned int snapshot_ann_index;
 		std::string snapshot_ann_type;
 		std::string snapshot_data_set;
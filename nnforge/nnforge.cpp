@@ -7,9 +7,12 @@ namespace nnforge
 	void nnforge::init()
 	{
 		single_layer_factory::get_mutable_instance().register_layer(layer_smart_ptr(new convolution_layer(std::vector<unsigned int>(1, 1), 1, 1)));
+		single_layer_factory::get_mutable_instance().register_layer(convolution_layer::layer_guid_v2, layer_smart_ptr(new convolution_layer(std::vector<unsigned int>(1, 1), 1, 1)));
 		single_layer_factory::get_mutable_instance().register_layer(convolution_layer::layer_guid_v1, layer_smart_ptr(new convolution_layer(std::vector<unsigned int>(1, 1), 1, 1)));
 		single_layer_factory::get_mutable_instance().register_layer(layer_smart_ptr(new sparse_convolution_layer(std::vector<unsigned int>(1, 1), 1, 1, 1U)));
+		single_layer_factory::get_mutable_instance().register_layer(sparse_convolution_layer::layer_guid_v2, layer_smart_ptr(new sparse_convolution_layer(std::vector<unsigned int>(1, 1), 1, 1, 1U)));
 		single_layer_factory::get_mutable_instance().register_layer(sparse_convolution_layer::layer_guid_v1, layer_smart_ptr(new sparse_convolution_layer(std::vector<unsigned int>(1, 1), 1, 1, 1U)));
+		single_layer_factory::get_mutable_instance().register_layer(layer_smart_ptr(new grouped_convolution_layer(std::vector<unsigned int>(1, 1), 1, 1, 1)));
 		single_layer_factory::get_mutable_instance().register_layer(layer_smart_ptr(new hyperbolic_tangent_layer()));
 		single_layer_factory::get_mutable_instance().register_layer(layer_smart_ptr(new average_subsampling_layer(std::vector<unsigned int>(1, 1))));
 		single_layer_factory::get_mutable_instance().register_layer(layer_smart_ptr(new max_subsampling_layer(std::vector<unsigned int>(1, 1))));
@@ -20,6 +20,7 @@
 
 #include "convolution_layer.h"
 #include "sparse_convolution_layer.h"
+#include "grouped_convolution_layer.h"
 #include "hyperbolic_tangent_layer.h"
 #include "average_subsampling_layer.h"
 #include "max_subsampling_layer.h"
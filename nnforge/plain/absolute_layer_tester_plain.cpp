@@ -16,8 +16,12 @@
 
 #include "absolute_layer_tester_plain.h"
 
+#include "activation_plain.h"
+#include "blocked_layout_plain.h"
 #include "../absolute_layer.h"
 
+#include <algorithm>
+
 namespace nnforge
 {
 	namespace plain
@@ -46,12 +50,49 @@ namespace nnforge
 			const layer_configuration_specific& output_configuration_specific,
 			unsigned int entry_count) const
 		{
-			const int elem_count = static_cast<int>(entry_count * input_configuration_specific.get_neuron_count());
-			const std::vector<float>::iterator in_it = input_buffer->begin();
+			const unsigned int elem_count = entry_count * input_configuration_specific.get_neuron_count();
+			float * const in_it = &(*input_buffer->begin());
+			const int chunk_count = static_cast<int>((elem_count + activation_plain::chunk_size - 1) / activation_plain::chunk_size);
+
+			#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+			for(int chunk_id = 0; chunk_id < chunk_count; ++chunk_id)
+			{
+				unsigned int chunk_start = chunk_id * activation_plain::chunk_size;
+				unsigned int chunk_elem_count = std::min(activation_plain::chunk_size, elem_count - chunk_start);
+				activation_plain::absolute(in_it + chunk_start, in_it + chunk_start, chunk_elem_count);
+			}
+		}
+
+		layer_tester_plain::blocked_layout_support absolute_layer_tester_plain::get_blocked_layout_support(
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			return blocked_layout_transparent;
+		}
+
+		void absolute_layer_tester_plain::test_blocked(
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_smart_ptr output_buffer,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int entry_count) const
+		{
+			const unsigned int elem_count = entry_count * blocked_layout_plain::get_neuron_count(input_configuration_specific);
+			const float * const in_it = &(*input_buffer->begin());
+			float * const out_it = &(*output_buffer->begin());
+			const int chunk_count = static_cast<int>((elem_count + activation_plain::chunk_size - 1) / activation_plain::chunk_size);
 
-			#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
-			for(int i = 0; i < elem_count; ++i)
-				*(in_it + i) = fabs(*(in_it + i));
+			#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+			for(int chunk_id = 0; chunk_id < chunk_count; ++chunk_id)
+			{
+				unsigned int chunk_start = chunk_id * activation_plain::chunk_size;
+				unsigned int chunk_elem_count = std::min(activation_plain::chunk_size, elem_count - chunk_start);
+				activation_plain::absolute(in_it + chunk_start, out_it + chunk_start, chunk_elem_count);
+			}
 		}
 	}
 }
@@ -41,6 +41,21 @@ namespace nnforge
 				const layer_configuration_specific& input_configuration_specific,
 				const layer_configuration_specific& output_configuration_specific,
 				unsigned int entry_count) const;
+
+			virtual blocked_layout_support get_blocked_layout_support(
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
+			virtual void test_blocked(
+				additional_buffer_smart_ptr input_buffer,
+				additional_buffer_smart_ptr output_buffer,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_layer_data_smart_ptr data,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int entry_count) const;
 		};
 	}
 }
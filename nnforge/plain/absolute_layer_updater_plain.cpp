@@ -16,9 +16,12 @@
 
 #include "absolute_layer_updater_plain.h"
 
+#include "activation_plain.h"
 #include "../absolute_layer.h"
 #include "../neural_network_exception.h"
 
+#include <algorithm>
+
 namespace nnforge
 {
 	namespace plain
@@ -53,13 +56,18 @@ namespace nnforge
 			if (offset_input_entry_id > 0)
 				throw neural_network_exception("absolute_layer_updater_plain is not able to run using offset");
 
-			const int elem_count = static_cast<int>(updater_count * input_configuration_specific.get_neuron_count());
-			const std::vector<float>::const_iterator in_it = input_buffer->begin();
-			const std::vector<float>::iterator out_it = output_buffer->begin();
+			const unsigned int elem_count = updater_count * input_configuration_specific.get_neuron_count();
+			const float * const in_it = &(*input_buffer->begin());
+			float * const out_it = &(*output_buffer->begin());
+			const int chunk_count = static_cast<int>((elem_count + activation_plain::chunk_size - 1) / activation_plain::chunk_size);
 
-			#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
-			for(int i = 0; i < elem_count; ++i)
-				*(out_it + i) = fabs(*(in_it + i));
+			#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+			for(int chunk_id = 0; chunk_id < chunk_count; ++chunk_id)
+			{
+				unsigned int chunk_start = chunk_id * activation_plain::chunk_size;
+				unsigned int chunk_elem_count = std::min(activation_plain::chunk_size, elem_count - chunk_start);
+				activation_plain::absolute(in_it + chunk_start, out_it + chunk_start, chunk_elem_count);
+			}
 		}
 
 		void absolute_layer_updater_plain::backprop(
@@ -77,18 +85,17 @@ namespace nnforge
 			unsigned int updater_count,
 			bool force_deterministic) const
 		{
-			const int elem_count = static_cast<int>(updater_count * input_configuration_specific.get_neuron_count());
-			const std::vector<float>::const_iterator in_it = input_neurons->begin();
-			const std::vector<float>::iterator in_err_it = input_errors->begin();
+			const unsigned int elem_count = updater_count * input_configuration_specific.get_neuron_count();
+			float * const in_err_it = &(*input_errors->begin());
+			const float * const in_it = &(*input_neurons->begin());
+			const int chunk_count = static_cast<int>((elem_count + activation_plain::chunk_size - 1) / activation_plain::chunk_size);
 
-			#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
-			for(int i = 0; i < elem_count; ++i)
+			#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+			for(int chunk_id = 0; chunk_id < chunk_count; ++chunk_id)
 			{
-				float val = *(in_it + i);
-				if (val < 0.0F)
-				{
-					*(in_err_it + i) = - *(in_err_it + i);
-				}
+				unsigned int chunk_start = chunk_id * activation_plain::chunk_size;
+				unsigned int chunk_elem_count = std::min(activation_plain::chunk_size, elem_count - chunk_start);
+				activation_plain::absolute_backprop(in_err_it + chunk_start, in_it + chunk_start, chunk_elem_count);
 			}
 		}
 
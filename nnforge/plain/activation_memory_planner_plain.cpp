@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "activation_memory_planner_plain.h"
+
+#include "../neural_network_exception.h"
+
+#include <algorithm>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		activation_memory_planner_plain::activation_memory_planner_plain()
+		{
+		}
+
+		activation_memory_planner_plain::~activation_memory_planner_plain()
+		{
+		}
+
+		unsigned int activation_memory_planner_plain::add_buffer(
+			unsigned int elem_count_per_entry,
+			unsigned int first_step)
+		{
+			if (!buffer_list.empty() && (buffer_list.back().first_step > first_step))
+				throw neural_network_exception("Buffers should be added to activation_memory_planner_plain in the order of their first steps");
+
+			buffer_lifetime new_buffer;
+			new_buffer.elem_count_per_entry = elem_count_per_entry;
+			new_buffer.first_step = first_step;
+			new_buffer.last_step = first_step;
+			buffer_list.push_back(new_buffer);
+
+			return static_cast<unsigned int>(buffer_list.size() - 1);
+		}
+
+		void activation_memory_planner_plain::use_buffer(
+			unsigned int buffer_id,
+			unsigned int step)
+		{
+			buffer_list[buffer_id].last_step = std::max(buffer_list[buffer_id].last_step, step);
+		}
+
+		void activation_memory_planner_plain::plan()
+		{
+			slab_id_list.clear();
+			slab_elem_count_per_entry_list.clear();
+
+			// The last step of the buffer assigned to each slab most recently
+			std::vector<unsigned int> slab_last_step_list;
+			for(std::vector<buffer_lifetime>::const_iterator it = buffer_list.begin(); it != buffer_list.end(); ++it)
+			{
+				// Best fit among the slabs free at the first step of the buffer: the smallest one large enough,
+				// otherwise the largest one, which grows to fit the buffer
+				int best_slab_id = -1;
+				for(unsigned int slab_id = 0; slab_id < slab_last_step_list.size(); ++slab_id)
+				{
+					if (slab_last_step_list[slab_id] >= it->first_step)
+						continue;
+
+					if (best_slab_id < 0)
+					{
+						best_slab_id = slab_id;
+						continue;
+					}
+
+					const unsigned int slab_elem_count = slab_elem_count_per_entry_list[slab_id];
+					const unsigned int best_slab_elem_count = slab_elem_count_per_entry_list[best_slab_id];
+					const bool fits = (slab_elem_count >= it->elem_count_per_entry);
+					const bool best_fits = (best_slab_elem_count >= it->elem_count_per_entry);
+					if ((fits && (!best_fits || (slab_elem_count < best_slab_elem_count))) || (!fits && !best_fits && (slab_elem_count > best_slab_elem_count)))
+						best_slab_id = slab_id;
+				}
+
+				if (best_slab_id < 0)
+				{
+					best_slab_id = static_cast<int>(slab_last_step_list.size());
+					slab_last_step_list.push_back(0);
+					slab_elem_count_per_entry_list.push_back(0);
+				}
+
+				slab_id_list.push_back(best_slab_id);
+				slab_last_step_list[best_slab_id] = it->last_step;
+				slab_elem_count_per_entry_list[best_slab_id] = std::max(slab_elem_count_per_entry_list[best_slab_id], it->elem_count_per_entry);
+			}
+		}
+
+		unsigned int activation_memory_planner_plain::get_slab_id(unsigned int buffer_id) const
+		{
+			return slab_id_list[buffer_id];
+		}
+
+		const std::vector<unsigned int>& activation_memory_planner_plain::get_slab_elem_count_per_entry_list() const
+		{
+			return slab_elem_count_per_entry_list;
+		}
+
+		unsigned int activation_memory_planner_plain::get_elem_count_per_entry() const
+		{
+			unsigned int res = 0;
+			for(std::vector<unsigned int>::const_iterator it = slab_elem_count_per_entry_list.begin(); it != slab_elem_count_per_entry_list.end(); ++it)
+				res += *it;
+
+			return res;
+		}
+	}
+}
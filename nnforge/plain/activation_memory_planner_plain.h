@@ -0,0 +1,68 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Assigns the activation buffers of a network to slabs, buffers which are never live at the same time share a slab.
+		// Lifetimes are expressed in steps: a buffer is live from the step it is written at till the last step it is used at, inclusive.
+		// For a linear schema the slabs end up ping-ponged between the layers writing their output to a separate buffer
+		class activation_memory_planner_plain
+		{
+		public:
+			activation_memory_planner_plain();
+
+			~activation_memory_planner_plain();
+
+			// Buffers should be added in the order of their first steps, returns the id of the buffer
+			unsigned int add_buffer(
+				unsigned int elem_count_per_entry,
+				unsigned int first_step);
+
+			// Extends the lifetime of the buffer up to the step specified
+			void use_buffer(
+				unsigned int buffer_id,
+				unsigned int step);
+
+			// Should be called after all the buffers are added and used
+			void plan();
+
+			unsigned int get_slab_id(unsigned int buffer_id) const;
+
+			const std::vector<unsigned int>& get_slab_elem_count_per_entry_list() const;
+
+			// The sum of all the slabs, which is the per entry memory the activations take
+			unsigned int get_elem_count_per_entry() const;
+
+		private:
+			struct buffer_lifetime
+			{
+				unsigned int elem_count_per_entry;
+				unsigned int first_step;
+				unsigned int last_step;
+			};
+
+			std::vector<buffer_lifetime> buffer_list;
+			std::vector<unsigned int> slab_id_list;
+			std::vector<unsigned int> slab_elem_count_per_entry_list;
+		};
+	}
+}
@@ -0,0 +1,274 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "activation_plain.h"
+
+#include "instruction_set_plain.h"
+
+#include <algorithm>
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define NNFORGE_PLAIN_TARGET_PRAGMAS
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		namespace activation_sse2
+		{
+			#include "activation_plain_kernels.h"
+		}
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+		namespace activation_avx2
+		{
+			#include "activation_plain_kernels.h"
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+#endif
+		namespace activation_avx512
+		{
+			#include "activation_plain_kernels.h"
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+
+		const unsigned int activation_plain::chunk_size;
+
+		void activation_plain::sigmoid(
+			const float * input,
+			float * output,
+			unsigned int elem_count)
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				activation_avx512::sigmoid(input, output, elem_count);
+				break;
+			case instruction_set_plain::instruction_set_avx2:
+				activation_avx2::sigmoid(input, output, elem_count);
+				break;
+			default:
+				activation_sse2::sigmoid(input, output, elem_count);
+				break;
+			}
+		}
+
+		void activation_plain::sigmoid_backprop(
+			float * errors,
+			const float * output_neurons,
+			unsigned int elem_count)
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				activation_avx512::sigmoid_backprop(errors, output_neurons, elem_count);
+				break;
+			case instruction_set_plain::instruction_set_avx2:
+				activation_avx2::sigmoid_backprop(errors, output_neurons, elem_count);
+				break;
+			default:
+				activation_sse2::sigmoid_backprop(errors, output_neurons, elem_count);
+				break;
+			}
+		}
+
+		void activation_plain::hyperbolic_tangent(
+			const float * input,
+			float * output,
+			unsigned int elem_count,
+			float steepness,
+			float major_multiplier)
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				activation_avx512::hyperbolic_tangent(input, output, elem_count, steepness, major_multiplier);
+				break;
+			case instruction_set_plain::instruction_set_avx2:
+				activation_avx2::hyperbolic_tangent(input, output, elem_count, steepness, major_multiplier);
+				break;
+			default:
+				activation_sse2::hyperbolic_tangent(input, output, elem_count, steepness, major_multiplier);
+				break;
+			}
+		}
+
+		void activation_plain::hyperbolic_tangent_backprop(
+			float * errors,
+			const float * output_neurons,
+			unsigned int elem_count,
+			float steepness,
+			float major_multiplier)
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				activation_avx512::hyperbolic_tangent_backprop(errors, output_neurons, elem_count, steepness, major_multiplier);
+				break;
+			case instruction_set_plain::instruction_set_avx2:
+				activation_avx2::hyperbolic_tangent_backprop(errors, output_neurons, elem_count, steepness, major_multiplier);
+				break;
+			default:
+				activation_sse2::hyperbolic_tangent_backprop(errors, output_neurons, elem_count, steepness, major_multiplier);
+				break;
+			}
+		}
+
+		void activation_plain::rectified_linear(
+			const float * input,
+			float * output,
+			unsigned int elem_count)
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				activation_avx512::rectified_linear(input, output, elem_count);
+				break;
+			case instruction_set_plain::instruction_set_avx2:
+				activation_avx2::rectified_linear(input, output, elem_count);
+				break;
+			default:
+				activation_sse2::rectified_linear(input, output, elem_count);
+				break;
+			}
+		}
+
+		void activation_plain::rectified_linear_backprop(
+			float * errors,
+			const float * output_neurons,
+			unsigned int elem_count)
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				activation_avx512::rectified_linear_backprop(errors, output_neurons, elem_count);
+				break;
+			case instruction_set_plain::instruction_set_avx2:
+				activation_avx2::rectified_linear_backprop(errors, output_neurons, elem_count);
+				break;
+			default:
+				activation_sse2::rectified_linear_backprop(errors, output_neurons, elem_count);
+				break;
+			}
+		}
+
+		void activation_plain::absolute(
+			const float * input,
+			float * output,
+			unsigned int elem_count)
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				activation_avx512::absolute(input, output, elem_count);
+				break;
+			case instruction_set_plain::instruction_set_avx2:
+				activation_avx2::absolute(input, output, elem_count);
+				break;
+			default:
+				activation_sse2::absolute(input, output, elem_count);
+				break;
+			}
+		}
+
+		void activation_plain::absolute_backprop(
+			float * errors,
+			const float * input_neurons,
+			unsigned int elem_count)
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				activation_avx512::absolute_backprop(errors, input_neurons, elem_count);
+				break;
+			case instruction_set_plain::instruction_set_avx2:
+				activation_avx2::absolute_backprop(errors, input_neurons, elem_count);
+				break;
+			default:
+				activation_sse2::absolute_backprop(errors, input_neurons, elem_count);
+				break;
+			}
+		}
+
+		void activation_plain::parametric_rectified_linear(
+			const float * input,
+			float * output,
+			unsigned int elem_count,
+			float a)
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				activation_avx512::parametric_rectified_linear(input, output, elem_count, a);
+				break;
+			case instruction_set_plain::instruction_set_avx2:
+				activation_avx2::parametric_rectified_linear(input, output, elem_count, a);
+				break;
+			default:
+				activation_sse2::parametric_rectified_linear(input, output, elem_count, a);
+				break;
+			}
+		}
+
+		void activation_plain::parametric_rectified_linear_backprop(
+			float * errors,
+			const float * input_neurons,
+			unsigned int elem_count,
+			float a)
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				activation_avx512::parametric_rectified_linear_backprop(errors, input_neurons, elem_count, a);
+				break;
+			case instruction_set_plain::instruction_set_avx2:
+				activation_avx2::parametric_rectified_linear_backprop(errors, input_neurons, elem_count, a);
+				break;
+			default:
+				activation_sse2::parametric_rectified_linear_backprop(errors, input_neurons, elem_count, a);
+				break;
+			}
+		}
+
+		float activation_plain::parametric_rectified_linear_gradient(
+			const float * errors,
+			const float * input_neurons,
+			unsigned int elem_count)
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				return activation_avx512::parametric_rectified_linear_gradient(errors, input_neurons, elem_count);
+			case instruction_set_plain::instruction_set_avx2:
+				return activation_avx2::parametric_rectified_linear_gradient(errors, input_neurons, elem_count);
+			default:
+				return activation_sse2::parametric_rectified_linear_gradient(errors, input_neurons, elem_count);
+			}
+		}
+	}
+}
@@ -0,0 +1,99 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Elementwise activation kernels, vectorized for SSE2, AVX2 and AVX-512, the variant is picked at runtime
+		// with instruction_set_plain. Each call runs in the calling thread, layers split the data into chunks of chunk_size
+		// between OpenMP threads. output might be the same as input
+		class activation_plain
+		{
+		public:
+			static void sigmoid(
+				const float * input,
+				float * output,
+				unsigned int elem_count);
+
+			static void sigmoid_backprop(
+				float * errors,
+				const float * output_neurons,
+				unsigned int elem_count);
+
+			static void hyperbolic_tangent(
+				const float * input,
+				float * output,
+				unsigned int elem_count,
+				float steepness,
+				float major_multiplier);
+
+			static void hyperbolic_tangent_backprop(
+				float * errors,
+				const float * output_neurons,
+				unsigned int elem_count,
+				float steepness,
+				float major_multiplier);
+
+			static void rectified_linear(
+				const float * input,
+				float * output,
+				unsigned int elem_count);
+
+			static void rectified_linear_backprop(
+				float * errors,
+				const float * output_neurons,
+				unsigned int elem_count);
+
+			static void absolute(
+				const float * input,
+				float * output,
+				unsigned int elem_count);
+
+			static void absolute_backprop(
+				float * errors,
+				const float * input_neurons,
+				unsigned int elem_count);
+
+			static void parametric_rectified_linear(
+				const float * input,
+				float * output,
+				unsigned int elem_count,
+				float a);
+
+			static void parametric_rectified_linear_backprop(
+				float * errors,
+				const float * input_neurons,
+				unsigned int elem_count,
+				float a);
+
+			// Returns the sum of errors multiplied by negative inputs
+			static float parametric_rectified_linear_gradient(
+				const float * errors,
+				const float * input_neurons,
+				unsigned int elem_count);
+
+			// Number of elements processed by a single thread at once
+			static const unsigned int chunk_size = 4096;
+
+		private:
+			activation_plain();
+			~activation_plain();
+		};
+	}
+}
@@ -0,0 +1,145 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// Bodies of the activation kernels, there is no include guard on purpose:
+// activation_plain.cpp includes this file once per instruction set, each time within its own namespace and target options.
+// The loops are written branch-free so that the compiler vectorizes them for the current target.
+
+#include "math_plain_kernels.h"
+
+void sigmoid(
+	const float * input,
+	float * output,
+	unsigned int elem_count)
+{
+	for(unsigned int i = 0; i < elem_count; ++i)
+		output[i] = 1.0F / (exp_approx(-input[i]) + 1.0F);
+}
+
+void sigmoid_backprop(
+	float * errors,
+	const float * output_neurons,
+	unsigned int elem_count)
+{
+	for(unsigned int i = 0; i < elem_count; ++i)
+	{
+		float out_neuron = output_neurons[i];
+		errors[i] *= out_neuron * (1.0F - out_neuron);
+	}
+}
+
+// major_multiplier * tanh(steepness * x) written as major_multiplier * (1 - 2 / (exp(2 * steepness * x) + 1)), which saturates without NaNs
+void hyperbolic_tangent(
+	const float * input,
+	float * output,
+	unsigned int elem_count,
+	float steepness,
+	float major_multiplier)
+{
+	const float steepness2 = steepness * 2.0F;
+	const float major_multiplier2 = major_multiplier * 2.0F;
+	for(unsigned int i = 0; i < elem_count; ++i)
+		output[i] = major_multiplier - major_multiplier2 / (exp_approx(input[i] * steepness2) + 1.0F);
+}
+
+void hyperbolic_tangent_backprop(
+	float * errors,
+	const float * output_neurons,
+	unsigned int elem_count,
+	float steepness,
+	float major_multiplier)
+{
+	const float major_multiplier_reverse = 1.0F / major_multiplier;
+	const float steepness3 = steepness * major_multiplier;
+	for(unsigned int i = 0; i < elem_count; ++i)
+	{
+		float normalized_value = output_neurons[i] * major_multiplier_reverse;
+		errors[i] *= steepness3 * (1.0F - normalized_value * normalized_value);
+	}
+}
+
+void rectified_linear(
+	const float * input,
+	float * output,
+	unsigned int elem_count)
+{
+	for(unsigned int i = 0; i < elem_count; ++i)
+		output[i] = std::max(input[i], 0.0F);
+}
+
+void rectified_linear_backprop(
+	float * errors,
+	const float * output_neurons,
+	unsigned int elem_count)
+{
+	for(unsigned int i = 0; i < elem_count; ++i)
+		errors[i] = (output_neurons[i] == 0.0F) ? 0.0F : errors[i];
+}
+
+void absolute(
+	const float * input,
+	float * output,
+	unsigned int elem_count)
+{
+	for(unsigned int i = 0; i < elem_count; ++i)
+		output[i] = std::max(input[i], -input[i]);
+}
+
+void absolute_backprop(
+	float * errors,
+	const float * input_neurons,
+	unsigned int elem_count)
+{
+	for(unsigned int i = 0; i < elem_count; ++i)
+		errors[i] = (input_neurons[i] < 0.0F) ? -errors[i] : errors[i];
+}
+
+void parametric_rectified_linear(
+	const float * input,
+	float * output,
+	unsigned int elem_count,
+	float a)
+{
+	for(unsigned int i = 0; i < elem_count; ++i)
+	{
+		float input_val = input[i];
+		output[i] = input_val * ((input_val >= 0.0F) ? 1.0F : a);
+	}
+}
+
+void parametric_rectified_linear_backprop(
+	float * errors,
+	const float * input_neurons,
+	unsigned int elem_count,
+	float a)
+{
+	for(unsigned int i = 0; i < elem_count; ++i)
+		errors[i] *= (input_neurons[i] >= 0.0F) ? 1.0F : a;
+}
+
+float parametric_rectified_linear_gradient(
+	const float * errors,
+	const float * input_neurons,
+	unsigned int elem_count)
+{
+	float sum = 0.0F;
+	for(unsigned int i = 0; i < elem_count; ++i)
+	{
+		float input_val = input_neurons[i];
+		sum += errors[i] * ((input_val >= 0.0F) ? 0.0F : input_val);
+	}
+	return sum;
+}
@@ -0,0 +1,34 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "aligned_allocator_plain.h"
+#include "../nn_types.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Neurons and scratch data of the layer testers and updaters
+		typedef std::vector<float, aligned_allocator_plain<float> > additional_buffer;
+		typedef nnforge_shared_ptr<additional_buffer> additional_buffer_smart_ptr;
+		typedef nnforge_shared_ptr<const additional_buffer> const_additional_buffer_smart_ptr;
+		typedef std::vector<additional_buffer_smart_ptr> additional_buffer_set;
+	}
+}
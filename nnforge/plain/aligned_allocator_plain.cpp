@@ -0,0 +1,70 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "aligned_allocator_plain.h"
+
+#include <cstdlib>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		const size_t aligned_memory_plain::alignment;
+		const size_t aligned_memory_plain::huge_page_size;
+
+		void * aligned_memory_plain::allocate(
+			size_t size,
+			bool huge_pages)
+		{
+			if (size == 0)
+				size = 1;
+
+			void * res = 0;
+#ifdef _MSC_VER
+			res = _aligned_malloc(size, alignment);
+#else
+			const bool use_huge_pages = huge_pages && (size >= huge_page_size);
+			if (posix_memalign(&res, use_huge_pages ? huge_page_size : alignment, size) != 0)
+				res = 0;
+#ifdef __linux__
+			// The advice should come before the memory is touched for the first time, it is ignored when THP is disabled
+			if ((res != 0) && use_huge_pages)
+				madvise(res, (size / huge_page_size) * huge_page_size, MADV_HUGEPAGE);
+#endif
+#endif
+
+			if (res == 0)
+				throw std::bad_alloc();
+
+			return res;
+		}
+
+		void aligned_memory_plain::deallocate(void * ptr)
+		{
+#ifdef _MSC_VER
+			_aligned_free(ptr);
+#else
+			free(ptr);
+#endif
+		}
+	}
+}
@@ -0,0 +1,157 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../nn_types.h"
+
+#include <cstddef>
+#include <new>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		class aligned_memory_plain
+		{
+		public:
+			// Cache line size, which is also the widest SIMD vector
+			static const size_t alignment = 64;
+
+			// Blocks of at least this size are aligned to it when huge pages are requested
+			static const size_t huge_page_size = 2 * 1024 * 1024;
+
+			// With huge_pages set the large blocks are advised to be backed by transparent huge pages, on Linux only.
+			// Throws std::bad_alloc
+			static void * allocate(
+				size_t size,
+				bool huge_pages);
+
+			static void deallocate(void * ptr);
+
+		private:
+			aligned_memory_plain();
+			~aligned_memory_plain();
+		};
+
+		// Allocator for std::vector returning memory from aligned_memory_plain, or the part of an arena block it is created with, see buffer_arena_plain.
+		// The instances without the arena part are interchangeable, huge_pages only affects the blocks allocated by them
+		template<typename value_type_>
+		class aligned_allocator_plain
+		{
+		public:
+			typedef value_type_ value_type;
+			typedef value_type * pointer;
+			typedef const value_type * const_pointer;
+			typedef value_type& reference;
+			typedef const value_type& const_reference;
+			typedef size_t size_type;
+			typedef ptrdiff_t difference_type;
+
+			template<typename other_value_type>
+			struct rebind
+			{
+				typedef aligned_allocator_plain<other_value_type> other;
+			};
+
+			explicit aligned_allocator_plain(bool huge_pages = false)
+				: huge_pages(huge_pages)
+				, arena_ptr(0)
+			{
+			}
+
+			// The vector using the allocator gets arena_ptr, the part of arena_block large enough for it, so it should not grow.
+			// The vector keeps arena_block alive
+			aligned_allocator_plain(
+				nnforge_shared_ptr<void> arena_block,
+				void * arena_ptr)
+				: huge_pages(false)
+				, arena_block(arena_block)
+				, arena_ptr(arena_ptr)
+			{
+			}
+
+			template<typename other_value_type>
+			aligned_allocator_plain(const aligned_allocator_plain<other_value_type>& other)
+				: huge_pages(other.huge_pages)
+				, arena_block(other.arena_block)
+				, arena_ptr(other.arena_ptr)
+			{
+			}
+
+			pointer address(reference x) const
+			{
+				return &x;
+			}
+
+			const_pointer address(const_reference x) const
+			{
+				return &x;
+			}
+
+			pointer allocate(
+				size_type n,
+				const void * hint = 0)
+			{
+				if (arena_ptr != 0)
+					return static_cast<pointer>(arena_ptr);
+
+				return static_cast<pointer>(aligned_memory_plain::allocate(n * sizeof(value_type), huge_pages));
+			}
+
+			void deallocate(
+				pointer p,
+				size_type n)
+			{
+				if (arena_ptr == 0)
+					aligned_memory_plain::deallocate(p);
+			}
+
+			size_type max_size() const
+			{
+				return static_cast<size_type>(-1) / sizeof(value_type);
+			}
+
+			void construct(
+				pointer p,
+				const value_type& val)
+			{
+				new(p) value_type(val);
+			}
+
+			void destroy(pointer p)
+			{
+				p->~value_type();
+			}
+
+			bool huge_pages;
+			nnforge_shared_ptr<void> arena_block;
+			void * arena_ptr;
+		};
+
+		template<typename value_type1, typename value_type2>
+		bool operator ==(const aligned_allocator_plain<value_type1>& x, const aligned_allocator_plain<value_type2>& y)
+		{
+			return (x.arena_ptr == y.arena_ptr);
+		}
+
+		template<typename value_type1, typename value_type2>
+		bool operator !=(const aligned_allocator_plain<value_type1>& x, const aligned_allocator_plain<value_type2>& y)
+		{
+			return (x.arena_ptr != y.arena_ptr);
+		}
+	}
+}
@@ -0,0 +1,103 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "blocked_layout_plain.h"
+
+#include <algorithm>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		const unsigned int blocked_layout_plain::block_size;
+
+		unsigned int blocked_layout_plain::get_block_count(unsigned int feature_map_count)
+		{
+			return (feature_map_count + block_size - 1) / block_size;
+		}
+
+		unsigned int blocked_layout_plain::get_neuron_count(const layer_configuration_specific& configuration_specific)
+		{
+			return get_block_count(configuration_specific.feature_map_count) * block_size * configuration_specific.get_neuron_count_per_feature_map();
+		}
+
+		void blocked_layout_plain::to_blocked(
+			const float * planar,
+			float * blocked,
+			const layer_configuration_specific& configuration_specific,
+			unsigned int entry_count,
+			int thread_count)
+		{
+			const unsigned int feature_map_count = configuration_specific.feature_map_count;
+			const unsigned int neuron_count_per_feature_map = configuration_specific.get_neuron_count_per_feature_map();
+			const unsigned int block_count = get_block_count(feature_map_count);
+			const int total_workload = static_cast<int>(entry_count * block_count);
+
+			#pragma omp parallel for default(none) schedule(guided) num_threads(thread_count) shared(planar,blocked)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				int entry_id = workload_id / block_count;
+				int block_id = workload_id - (entry_id * block_count);
+				const unsigned int feature_map_start = block_id * block_size;
+				const unsigned int current_block_size = std::min(block_size, feature_map_count - feature_map_start);
+				const float * src = planar + (entry_id * feature_map_count + feature_map_start) * neuron_count_per_feature_map;
+				float * dst = blocked + workload_id * neuron_count_per_feature_map * block_size;
+
+				if (current_block_size < block_size)
+					std::fill_n(dst, neuron_count_per_feature_map * block_size, 0.0F);
+				for(unsigned int i = 0; i < current_block_size; ++i)
+				{
+					const float * src_fm = src + i * neuron_count_per_feature_map;
+					float * dst_fm = dst + i;
+					for(unsigned int j = 0; j < neuron_count_per_feature_map; ++j)
+						dst_fm[j * block_size] = src_fm[j];
+				}
+			}
+		}
+
+		void blocked_layout_plain::to_planar(
+			const float * blocked,
+			float * planar,
+			const layer_configuration_specific& configuration_specific,
+			unsigned int entry_count,
+			int thread_count)
+		{
+			const unsigned int feature_map_count = configuration_specific.feature_map_count;
+			const unsigned int neuron_count_per_feature_map = configuration_specific.get_neuron_count_per_feature_map();
+			const unsigned int block_count = get_block_count(feature_map_count);
+			const int total_workload = static_cast<int>(entry_count * block_count);
+
+			#pragma omp parallel for default(none) schedule(guided) num_threads(thread_count) shared(planar,blocked)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				int entry_id = workload_id / block_count;
+				int block_id = workload_id - (entry_id * block_count);
+				const unsigned int feature_map_start = block_id * block_size;
+				const unsigned int current_block_size = std::min(block_size, feature_map_count - feature_map_start);
+				const float * src = blocked + workload_id * neuron_count_per_feature_map * block_size;
+				float * dst = planar + (entry_id * feature_map_count + feature_map_start) * neuron_count_per_feature_map;
+
+				for(unsigned int i = 0; i < current_block_size; ++i)
+				{
+					const float * src_fm = src + i;
+					float * dst_fm = dst + i * neuron_count_per_feature_map;
+					for(unsigned int j = 0; j < neuron_count_per_feature_map; ++j)
+						dst_fm[j] = src_fm[j * block_size];
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,59 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../layer_configuration_specific.h"
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Blocked layout keeps feature maps interleaved in blocks of block_size: [entry][feature map block][spatial][block_size],
+		// so that kernels load a full SIMD vector of feature maps at each spatial position.
+		// The last block is padded when the feature map count is not a multiple of block_size: conversion fills the padding
+		// feature maps with zeros, layers keep them finite but not necessarily zero, and consumers ignore them.
+		// Planar layout [entry][feature map][spatial] is used everywhere else, network_tester_plain converts between them
+		class blocked_layout_plain
+		{
+		public:
+			static const unsigned int block_size = 8;
+
+			static unsigned int get_block_count(unsigned int feature_map_count);
+
+			// Neuron count of a single entry in the blocked layout, including the padding feature maps
+			static unsigned int get_neuron_count(const layer_configuration_specific& configuration_specific);
+
+			static void to_blocked(
+				const float * planar,
+				float * blocked,
+				const layer_configuration_specific& configuration_specific,
+				unsigned int entry_count,
+				int thread_count);
+
+			static void to_planar(
+				const float * blocked,
+				float * planar,
+				const layer_configuration_specific& configuration_specific,
+				unsigned int entry_count,
+				int thread_count);
+
+		private:
+			blocked_layout_plain();
+			~blocked_layout_plain();
+		};
+	}
+}
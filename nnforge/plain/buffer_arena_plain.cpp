@@ -0,0 +1,70 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include "buffer_arena_plain.h"
+
+#include "../neural_network_exception.h"
+
+namespace nnforge
+{
+	namespace plain
+	{
+		buffer_arena_plain::buffer_arena_plain(bool huge_pages)
+			: huge_pages(huge_pages)
+			, total_elem_count(0)
+			, next_buffer_id(0)
+		{
+		}
+
+		buffer_arena_plain::~buffer_arena_plain()
+		{
+		}
+
+		additional_buffer_smart_ptr buffer_arena_plain::create_buffer(size_t elem_count)
+		{
+			if (!block)
+			{
+				const size_t alignment_elem_count = aligned_memory_plain::alignment / sizeof(float);
+				elem_count_list.push_back(elem_count);
+				elem_offset_list.push_back(total_elem_count);
+				total_elem_count += (elem_count + alignment_elem_count - 1) / alignment_elem_count * alignment_elem_count;
+				return additional_buffer_smart_ptr();
+			}
+
+			if ((next_buffer_id >= elem_count_list.size()) || (elem_count_list[next_buffer_id] != elem_count))
+				throw neural_network_exception("Buffers requested from buffer_arena_plain don't match the ones reserved");
+
+			float * arena_ptr = static_cast<float *>(block.get()) + elem_offset_list[next_buffer_id];
+			++next_buffer_id;
+
+			return additional_buffer_smart_ptr(new additional_buffer(elem_count, 0.0F, aligned_allocator_plain<float>(block, arena_ptr)));
+		}
+
+		void buffer_arena_plain::allocate()
+		{
+			if (block)
+				throw neural_network_exception("buffer_arena_plain is allocated already");
+
+			block = nnforge_shared_ptr<void>(aligned_memory_plain::allocate(get_size(), huge_pages), aligned_memory_plain::deallocate);
+		}
+
+		size_t buffer_arena_plain::get_size() const
+		{
+			return total_elem_count * sizeof(float);
+		}
+	}
+}
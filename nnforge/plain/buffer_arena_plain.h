@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include "additional_buffer_plain.h"
+#include "../nn_types.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// A single aligned block holding the buffers of the tester or the updater, each buffer starting at the cache line boundary.
+		// The buffers are requested twice in the same order: before allocate is called create_buffer only reserves the room for the buffer
+		// and returns an empty pointer, after that it returns the zero-filled buffer in its part of the block
+		class buffer_arena_plain
+		{
+		public:
+			// The block is advised to be backed by transparent huge pages, see aligned_memory_plain
+			buffer_arena_plain(bool huge_pages);
+
+			~buffer_arena_plain();
+
+			additional_buffer_smart_ptr create_buffer(size_t elem_count);
+
+			// Should be called once, after all the buffers are reserved
+			void allocate();
+
+			// The size of the block in bytes
+			size_t get_size() const;
+
+		private:
+			buffer_arena_plain(const buffer_arena_plain&);
+			buffer_arena_plain& operator =(const buffer_arena_plain&);
+
+			bool huge_pages;
+			std::vector<size_t> elem_count_list;
+			// The offsets of the buffers in the block, in elements
+			std::vector<size_t> elem_offset_list;
+			size_t total_elem_count;
+			nnforge_shared_ptr<void> block;
+			unsigned int next_buffer_id;
+		};
+	}
+}
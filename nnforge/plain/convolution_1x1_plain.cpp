@@ -0,0 +1,189 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "convolution_1x1_plain.h"
+
+#include "gemm_plain.h"
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		convolution_1x1_plain::convolution_1x1_plain(
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+			: input_feature_map_count(input_configuration_specific.feature_map_count)
+			, output_feature_map_count(output_configuration_specific.feature_map_count)
+			, neuron_count_per_feature_map(output_configuration_specific.get_neuron_count_per_feature_map())
+		{
+		}
+
+		bool convolution_1x1_plain::is_applicable(
+			const std::vector<unsigned int>& window_sizes,
+			const std::vector<unsigned int>& strides)
+		{
+			for(std::vector<unsigned int>::const_iterator it = window_sizes.begin(); it != window_sizes.end(); ++it)
+				if (*it != 1)
+					return false;
+			for(std::vector<unsigned int>::const_iterator it = strides.begin(); it != strides.end(); ++it)
+				if (*it != 1)
+					return false;
+
+			return true;
+		}
+
+		unsigned int convolution_1x1_plain::get_buffer_elem_count() const
+		{
+			return std::max(
+				std::max(
+					gemm_plain::get_workspace_elem_count(output_feature_map_count, neuron_count_per_feature_map, input_feature_map_count),
+					gemm_plain::get_workspace_elem_count(input_feature_map_count, neuron_count_per_feature_map, output_feature_map_count)),
+				gemm_plain::get_workspace_elem_count(output_feature_map_count, input_feature_map_count, neuron_count_per_feature_map));
+		}
+
+		template<typename weight_type>
+		void convolution_1x1_plain::forward(
+			const float * input,
+			float * output,
+			const weight_type * weights,
+			const float * biases,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_feature_map_count * neuron_count_per_feature_map;
+			const unsigned int output_neuron_count = output_feature_map_count * neuron_count_per_feature_map;
+
+			// Parallelize over entries when there are enough of them, split each product between threads otherwise
+			const int entry_thread_count = (entry_count >= static_cast<unsigned int>(thread_count)) ? thread_count : 1;
+			const int gemm_thread_count = (entry_thread_count > 1) ? 1 : thread_count;
+			const int total_workload = static_cast<int>(entry_count);
+
+			#pragma omp parallel for default(none) schedule(dynamic) num_threads(entry_thread_count) shared(input,output,weights,biases,buffers)
+			for(int entry_id = 0; entry_id < total_workload; ++entry_id)
+			{
+				float * thread_buffers = buffers;
+				#ifdef _OPENMP
+				thread_buffers += get_buffer_elem_count() * omp_get_thread_num();
+				#endif
+
+				float * out = output + entry_id * output_neuron_count;
+				for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+					std::fill_n(out + output_feature_map_id * neuron_count_per_feature_map, neuron_count_per_feature_map, biases[output_feature_map_id]);
+
+				gemm_plain::parallel_sgemm(
+					false,
+					false,
+					output_feature_map_count,
+					neuron_count_per_feature_map,
+					input_feature_map_count,
+					weights,
+					input_feature_map_count,
+					input + entry_id * input_neuron_count,
+					neuron_count_per_feature_map,
+					out,
+					neuron_count_per_feature_map,
+					true,
+					thread_buffers,
+					gemm_thread_count);
+			}
+		}
+
+		template void convolution_1x1_plain::forward<float>(const float *, float *, const float *, const float *, float *, unsigned int, int) const;
+		template void convolution_1x1_plain::forward<half_float_plain::fp16>(const float *, float *, const half_float_plain::fp16 *, const float *, float *, unsigned int, int) const;
+		template void convolution_1x1_plain::forward<half_float_plain::bf16>(const float *, float *, const half_float_plain::bf16 *, const float *, float *, unsigned int, int) const;
+
+		void convolution_1x1_plain::backprop(
+			const float * output_errors,
+			float * input_errors,
+			const float * weights,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_feature_map_count * neuron_count_per_feature_map;
+			const unsigned int output_neuron_count = output_feature_map_count * neuron_count_per_feature_map;
+
+			const int entry_thread_count = (entry_count >= static_cast<unsigned int>(thread_count)) ? thread_count : 1;
+			const int gemm_thread_count = (entry_thread_count > 1) ? 1 : thread_count;
+			const int total_workload = static_cast<int>(entry_count);
+
+			#pragma omp parallel for default(none) schedule(dynamic) num_threads(entry_thread_count) shared(output_errors,input_errors,weights,buffers)
+			for(int entry_id = 0; entry_id < total_workload; ++entry_id)
+			{
+				float * thread_buffers = buffers;
+				#ifdef _OPENMP
+				thread_buffers += get_buffer_elem_count() * omp_get_thread_num();
+				#endif
+
+				// input_errors = transpose(weights) * output_errors
+				gemm_plain::parallel_sgemm(
+					true,
+					false,
+					input_feature_map_count,
+					neuron_count_per_feature_map,
+					output_feature_map_count,
+					weights,
+					input_feature_map_count,
+					output_errors + entry_id * output_neuron_count,
+					neuron_count_per_feature_map,
+					input_errors + entry_id * input_neuron_count,
+					neuron_count_per_feature_map,
+					false,
+					thread_buffers,
+					gemm_thread_count);
+			}
+		}
+
+		void convolution_1x1_plain::update_weights(
+			const float * input,
+			const float * output_errors,
+			float * gradient_weights,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_feature_map_count * neuron_count_per_feature_map;
+			const unsigned int output_neuron_count = output_feature_map_count * neuron_count_per_feature_map;
+
+			// gradient_weights += output_errors * transpose(input), accumulated over entries
+			for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+			{
+				gemm_plain::parallel_sgemm(
+					false,
+					true,
+					output_feature_map_count,
+					input_feature_map_count,
+					neuron_count_per_feature_map,
+					output_errors + entry_id * output_neuron_count,
+					neuron_count_per_feature_map,
+					input + entry_id * input_neuron_count,
+					neuron_count_per_feature_map,
+					gradient_weights,
+					input_feature_map_count,
+					true,
+					buffers,
+					thread_count);
+			}
+		}
+	}
+}
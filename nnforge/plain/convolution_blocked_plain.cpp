@@ -0,0 +1,280 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "convolution_blocked_plain.h"
+
+#include "blocked_layout_plain.h"
+#include "instruction_set_plain.h"
+
+#include <algorithm>
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define NNFORGE_PLAIN_TARGET_PRAGMAS
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		namespace convolution_blocked_sse2
+		{
+			#include "convolution_blocked_plain_kernels.h"
+		}
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+		namespace convolution_blocked_avx2
+		{
+			#include "convolution_blocked_plain_kernels.h"
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+#endif
+		namespace convolution_blocked_avx512
+		{
+			#include "convolution_blocked_plain_kernels.h"
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+
+		const int convolution_blocked_plain::max_dimension_count;
+
+		convolution_blocked_plain::convolution_blocked_plain(
+			const std::vector<unsigned int>& window_sizes,
+			const std::vector<unsigned int>& left_zero_padding,
+			const std::vector<unsigned int>& strides,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+			: input_feature_map_count(input_configuration_specific.feature_map_count)
+			, output_feature_map_count(output_configuration_specific.feature_map_count)
+			, input_block_count(blocked_layout_plain::get_block_count(input_configuration_specific.feature_map_count))
+			, output_block_count(blocked_layout_plain::get_block_count(output_configuration_specific.feature_map_count))
+			, input_neuron_count_per_feature_map(input_configuration_specific.get_neuron_count_per_feature_map())
+			, output_neuron_count_per_feature_map(output_configuration_specific.get_neuron_count_per_feature_map())
+		{
+			const unsigned int dimension_count = static_cast<unsigned int>(window_sizes.size());
+			int window_sizes_extended[max_dimension_count];
+			int left_zero_padding_extended[max_dimension_count];
+			int strides_extended[max_dimension_count];
+			int input_dimension_sizes[max_dimension_count];
+			int output_dimension_sizes[max_dimension_count];
+			int input_slices[max_dimension_count];
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+			{
+				window_sizes_extended[i] = (i < dimension_count) ? static_cast<int>(window_sizes[i]) : 1;
+				left_zero_padding_extended[i] = (i < dimension_count) ? static_cast<int>(left_zero_padding[i]) : 0;
+				strides_extended[i] = (i < dimension_count) ? static_cast<int>(strides[i]) : 1;
+				input_dimension_sizes[i] = (i < dimension_count) ? static_cast<int>(input_configuration_specific.dimension_sizes[i]) : 1;
+				output_dimension_sizes[i] = (i < dimension_count) ? static_cast<int>(output_configuration_specific.dimension_sizes[i]) : 1;
+				input_slices[i] = (i == 0) ? 1 : input_slices[i - 1] * input_dimension_sizes[i - 1];
+			}
+
+			window_elem_count = 1;
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+				window_elem_count *= window_sizes_extended[i];
+			window_width = window_sizes_extended[0];
+			window_row_count = window_elem_count / window_width;
+			output_width = output_dimension_sizes[0];
+			output_row_count = output_neuron_count_per_feature_map / output_width;
+			stride_x = strides_extended[0];
+
+			input_row_offsets.resize(output_row_count * window_row_count);
+			for(unsigned int output_row_id = 0; output_row_id < output_row_count; ++output_row_id)
+			{
+				int output_position[max_dimension_count];
+				unsigned int remainder = output_row_id;
+				for(unsigned int i = 1; i < max_dimension_count; ++i)
+				{
+					output_position[i] = remainder % output_dimension_sizes[i];
+					remainder /= output_dimension_sizes[i];
+				}
+
+				for(unsigned int window_row_id = 0; window_row_id < window_row_count; ++window_row_id)
+				{
+					int offset = 0;
+					unsigned int window_remainder = window_row_id;
+					for(unsigned int i = 1; i < max_dimension_count; ++i)
+					{
+						int input_position = output_position[i] * strides_extended[i] + static_cast<int>(window_remainder % window_sizes_extended[i]) - left_zero_padding_extended[i];
+						window_remainder /= window_sizes_extended[i];
+						if ((input_position < 0) || (input_position >= input_dimension_sizes[i]))
+						{
+							offset = -1;
+							break;
+						}
+						offset += input_position * input_slices[i];
+					}
+					input_row_offsets[output_row_id * window_row_count + window_row_id] = offset;
+				}
+			}
+
+			x_offsets.resize(window_width);
+			x_starts.resize(window_width);
+			x_ends.resize(window_width);
+			for(unsigned int window_x = 0; window_x < window_width; ++window_x)
+			{
+				int x_offset = static_cast<int>(window_x) - left_zero_padding_extended[0];
+				x_offsets[window_x] = x_offset;
+				x_starts[window_x] = std::max(0, (stride_x - 1 - x_offset) / stride_x);
+				x_ends[window_x] = std::max(x_starts[window_x], std::min(output_dimension_sizes[0], (input_dimension_sizes[0] - x_offset + stride_x - 1) / stride_x));
+			}
+			interior_x_start = static_cast<unsigned int>(*std::max_element(x_starts.begin(), x_starts.end()));
+			interior_x_end = std::max(interior_x_start, static_cast<unsigned int>(*std::min_element(x_ends.begin(), x_ends.end())));
+		}
+
+		bool convolution_blocked_plain::is_applicable(const std::vector<unsigned int>& window_sizes)
+		{
+			return (window_sizes.size() <= static_cast<size_t>(max_dimension_count));
+		}
+
+		bool convolution_blocked_plain::is_efficient(
+			const std::vector<unsigned int>& window_sizes,
+			const std::vector<unsigned int>& strides,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+		{
+			if (!is_applicable(window_sizes) || (window_sizes.size() != 2))
+				return false;
+
+			for(unsigned int i = 0; i < window_sizes.size(); ++i)
+			{
+				if (window_sizes[i] != 3)
+					return false;
+				if ((i < strides.size()) && (strides[i] != 1))
+					return false;
+			}
+
+			// Partial blocks waste the padding lanes of the kernel
+			if ((input_configuration_specific.feature_map_count % blocked_layout_plain::block_size) != 0)
+				return false;
+
+			if (std::max(input_configuration_specific.feature_map_count, output_configuration_specific.feature_map_count) <= efficient_max_feature_map_count)
+				return true;
+
+			return (output_configuration_specific.get_neuron_count_per_feature_map() <= efficient_max_output_neuron_count_per_feature_map);
+		}
+
+		unsigned int convolution_blocked_plain::get_packed_weights_elem_count() const
+		{
+			const unsigned int block_size = blocked_layout_plain::block_size;
+			return output_block_count * input_block_count * window_elem_count * block_size * block_size + output_block_count * block_size;
+		}
+
+		void convolution_blocked_plain::pack_weights(
+			const float * weights,
+			const float * biases,
+			float * packed_weights) const
+		{
+			const unsigned int block_size = blocked_layout_plain::block_size;
+			const unsigned int packed_biases_offset = output_block_count * input_block_count * window_elem_count * block_size * block_size;
+			std::fill_n(packed_weights, get_packed_weights_elem_count(), 0.0F);
+
+			for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+			{
+				const unsigned int output_block_id = output_feature_map_id / block_size;
+				const unsigned int oc = output_feature_map_id - output_block_id * block_size;
+				for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count; ++input_feature_map_id)
+				{
+					const unsigned int input_block_id = input_feature_map_id / block_size;
+					const unsigned int ic = input_feature_map_id - input_block_id * block_size;
+					const float * src = weights + (output_feature_map_id * input_feature_map_count + input_feature_map_id) * window_elem_count;
+					float * dst = packed_weights + (output_block_id * input_block_count + input_block_id) * window_elem_count * block_size * block_size + ic * block_size + oc;
+					for(unsigned int window_elem_id = 0; window_elem_id < window_elem_count; ++window_elem_id)
+						dst[window_elem_id * block_size * block_size] = src[window_elem_id];
+				}
+				packed_weights[packed_biases_offset + output_feature_map_id] = biases[output_feature_map_id];
+			}
+		}
+
+		void convolution_blocked_plain::forward(
+			const float * input,
+			float * output,
+			const float * packed_weights,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int block_size = blocked_layout_plain::block_size;
+			const unsigned int input_block_elem_count = input_neuron_count_per_feature_map * block_size;
+			const unsigned int output_block_elem_count = output_neuron_count_per_feature_map * block_size;
+			const unsigned int input_entry_elem_count = input_block_count * input_block_elem_count;
+			const unsigned int output_entry_elem_count = output_block_count * output_block_elem_count;
+			const unsigned int output_block_weight_count = input_block_count * window_elem_count * block_size * block_size;
+			const float * const packed_biases = packed_weights + output_block_count * output_block_weight_count;
+			const int total_workload = static_cast<int>(entry_count * output_row_count);
+			const int * const input_row_offsets_it = &(*input_row_offsets.begin());
+			const int * const x_offsets_it = &(*x_offsets.begin());
+			const int * const x_starts_it = &(*x_starts.begin());
+			const int * const x_ends_it = &(*x_ends.begin());
+			const row_kernel_function row_kernel = get_row_kernel();
+			// The kernels are the same for all the instruction sets except for target options
+			const unsigned int packed_input_elem_count = input_block_count * window_elem_count * block_size * convolution_blocked_sse2::tile_width;
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(input,output,packed_weights)
+			{
+				std::vector<float> packed_input(packed_input_elem_count);
+
+				#pragma omp for schedule(dynamic)
+				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+				{
+					int entry_id = workload_id / output_row_count;
+					int output_row_id = workload_id - (entry_id * output_row_count);
+
+					row_kernel(
+						input + entry_id * input_entry_elem_count,
+						output + entry_id * output_entry_elem_count + output_row_id * output_width * block_size,
+						packed_weights,
+						packed_biases,
+						input_row_offsets_it + output_row_id * window_row_count,
+						x_offsets_it,
+						x_starts_it,
+						x_ends_it,
+						&(*packed_input.begin()),
+						input_block_count,
+						input_block_elem_count,
+						output_block_count,
+						output_block_elem_count,
+						window_width,
+						window_row_count,
+						stride_x,
+						output_width,
+						interior_x_start,
+						interior_x_end);
+				}
+			}
+		}
+
+		convolution_blocked_plain::row_kernel_function convolution_blocked_plain::get_row_kernel()
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				return convolution_blocked_avx512::forward_row;
+			case instruction_set_plain::instruction_set_avx2:
+				return convolution_blocked_avx2::forward_row;
+			default:
+				return convolution_blocked_sse2::forward_row;
+			}
+		}
+	}
+}
@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../layer_configuration_specific.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Direct convolution over the blocked layout, see blocked_layout_plain
+		// Each output row is computed in tiles of tile_width positions, the input of the tile is packed once for all the output blocks:
+		// every input element is broadcast and multiplied by a full vector of block_size output feature map weights,
+		// the accumulators of the tile stay in registers. Vectorized for SSE2, AVX2 and AVX-512, picked at runtime
+		class convolution_blocked_plain
+		{
+		public:
+			convolution_blocked_plain(
+				const std::vector<unsigned int>& window_sizes,
+				const std::vector<unsigned int>& left_zero_padding,
+				const std::vector<unsigned int>& strides,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific);
+
+			static bool is_applicable(const std::vector<unsigned int>& window_sizes);
+
+			// The blocked engine beats the planar ones (Winograd, GEMM) only for 3x3 windows with stride 1 on full blocks
+			// of feature maps, and there only while the feature map count or the spatial size is small
+			static bool is_efficient(
+				const std::vector<unsigned int>& window_sizes,
+				const std::vector<unsigned int>& strides,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific);
+
+			unsigned int get_packed_weights_elem_count() const;
+
+			// Packed weights are [output block][input block][window element][input feature map][output feature map],
+			// followed by the biases padded to the whole output blocks; padding feature maps get zero weights and biases
+			void pack_weights(
+				const float * weights,
+				const float * biases,
+				float * packed_weights) const;
+
+			// Input and output are in the blocked layout
+			void forward(
+				const float * input,
+				float * output,
+				const float * packed_weights,
+				unsigned int entry_count,
+				int thread_count) const;
+
+		private:
+			typedef void (*row_kernel_function)(
+				const float * input,
+				float * output_row,
+				const float * weights,
+				const float * biases,
+				const int * input_row_offsets,
+				const int * x_offsets,
+				const int * x_starts,
+				const int * x_ends,
+				float * packed_input,
+				unsigned int input_block_count,
+				unsigned int input_block_elem_count,
+				unsigned int output_block_count,
+				unsigned int output_block_elem_count,
+				unsigned int window_width,
+				unsigned int window_row_count,
+				int stride_x,
+				unsigned int output_width,
+				unsigned int interior_x_start,
+				unsigned int interior_x_end);
+
+			static row_kernel_function get_row_kernel();
+
+			static const int max_dimension_count = 4;
+			static const unsigned int efficient_max_feature_map_count = 16;
+			static const unsigned int efficient_max_output_neuron_count_per_feature_map = 64;
+
+			unsigned int input_feature_map_count;
+			unsigned int output_feature_map_count;
+			unsigned int input_block_count;
+			unsigned int output_block_count;
+			unsigned int input_neuron_count_per_feature_map;
+			unsigned int output_neuron_count_per_feature_map;
+			unsigned int window_elem_count;
+			unsigned int window_width;
+			unsigned int window_row_count;
+			unsigned int output_width;
+			unsigned int output_row_count;
+			int stride_x;
+
+			// Offset of the input row for each (output row, window row) pair, -1 if the row is in the padding area
+			std::vector<int> input_row_offsets;
+			// Horizontal offset of the input and the range of valid output positions for each window column,
+			// output position x reads input position x * stride_x + x_offset
+			std::vector<int> x_offsets;
+			std::vector<int> x_starts;
+			std::vector<int> x_ends;
+			// Output positions with all the window columns within the input row
+			unsigned int interior_x_start;
+			unsigned int interior_x_end;
+		};
+	}
+}
@@ -0,0 +1,189 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// Bodies of the blocked convolution kernels, there is no include guard on purpose:
+// convolution_blocked_plain.cpp includes this file once per instruction set, each time within its own namespace and target options.
+// The loops over block_size output feature maps have constant trip count, the compiler turns them into full-width vector operations.
+
+// The tile is small enough for its accumulators to stay in registers
+const unsigned int tile_width = 6;
+
+// Transposes the input of tile_width neighbouring output positions so that forward_tile reads tile_width consecutive elements,
+// the same way gemm_plain packs A. The tile is packed once and used for all the output blocks
+// Window columns and input feature maps of a block are contiguous in the input row, packed_input is
+// [input block][window row][window column][input feature map][tile position], the same order as the weights.
+// Window rows in the padding area are packed as zeros, this keeps the reduction in forward_tile a single loop
+void pack_tile(
+	const float * input,
+	float * packed_input,
+	const int * input_row_offsets,
+	unsigned int input_block_count,
+	unsigned int input_block_elem_count,
+	unsigned int window_width,
+	unsigned int window_row_count,
+	int stride_x)
+{
+	const int block_size = static_cast<int>(blocked_layout_plain::block_size);
+	const int input_x_step = stride_x * block_size;
+	const int row_elem_count = static_cast<int>(window_width) * block_size;
+
+	for(unsigned int input_block_id = 0; input_block_id < input_block_count; ++input_block_id)
+	{
+		const float * in_block = input + input_block_id * input_block_elem_count;
+		for(unsigned int window_row_id = 0; window_row_id < window_row_count; ++window_row_id, packed_input += row_elem_count * tile_width)
+		{
+			const int input_row_offset = input_row_offsets[window_row_id];
+			if (input_row_offset < 0)
+			{
+				std::fill_n(packed_input, row_elem_count * tile_width, 0.0F);
+				continue;
+			}
+
+			const float * in_row = in_block + input_row_offset * block_size;
+			for(int t = 0; t < static_cast<int>(tile_width); ++t)
+				for(int p = 0; p < row_elem_count; ++p)
+					packed_input[p * static_cast<int>(tile_width) + t] = in_row[t * input_x_step + p];
+		}
+	}
+}
+
+// tile_width neighbouring output positions of a single output block, all the window columns are within the input row for each of them
+// The same loop as in gemm_plain micro-kernel, with the reduction over input blocks, window elements and input feature maps
+void forward_tile(
+	const float * packed_input,
+	float * output,
+	const float * weights,
+	const float * biases,
+	unsigned int reduction_elem_count)
+{
+	const int block_size = static_cast<int>(blocked_layout_plain::block_size);
+
+	float sums[tile_width * blocked_layout_plain::block_size];
+	for(int t = 0; t < static_cast<int>(tile_width); ++t)
+		for(int oc = 0; oc < block_size; ++oc)
+			sums[t * block_size + oc] = biases[oc];
+
+	for(int p = 0; p < static_cast<int>(reduction_elem_count); ++p)
+	{
+		for(int t = 0; t < static_cast<int>(tile_width); ++t)
+		{
+			const float in_val = packed_input[t];
+			for(int oc = 0; oc < block_size; ++oc)
+				sums[t * block_size + oc] += in_val * weights[oc];
+		}
+		packed_input += tile_width;
+		weights += block_size;
+	}
+
+	for(int i = 0; i < static_cast<int>(tile_width) * block_size; ++i)
+		output[i] = sums[i];
+}
+
+// A single output position of a single output block, window columns out of the input row are skipped
+void forward_position(
+	const float * input,
+	float * output,
+	const float * weights,
+	const float * biases,
+	const int * input_row_offsets,
+	const int * x_offsets,
+	const int * x_starts,
+	const int * x_ends,
+	unsigned int input_block_count,
+	unsigned int input_block_elem_count,
+	unsigned int window_width,
+	unsigned int window_row_count,
+	int stride_x,
+	int x)
+{
+	const int block_size = static_cast<int>(blocked_layout_plain::block_size);
+
+	float sums[blocked_layout_plain::block_size];
+	for(int oc = 0; oc < block_size; ++oc)
+		sums[oc] = biases[oc];
+
+	for(unsigned int input_block_id = 0; input_block_id < input_block_count; ++input_block_id)
+	{
+		const float * in_block = input + input_block_id * input_block_elem_count;
+		for(unsigned int window_row_id = 0; window_row_id < window_row_count; ++window_row_id)
+		{
+			const int input_row_offset = input_row_offsets[window_row_id];
+			if (input_row_offset < 0)
+				continue;
+
+			const float * in_row = in_block + input_row_offset * block_size;
+			const float * w_row = weights + (input_block_id * window_row_count + window_row_id) * window_width * block_size * block_size;
+			for(unsigned int window_x = 0; window_x < window_width; ++window_x)
+			{
+				if ((x < x_starts[window_x]) || (x >= x_ends[window_x]))
+					continue;
+
+				const float * in_pos = in_row + (x * stride_x + x_offsets[window_x]) * block_size;
+				const float * w = w_row + window_x * block_size * block_size;
+				for(int ic = 0; ic < block_size; ++ic, w += block_size)
+				{
+					const float in_val = in_pos[ic];
+					for(int oc = 0; oc < block_size; ++oc)
+						sums[oc] += in_val * w[oc];
+				}
+			}
+		}
+	}
+
+	for(int oc = 0; oc < block_size; ++oc)
+		output[oc] = sums[oc];
+}
+
+// All the output blocks of a single output row
+void forward_row(
+	const float * input,
+	float * output_row,
+	const float * weights,
+	const float * biases,
+	const int * input_row_offsets,
+	const int * x_offsets,
+	const int * x_starts,
+	const int * x_ends,
+	float * packed_input,
+	unsigned int input_block_count,
+	unsigned int input_block_elem_count,
+	unsigned int output_block_count,
+	unsigned int output_block_elem_count,
+	unsigned int window_width,
+	unsigned int window_row_count,
+	int stride_x,
+	unsigned int output_width,
+	unsigned int interior_x_start,
+	unsigned int interior_x_end)
+{
+	const unsigned int block_size = blocked_layout_plain::block_size;
+	const unsigned int output_block_weight_count = input_block_count * window_row_count * window_width * block_size * block_size;
+
+	// Border positions one by one, the interior in whole tiles, the remainder of the interior one by one again
+	unsigned int x = 0;
+	for(; x < interior_x_start; ++x)
+		for(unsigned int output_block_id = 0; output_block_id < output_block_count; ++output_block_id)
+			forward_position(input, output_row + output_block_id * output_block_elem_count + x * block_size, weights + output_block_id * output_block_weight_count, biases + output_block_id * block_size, input_row_offsets, x_offsets, x_starts, x_ends, input_block_count, input_block_elem_count, window_width, window_row_count, stride_x, static_cast<int>(x));
+	for(; x + tile_width <= interior_x_end; x += tile_width)
+	{
+		pack_tile(input + (static_cast<int>(x) * stride_x + x_offsets[0]) * static_cast<int>(block_size), packed_input, input_row_offsets, input_block_count, input_block_elem_count, window_width, window_row_count, stride_x);
+		for(unsigned int output_block_id = 0; output_block_id < output_block_count; ++output_block_id)
+			forward_tile(packed_input, output_row + output_block_id * output_block_elem_count + x * block_size, weights + output_block_id * output_block_weight_count, biases + output_block_id * block_size, input_block_count * window_row_count * window_width * block_size);
+	}
+	for(; x < output_width; ++x)
+		for(unsigned int output_block_id = 0; output_block_id < output_block_count; ++output_block_id)
+			forward_position(input, output_row + output_block_id * output_block_elem_count + x * block_size, weights + output_block_id * output_block_weight_count, biases + output_block_id * block_size, input_row_offsets, x_offsets, x_starts, x_ends, input_block_count, input_block_elem_count, window_width, window_row_count, stride_x, static_cast<int>(x));
+}
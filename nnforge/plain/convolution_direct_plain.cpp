@@ -0,0 +1,189 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "convolution_direct_plain.h"
+
+#include "instruction_set_plain.h"
+#include "../neural_network_exception.h"
+
+#include <algorithm>
+#include <boost/format.hpp>
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define NNFORGE_PLAIN_TARGET_PRAGMAS
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		namespace convolution_direct_sse2
+		{
+			#include "convolution_direct_plain_kernels.h"
+		}
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+		namespace convolution_direct_avx2
+		{
+			#include "convolution_direct_plain_kernels.h"
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+#endif
+		namespace convolution_direct_avx512
+		{
+			#include "convolution_direct_plain_kernels.h"
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+
+		convolution_direct_plain::convolution_direct_plain(
+			const std::vector<unsigned int>& window_sizes,
+			const std::vector<unsigned int>& left_zero_padding,
+			const std::vector<unsigned int>& strides,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+			: input_feature_map_count(input_configuration_specific.feature_map_count)
+			, output_feature_map_count(output_configuration_specific.feature_map_count)
+			, window_width(window_sizes[0])
+			, window_height((window_sizes.size() > 1) ? window_sizes[1] : 1)
+			, input_width(input_configuration_specific.dimension_sizes[0])
+			, input_height((window_sizes.size() > 1) ? input_configuration_specific.dimension_sizes[1] : 1)
+			, output_width(output_configuration_specific.dimension_sizes[0])
+			, output_height((window_sizes.size() > 1) ? output_configuration_specific.dimension_sizes[1] : 1)
+			, stride_x(static_cast<int>(strides[0]))
+			, stride_y((window_sizes.size() > 1) ? static_cast<int>(strides[1]) : 1)
+			, left_zero_padding_x(static_cast<int>(left_zero_padding[0]))
+			, left_zero_padding_y((window_sizes.size() > 1) ? static_cast<int>(left_zero_padding[1]) : 0)
+		{
+			if (!is_applicable(window_sizes))
+				throw neural_network_exception((boost::format("convolution_direct_plain has no kernel for %1%D window of size %2%") % window_sizes.size() % window_sizes[0]).str());
+
+			interior_x_start = std::min((static_cast<unsigned int>(left_zero_padding_x) + stride_x - 1) / stride_x, output_width);
+			const int last_input_x = static_cast<int>(input_width) + left_zero_padding_x - static_cast<int>(window_width);
+			interior_x_end = (last_input_x >= 0) ? std::min(static_cast<unsigned int>(last_input_x / stride_x + 1), output_width) : 0;
+			interior_x_end = std::max(interior_x_end, interior_x_start);
+		}
+
+		bool convolution_direct_plain::is_applicable(const std::vector<unsigned int>& window_sizes)
+		{
+			switch (window_sizes.size())
+			{
+			case 1:
+				return (window_sizes[0] == 3) || (window_sizes[0] == 5);
+			case 2:
+				return (window_sizes[0] == window_sizes[1]) && ((window_sizes[0] == 3) || (window_sizes[0] == 5));
+			default:
+				return false;
+			}
+		}
+
+		void convolution_direct_plain::forward(
+			const float * input,
+			float * output,
+			const float * weights,
+			const float * biases,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_feature_map_count * input_width * input_height;
+			const unsigned int output_neuron_count_per_feature_map = output_width * output_height;
+			const unsigned int output_feature_map_weight_count = input_feature_map_count * window_width * window_height;
+			const row_kernel_function row_kernel = get_row_kernel(window_width, window_height);
+			// Rows rather than whole feature maps: the direct kernels are used when there are few output feature maps
+			const int total_workload = static_cast<int>(entry_count * output_feature_map_count * output_height);
+
+			#pragma omp parallel for default(none) schedule(guided) num_threads(thread_count) shared(input,output,weights,biases)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				int output_feature_map_row_id = workload_id / output_height;
+				int output_y = workload_id - (output_feature_map_row_id * output_height);
+				int entry_id = output_feature_map_row_id / output_feature_map_count;
+				int output_feature_map_id = output_feature_map_row_id - (entry_id * output_feature_map_count);
+
+				row_kernel(
+					input + entry_id * input_neuron_count,
+					output + output_feature_map_row_id * output_neuron_count_per_feature_map + output_y * output_width,
+					weights + output_feature_map_id * output_feature_map_weight_count,
+					biases[output_feature_map_id],
+					input_feature_map_count,
+					input_width,
+					input_height,
+					output_width,
+					output_y * stride_y - left_zero_padding_y,
+					stride_x,
+					left_zero_padding_x,
+					interior_x_start,
+					interior_x_end);
+			}
+		}
+
+		convolution_direct_plain::row_kernel_function convolution_direct_plain::get_row_kernel(
+			unsigned int window_width,
+			unsigned int window_height)
+		{
+			const unsigned int window_id = window_width * 10 + window_height;
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				switch (window_id)
+				{
+				case 31:
+					return convolution_direct_avx512::forward_row<3, 1>;
+				case 51:
+					return convolution_direct_avx512::forward_row<5, 1>;
+				case 33:
+					return convolution_direct_avx512::forward_row<3, 3>;
+				default:
+					return convolution_direct_avx512::forward_row<5, 5>;
+				}
+			case instruction_set_plain::instruction_set_avx2:
+				switch (window_id)
+				{
+				case 31:
+					return convolution_direct_avx2::forward_row<3, 1>;
+				case 51:
+					return convolution_direct_avx2::forward_row<5, 1>;
+				case 33:
+					return convolution_direct_avx2::forward_row<3, 3>;
+				default:
+					return convolution_direct_avx2::forward_row<5, 5>;
+				}
+			default:
+				switch (window_id)
+				{
+				case 31:
+					return convolution_direct_sse2::forward_row<3, 1>;
+				case 51:
+					return convolution_direct_sse2::forward_row<5, 1>;
+				case 33:
+					return convolution_direct_sse2::forward_row<3, 3>;
+				default:
+					return convolution_direct_sse2::forward_row<5, 5>;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,89 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../layer_configuration_specific.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Direct convolution with kernels instantiated at compile time for the common windows: 3 and 5 in 1D, 3x3 and 5x5 in 2D
+		// Each output row is split into the border positions, where the window is clipped against the input,
+		// and the interior, where the window taps are fully unrolled and there are no bounds checks at all.
+		// Vectorized for SSE2, AVX2 and AVX-512, picked at runtime
+		class convolution_direct_plain
+		{
+		public:
+			convolution_direct_plain(
+				const std::vector<unsigned int>& window_sizes,
+				const std::vector<unsigned int>& left_zero_padding,
+				const std::vector<unsigned int>& strides,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific);
+
+			// Returns true if there is a specialized kernel for the window
+			static bool is_applicable(const std::vector<unsigned int>& window_sizes);
+
+			void forward(
+				const float * input,
+				float * output,
+				const float * weights,
+				const float * biases,
+				unsigned int entry_count,
+				int thread_count) const;
+
+		private:
+			typedef void (*row_kernel_function)(
+				const float * input,
+				float * output_row,
+				const float * weights,
+				float bias,
+				unsigned int input_feature_map_count,
+				unsigned int input_width,
+				unsigned int input_height,
+				unsigned int output_width,
+				int input_y,
+				int stride_x,
+				int left_zero_padding_x,
+				unsigned int interior_x_start,
+				unsigned int interior_x_end);
+
+			static row_kernel_function get_row_kernel(
+				unsigned int window_width,
+				unsigned int window_height);
+
+			unsigned int input_feature_map_count;
+			unsigned int output_feature_map_count;
+			unsigned int window_width;
+			unsigned int window_height;
+			unsigned int input_width;
+			unsigned int input_height;
+			unsigned int output_width;
+			unsigned int output_height;
+			int stride_x;
+			int stride_y;
+			int left_zero_padding_x;
+			int left_zero_padding_y;
+			// Output positions with all the window columns within the input row
+			unsigned int interior_x_start;
+			unsigned int interior_x_end;
+		};
+	}
+}
@@ -0,0 +1,146 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// Bodies of the direct convolution kernels, there is no include guard on purpose:
+// convolution_direct_plain.cpp includes this file once per instruction set, each time within its own namespace and target options.
+// Window sizes are template parameters, so the loops over the window taps have constant trip counts and are fully unrolled.
+
+// Adds the contribution of a single input feature map to output positions [x_start, x_end) with all the window within the input,
+// input_rows points to the first window row at the first of these positions
+template<int window_width, int window_height>
+void accumulate_interior(
+	const float * input_rows,
+	float * output_row,
+	const float * weights,
+	unsigned int input_width,
+	int stride_x,
+	unsigned int x_start,
+	unsigned int x_end)
+{
+	float w[window_height * window_width];
+	for(int i = 0; i < window_height * window_width; ++i)
+		w[i] = weights[i];
+
+	const int position_count = static_cast<int>(x_end) - static_cast<int>(x_start);
+	float * out = output_row + x_start;
+	// Unit stride is the common case, the compiler vectorizes it across the output positions
+	if (stride_x == 1)
+	{
+		for(int i = 0; i < position_count; ++i)
+		{
+			float sum = 0.0F;
+			for(int wy = 0; wy < window_height; ++wy)
+				for(int wx = 0; wx < window_width; ++wx)
+					sum += input_rows[wy * static_cast<int>(input_width) + i + wx] * w[wy * window_width + wx];
+			out[i] += sum;
+		}
+	}
+	else
+	{
+		for(int i = 0; i < position_count; ++i)
+		{
+			float sum = 0.0F;
+			for(int wy = 0; wy < window_height; ++wy)
+				for(int wx = 0; wx < window_width; ++wx)
+					sum += input_rows[wy * static_cast<int>(input_width) + i * stride_x + wx] * w[wy * window_width + wx];
+			out[i] += sum;
+		}
+	}
+}
+
+// Adds the contribution of a single input feature map to output position x, the window is clipped to window rows [wy_start, wy_end)
+// and to the window columns within the input row
+template<int window_width, int window_height>
+void accumulate_border(
+	const float * input_feature_map,
+	float * output_row,
+	const float * weights,
+	unsigned int input_width,
+	int input_y,
+	int wy_start,
+	int wy_end,
+	int stride_x,
+	int left_zero_padding_x,
+	unsigned int x)
+{
+	const int input_x = static_cast<int>(x) * stride_x - left_zero_padding_x;
+	const int wx_start = std::max(-input_x, 0);
+	const int wx_end = std::min(static_cast<int>(input_width) - input_x, window_width);
+
+	float sum = 0.0F;
+	for(int wy = wy_start; wy < wy_end; ++wy)
+	{
+		const float * in_row = input_feature_map + (input_y + wy) * static_cast<int>(input_width) + input_x;
+		for(int wx = wx_start; wx < wx_end; ++wx)
+			sum += in_row[wx] * weights[wy * window_width + wx];
+	}
+	output_row[x] += sum;
+}
+
+// A single output row of a single output feature map, weights are [input feature map][window row][window column]
+// input_y is the input row of the first window row, it is negative when the window starts in the padding area
+template<int window_width, int window_height>
+void forward_row(
+	const float * input,
+	float * output_row,
+	const float * weights,
+	float bias,
+	unsigned int input_feature_map_count,
+	unsigned int input_width,
+	unsigned int input_height,
+	unsigned int output_width,
+	int input_y,
+	int stride_x,
+	int left_zero_padding_x,
+	unsigned int interior_x_start,
+	unsigned int interior_x_end)
+{
+	const int wy_start = std::max(-input_y, 0);
+	const int wy_end = std::min(static_cast<int>(input_height) - input_y, window_height);
+	const bool all_rows_within = (wy_start == 0) && (wy_end == window_height);
+	const unsigned int input_feature_map_elem_count = input_width * input_height;
+
+	for(unsigned int x = 0; x < output_width; ++x)
+		output_row[x] = bias;
+
+	for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count; ++input_feature_map_id)
+	{
+		const float * input_feature_map = input + input_feature_map_id * input_feature_map_elem_count;
+		const float * w = weights + input_feature_map_id * (window_width * window_height);
+
+		if (all_rows_within)
+		{
+			for(unsigned int x = 0; x < interior_x_start; ++x)
+				accumulate_border<window_width, window_height>(input_feature_map, output_row, w, input_width, input_y, 0, window_height, stride_x, left_zero_padding_x, x);
+			if (interior_x_start < interior_x_end)
+				accumulate_interior<window_width, window_height>(
+					input_feature_map + input_y * static_cast<int>(input_width) + static_cast<int>(interior_x_start) * stride_x - left_zero_padding_x,
+					output_row,
+					w,
+					input_width,
+					stride_x,
+					interior_x_start,
+					interior_x_end);
+			for(unsigned int x = interior_x_end; x < output_width; ++x)
+				accumulate_border<window_width, window_height>(input_feature_map, output_row, w, input_width, input_y, 0, window_height, stride_x, left_zero_padding_x, x);
+		}
+		else
+		{
+			for(unsigned int x = 0; x < output_width; ++x)
+				accumulate_border<window_width, window_height>(input_feature_map, output_row, w, input_width, input_y, wy_start, wy_end, stride_x, left_zero_padding_x, x);
+		}
+	}
+}
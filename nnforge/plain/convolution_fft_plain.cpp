@@ -0,0 +1,673 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "convolution_fft_plain.h"
+
+#include "../neural_network_exception.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		const unsigned int convolution_fft_plain::max_dimension_count;
+		const unsigned int convolution_fft_plain::window_elem_count_threshold;
+
+		convolution_fft_plain::convolution_fft_plain(
+			const std::vector<unsigned int>& window_sizes,
+			const std::vector<unsigned int>& left_zero_padding,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+			: input_feature_map_count(input_configuration_specific.feature_map_count)
+			, output_feature_map_count(output_configuration_specific.feature_map_count)
+			, input_neuron_count_per_feature_map(input_configuration_specific.get_neuron_count_per_feature_map())
+			, output_neuron_count_per_feature_map(output_configuration_specific.get_neuron_count_per_feature_map())
+		{
+			const unsigned int dimension_count = static_cast<unsigned int>(window_sizes.size());
+			if (dimension_count > max_dimension_count)
+				throw neural_network_exception("convolution_fft_plain cannot handle more than 4 dimensions");
+
+			window_elem_count = 1;
+			row_count = 1;
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+			{
+				bool used = (i < dimension_count);
+				this->window_sizes[i] = used ? static_cast<int>(window_sizes[i]) : 1;
+				input_sizes[i] = used ? static_cast<int>(input_configuration_specific.dimension_sizes[i]) : 1;
+				output_sizes[i] = used ? static_cast<int>(output_configuration_specific.dimension_sizes[i]) : 1;
+				this->left_zero_padding[i] = used ? static_cast<int>(left_zero_padding[i]) : 0;
+				zero_offsets[i] = 0;
+
+				// The 1st dimension is split in halves for real transforms
+				int fft_size = (i == 0) ? 2 : 1;
+				while (fft_size < output_sizes[i] + this->window_sizes[i] - 1)
+					fft_size <<= 1;
+				fft_sizes[i] = fft_size;
+
+				window_elem_count *= static_cast<unsigned int>(this->window_sizes[i]);
+				if (i > 0)
+					row_count *= static_cast<unsigned int>(fft_size);
+
+				twiddle_re[i].resize(fft_size / 2);
+				twiddle_im[i].resize(fft_size / 2);
+				for(int k = 0; k < fft_size / 2; ++k)
+				{
+					double angle = -2.0 * 3.14159265358979323846 * static_cast<double>(k) / static_cast<double>(fft_size);
+					twiddle_re[i][k] = static_cast<float>(cos(angle));
+					twiddle_im[i][k] = static_cast<float>(sin(angle));
+				}
+
+				bit_reversal[i].resize(fft_size);
+				int bit_count = 0;
+				while ((1 << bit_count) < fft_size)
+					++bit_count;
+				for(int k = 0; k < fft_size; ++k)
+				{
+					unsigned int reversed = 0;
+					for(int b = 0; b < bit_count; ++b)
+						if (k & (1 << b))
+							reversed |= (1U << (bit_count - 1 - b));
+					bit_reversal[i][k] = reversed;
+				}
+			}
+
+			half_size = fft_sizes[0] / 2 + 1;
+			bin_count = half_size * row_count;
+
+			// Spectra of a chunk of entries are kept in a buffer of limited size
+			const unsigned int spectra_buffer_budget = 4 * 1024 * 1024;
+			chunk_entry_count = std::max(spectra_buffer_budget / ((input_feature_map_count + output_feature_map_count) * 2 * bin_count), 1U);
+		}
+
+		bool convolution_fft_plain::is_applicable(
+			const std::vector<unsigned int>& window_sizes,
+			const std::vector<unsigned int>& strides,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+		{
+			if (window_sizes.size() > max_dimension_count)
+				return false;
+			for(std::vector<unsigned int>::const_iterator it = strides.begin(); it != strides.end(); ++it)
+				if (*it != 1)
+					return false;
+
+			unsigned int window_elem_count = 1;
+			for(std::vector<unsigned int>::const_iterator it = window_sizes.begin(); it != window_sizes.end(); ++it)
+				window_elem_count *= *it;
+
+			return (window_elem_count >= window_elem_count_threshold);
+		}
+
+		unsigned int convolution_fft_plain::get_bin_count() const
+		{
+			return bin_count;
+		}
+
+		unsigned int convolution_fft_plain::get_weights_spectrum_elem_count() const
+		{
+			return output_feature_map_count * input_feature_map_count * 2 * bin_count;
+		}
+
+		unsigned int convolution_fft_plain::get_buffer_elem_count() const
+		{
+			return chunk_entry_count * (input_feature_map_count + output_feature_map_count) * 2 * bin_count;
+		}
+
+		unsigned int convolution_fft_plain::get_update_weights_buffer_elem_count() const
+		{
+			return get_buffer_elem_count() + get_weights_spectrum_elem_count();
+		}
+
+		unsigned int convolution_fft_plain::get_temp_elem_count() const
+		{
+			return 2 * static_cast<unsigned int>(*std::max_element(fft_sizes, fft_sizes + max_dimension_count));
+		}
+
+		int convolution_fft_plain::get_row_offset(
+			unsigned int row_id,
+			const int * sizes,
+			const int * offsets) const
+		{
+			int y = static_cast<int>(row_id % fft_sizes[1]) - offsets[1];
+			int z = static_cast<int>((row_id / fft_sizes[1]) % fft_sizes[2]) - offsets[2];
+			int w = static_cast<int>(row_id / (fft_sizes[1] * fft_sizes[2])) - offsets[3];
+			if (((unsigned int)y >= (unsigned int)sizes[1]) || ((unsigned int)z >= (unsigned int)sizes[2]) || ((unsigned int)w >= (unsigned int)sizes[3]))
+				return -1;
+
+			return ((w * sizes[2] + z) * sizes[1] + y) * sizes[0];
+		}
+
+		void convolution_fft_plain::fft(
+			float * re,
+			float * im,
+			unsigned int dimension_id,
+			bool inverse) const
+		{
+			const int n = fft_sizes[dimension_id];
+			const unsigned int * reversal = &(*bit_reversal[dimension_id].begin());
+			for(int i = 0; i < n; ++i)
+			{
+				int j = static_cast<int>(reversal[i]);
+				if (i < j)
+				{
+					std::swap(re[i], re[j]);
+					std::swap(im[i], im[j]);
+				}
+			}
+
+			const float * tw_re = &(*twiddle_re[dimension_id].begin());
+			const float * tw_im = &(*twiddle_im[dimension_id].begin());
+			const float sign = inverse ? -1.0F : 1.0F;
+			for(int len = 2; len <= n; len <<= 1)
+			{
+				int half = len >> 1;
+				int step = n / len;
+				for(int start = 0; start < n; start += len)
+				{
+					for(int k = 0; k < half; ++k)
+					{
+						float w_re = tw_re[k * step];
+						float w_im = sign * tw_im[k * step];
+						int a = start + k;
+						int b = a + half;
+						float t_re = re[b] * w_re - im[b] * w_im;
+						float t_im = re[b] * w_im + im[b] * w_re;
+						re[b] = re[a] - t_re;
+						im[b] = im[a] - t_im;
+						re[a] += t_re;
+						im[a] += t_im;
+					}
+				}
+			}
+		}
+
+		void convolution_fft_plain::forward_transform(
+			const float * src,
+			const int * src_sizes,
+			const int * offsets,
+			float * spectrum,
+			float * temp) const
+		{
+			const int n0 = fft_sizes[0];
+			const unsigned int max_size = get_temp_elem_count() / 2;
+			float * t_re = temp;
+			float * t_im = temp + max_size;
+			float * spectrum_re = spectrum;
+			float * spectrum_im = spectrum + bin_count;
+
+			// Transform pairs of real rows along the 1st dimension as single complex rows
+			for(unsigned int row_id = 0; row_id < row_count; row_id += 2)
+			{
+				int offset_a = get_row_offset(row_id, src_sizes, offsets);
+				int offset_b = (row_id + 1 < row_count) ? get_row_offset(row_id + 1, src_sizes, offsets) : -1;
+				float * a_re = spectrum_re + row_id * half_size;
+				float * a_im = spectrum_im + row_id * half_size;
+				float * b_re = a_re + half_size;
+				float * b_im = a_im + half_size;
+				const bool has_b = (row_id + 1 < row_count);
+
+				if ((offset_a < 0) && (offset_b < 0))
+				{
+					std::fill_n(a_re, half_size, 0.0F);
+					std::fill_n(a_im, half_size, 0.0F);
+					if (has_b)
+					{
+						std::fill_n(b_re, half_size, 0.0F);
+						std::fill_n(b_im, half_size, 0.0F);
+					}
+					continue;
+				}
+
+				std::fill_n(t_re, n0, 0.0F);
+				std::fill_n(t_im, n0, 0.0F);
+				if (offset_a >= 0)
+					std::copy(src + offset_a, src + offset_a + src_sizes[0], t_re + offsets[0]);
+				if (offset_b >= 0)
+					std::copy(src + offset_b, src + offset_b + src_sizes[0], t_im + offsets[0]);
+
+				fft(t_re, t_im, 0, false);
+
+				for(unsigned int k = 0; k < half_size; ++k)
+				{
+					unsigned int nk = (n0 - k) & (n0 - 1);
+					float z_re = t_re[k];
+					float z_im = t_im[k];
+					float n_re = t_re[nk];
+					float n_im = t_im[nk];
+					a_re[k] = 0.5F * (z_re + n_re);
+					a_im[k] = 0.5F * (z_im - n_im);
+					if (has_b)
+					{
+						b_re[k] = 0.5F * (z_im + n_im);
+						b_im[k] = 0.5F * (n_re - z_re);
+					}
+				}
+			}
+
+			unsigned int stride = half_size;
+			for(unsigned int dimension_id = 1; dimension_id < max_dimension_count; ++dimension_id)
+			{
+				const unsigned int n = static_cast<unsigned int>(fft_sizes[dimension_id]);
+				if (n > 1)
+				{
+					const unsigned int outer_count = bin_count / (stride * n);
+					for(unsigned int outer_id = 0; outer_id < outer_count; ++outer_id)
+					{
+						for(unsigned int inner_id = 0; inner_id < stride; ++inner_id)
+						{
+							unsigned int base = outer_id * stride * n + inner_id;
+							for(unsigned int k = 0; k < n; ++k)
+							{
+								t_re[k] = spectrum_re[base + k * stride];
+								t_im[k] = spectrum_im[base + k * stride];
+							}
+							fft(t_re, t_im, dimension_id, false);
+							for(unsigned int k = 0; k < n; ++k)
+							{
+								spectrum_re[base + k * stride] = t_re[k];
+								spectrum_im[base + k * stride] = t_im[k];
+							}
+						}
+					}
+				}
+				stride *= n;
+			}
+		}
+
+		void convolution_fft_plain::inverse_transform(
+			float * spectrum,
+			float * dst,
+			const int * dst_sizes,
+			const int * offsets,
+			float bias,
+			bool accumulate,
+			float * temp) const
+		{
+			const int n0 = fft_sizes[0];
+			const unsigned int max_size = get_temp_elem_count() / 2;
+			float * t_re = temp;
+			float * t_im = temp + max_size;
+			float * spectrum_re = spectrum;
+			float * spectrum_im = spectrum + bin_count;
+			const float scale = 1.0F / static_cast<float>(n0 * row_count);
+
+			unsigned int stride = bin_count;
+			for(unsigned int dimension_id = max_dimension_count - 1; dimension_id > 0; --dimension_id)
+			{
+				const unsigned int n = static_cast<unsigned int>(fft_sizes[dimension_id]);
+				stride /= n;
+				if (n > 1)
+				{
+					const unsigned int outer_count = bin_count / (stride * n);
+					for(unsigned int outer_id = 0; outer_id < outer_count; ++outer_id)
+					{
+						for(unsigned int inner_id = 0; inner_id < stride; ++inner_id)
+						{
+							unsigned int base = outer_id * stride * n + inner_id;
+							for(unsigned int k = 0; k < n; ++k)
+							{
+								t_re[k] = spectrum_re[base + k * stride];
+								t_im[k] = spectrum_im[base + k * stride];
+							}
+							fft(t_re, t_im, dimension_id, true);
+							for(unsigned int k = 0; k < n; ++k)
+							{
+								spectrum_re[base + k * stride] = t_re[k];
+								spectrum_im[base + k * stride] = t_im[k];
+							}
+						}
+					}
+				}
+			}
+
+			for(unsigned int row_id = 0; row_id < row_count; row_id += 2)
+			{
+				int offset_a = get_row_offset(row_id, dst_sizes, offsets);
+				int offset_b = (row_id + 1 < row_count) ? get_row_offset(row_id + 1, dst_sizes, offsets) : -1;
+				if ((offset_a < 0) && (offset_b < 0))
+					continue;
+
+				const float * a_re = spectrum_re + row_id * half_size;
+				const float * a_im = spectrum_im + row_id * half_size;
+				const bool has_b = (row_id + 1 < row_count);
+				const float * b_re = a_re + half_size;
+				const float * b_im = a_im + half_size;
+
+				// Restore full rows from Hermitian symmetry and combine them as real and imaginary parts
+				for(int k = 0; k < n0; ++k)
+				{
+					bool direct = (k < static_cast<int>(half_size));
+					int kk = direct ? k : n0 - k;
+					float sign = direct ? 1.0F : -1.0F;
+					float ar = a_re[kk];
+					float ai = sign * a_im[kk];
+					float br = has_b ? b_re[kk] : 0.0F;
+					float bi = has_b ? sign * b_im[kk] : 0.0F;
+					t_re[k] = ar - bi;
+					t_im[k] = ai + br;
+				}
+
+				fft(t_re, t_im, 0, true);
+
+				for(int pair_id = 0; pair_id < 2; ++pair_id)
+				{
+					int offset = (pair_id == 0) ? offset_a : offset_b;
+					if (offset < 0)
+						continue;
+
+					const float * src = ((pair_id == 0) ? t_re : t_im) + offsets[0];
+					float * d = dst + offset;
+					if (accumulate)
+					{
+						for(int x = 0; x < dst_sizes[0]; ++x)
+							d[x] += src[x] * scale;
+					}
+					else
+					{
+						for(int x = 0; x < dst_sizes[0]; ++x)
+							d[x] = src[x] * scale + bias;
+					}
+				}
+			}
+		}
+
+		void convolution_fft_plain::transform_weights(
+			const float * weights,
+			float * weights_spectrum,
+			int thread_count) const
+		{
+			const unsigned int spectrum_elem_count = 2 * bin_count;
+			const int total_workload = static_cast<int>(output_feature_map_count * input_feature_map_count);
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(weights,weights_spectrum)
+			{
+				std::vector<float> temp(get_temp_elem_count());
+
+				#pragma omp for schedule(dynamic)
+				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+				{
+					forward_transform(
+						weights + workload_id * window_elem_count,
+						window_sizes,
+						zero_offsets,
+						weights_spectrum + workload_id * spectrum_elem_count,
+						&(*temp.begin()));
+				}
+			}
+		}
+
+		void convolution_fft_plain::forward(
+			const float * input,
+			float * output,
+			const float * weights_spectrum,
+			const float * biases,
+			float * buffer,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int spectrum_elem_count = 2 * bin_count;
+			const unsigned int input_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count;
+			const unsigned int output_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count;
+			float * input_spectra = buffer;
+			float * output_spectra = buffer + chunk_entry_count * input_feature_map_count * spectrum_elem_count;
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(input,output,weights_spectrum,biases,input_spectra,output_spectra,entry_count)
+			{
+				std::vector<float> temp(get_temp_elem_count());
+
+				for(unsigned int chunk_start = 0; chunk_start < entry_count; chunk_start += chunk_entry_count)
+				{
+					const unsigned int current_entry_count = std::min(chunk_entry_count, entry_count - chunk_start);
+
+					const int input_workload = static_cast<int>(current_entry_count * input_feature_map_count);
+					#pragma omp for schedule(dynamic)
+					for(int workload_id = 0; workload_id < input_workload; ++workload_id)
+					{
+						int entry_id = workload_id / input_feature_map_count;
+						int input_feature_map_id = workload_id - entry_id * input_feature_map_count;
+						forward_transform(
+							input + (chunk_start + entry_id) * input_neuron_count + input_feature_map_id * input_neuron_count_per_feature_map,
+							input_sizes,
+							left_zero_padding,
+							input_spectra + workload_id * spectrum_elem_count,
+							&(*temp.begin()));
+					}
+
+					// Y = sum over input feature maps of X * conj(W)
+					#pragma omp for schedule(dynamic)
+					for(int output_feature_map_id = 0; output_feature_map_id < static_cast<int>(output_feature_map_count); ++output_feature_map_id)
+					{
+						for(unsigned int entry_id = 0; entry_id < current_entry_count; ++entry_id)
+							std::fill_n(output_spectra + (entry_id * output_feature_map_count + output_feature_map_id) * spectrum_elem_count, spectrum_elem_count, 0.0F);
+
+						for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count; ++input_feature_map_id)
+						{
+							const float * w_re = weights_spectrum + (output_feature_map_id * input_feature_map_count + input_feature_map_id) * spectrum_elem_count;
+							const float * w_im = w_re + bin_count;
+							for(unsigned int entry_id = 0; entry_id < current_entry_count; ++entry_id)
+							{
+								const float * x_re = input_spectra + (entry_id * input_feature_map_count + input_feature_map_id) * spectrum_elem_count;
+								const float * x_im = x_re + bin_count;
+								float * y_re = output_spectra + (entry_id * output_feature_map_count + output_feature_map_id) * spectrum_elem_count;
+								float * y_im = y_re + bin_count;
+								for(unsigned int bin_id = 0; bin_id < bin_count; ++bin_id)
+								{
+									y_re[bin_id] += x_re[bin_id] * w_re[bin_id] + x_im[bin_id] * w_im[bin_id];
+									y_im[bin_id] += x_im[bin_id] * w_re[bin_id] - x_re[bin_id] * w_im[bin_id];
+								}
+							}
+						}
+					}
+
+					const int output_workload = static_cast<int>(current_entry_count * output_feature_map_count);
+					#pragma omp for schedule(dynamic)
+					for(int workload_id = 0; workload_id < output_workload; ++workload_id)
+					{
+						int entry_id = workload_id / output_feature_map_count;
+						int output_feature_map_id = workload_id - entry_id * output_feature_map_count;
+						inverse_transform(
+							output_spectra + workload_id * spectrum_elem_count,
+							output + (chunk_start + entry_id) * output_neuron_count + output_feature_map_id * output_neuron_count_per_feature_map,
+							output_sizes,
+							zero_offsets,
+							biases ? biases[output_feature_map_id] : 0.0F,
+							false,
+							&(*temp.begin()));
+					}
+				}
+			}
+		}
+
+		void convolution_fft_plain::backprop(
+			const float * output_errors,
+			float * input_errors,
+			const float * weights_spectrum,
+			float * buffer,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int spectrum_elem_count = 2 * bin_count;
+			const unsigned int input_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count;
+			const unsigned int output_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count;
+			float * output_spectra = buffer;
+			float * input_spectra = buffer + chunk_entry_count * output_feature_map_count * spectrum_elem_count;
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(output_errors,input_errors,weights_spectrum,input_spectra,output_spectra,entry_count)
+			{
+				std::vector<float> temp(get_temp_elem_count());
+
+				for(unsigned int chunk_start = 0; chunk_start < entry_count; chunk_start += chunk_entry_count)
+				{
+					const unsigned int current_entry_count = std::min(chunk_entry_count, entry_count - chunk_start);
+
+					const int output_workload = static_cast<int>(current_entry_count * output_feature_map_count);
+					#pragma omp for schedule(dynamic)
+					for(int workload_id = 0; workload_id < output_workload; ++workload_id)
+					{
+						int entry_id = workload_id / output_feature_map_count;
+						int output_feature_map_id = workload_id - entry_id * output_feature_map_count;
+						forward_transform(
+							output_errors + (chunk_start + entry_id) * output_neuron_count + output_feature_map_id * output_neuron_count_per_feature_map,
+							output_sizes,
+							zero_offsets,
+							output_spectra + workload_id * spectrum_elem_count,
+							&(*temp.begin()));
+					}
+
+					// Input errors are the full convolution of output errors with the window: X = sum over output feature maps of E * W
+					#pragma omp for schedule(dynamic)
+					for(int input_feature_map_id = 0; input_feature_map_id < static_cast<int>(input_feature_map_count); ++input_feature_map_id)
+					{
+						for(unsigned int entry_id = 0; entry_id < current_entry_count; ++entry_id)
+							std::fill_n(input_spectra + (entry_id * input_feature_map_count + input_feature_map_id) * spectrum_elem_count, spectrum_elem_count, 0.0F);
+
+						for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+						{
+							const float * w_re = weights_spectrum + (output_feature_map_id * input_feature_map_count + input_feature_map_id) * spectrum_elem_count;
+							const float * w_im = w_re + bin_count;
+							for(unsigned int entry_id = 0; entry_id < current_entry_count; ++entry_id)
+							{
+								const float * e_re = output_spectra + (entry_id * output_feature_map_count + output_feature_map_id) * spectrum_elem_count;
+								const float * e_im = e_re + bin_count;
+								float * x_re = input_spectra + (entry_id * input_feature_map_count + input_feature_map_id) * spectrum_elem_count;
+								float * x_im = x_re + bin_count;
+								for(unsigned int bin_id = 0; bin_id < bin_count; ++bin_id)
+								{
+									x_re[bin_id] += e_re[bin_id] * w_re[bin_id] - e_im[bin_id] * w_im[bin_id];
+									x_im[bin_id] += e_re[bin_id] * w_im[bin_id] + e_im[bin_id] * w_re[bin_id];
+								}
+							}
+						}
+					}
+
+					const int input_workload = static_cast<int>(current_entry_count * input_feature_map_count);
+					#pragma omp for schedule(dynamic)
+					for(int workload_id = 0; workload_id < input_workload; ++workload_id)
+					{
+						int entry_id = workload_id / input_feature_map_count;
+						int input_feature_map_id = workload_id - entry_id * input_feature_map_count;
+						inverse_transform(
+							input_spectra + workload_id * spectrum_elem_count,
+							input_errors + (chunk_start + entry_id) * input_neuron_count + input_feature_map_id * input_neuron_count_per_feature_map,
+							input_sizes,
+							left_zero_padding,
+							0.0F,
+							false,
+							&(*temp.begin()));
+					}
+				}
+			}
+		}
+
+		void convolution_fft_plain::update_weights(
+			const float * input,
+			const float * output_errors,
+			float * gradient_weights,
+			float * buffer,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int spectrum_elem_count = 2 * bin_count;
+			const unsigned int input_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count;
+			const unsigned int output_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count;
+			const unsigned int feature_map_pair_count = output_feature_map_count * input_feature_map_count;
+			float * input_spectra = buffer;
+			float * output_spectra = input_spectra + chunk_entry_count * input_feature_map_count * spectrum_elem_count;
+			float * gradient_spectra = output_spectra + chunk_entry_count * output_feature_map_count * spectrum_elem_count;
+			std::fill_n(gradient_spectra, feature_map_pair_count * spectrum_elem_count, 0.0F);
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(input,output_errors,gradient_weights,input_spectra,output_spectra,gradient_spectra,entry_count)
+			{
+				std::vector<float> temp(get_temp_elem_count());
+
+				for(unsigned int chunk_start = 0; chunk_start < entry_count; chunk_start += chunk_entry_count)
+				{
+					const unsigned int current_entry_count = std::min(chunk_entry_count, entry_count - chunk_start);
+
+					const int transform_workload = static_cast<int>(current_entry_count * (input_feature_map_count + output_feature_map_count));
+					#pragma omp for schedule(dynamic)
+					for(int workload_id = 0; workload_id < transform_workload; ++workload_id)
+					{
+						if (workload_id < static_cast<int>(current_entry_count * input_feature_map_count))
+						{
+							int entry_id = workload_id / input_feature_map_count;
+							int input_feature_map_id = workload_id - entry_id * input_feature_map_count;
+							forward_transform(
+								input + (chunk_start + entry_id) * input_neuron_count + input_feature_map_id * input_neuron_count_per_feature_map,
+								input_sizes,
+								left_zero_padding,
+								input_spectra + workload_id * spectrum_elem_count,
+								&(*temp.begin()));
+						}
+						else
+						{
+							int output_workload_id = workload_id - static_cast<int>(current_entry_count * input_feature_map_count);
+							int entry_id = output_workload_id / output_feature_map_count;
+							int output_feature_map_id = output_workload_id - entry_id * output_feature_map_count;
+							forward_transform(
+								output_errors + (chunk_start + entry_id) * output_neuron_count + output_feature_map_id * output_neuron_count_per_feature_map,
+								output_sizes,
+								zero_offsets,
+								output_spectra + output_workload_id * spectrum_elem_count,
+								&(*temp.begin()));
+						}
+					}
+
+					// dW = sum over entries of X * conj(E)
+					#pragma omp for schedule(dynamic)
+					for(int feature_map_pair_id = 0; feature_map_pair_id < static_cast<int>(feature_map_pair_count); ++feature_map_pair_id)
+					{
+						int output_feature_map_id = feature_map_pair_id / input_feature_map_count;
+						int input_feature_map_id = feature_map_pair_id - output_feature_map_id * input_feature_map_count;
+						float * g_re = gradient_spectra + feature_map_pair_id * spectrum_elem_count;
+						float * g_im = g_re + bin_count;
+						for(unsigned int entry_id = 0; entry_id < current_entry_count; ++entry_id)
+						{
+							const float * x_re = input_spectra + (entry_id * input_feature_map_count + input_feature_map_id) * spectrum_elem_count;
+							const float * x_im = x_re + bin_count;
+							const float * e_re = output_spectra + (entry_id * output_feature_map_count + output_feature_map_id) * spectrum_elem_count;
+							const float * e_im = e_re + bin_count;
+							for(unsigned int bin_id = 0; bin_id < bin_count; ++bin_id)
+							{
+								g_re[bin_id] += x_re[bin_id] * e_re[bin_id] + x_im[bin_id] * e_im[bin_id];
+								g_im[bin_id] += x_im[bin_id] * e_re[bin_id] - x_re[bin_id] * e_im[bin_id];
+							}
+						}
+					}
+				}
+
+				#pragma omp for schedule(dynamic)
+				for(int feature_map_pair_id = 0; feature_map_pair_id < static_cast<int>(feature_map_pair_count); ++feature_map_pair_id)
+				{
+					inverse_transform(
+						gradient_spectra + feature_map_pair_id * spectrum_elem_count,
+						gradient_weights + feature_map_pair_id * window_elem_count,
+						window_sizes,
+						zero_offsets,
+						0.0F,
+						true,
+						&(*temp.begin()));
+				}
+			}
+		}
+	}
+}
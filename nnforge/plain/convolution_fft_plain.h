@@ -0,0 +1,153 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../layer_configuration_specific.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Convolution via multidimensional FFT, for layers with large windows
+		// Each feature map is zero padded to power-of-2 sizes, at least output size + window size - 1 in each dimension,
+		// so that circular correlation equals the linear one. Spectra are stored as half spectra along the 1st dimension
+		// (the data is real), split into real and imaginary planes of get_bin_count() elements each.
+		// Feature maps of several entries are transformed at once, so that weight spectra are reused across entries
+		class convolution_fft_plain
+		{
+		public:
+			convolution_fft_plain(
+				const std::vector<unsigned int>& window_sizes,
+				const std::vector<unsigned int>& left_zero_padding,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific);
+
+			// Returns true if strides are 1 and the window is large enough for FFT to beat direct and im2col approaches
+			static bool is_applicable(
+				const std::vector<unsigned int>& window_sizes,
+				const std::vector<unsigned int>& strides,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific);
+
+			unsigned int get_bin_count() const;
+
+			unsigned int get_weights_spectrum_elem_count() const;
+
+			// The size of the scratch buffer shared by all the threads running forward and backprop
+			unsigned int get_buffer_elem_count() const;
+
+			// The size of the scratch buffer shared by all the threads running update_weights
+			unsigned int get_update_weights_buffer_elem_count() const;
+
+			// weights are output_feature_map_count x input_feature_map_count x window
+			void transform_weights(
+				const float * weights,
+				float * weights_spectrum,
+				int thread_count) const;
+
+			void forward(
+				const float * input,
+				float * output,
+				const float * weights_spectrum,
+				const float * biases,
+				float * buffer,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			void backprop(
+				const float * output_errors,
+				float * input_errors,
+				const float * weights_spectrum,
+				float * buffer,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// Gradient is added to gradient_weights, biases are not touched
+			void update_weights(
+				const float * input,
+				const float * output_errors,
+				float * gradient_weights,
+				float * buffer,
+				unsigned int entry_count,
+				int thread_count) const;
+
+		private:
+			// In-place unnormalized complex FFT of fft_sizes[dimension_id] elements
+			void fft(
+				float * re,
+				float * im,
+				unsigned int dimension_id,
+				bool inverse) const;
+
+			// Places real src of src_sizes at offsets into zero grid and computes its spectrum
+			// temp should have get_temp_elem_count() elements
+			void forward_transform(
+				const float * src,
+				const int * src_sizes,
+				const int * offsets,
+				float * spectrum,
+				float * temp) const;
+
+			// Computes inverse transform of the spectrum, destroying it, and writes dst_sizes region of the grid at offsets
+			// into dst as val * scale + bias, adding to dst if accumulate is true
+			void inverse_transform(
+				float * spectrum,
+				float * dst,
+				const int * dst_sizes,
+				const int * offsets,
+				float bias,
+				bool accumulate,
+				float * temp) const;
+
+			unsigned int get_temp_elem_count() const;
+
+			// Returns the offset of the row of the grid in the array of sizes placed at offsets, -1 if the row is outside of the array
+			int get_row_offset(
+				unsigned int row_id,
+				const int * sizes,
+				const int * offsets) const;
+
+			static const unsigned int max_dimension_count = 4;
+
+			// Window volume starting from which FFT is used
+			static const unsigned int window_elem_count_threshold = 81;
+
+			unsigned int input_feature_map_count;
+			unsigned int output_feature_map_count;
+			unsigned int input_neuron_count_per_feature_map;
+			unsigned int output_neuron_count_per_feature_map;
+			unsigned int window_elem_count;
+			unsigned int bin_count;
+			unsigned int half_size;
+			unsigned int row_count;
+			unsigned int chunk_entry_count;
+
+			int fft_sizes[max_dimension_count];
+			int window_sizes[max_dimension_count];
+			int input_sizes[max_dimension_count];
+			int output_sizes[max_dimension_count];
+			int left_zero_padding[max_dimension_count];
+			int zero_offsets[max_dimension_count];
+
+			std::vector<float> twiddle_re[max_dimension_count];
+			std::vector<float> twiddle_im[max_dimension_count];
+			std::vector<unsigned int> bit_reversal[max_dimension_count];
+		};
+	}
+}
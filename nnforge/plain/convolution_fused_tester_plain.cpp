@@ -0,0 +1,199 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "convolution_fused_tester_plain.h"
+
+#include "activation_plain.h"
+#include "subsampling_plain.h"
+#include "../convolution_layer.h"
+#include "../hyperbolic_tangent_layer.h"
+#include "../absolute_layer.h"
+#include "../sigmoid_layer.h"
+#include "../rectified_linear_layer.h"
+#include "../average_subsampling_layer.h"
+#include "../nn_types.h"
+
+#include <algorithm>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		const unsigned int convolution_fused_tester_plain::cache_elem_count_per_thread;
+
+		convolution_fused_tester_plain::convolution_fused_tester_plain(
+			const_layer_list::const_iterator layer_it,
+			unsigned int fused_layer_count)
+			: convolution_layer_schema(*layer_it)
+			, fused_layer_count(fused_layer_count)
+		{
+			for(const_layer_list::const_iterator it = layer_it + 1; it != layer_it + 1 + fused_layer_count; ++it)
+			{
+				activation_type type;
+				if (get_activation_type((*it)->get_uuid(), type))
+					activation_list.push_back(type);
+				else
+					subsampling_sizes = nnforge_dynamic_pointer_cast<const average_subsampling_layer>(*it)->subsampling_sizes;
+			}
+		}
+
+		convolution_fused_tester_plain::~convolution_fused_tester_plain()
+		{
+		}
+
+		unsigned int convolution_fused_tester_plain::get_fused_layer_count(
+			const_layer_list::const_iterator layer_it,
+			const_layer_list::const_iterator layer_end_it)
+		{
+			if ((*layer_it)->get_uuid() != convolution_layer::layer_guid)
+				return 0;
+
+			unsigned int res = 0;
+			for(const_layer_list::const_iterator it = layer_it + 1; it != layer_end_it; ++it)
+			{
+				activation_type type;
+				if (get_activation_type((*it)->get_uuid(), type))
+				{
+					++res;
+					continue;
+				}
+
+				if ((*it)->get_uuid() == average_subsampling_layer::layer_guid)
+					++res;
+				break;
+			}
+
+			return res;
+		}
+
+		unsigned int convolution_fused_tester_plain::get_fused_layer_count() const
+		{
+			return fused_layer_count;
+		}
+
+		bool convolution_fused_tester_plain::get_activation_type(
+			const boost::uuids::uuid& layer_guid,
+			activation_type& type)
+		{
+			if (layer_guid == hyperbolic_tangent_layer::layer_guid)
+				type = activation_hyperbolic_tangent;
+			else if (layer_guid == absolute_layer::layer_guid)
+				type = activation_absolute;
+			else if (layer_guid == sigmoid_layer::layer_guid)
+				type = activation_sigmoid;
+			else if (layer_guid == rectified_linear_layer::layer_guid)
+				type = activation_rectified_linear;
+			else
+				return false;
+
+			return true;
+		}
+
+		void convolution_fused_tester_plain::apply_activations(
+			float * data,
+			unsigned int elem_count) const
+		{
+			for(std::vector<activation_type>::const_iterator it = activation_list.begin(); it != activation_list.end(); ++it)
+			{
+				switch (*it)
+				{
+				case activation_hyperbolic_tangent:
+					activation_plain::hyperbolic_tangent(data, data, elem_count, hyperbolic_tangent_layer::steepness, hyperbolic_tangent_layer::major_multiplier);
+					break;
+				case activation_absolute:
+					activation_plain::absolute(data, data, elem_count);
+					break;
+				case activation_sigmoid:
+					activation_plain::sigmoid(data, data, elem_count);
+					break;
+				case activation_rectified_linear:
+					activation_plain::rectified_linear(data, data, elem_count);
+					break;
+				}
+			}
+		}
+
+		void convolution_fused_tester_plain::test(
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_set& convolution_additional_buffers,
+			additional_buffer_smart_ptr output_buffer,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_data_smart_ptr convolution_data,
+			layer_configuration_specific_list::const_iterator input_config_it,
+			unsigned int entry_count) const
+		{
+			const layer_configuration_specific& input_configuration_specific = *input_config_it;
+			const layer_configuration_specific& convolution_output_configuration_specific = *(input_config_it + 1);
+			const layer_configuration_specific& output_configuration_specific = *(input_config_it + 1 + fused_layer_count);
+			const unsigned int input_neuron_count = input_configuration_specific.get_neuron_count();
+			const unsigned int convolution_output_neuron_count = convolution_output_configuration_specific.get_neuron_count();
+			const unsigned int convolution_output_neuron_count_per_feature_map = convolution_output_configuration_specific.get_neuron_count_per_feature_map();
+			const unsigned int output_neuron_count = output_configuration_specific.get_neuron_count();
+			const unsigned int output_neuron_count_per_feature_map = output_configuration_specific.get_neuron_count_per_feature_map();
+			const unsigned int feature_map_count = convolution_output_configuration_specific.feature_map_count;
+			const bool subsampling = !subsampling_sizes.empty();
+			const int thread_count = plain_config->openmp_thread_count;
+
+			const float * const input = &(*input_buffer->begin());
+			float * const convolution_output = &(*convolution_additional_buffers[0]->begin());
+			float * const scratch = (convolution_additional_buffers.size() > 1) ? &(*convolution_additional_buffers[1]->begin()) : 0;
+			float * const output = &(*output_buffer->begin());
+
+			const unsigned int group_entry_count = std::min(entry_count, std::max(1U, (cache_elem_count_per_thread * thread_count) / convolution_output_neuron_count));
+
+			nnforge_shared_ptr<subsampling_plain> average_subsampling;
+			if (subsampling)
+				average_subsampling = nnforge_shared_ptr<subsampling_plain>(new subsampling_plain(subsampling_sizes, convolution_output_configuration_specific, output_configuration_specific));
+			const subsampling_plain * const average_subsampling_ptr = average_subsampling.get();
+
+			for(unsigned int group_start = 0; group_start < entry_count; group_start += group_entry_count)
+			{
+				const unsigned int current_entry_count = std::min(group_entry_count, entry_count - group_start);
+
+				// With subsampling the convolution output is consumed right away, so the same part of the buffer is reused by all the groups
+				float * const group_convolution_output = subsampling ? convolution_output : (convolution_output + group_start * convolution_output_neuron_count);
+				float * const group_output = output + group_start * output_neuron_count;
+
+				convolution_tester.forward(
+					input + group_start * input_neuron_count,
+					group_convolution_output,
+					scratch,
+					plain_config,
+					convolution_layer_schema,
+					convolution_data,
+					input_configuration_specific,
+					convolution_output_configuration_specific,
+					current_entry_count);
+
+				const int total_workload = static_cast<int>(current_entry_count * feature_map_count);
+				#pragma omp parallel for default(none) schedule(static) num_threads(thread_count)
+				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+				{
+					int entry_id = workload_id / feature_map_count;
+					int feature_map_id = workload_id - (entry_id * feature_map_count);
+
+					float * in_it_base = group_convolution_output + (entry_id * convolution_output_neuron_count) + (feature_map_id * convolution_output_neuron_count_per_feature_map);
+					apply_activations(in_it_base, convolution_output_neuron_count_per_feature_map);
+
+					if (subsampling)
+						average_subsampling_ptr->average_forward_feature_map(
+							in_it_base,
+							group_output + (entry_id * output_neuron_count) + (feature_map_id * output_neuron_count_per_feature_map));
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,96 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "convolution_layer_tester_plain.h"
+#include "../layer_configuration_specific.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Convolution followed by elementwise activations (hyperbolic tangent, absolute, sigmoid, rectified linear)
+		// and optionally by average subsampling, run by network_tester_plain in place of the separate layer testers.
+		// Convolution is computed for a group of entries small enough for its output to stay in cache,
+		// activations and subsampling are applied to the group right away, so the intermediate results
+		// are not written to memory and read back by each of the layers
+		class convolution_fused_tester_plain
+		{
+		public:
+			// Returns the number of layers following the convolution layer at layer_it which can be fused with it, 0 if none
+			static unsigned int get_fused_layer_count(
+				const_layer_list::const_iterator layer_it,
+				const_layer_list::const_iterator layer_end_it);
+
+			// layer_it should point to the convolution layer
+			convolution_fused_tester_plain(
+				const_layer_list::const_iterator layer_it,
+				unsigned int fused_layer_count);
+
+			~convolution_fused_tester_plain();
+
+			unsigned int get_fused_layer_count() const;
+
+			// convolution_additional_buffers are the ones allocated by the convolution layer tester,
+			// output_buffer is the output buffer of the last fused layer
+			// input_config_it should point to the input configuration of the convolution layer
+			void test(
+				additional_buffer_smart_ptr input_buffer,
+				additional_buffer_set& convolution_additional_buffers,
+				additional_buffer_smart_ptr output_buffer,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_data_smart_ptr convolution_data,
+				layer_configuration_specific_list::const_iterator input_config_it,
+				unsigned int entry_count) const;
+
+		private:
+			convolution_fused_tester_plain(const convolution_fused_tester_plain&);
+			convolution_fused_tester_plain& operator =(const convolution_fused_tester_plain&);
+
+			enum activation_type
+			{
+				activation_hyperbolic_tangent,
+				activation_absolute,
+				activation_sigmoid,
+				activation_rectified_linear
+			};
+
+			static bool get_activation_type(
+				const boost::uuids::uuid& layer_guid,
+				activation_type& type);
+
+			// Applies all the activations in order, in place
+			void apply_activations(
+				float * data,
+				unsigned int elem_count) const;
+
+			const_layer_smart_ptr convolution_layer_schema;
+			unsigned int fused_layer_count;
+			std::vector<activation_type> activation_list;
+			// Empty when the chain doesn't end with average subsampling
+			std::vector<unsigned int> subsampling_sizes;
+			convolution_layer_tester_plain convolution_tester;
+
+			// Number of convolution output elements per thread processed in one group
+			static const unsigned int cache_elem_count_per_thread = 65536;
+		};
+
+		typedef nnforge_shared_ptr<const convolution_fused_tester_plain> const_convolution_fused_tester_plain_smart_ptr;
+	}
+}
@@ -0,0 +1,529 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "convolution_gemm_plain.h"
+
+#include "gemm_plain.h"
+#include "../neural_network_exception.h"
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		const int convolution_gemm_plain::max_dimension_count;
+
+		convolution_gemm_plain::convolution_gemm_plain(
+			const std::vector<unsigned int>& window_sizes,
+			const std::vector<unsigned int>& left_zero_padding,
+			const std::vector<unsigned int>& strides,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+			: input_feature_map_count(input_configuration_specific.feature_map_count)
+			, output_feature_map_count(output_configuration_specific.feature_map_count)
+			, input_neuron_count_per_feature_map(input_configuration_specific.get_neuron_count_per_feature_map())
+			, output_neuron_count_per_feature_map(output_configuration_specific.get_neuron_count_per_feature_map())
+		{
+			const unsigned int dimension_count = static_cast<unsigned int>(window_sizes.size());
+			if (dimension_count > max_dimension_count)
+				throw neural_network_exception("convolution_gemm_plain cannot handle more than 4 dimensions");
+
+			int window_sizes_extended[max_dimension_count];
+			int slice = 1;
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+			{
+				bool used = (i < dimension_count);
+				window_sizes_extended[i] = used ? static_cast<int>(window_sizes[i]) : 1;
+				input_dimension_sizes[i] = used ? static_cast<int>(input_configuration_specific.dimension_sizes[i]) : 1;
+				output_dimension_sizes[i] = used ? static_cast<int>(output_configuration_specific.dimension_sizes[i]) : 1;
+				this->left_zero_padding[i] = (used && (i < left_zero_padding.size())) ? static_cast<int>(left_zero_padding[i]) : 0;
+				this->strides[i] = (used && (i < strides.size())) ? static_cast<int>(strides[i]) : 1;
+				input_slices[i] = slice;
+				slice *= input_dimension_sizes[i];
+			}
+
+			window_elem_count = 1;
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+				window_elem_count *= static_cast<unsigned int>(window_sizes_extended[i]);
+			column_height = window_elem_count * input_feature_map_count;
+
+			window_positions.resize(window_elem_count * max_dimension_count);
+			std::vector<int>::iterator window_positions_it = window_positions.begin();
+			for(int w = 0; w < window_sizes_extended[3]; ++w)
+				for(int z = 0; z < window_sizes_extended[2]; ++z)
+					for(int y = 0; y < window_sizes_extended[1]; ++y)
+						for(int x = 0; x < window_sizes_extended[0]; ++x)
+						{
+							*(window_positions_it++) = x;
+							*(window_positions_it++) = y;
+							*(window_positions_it++) = z;
+							*(window_positions_it++) = w;
+						}
+
+			// Keep the unfolded block within L2 cache
+			const unsigned int column_buffer_budget = 64 * 1024;
+			block_size = std::max(column_buffer_budget / std::max(column_height, 1U), gemm_plain::nr);
+			block_size = std::min((block_size / gemm_plain::nr) * gemm_plain::nr, gemm_plain::nc);
+			block_size = std::min(block_size, output_neuron_count_per_feature_map);
+		}
+
+		bool convolution_gemm_plain::is_efficient() const
+		{
+			return (output_feature_map_count >= 4) && (column_height >= 8);
+		}
+
+		unsigned int convolution_gemm_plain::get_column_height() const
+		{
+			return column_height;
+		}
+
+		unsigned int convolution_gemm_plain::get_block_size() const
+		{
+			return block_size;
+		}
+
+		unsigned int convolution_gemm_plain::get_column_buffer_elem_count() const
+		{
+			return column_height * block_size + get_gemm_workspace_elem_count();
+		}
+
+		unsigned int convolution_gemm_plain::get_gemm_workspace_elem_count() const
+		{
+			return std::max(
+				std::max(
+					gemm_plain::get_workspace_elem_count(output_feature_map_count, block_size, column_height),
+					gemm_plain::get_workspace_elem_count(column_height, block_size, output_feature_map_count)),
+				gemm_plain::get_workspace_elem_count(output_feature_map_count, column_height, block_size));
+		}
+
+		void convolution_gemm_plain::fill_runs(
+			std::vector<output_run>& runs,
+			unsigned int output_position_start,
+			unsigned int output_position_count) const
+		{
+			int current_output_position[max_dimension_count];
+			unsigned int remainder = output_position_start;
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+			{
+				current_output_position[i] = static_cast<int>(remainder % static_cast<unsigned int>(output_dimension_sizes[i]));
+				remainder /= static_cast<unsigned int>(output_dimension_sizes[i]);
+			}
+
+			runs.clear();
+			unsigned int column_offset = 0;
+			while (column_offset < output_position_count)
+			{
+				output_run run;
+				run.column_offset = column_offset;
+				run.length = std::min(output_position_count - column_offset, static_cast<unsigned int>(output_dimension_sizes[0] - current_output_position[0]));
+				for(unsigned int i = 0; i < max_dimension_count; ++i)
+					run.input_position[i] = current_output_position[i] * strides[i] - left_zero_padding[i];
+				runs.push_back(run);
+
+				column_offset += run.length;
+				current_output_position[0] = 0;
+				for(unsigned int i = 1; i < max_dimension_count; ++i)
+				{
+					if ((++current_output_position[i]) < output_dimension_sizes[i])
+						break;
+					current_output_position[i] = 0;
+				}
+			}
+		}
+
+		void convolution_gemm_plain::get_valid_range(
+			int x,
+			int length,
+			int& valid_start,
+			int& valid_end) const
+		{
+			// Run element i reads input x + i * stride, the range of i for which it is within the input
+			const int stride_x = strides[0];
+			valid_start = std::min(std::max((stride_x - 1 - x) / stride_x, 0), length);
+			valid_end = std::max(std::min((input_dimension_sizes[0] - x + stride_x - 1) / stride_x, length), valid_start);
+		}
+
+		void convolution_gemm_plain::unfold(
+			const float * input,
+			float * columns,
+			unsigned int output_position_start,
+			unsigned int output_position_count) const
+		{
+			std::vector<output_run> runs;
+			fill_runs(runs, output_position_start, output_position_count);
+
+			float * dst_row = columns;
+			for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count; ++input_feature_map_id)
+			{
+				const float * in_feature_map = input + input_feature_map_id * input_neuron_count_per_feature_map;
+				std::vector<int>::const_iterator window_position_it = window_positions.begin();
+				for(unsigned int window_elem_id = 0; window_elem_id < window_elem_count; ++window_elem_id, window_position_it += max_dimension_count, dst_row += output_position_count)
+				{
+					for(std::vector<output_run>::const_iterator run_it = runs.begin(); run_it != runs.end(); ++run_it)
+					{
+						float * dst = dst_row + run_it->column_offset;
+						const int length = static_cast<int>(run_it->length);
+
+						int y = run_it->input_position[1] + window_position_it[1];
+						int z = run_it->input_position[2] + window_position_it[2];
+						int w = run_it->input_position[3] + window_position_it[3];
+						if (((unsigned int)y >= (unsigned int)input_dimension_sizes[1])
+							|| ((unsigned int)z >= (unsigned int)input_dimension_sizes[2])
+							|| ((unsigned int)w >= (unsigned int)input_dimension_sizes[3]))
+						{
+							std::fill_n(dst, length, 0.0F);
+							continue;
+						}
+
+						int x = run_it->input_position[0] + window_position_it[0];
+						int valid_start;
+						int valid_end;
+						get_valid_range(x, length, valid_start, valid_end);
+						const float * src = in_feature_map + (w * input_slices[3] + z * input_slices[2] + y * input_slices[1] + x);
+
+						std::fill(dst, dst + valid_start, 0.0F);
+						if (strides[0] == 1)
+							std::copy(src + valid_start, src + valid_end, dst + valid_start);
+						else
+						{
+							const int stride_x = strides[0];
+							for(int i = valid_start; i < valid_end; ++i)
+								dst[i] = src[i * stride_x];
+						}
+						std::fill(dst + valid_end, dst + length, 0.0F);
+					}
+				}
+			}
+		}
+
+		void convolution_gemm_plain::fold(
+			const float * columns,
+			float * input,
+			unsigned int output_position_start,
+			unsigned int output_position_count,
+			unsigned int input_feature_map_id) const
+		{
+			std::vector<output_run> runs;
+			fill_runs(runs, output_position_start, output_position_count);
+
+			float * in_feature_map = input + input_feature_map_id * input_neuron_count_per_feature_map;
+			const float * src_row = columns + input_feature_map_id * window_elem_count * output_position_count;
+			std::vector<int>::const_iterator window_position_it = window_positions.begin();
+			for(unsigned int window_elem_id = 0; window_elem_id < window_elem_count; ++window_elem_id, window_position_it += max_dimension_count, src_row += output_position_count)
+			{
+				for(std::vector<output_run>::const_iterator run_it = runs.begin(); run_it != runs.end(); ++run_it)
+				{
+					int y = run_it->input_position[1] + window_position_it[1];
+					int z = run_it->input_position[2] + window_position_it[2];
+					int w = run_it->input_position[3] + window_position_it[3];
+					if (((unsigned int)y >= (unsigned int)input_dimension_sizes[1])
+						|| ((unsigned int)z >= (unsigned int)input_dimension_sizes[2])
+						|| ((unsigned int)w >= (unsigned int)input_dimension_sizes[3]))
+						continue;
+
+					const int length = static_cast<int>(run_it->length);
+					int x = run_it->input_position[0] + window_position_it[0];
+					int valid_start;
+					int valid_end;
+					get_valid_range(x, length, valid_start, valid_end);
+					const float * src = src_row + run_it->column_offset;
+					float * dst = in_feature_map + (w * input_slices[3] + z * input_slices[2] + y * input_slices[1] + x);
+
+					if (strides[0] == 1)
+					{
+						for(int i = valid_start; i < valid_end; ++i)
+							dst[i] += src[i];
+					}
+					else
+					{
+						const int stride_x = strides[0];
+						for(int i = valid_start; i < valid_end; ++i)
+							dst[i * stride_x] += src[i];
+					}
+				}
+			}
+		}
+
+		template<typename weight_type>
+		void convolution_gemm_plain::forward(
+			const float * input,
+			float * output,
+			const weight_type * weights,
+			const float * biases,
+			float * column_buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count;
+			const unsigned int output_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count;
+			const unsigned int block_count = (output_neuron_count_per_feature_map + block_size - 1) / block_size;
+			const unsigned int column_buffer_elem_count = get_column_buffer_elem_count();
+			const int total_workload = static_cast<int>(entry_count * block_count);
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(input,output,weights,biases,column_buffers)
+			{
+				int thread_id = 0;
+				#ifdef _OPENMP
+				thread_id = omp_get_thread_num();
+				#endif
+
+				float * columns = column_buffers + thread_id * column_buffer_elem_count;
+				float * workspace = columns + column_height * block_size;
+
+				#pragma omp for schedule(dynamic)
+				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+				{
+					int entry_id = workload_id / block_count;
+					int block_id = workload_id - (entry_id * block_count);
+					unsigned int output_position_start = block_id * block_size;
+					unsigned int output_position_count = std::min(block_size, output_neuron_count_per_feature_map - output_position_start);
+
+					unfold(
+						input + entry_id * input_neuron_count,
+						columns,
+						output_position_start,
+						output_position_count);
+
+					float * out = output + entry_id * output_neuron_count + output_position_start;
+					for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+						std::fill_n(out + output_feature_map_id * output_neuron_count_per_feature_map, output_position_count, biases[output_feature_map_id]);
+
+					gemm_plain::sgemm(
+						false,
+						false,
+						output_feature_map_count,
+						output_position_count,
+						column_height,
+						weights,
+						column_height,
+						columns,
+						output_position_count,
+						out,
+						output_neuron_count_per_feature_map,
+						true,
+						workspace);
+				}
+			}
+		}
+
+		template void convolution_gemm_plain::forward<float>(const float *, float *, const float *, const float *, float *, unsigned int, int) const;
+		template void convolution_gemm_plain::forward<half_float_plain::fp16>(const float *, float *, const half_float_plain::fp16 *, const float *, float *, unsigned int, int) const;
+		template void convolution_gemm_plain::forward<half_float_plain::bf16>(const float *, float *, const half_float_plain::bf16 *, const float *, float *, unsigned int, int) const;
+
+		void convolution_gemm_plain::backprop(
+			const float * output_errors,
+			float * input_errors,
+			const float * weights,
+			float * column_buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count;
+			const unsigned int output_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count;
+			const unsigned int block_count = (output_neuron_count_per_feature_map + block_size - 1) / block_size;
+			const unsigned int column_buffer_elem_count = get_column_buffer_elem_count();
+
+			// Blocks of the same entry overlap in input errors, so entries are split between threads when there are enough of them,
+			// otherwise each product is split between threads and each input feature map is folded independently
+			if (entry_count >= static_cast<unsigned int>(thread_count))
+			{
+				const int total_workload = static_cast<int>(entry_count);
+
+				#pragma omp parallel default(none) num_threads(thread_count) shared(output_errors,input_errors,weights,column_buffers)
+				{
+					int thread_id = 0;
+					#ifdef _OPENMP
+					thread_id = omp_get_thread_num();
+					#endif
+
+					float * columns = column_buffers + thread_id * column_buffer_elem_count;
+					float * workspace = columns + column_height * block_size;
+
+					#pragma omp for schedule(dynamic)
+					for(int entry_id = 0; entry_id < total_workload; ++entry_id)
+					{
+						float * in_err = input_errors + entry_id * input_neuron_count;
+						std::fill_n(in_err, input_neuron_count, 0.0F);
+						for(unsigned int block_id = 0; block_id < block_count; ++block_id)
+						{
+							unsigned int output_position_start = block_id * block_size;
+							unsigned int output_position_count = std::min(block_size, output_neuron_count_per_feature_map - output_position_start);
+
+							gemm_plain::sgemm(
+								true,
+								false,
+								column_height,
+								output_position_count,
+								output_feature_map_count,
+								weights,
+								column_height,
+								output_errors + entry_id * output_neuron_count + output_position_start,
+								output_neuron_count_per_feature_map,
+								columns,
+								output_position_count,
+								false,
+								workspace);
+
+							for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count; ++input_feature_map_id)
+								fold(columns, in_err, output_position_start, output_position_count, input_feature_map_id);
+						}
+					}
+				}
+			}
+			else
+			{
+				const int input_feature_map_workload = static_cast<int>(input_feature_map_count);
+				std::fill_n(input_errors, entry_count * input_neuron_count, 0.0F);
+				for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+				{
+					float * in_err = input_errors + entry_id * input_neuron_count;
+					for(unsigned int block_id = 0; block_id < block_count; ++block_id)
+					{
+						unsigned int output_position_start = block_id * block_size;
+						unsigned int output_position_count = std::min(block_size, output_neuron_count_per_feature_map - output_position_start);
+
+						// Product workspaces of all the threads follow the columns, they fit into the buffers of the threads
+						gemm_plain::parallel_sgemm(
+							true,
+							false,
+							column_height,
+							output_position_count,
+							output_feature_map_count,
+							weights,
+							column_height,
+							output_errors + entry_id * output_neuron_count + output_position_start,
+							output_neuron_count_per_feature_map,
+							column_buffers,
+							output_position_count,
+							false,
+							column_buffers + column_height * block_size,
+							thread_count);
+
+						#pragma omp parallel for default(none) schedule(dynamic) num_threads(thread_count) shared(column_buffers,in_err,output_position_start,output_position_count)
+						for(int input_feature_map_id = 0; input_feature_map_id < input_feature_map_workload; ++input_feature_map_id)
+							fold(column_buffers, in_err, output_position_start, output_position_count, input_feature_map_id);
+					}
+				}
+			}
+		}
+
+		unsigned int convolution_gemm_plain::get_update_weights_buffer_elem_count() const
+		{
+			return get_column_buffer_elem_count() + output_feature_map_count * column_height;
+		}
+
+		void convolution_gemm_plain::update_weights(
+			const float * input,
+			const float * output_errors,
+			float * gradient_weights,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count;
+			const unsigned int output_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count;
+			const unsigned int block_count = (output_neuron_count_per_feature_map + block_size - 1) / block_size;
+			const unsigned int buffer_elem_count = get_update_weights_buffer_elem_count();
+			const unsigned int column_buffer_elem_count = get_column_buffer_elem_count();
+			const unsigned int gradient_elem_count = output_feature_map_count * column_height;
+			const int total_workload = static_cast<int>(entry_count * block_count);
+			const unsigned int reduction_chunk_size = 4096;
+			const int reduction_chunk_count = static_cast<int>((gradient_elem_count + reduction_chunk_size - 1) / reduction_chunk_size);
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(input,output_errors,gradient_weights,buffers)
+			{
+				int thread_id = 0;
+				int team_thread_count = 1;
+				#ifdef _OPENMP
+				thread_id = omp_get_thread_num();
+				team_thread_count = omp_get_num_threads();
+				#endif
+
+				float * columns = buffers + thread_id * buffer_elem_count;
+				float * workspace = columns + column_height * block_size;
+				float * partial_gradient = columns + column_buffer_elem_count;
+				std::fill_n(partial_gradient, gradient_elem_count, 0.0F);
+
+				// Static schedule keeps the summation order, and hence the result, reproducible
+				#pragma omp for schedule(static)
+				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+				{
+					int entry_id = workload_id / block_count;
+					int block_id = workload_id - (entry_id * block_count);
+					unsigned int output_position_start = block_id * block_size;
+					unsigned int output_position_count = std::min(block_size, output_neuron_count_per_feature_map - output_position_start);
+
+					unfold(
+						input + entry_id * input_neuron_count,
+						columns,
+						output_position_start,
+						output_position_count);
+
+					gemm_plain::sgemm(
+						false,
+						true,
+						output_feature_map_count,
+						column_height,
+						output_position_count,
+						output_errors + entry_id * output_neuron_count + output_position_start,
+						output_neuron_count_per_feature_map,
+						columns,
+						output_position_count,
+						partial_gradient,
+						column_height,
+						true,
+						workspace);
+				}
+
+				// Pairwise reduction of partial gradients, log2(thread count) levels
+				for(int stride = 1; stride < team_thread_count; stride *= 2)
+				{
+					const int pair_count = (team_thread_count - stride + 2 * stride - 1) / (2 * stride);
+					const int reduction_workload = pair_count * reduction_chunk_count;
+
+					#pragma omp for schedule(static)
+					for(int workload_id = 0; workload_id < reduction_workload; ++workload_id)
+					{
+						int pair_id = workload_id / reduction_chunk_count;
+						int chunk_id = workload_id - pair_id * reduction_chunk_count;
+						unsigned int chunk_start = chunk_id * reduction_chunk_size;
+						unsigned int chunk_elem_count = std::min(reduction_chunk_size, gradient_elem_count - chunk_start);
+						float * dst = buffers + (pair_id * 2 * stride) * buffer_elem_count + column_buffer_elem_count + chunk_start;
+						const float * src = buffers + (pair_id * 2 * stride + stride) * buffer_elem_count + column_buffer_elem_count + chunk_start;
+						for(unsigned int i = 0; i < chunk_elem_count; ++i)
+							dst[i] += src[i];
+					}
+				}
+
+				#pragma omp for schedule(static)
+				for(int chunk_id = 0; chunk_id < reduction_chunk_count; ++chunk_id)
+				{
+					unsigned int chunk_start = chunk_id * reduction_chunk_size;
+					unsigned int chunk_elem_count = std::min(reduction_chunk_size, gradient_elem_count - chunk_start);
+					const float * src = buffers + column_buffer_elem_count + chunk_start;
+					float * dst = gradient_weights + chunk_start;
+					for(unsigned int i = 0; i < chunk_elem_count; ++i)
+						dst[i] += src[i];
+				}
+			}
+		}
+	}
+}
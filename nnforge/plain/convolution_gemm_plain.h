@@ -0,0 +1,150 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../layer_configuration_specific.h"
+#include "half_float_plain.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Convolution expressed as im2col followed by SGEMM
+		// The output positions of each entry are split into blocks, each block is unfolded into
+		// column_height x block_size matrix and multiplied by output_feature_map_count x column_height weight matrix
+		class convolution_gemm_plain
+		{
+		public:
+			convolution_gemm_plain(
+				const std::vector<unsigned int>& window_sizes,
+				const std::vector<unsigned int>& left_zero_padding,
+				const std::vector<unsigned int>& strides,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific);
+
+			// Returns false for layers too small to benefit from unfolding, direct kernel should be used for them
+			bool is_efficient() const;
+
+			// Column matrix height: input feature map count times window element count
+			unsigned int get_column_height() const;
+
+			// Number of output positions unfolded at once
+			unsigned int get_block_size() const;
+
+			// The size of the scratch buffer the caller should provide for each thread:
+			// unfolded columns followed by SGEMM workspace
+			unsigned int get_column_buffer_elem_count() const;
+
+			// Unfold output positions [output_position_start, output_position_start + output_position_count) of a single entry
+			// The result is row-major column_height x output_position_count matrix
+			void unfold(
+				const float * input,
+				float * columns,
+				unsigned int output_position_start,
+				unsigned int output_position_count) const;
+
+			// Add the columns of input_feature_map_id back to the input-shaped array of a single entry, the reverse of unfold
+			void fold(
+				const float * columns,
+				float * input,
+				unsigned int output_position_start,
+				unsigned int output_position_count,
+				unsigned int input_feature_map_id) const;
+
+			// column_buffers should have get_column_buffer_elem_count() elements per thread
+			// weight_type is float, half_float_plain::fp16 or half_float_plain::bf16
+			template<typename weight_type>
+			void forward(
+				const float * input,
+				float * output,
+				const weight_type * weights,
+				const float * biases,
+				float * column_buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// Input errors are computed block by block as transpose(weights) * output errors followed by fold
+			// column_buffers should have get_column_buffer_elem_count() elements per thread
+			void backprop(
+				const float * output_errors,
+				float * input_errors,
+				const float * weights,
+				float * column_buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// The size of the scratch buffer the caller should provide for each thread running update_weights:
+			// column buffer followed by partial gradient of the thread
+			unsigned int get_update_weights_buffer_elem_count() const;
+
+			// Gradient is added to gradient_weights, biases are not touched
+			// (entry, block) pairs are split between threads, each thread accumulates its own partial gradient
+			// with SGEMM of output errors by transposed unfolded input, partial gradients are summed with tree reduction
+			// buffers should have get_update_weights_buffer_elem_count() elements per thread
+			void update_weights(
+				const float * input,
+				const float * output_errors,
+				float * gradient_weights,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+		private:
+			struct output_run
+			{
+				unsigned int column_offset;
+				unsigned int length;
+				int input_position[4];
+			};
+
+			void fill_runs(
+				std::vector<output_run>& runs,
+				unsigned int output_position_start,
+				unsigned int output_position_count) const;
+
+			void get_valid_range(
+				int x,
+				int length,
+				int& valid_start,
+				int& valid_end) const;
+
+			// The largest SGEMM workspace of forward, backprop and update_weights
+			unsigned int get_gemm_workspace_elem_count() const;
+
+			static const int max_dimension_count = 4;
+
+			unsigned int input_feature_map_count;
+			unsigned int output_feature_map_count;
+			unsigned int input_neuron_count_per_feature_map;
+			unsigned int output_neuron_count_per_feature_map;
+			unsigned int window_elem_count;
+			unsigned int column_height;
+			unsigned int block_size;
+
+			int input_dimension_sizes[max_dimension_count];
+			int output_dimension_sizes[max_dimension_count];
+			int input_slices[max_dimension_count];
+			int left_zero_padding[max_dimension_count];
+			int strides[max_dimension_count];
+
+			// Offsets of each window element relative to the window start, one entry per dimension
+			std::vector<int> window_positions;
+		};
+	}
+}
@@ -0,0 +1,291 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include "convolution_int8_plain.h"
+
+#include "int8_gemm_plain.h"
+#include "../neural_network_exception.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		const int convolution_int8_plain::max_dimension_count;
+
+		convolution_int8_plain::convolution_int8_plain(
+			const std::vector<unsigned int>& window_sizes,
+			const std::vector<unsigned int>& left_zero_padding,
+			const std::vector<unsigned int>& strides,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+			: input_feature_map_count(input_configuration_specific.feature_map_count)
+			, padded_input_feature_map_count(int8_gemm_plain::get_padded_k(input_configuration_specific.feature_map_count))
+			, input_neuron_count(input_configuration_specific.get_neuron_count())
+			, input_neuron_count_per_feature_map(input_configuration_specific.get_neuron_count_per_feature_map())
+			, output_feature_map_count(output_configuration_specific.feature_map_count)
+			, output_neuron_count_per_feature_map(output_configuration_specific.get_neuron_count_per_feature_map())
+		{
+			const unsigned int dimension_count = static_cast<unsigned int>(window_sizes.size());
+			if (dimension_count > max_dimension_count)
+				throw neural_network_exception("convolution_int8_plain cannot handle more than 4 dimensions");
+
+			int window_sizes_extended[max_dimension_count];
+			int slice = 1;
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+			{
+				bool used = (i < dimension_count);
+				window_sizes_extended[i] = used ? static_cast<int>(window_sizes[i]) : 1;
+				input_dimension_sizes[i] = used ? static_cast<int>(input_configuration_specific.dimension_sizes[i]) : 1;
+				output_dimension_sizes[i] = used ? static_cast<int>(output_configuration_specific.dimension_sizes[i]) : 1;
+				this->left_zero_padding[i] = (used && (i < left_zero_padding.size())) ? static_cast<int>(left_zero_padding[i]) : 0;
+				this->strides[i] = (used && (i < strides.size())) ? static_cast<int>(strides[i]) : 1;
+				input_slices[i] = slice;
+				slice *= input_dimension_sizes[i];
+			}
+
+			window_elem_count = 1;
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+				window_elem_count *= static_cast<unsigned int>(window_sizes_extended[i]);
+			column_height = window_elem_count * input_feature_map_count;
+			padded_column_height = int8_gemm_plain::get_padded_k(column_height);
+
+			window_positions.resize(window_elem_count * max_dimension_count);
+			std::vector<int>::iterator window_positions_it = window_positions.begin();
+			for(int w = 0; w < window_sizes_extended[3]; ++w)
+				for(int z = 0; z < window_sizes_extended[2]; ++z)
+					for(int y = 0; y < window_sizes_extended[1]; ++y)
+						for(int x = 0; x < window_sizes_extended[0]; ++x)
+						{
+							*(window_positions_it++) = x;
+							*(window_positions_it++) = y;
+							*(window_positions_it++) = z;
+							*(window_positions_it++) = w;
+						}
+
+			// Keep the rows of a block of output positions within L2 cache, next to the weights
+			const unsigned int row_buffer_budget = 32 * 1024;
+			block_size = std::min(std::max(row_buffer_budget / padded_column_height, 1U), output_neuron_count_per_feature_map);
+
+			// A single output position with the window covering the whole input: the row is the entry itself
+			fully_connected = (output_neuron_count_per_feature_map == 1) && (column_height == input_neuron_count);
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+				fully_connected = fully_connected && (this->left_zero_padding[i] == 0);
+		}
+
+		quantized_layer_data_plain_smart_ptr convolution_int8_plain::quantize(
+			const float * weights,
+			const float * biases,
+			float input_scale) const
+		{
+			quantized_layer_data_plain_smart_ptr res(new quantized_layer_data_plain());
+			res->input_scale = input_scale;
+			res->output_scales.resize(output_feature_map_count);
+			res->biases.assign(biases, biases + output_feature_map_count);
+
+			std::vector<signed char> quantized_weights(output_feature_map_count * column_height);
+			int8_gemm_plain::quantize_rows(
+				weights,
+				output_feature_map_count,
+				column_height,
+				&(*quantized_weights.begin()),
+				&(*res->output_scales.begin()));
+			if (!fully_connected)
+			{
+				// Window elements first, input feature maps within each of them, the same way gather_rows fills the rows
+				std::vector<signed char> reordered_weights(quantized_weights.size());
+				for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+				{
+					const signed char * src = &(*quantized_weights.begin()) + output_feature_map_id * column_height;
+					signed char * dst = &(*reordered_weights.begin()) + output_feature_map_id * column_height;
+					for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count; ++input_feature_map_id)
+						for(unsigned int window_elem_id = 0; window_elem_id < window_elem_count; ++window_elem_id)
+							dst[window_elem_id * input_feature_map_count + input_feature_map_id] = src[input_feature_map_id * window_elem_count + window_elem_id];
+				}
+				quantized_weights.swap(reordered_weights);
+			}
+			res->weights.resize(int8_gemm_plain::get_packed_weights_elem_count(output_feature_map_count, column_height));
+			int8_gemm_plain::pack_weights(
+				&(*quantized_weights.begin()),
+				output_feature_map_count,
+				column_height,
+				&(*res->weights.begin()));
+			for(std::vector<float>::iterator it = res->output_scales.begin(); it != res->output_scales.end(); ++it)
+				*it *= input_scale;
+
+			return res;
+		}
+
+		void convolution_int8_plain::forward(
+			const float * input,
+			float * output,
+			const quantized_layer_data_plain& data,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int output_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count;
+			const signed char * const weights = &(*data.weights.begin());
+			const float * const output_scales = &(*data.output_scales.begin());
+			const float * const biases = &(*data.biases.begin());
+			const float input_scale = data.input_scale;
+			const int entry_count_int = static_cast<int>(entry_count);
+
+			if (fully_connected)
+			{
+				// The padding of the rows stays zero
+				std::vector<short> quantized_input(entry_count * padded_column_height, 0);
+				short * const quantized_input_it = &(*quantized_input.begin());
+
+				#pragma omp parallel for default(none) schedule(static) num_threads(thread_count) shared(input)
+				for(int entry_id = 0; entry_id < entry_count_int; ++entry_id)
+					int8_gemm_plain::quantize(
+						input + entry_id * input_neuron_count,
+						quantized_input_it + entry_id * padded_column_height,
+						input_neuron_count,
+						input_scale);
+
+				// Blocks of output feature maps are split between threads, each thread reads its weights once for all the entries
+				const unsigned int output_block_size = int8_gemm_plain::output_block_size;
+				const int total_workload = static_cast<int>((output_feature_map_count + output_block_size - 1) / output_block_size);
+
+				#pragma omp parallel for default(none) schedule(dynamic) num_threads(thread_count) shared(output,entry_count)
+				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+				{
+					unsigned int output_feature_map_start = workload_id * output_block_size;
+					int8_gemm_plain::multiply(
+						entry_count,
+						std::min(output_block_size, output_feature_map_count - output_feature_map_start),
+						column_height,
+						quantized_input_it,
+						weights + output_feature_map_start * padded_column_height,
+						output_scales + output_feature_map_start,
+						biases + output_feature_map_start,
+						output + output_feature_map_start,
+						output_neuron_count,
+						1);
+				}
+
+				return;
+			}
+
+			// Each entry is quantized once, the rows of all its output positions are gathered from it
+			const unsigned int quantized_entry_elem_count = input_neuron_count_per_feature_map * padded_input_feature_map_count;
+			std::vector<short> quantized_input(entry_count * quantized_entry_elem_count);
+			short * const quantized_input_it = &(*quantized_input.begin());
+
+			#pragma omp parallel for default(none) schedule(static) num_threads(thread_count) shared(input)
+			for(int entry_id = 0; entry_id < entry_count_int; ++entry_id)
+				int8_gemm_plain::quantize_transposed(
+					input + entry_id * input_neuron_count,
+					quantized_input_it + entry_id * quantized_entry_elem_count,
+					input_feature_map_count,
+					input_neuron_count_per_feature_map,
+					input_scale);
+
+			const unsigned int block_count = (output_neuron_count_per_feature_map + block_size - 1) / block_size;
+			const int total_workload = static_cast<int>(entry_count * block_count);
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(output)
+			{
+				// The padding of the rows stays zero
+				std::vector<short> rows(padded_column_height * block_size, 0);
+
+				#pragma omp for schedule(dynamic)
+				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+				{
+					int entry_id = workload_id / block_count;
+					int block_id = workload_id - (entry_id * block_count);
+					unsigned int output_position_start = block_id * block_size;
+					unsigned int output_position_count = std::min(block_size, output_neuron_count_per_feature_map - output_position_start);
+
+					gather_rows(
+						quantized_input_it + entry_id * quantized_entry_elem_count,
+						&(*rows.begin()),
+						output_position_start,
+						output_position_count);
+
+					int8_gemm_plain::multiply(
+						output_position_count,
+						output_feature_map_count,
+						column_height,
+						&(*rows.begin()),
+						weights,
+						output_scales,
+						biases,
+						output + entry_id * output_neuron_count + output_position_start,
+						1,
+						output_neuron_count_per_feature_map);
+				}
+			}
+		}
+
+		void convolution_int8_plain::gather_rows(
+			const short * quantized_input,
+			short * rows,
+			unsigned int output_position_start,
+			unsigned int output_position_count) const
+		{
+			int current_output_position[max_dimension_count];
+			unsigned int remainder = output_position_start;
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+			{
+				current_output_position[i] = static_cast<int>(remainder % static_cast<unsigned int>(output_dimension_sizes[i]));
+				remainder /= static_cast<unsigned int>(output_dimension_sizes[i]);
+			}
+
+			short * row = rows;
+			for(unsigned int output_position_id = 0; output_position_id < output_position_count; ++output_position_id, row += padded_column_height)
+			{
+				int window_start[max_dimension_count];
+				for(unsigned int i = 0; i < max_dimension_count; ++i)
+					window_start[i] = current_output_position[i] * strides[i] - left_zero_padding[i];
+
+				short * dst = row;
+				std::vector<int>::const_iterator window_position_it = window_positions.begin();
+				for(unsigned int window_elem_id = 0; window_elem_id < window_elem_count; ++window_elem_id, window_position_it += max_dimension_count, dst += input_feature_map_count)
+				{
+					bool valid = true;
+					int input_position = 0;
+					for(unsigned int i = 0; i < max_dimension_count; ++i)
+					{
+						int x = window_start[i] + window_position_it[i];
+						valid = valid && ((unsigned int)x < (unsigned int)input_dimension_sizes[i]);
+						input_position += x * input_slices[i];
+					}
+
+					if (valid)
+						memcpy(dst, quantized_input + input_position * padded_input_feature_map_count, input_feature_map_count * sizeof(short));
+					else
+						std::fill_n(dst, input_feature_map_count, static_cast<short>(0));
+				}
+
+				for(unsigned int i = 0; i < max_dimension_count; ++i)
+				{
+					if ((++current_output_position[i]) < output_dimension_sizes[i])
+						break;
+					current_output_position[i] = 0;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,90 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include "quantized_layer_data_plain.h"
+#include "../layer_configuration_specific.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Convolution with 8-bit weights and input neurons, see quantized_layer_data_plain
+		// The input of each entry is quantized to 16 bits with the feature maps of each position stored together,
+		// so that the row of an output position is gathered with a single copy per window element and multiplied with int8_gemm_plain.
+		// The weights are reordered to match: window elements first, input feature maps within each of them.
+		// Fully connected layers keep the original order: the quantized entries are multiplied by the weights directly
+		class convolution_int8_plain
+		{
+		public:
+			convolution_int8_plain(
+				const std::vector<unsigned int>& window_sizes,
+				const std::vector<unsigned int>& left_zero_padding,
+				const std::vector<unsigned int>& strides,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific);
+
+			// input_scale is the input neuron value to be represented by 1, usually the max absolute value of the input divided by 127
+			quantized_layer_data_plain_smart_ptr quantize(
+				const float * weights,
+				const float * biases,
+				float input_scale) const;
+
+			void forward(
+				const float * input,
+				float * output,
+				const quantized_layer_data_plain& data,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			static const int max_dimension_count = 4;
+
+		private:
+			// Fills the rows of output_position_count output positions, each one padded_column_height long.
+			// quantized_input holds the input feature maps of each input position together, padded_input_feature_map_count of them
+			void gather_rows(
+				const short * quantized_input,
+				short * rows,
+				unsigned int output_position_start,
+				unsigned int output_position_count) const;
+
+			unsigned int input_feature_map_count;
+			unsigned int padded_input_feature_map_count;
+			unsigned int input_neuron_count;
+			unsigned int input_neuron_count_per_feature_map;
+			unsigned int output_feature_map_count;
+			unsigned int output_neuron_count_per_feature_map;
+			unsigned int window_elem_count;
+			unsigned int column_height;
+			unsigned int padded_column_height;
+			unsigned int block_size;
+			bool fully_connected;
+
+			int input_dimension_sizes[max_dimension_count];
+			int output_dimension_sizes[max_dimension_count];
+			int input_slices[max_dimension_count];
+			int left_zero_padding[max_dimension_count];
+			int strides[max_dimension_count];
+
+			// Offsets of each window element relative to the window start, one entry per dimension
+			std::vector<int> window_positions;
+		};
+	}
+}
@@ -16,10 +16,19 @@
 
 #include "convolution_layer_tester_plain.h"
 
+#include "convolution_1x1_plain.h"
+#include "convolution_blocked_plain.h"
+#include "convolution_direct_plain.h"
+#include "convolution_gemm_plain.h"
+#include "convolution_int8_plain.h"
+#include "convolution_winograd_plain.h"
+#include "convolution_fft_plain.h"
+#include "fully_connected_gemm_plain.h"
 #include "../convolution_layer.h"
 #include "../nn_types.h"
 
 #include <array>
+#include <algorithm>
 
 namespace nnforge
 {
@@ -51,8 +60,156 @@ namespace nnforge
 			const layer_configuration_specific& output_configuration_specific,
 			unsigned int entry_count) const
 		{
-			const std::vector<float>::const_iterator in_it_global = input_buffer->begin();
-			const std::vector<float>::iterator out_it_global = additional_buffers[0]->begin();
+			forward(
+				&(*input_buffer->begin()),
+				&(*additional_buffers[0]->begin()),
+				(additional_buffers.size() > 1) ? &(*additional_buffers[1]->begin()) : 0,
+				plain_config,
+				layer_schema,
+				data,
+				input_configuration_specific,
+				output_configuration_specific,
+				entry_count);
+		}
+
+		void convolution_layer_tester_plain::forward(
+			const float * input,
+			float * output,
+			float * scratch,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int entry_count) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+
+			convolution_gemm_plain gemm_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			if (fully_connected_gemm_plain::is_applicable(layer_derived->window_sizes, layer_derived->left_zero_padding, layer_derived->right_zero_padding, input_configuration_specific))
+			{
+				fully_connected_gemm_plain fully_connected_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+
+				fully_connected_engine.forward(
+					input,
+					output,
+					&(*(*data)[0].begin()),
+					&(*(*data)[1].begin()),
+					scratch,
+					entry_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_1x1_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides))
+			{
+				convolution_1x1_plain convolution_1x1_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+
+				convolution_1x1_engine.forward(
+					input,
+					output,
+					&(*(*data)[0].begin()),
+					&(*(*data)[1].begin()),
+					scratch,
+					entry_count,
+					plain_config->openmp_thread_count);
+			}
+			// Transformed weights are available only when data was prepared with get_data
+			else if (convolution_winograd_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific) && (data->size() > 2))
+			{
+				convolution_winograd_plain winograd_engine(
+					input_configuration_specific,
+					output_configuration_specific,
+					layer_derived->left_zero_padding);
+
+				winograd_engine.forward(
+					input,
+					output,
+					&(*(*data)[2].begin()),
+					&(*(*data)[1].begin()),
+					scratch,
+					entry_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_fft_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific) && (data->size() > 2))
+			{
+				convolution_fft_plain fft_engine(
+					layer_derived->window_sizes,
+					layer_derived->left_zero_padding,
+					input_configuration_specific,
+					output_configuration_specific);
+
+				fft_engine.forward(
+					input,
+					output,
+					&(*(*data)[2].begin()),
+					&(*(*data)[1].begin()),
+					scratch,
+					entry_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (gemm_engine.is_efficient())
+			{
+				gemm_engine.forward(
+					input,
+					output,
+					&(*(*data)[0].begin()),
+					&(*(*data)[1].begin()),
+					scratch,
+					entry_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_direct_plain::is_applicable(layer_derived->window_sizes))
+			{
+				convolution_direct_plain direct_engine(
+					layer_derived->window_sizes,
+					layer_derived->left_zero_padding,
+					layer_derived->strides,
+					input_configuration_specific,
+					output_configuration_specific);
+
+				direct_engine.forward(
+					input,
+					output,
+					&(*(*data)[0].begin()),
+					&(*(*data)[1].begin()),
+					entry_count,
+					plain_config->openmp_thread_count);
+			}
+			else
+			{
+				test_direct(
+					input,
+					output,
+					plain_config,
+					layer_schema,
+					data,
+					input_configuration_specific,
+					output_configuration_specific,
+					entry_count);
+			}
+		}
+
+		void convolution_layer_tester_plain::test_direct(
+			const float * input,
+			float * output,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int entry_count) const
+		{
+			const float * const in_it_global = input;
+			float * const out_it_global = output;
 			const unsigned int input_neuron_count = input_configuration_specific.get_neuron_count();
 			const unsigned int input_neuron_count_per_feature_map = input_configuration_specific.get_neuron_count_per_feature_map();
 			const unsigned int output_neuron_count = output_configuration_specific.get_neuron_count();
@@ -71,6 +228,10 @@ namespace nnforge
 			right_zero_padding_extended.resize(max_dimension_count, 0);
 			const std::vector<unsigned int>& right_zero_padding = right_zero_padding_extended;
 
+			std::vector<unsigned int> strides_extended = layer_derived->strides;
+			strides_extended.resize(max_dimension_count, 1);
+			const std::vector<unsigned int>& strides = strides_extended;
+
 			std::vector<unsigned int> input_dimension_sizes_extended = input_configuration_specific.dimension_sizes;
 			input_dimension_sizes_extended .resize(max_dimension_count, 1);
 			const std::vector<unsigned int>& input_dimension_sizes = input_dimension_sizes_extended ;
@@ -112,7 +273,7 @@ namespace nnforge
 			const std::vector<unsigned int>::const_iterator input_slices_it = input_slices.begin();
 			const std::vector<unsigned int>::const_iterator offset_list_it = offset_list.begin();
 
-			#pragma omp parallel default(none) num_threads(plain_config->openmp_thread_count) shared(window_sizes,left_zero_padding,right_zero_padding,input_dimension_sizes)
+			#pragma omp parallel default(none) num_threads(plain_config->openmp_thread_count) shared(window_sizes,left_zero_padding,right_zero_padding,strides,input_dimension_sizes)
 			{
 				nnforge_array<unsigned int, max_dimension_count> current_output_position;
 				nnforge_array<int, max_dimension_count> current_input_position;
@@ -123,12 +284,12 @@ namespace nnforge
 					int entry_id = workload_id / output_feature_map_count;
 					int output_feature_map_id = workload_id - (entry_id * output_feature_map_count);
 
-					std::vector<float>::iterator out_it_base = out_it_global + (entry_id * output_neuron_count) + (output_feature_map_id * output_neuron_count_per_feature_map);
-					std::vector<float>::const_iterator in_it_base = in_it_global + (entry_id * input_neuron_count);
+					float * out_it_base = out_it_global + (entry_id * output_neuron_count) + (output_feature_map_id * output_neuron_count_per_feature_map);
+					const float * in_it_base = in_it_global + (entry_id * input_neuron_count);
 
 					std::fill_n(current_input_position.begin(), max_dimension_count, 0);
 					std::fill_n(current_output_position.begin(), max_dimension_count, 0);
-					for(std::vector<float>::iterator out_it = out_it_base; out_it != out_it_base + output_neuron_count_per_feature_map; ++out_it)
+					for(float * out_it = out_it_base; out_it != out_it_base + output_neuron_count_per_feature_map; ++out_it)
 					{
 						float sum = *(biases + output_feature_map_id);
 						std::vector<float>::const_iterator weights_it = weights + (output_feature_map_id * (const_window_elem_count * input_feature_map_count));
@@ -136,7 +297,7 @@ namespace nnforge
 						int in_it_offset2 = 0;
 
 						for(unsigned int i = 0; i < dimension_count; ++i)
-							current_input_position[i] = static_cast<int>(current_output_position[i]) - static_cast<int>(left_zero_padding[i]);
+							current_input_position[i] = static_cast<int>(current_output_position[i] * strides[i]) - static_cast<int>(left_zero_padding[i]);
 
 						for(unsigned int i = 0; i < dimension_count; ++i)
 							in_it_offset2 += current_input_position[i] * (*(input_slices_it + i));
@@ -182,11 +343,9 @@ namespace nnforge
 			}
 		}
 
-		additional_buffer_smart_ptr convolution_layer_tester_plain::get_output_buffer(
-			additional_buffer_smart_ptr input_buffer,
-			additional_buffer_set& additional_buffers) const
+		bool convolution_layer_tester_plain::is_in_place() const
 		{
-			return additional_buffers[0];
+			return false;
 		}
 
 		std::vector<std::pair<unsigned int, bool> > convolution_layer_tester_plain::get_elem_count_and_per_entry_flag_additional_buffers(
@@ -199,7 +358,389 @@ namespace nnforge
 
 			res.push_back(std::make_pair<unsigned int, bool>(output_configuration_specific.get_neuron_count(), true));
 
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+			if (fully_connected_gemm_plain::is_applicable(layer_derived->window_sizes, layer_derived->left_zero_padding, layer_derived->right_zero_padding, input_configuration_specific))
+			{
+				fully_connected_gemm_plain fully_connected_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+				res.push_back(std::make_pair<unsigned int, bool>(fully_connected_engine.get_buffer_elem_count() * plain_config->openmp_thread_count, false));
+				return res;
+			}
+			if (convolution_1x1_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides))
+			{
+				convolution_1x1_plain convolution_1x1_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+				res.push_back(std::make_pair<unsigned int, bool>(convolution_1x1_engine.get_buffer_elem_count() * plain_config->openmp_thread_count, false));
+				return res;
+			}
+
+			convolution_gemm_plain gemm_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			// 16-bit weights are always multiplied by the unfolded input
+			unsigned int scratch_elem_count = 0;
+			if (gemm_engine.is_efficient() || (plain_config->weight_storage != plain_running_configuration::weight_storage_fp32))
+				scratch_elem_count = gemm_engine.get_column_buffer_elem_count();
+			if (convolution_winograd_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_winograd_plain winograd_engine(
+					input_configuration_specific,
+					output_configuration_specific,
+					layer_derived->left_zero_padding);
+				scratch_elem_count = std::max(scratch_elem_count, winograd_engine.get_buffer_elem_count());
+			}
+			scratch_elem_count *= plain_config->openmp_thread_count;
+			if (convolution_fft_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_fft_plain fft_engine(
+					layer_derived->window_sizes,
+					layer_derived->left_zero_padding,
+					input_configuration_specific,
+					output_configuration_specific);
+				// Spectra buffer is shared by all the threads
+				scratch_elem_count = std::max(scratch_elem_count, fft_engine.get_buffer_elem_count());
+			}
+
+			if (scratch_elem_count > 0)
+				res.push_back(std::make_pair(scratch_elem_count, false));
+
+			return res;
+		}
+
+		const_layer_data_smart_ptr convolution_layer_tester_plain::get_data(
+			const_layer_data_smart_ptr host_data,
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			plain_running_configuration_const_smart_ptr plain_config) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+			if (fully_connected_gemm_plain::is_applicable(layer_derived->window_sizes, layer_derived->left_zero_padding, layer_derived->right_zero_padding, input_configuration_specific))
+				return host_data;
+
+			if (convolution_fft_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_fft_plain fft_engine(
+					layer_derived->window_sizes,
+					layer_derived->left_zero_padding,
+					input_configuration_specific,
+					output_configuration_specific);
+
+				// Biases and weight spectra computed once per data load, the original weights are not used anymore
+				// and are dropped, the empty part keeps the indices of the other ones
+				layer_data_smart_ptr res(new layer_data());
+				res->push_back(std::vector<float>());
+				res->push_back((*host_data)[1]);
+				res->push_back(std::vector<float>(fft_engine.get_weights_spectrum_elem_count()));
+				fft_engine.transform_weights(
+					&(*(*host_data)[0].begin()),
+					&(*res->back().begin()),
+					plain_config->openmp_thread_count);
+
+				return res;
+			}
+
+			if (!convolution_winograd_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+				return host_data;
+
+			convolution_winograd_plain winograd_engine(
+				input_configuration_specific,
+				output_configuration_specific,
+				layer_derived->left_zero_padding);
+
+			// Biases and Winograd-transformed weights, the original weights are dropped the same way as for FFT
+			layer_data_smart_ptr res(new layer_data());
+			res->push_back(std::vector<float>());
+			res->push_back((*host_data)[1]);
+			res->push_back(std::vector<float>(winograd_engine.get_transformed_weights_elem_count()));
+			winograd_engine.transform_weights(
+				&(*(*host_data)[0].begin()),
+				&(*res->back().begin()),
+				false,
+				plain_config->openmp_thread_count);
+
+			return res;
+		}
+
+		layer_tester_plain::blocked_layout_support convolution_layer_tester_plain::get_blocked_layout_support(
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+
+			// Fully connected layers are better served by the planar GEMM
+			if (fully_connected_gemm_plain::is_applicable(layer_derived->window_sizes, layer_derived->left_zero_padding, layer_derived->right_zero_padding, input_configuration_specific))
+				return blocked_layout_unsupported;
+
+			return convolution_blocked_plain::is_efficient(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific) ? blocked_layout_native : blocked_layout_unsupported;
+		}
+
+		const_layer_data_smart_ptr convolution_layer_tester_plain::get_blocked_data(
+			const_layer_data_smart_ptr host_data,
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			plain_running_configuration_const_smart_ptr plain_config) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+
+			convolution_blocked_plain blocked_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			// Packed weights and biases only
+			layer_data_smart_ptr res(new layer_data());
+			res->push_back(std::vector<float>(blocked_engine.get_packed_weights_elem_count()));
+			blocked_engine.pack_weights(
+				&(*(*host_data)[0].begin()),
+				&(*(*host_data)[1].begin()),
+				&(*res->back().begin()));
+
 			return res;
 		}
+
+		void convolution_layer_tester_plain::test_blocked(
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_smart_ptr output_buffer,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int entry_count) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+
+			convolution_blocked_plain blocked_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			blocked_engine.forward(
+				&(*input_buffer->begin()),
+				&(*output_buffer->begin()),
+				&(*(*data)[0].begin()),
+				entry_count,
+				plain_config->openmp_thread_count);
+		}
+
+		bool convolution_layer_tester_plain::is_quantization_supported(
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+
+			if (layer_derived->window_sizes.size() > convolution_int8_plain::max_dimension_count)
+				return false;
+
+			// Short rows do not pay for quantizing the input, the first layers with few input feature maps stay in fp32
+			unsigned int column_height = input_configuration_specific.feature_map_count;
+			for(std::vector<unsigned int>::const_iterator it = layer_derived->window_sizes.begin(); it != layer_derived->window_sizes.end(); ++it)
+				column_height *= *it;
+
+			return (column_height >= 64);
+		}
+
+		const_quantized_layer_data_plain_smart_ptr convolution_layer_tester_plain::get_quantized_data(
+			const_layer_data_smart_ptr host_data,
+			float input_scale,
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+
+			convolution_int8_plain int8_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			return int8_engine.quantize(
+				&(*(*host_data)[0].begin()),
+				&(*(*host_data)[1].begin()),
+				input_scale);
+		}
+
+		void convolution_layer_tester_plain::test_quantized(
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_set& additional_buffers,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_quantized_layer_data_plain_smart_ptr data,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int entry_count) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+
+			convolution_int8_plain int8_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			int8_engine.forward(
+				&(*input_buffer->begin()),
+				&(*additional_buffers[0]->begin()),
+				*data,
+				entry_count,
+				plain_config->openmp_thread_count);
+		}
+
+		bool convolution_layer_tester_plain::is_half_precision_supported(
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+
+			// Unfolding relies on convolution_gemm_plain
+			return (layer_derived->window_sizes.size() <= 4);
+		}
+
+		const_half_layer_data_plain_smart_ptr convolution_layer_tester_plain::get_half_precision_data(
+			const_layer_data_smart_ptr host_data,
+			half_float_plain::format weight_format,
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			const std::vector<float>& weights = (*host_data)[0];
+
+			half_layer_data_plain_smart_ptr res(new half_layer_data_plain());
+			res->weight_format = weight_format;
+			if (weight_format == half_float_plain::format_bf16)
+			{
+				res->bf16_weights.resize(weights.size());
+				half_float_plain::to_bf16(&(*weights.begin()), &(*res->bf16_weights.begin()), static_cast<unsigned int>(weights.size()));
+			}
+			else
+			{
+				res->fp16_weights.resize(weights.size());
+				half_float_plain::to_fp16(&(*weights.begin()), &(*res->fp16_weights.begin()), static_cast<unsigned int>(weights.size()));
+			}
+			res->biases = (*host_data)[1];
+
+			return res;
+		}
+
+		void convolution_layer_tester_plain::test_half_precision(
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_set& additional_buffers,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_half_layer_data_plain_smart_ptr data,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int entry_count) const
+		{
+			float * scratch = (additional_buffers.size() > 1) ? &(*additional_buffers[1]->begin()) : 0;
+
+			if (data->weight_format == half_float_plain::format_bf16)
+				forward_half_precision(
+					&(*input_buffer->begin()),
+					&(*additional_buffers[0]->begin()),
+					scratch,
+					plain_config,
+					layer_schema,
+					&(*data->bf16_weights.begin()),
+					&(*data->biases.begin()),
+					input_configuration_specific,
+					output_configuration_specific,
+					entry_count);
+			else
+				forward_half_precision(
+					&(*input_buffer->begin()),
+					&(*additional_buffers[0]->begin()),
+					scratch,
+					plain_config,
+					layer_schema,
+					&(*data->fp16_weights.begin()),
+					&(*data->biases.begin()),
+					input_configuration_specific,
+					output_configuration_specific,
+					entry_count);
+		}
+
+		template<typename weight_type>
+		void convolution_layer_tester_plain::forward_half_precision(
+			const float * input,
+			float * output,
+			float * scratch,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const weight_type * weights,
+			const float * biases,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int entry_count) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+
+			if (fully_connected_gemm_plain::is_applicable(layer_derived->window_sizes, layer_derived->left_zero_padding, layer_derived->right_zero_padding, input_configuration_specific))
+			{
+				fully_connected_gemm_plain fully_connected_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+
+				fully_connected_engine.forward(
+					input,
+					output,
+					weights,
+					biases,
+					scratch,
+					entry_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_1x1_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides))
+			{
+				convolution_1x1_plain convolution_1x1_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+
+				convolution_1x1_engine.forward(
+					input,
+					output,
+					weights,
+					biases,
+					scratch,
+					entry_count,
+					plain_config->openmp_thread_count);
+			}
+			else
+			{
+				convolution_gemm_plain gemm_engine(
+					layer_derived->window_sizes,
+					layer_derived->left_zero_padding,
+					layer_derived->strides,
+					input_configuration_specific,
+					output_configuration_specific);
+
+				gemm_engine.forward(
+					input,
+					output,
+					weights,
+					biases,
+					scratch,
+					entry_count,
+					plain_config->openmp_thread_count);
+			}
+		}
 	}
 }
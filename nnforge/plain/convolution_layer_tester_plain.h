@@ -42,9 +42,93 @@ namespace nnforge
 				const layer_configuration_specific& output_configuration_specific,
 				unsigned int entry_count) const;
 
-			virtual additional_buffer_smart_ptr get_output_buffer(
+			virtual bool is_in_place() const;
+
+			virtual const_layer_data_smart_ptr get_data(
+				const_layer_data_smart_ptr host_data,
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				plain_running_configuration_const_smart_ptr plain_config) const;
+
+			virtual blocked_layout_support get_blocked_layout_support(
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
+			virtual const_layer_data_smart_ptr get_blocked_data(
+				const_layer_data_smart_ptr host_data,
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				plain_running_configuration_const_smart_ptr plain_config) const;
+
+			virtual void test_blocked(
+				additional_buffer_smart_ptr input_buffer,
+				additional_buffer_smart_ptr output_buffer,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_layer_data_smart_ptr data,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int entry_count) const;
+
+			virtual bool is_quantization_supported(
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
+			virtual const_quantized_layer_data_plain_smart_ptr get_quantized_data(
+				const_layer_data_smart_ptr host_data,
+				float input_scale,
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
+			virtual void test_quantized(
+				additional_buffer_smart_ptr input_buffer,
+				additional_buffer_set& additional_buffers,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_quantized_layer_data_plain_smart_ptr data,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int entry_count) const;
+
+			virtual bool is_half_precision_supported(
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
+			virtual const_half_layer_data_plain_smart_ptr get_half_precision_data(
+				const_layer_data_smart_ptr host_data,
+				half_float_plain::format weight_format,
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
+			virtual void test_half_precision(
 				additional_buffer_smart_ptr input_buffer,
-				additional_buffer_set& additional_buffers) const;
+				additional_buffer_set& additional_buffers,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_half_layer_data_plain_smart_ptr data,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int entry_count) const;
+
+			// Computes convolution of entry_count entries, used both by test and by the fused chains of network_tester_plain
+			// scratch is the second additional buffer, if the layer has requested one
+			void forward(
+				const float * input,
+				float * output,
+				float * scratch,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_layer_data_smart_ptr data,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int entry_count) const;
 
 		protected:
 			virtual std::vector<std::pair<unsigned int, bool> > get_elem_count_and_per_entry_flag_additional_buffers(
@@ -54,6 +138,30 @@ namespace nnforge
 				plain_running_configuration_const_smart_ptr plain_config) const;
 
 		private:
+			// 16-bit weights are supported by the GEMM based engines only: fully connected, 1x1 and unfolding ones
+			template<typename weight_type>
+			void forward_half_precision(
+				const float * input,
+				float * output,
+				float * scratch,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const weight_type * weights,
+				const float * biases,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int entry_count) const;
+
+			void test_direct(
+				const float * input,
+				float * output,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_layer_data_smart_ptr data,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int entry_count) const;
+
 			static const int max_dimension_count;
 		};
 	}
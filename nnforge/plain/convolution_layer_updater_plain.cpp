@@ -16,11 +16,18 @@
 
 #include "convolution_layer_updater_plain.h"
 
+#include "convolution_1x1_plain.h"
+#include "convolution_direct_plain.h"
+#include "convolution_gemm_plain.h"
+#include "convolution_winograd_plain.h"
+#include "convolution_fft_plain.h"
+#include "fully_connected_gemm_plain.h"
 #include "../convolution_layer.h"
 #include "../neural_network_exception.h"
 #include "../nn_types.h"
 
 #include <array>
+#include <algorithm>
 
 namespace nnforge
 {
@@ -54,13 +61,145 @@ namespace nnforge
 			unsigned int updater_count,
 			unsigned int offset_input_entry_id,
 			bool force_deterministic) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+
+			convolution_gemm_plain gemm_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			if (fully_connected_gemm_plain::is_applicable(layer_derived->window_sizes, layer_derived->left_zero_padding, layer_derived->right_zero_padding, input_configuration_specific))
+			{
+				fully_connected_gemm_plain fully_connected_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+
+				fully_connected_engine.forward(
+					&(*input_buffer->begin()) + input_configuration_specific.get_neuron_count() * offset_input_entry_id,
+					&(*output_buffer->begin()),
+					&(*(*data)[0].begin()),
+					&(*(*data)[1].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_1x1_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides))
+			{
+				convolution_1x1_plain convolution_1x1_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+
+				convolution_1x1_engine.forward(
+					&(*input_buffer->begin()) + input_configuration_specific.get_neuron_count() * offset_input_entry_id,
+					&(*output_buffer->begin()),
+					&(*(*data)[0].begin()),
+					&(*(*data)[1].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_winograd_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_winograd_plain winograd_engine(
+					input_configuration_specific,
+					output_configuration_specific,
+					layer_derived->left_zero_padding);
+
+				winograd_engine.forward(
+					&(*input_buffer->begin()) + input_configuration_specific.get_neuron_count() * offset_input_entry_id,
+					&(*output_buffer->begin()),
+					&(*additional_buffers[1]->begin()),
+					&(*(*data)[1].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_fft_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_fft_plain fft_engine(
+					layer_derived->window_sizes,
+					layer_derived->left_zero_padding,
+					input_configuration_specific,
+					output_configuration_specific);
+
+				fft_engine.forward(
+					&(*input_buffer->begin()) + input_configuration_specific.get_neuron_count() * offset_input_entry_id,
+					&(*output_buffer->begin()),
+					&(*additional_buffers[1]->begin()),
+					&(*(*data)[1].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (gemm_engine.is_efficient())
+			{
+				gemm_engine.forward(
+					&(*input_buffer->begin()) + input_configuration_specific.get_neuron_count() * offset_input_entry_id,
+					&(*output_buffer->begin()),
+					&(*(*data)[0].begin()),
+					&(*(*data)[1].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_direct_plain::is_applicable(layer_derived->window_sizes))
+			{
+				convolution_direct_plain direct_engine(
+					layer_derived->window_sizes,
+					layer_derived->left_zero_padding,
+					layer_derived->strides,
+					input_configuration_specific,
+					output_configuration_specific);
+
+				direct_engine.forward(
+					&(*input_buffer->begin()) + input_configuration_specific.get_neuron_count() * offset_input_entry_id,
+					&(*output_buffer->begin()),
+					&(*(*data)[0].begin()),
+					&(*(*data)[1].begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else
+			{
+				test_direct(
+					input_buffer,
+					output_buffer,
+					additional_buffers,
+					plain_config,
+					layer_schema,
+					data,
+					data_custom,
+					input_configuration_specific,
+					output_configuration_specific,
+					updater_count,
+					offset_input_entry_id,
+					force_deterministic);
+			}
+		}
+
+		void convolution_layer_updater_plain::test_direct(
+			const_additional_buffer_smart_ptr input_buffer,
+			additional_buffer_smart_ptr output_buffer,
+			std::vector<additional_buffer_smart_ptr>& additional_buffers,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const_layer_data_custom_smart_ptr data_custom,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int updater_count,
+			unsigned int offset_input_entry_id,
+			bool force_deterministic) const
 		{
 			const unsigned int input_neuron_count = input_configuration_specific.get_neuron_count();
 			const unsigned int input_neuron_count_per_feature_map = input_configuration_specific.get_neuron_count_per_feature_map();
 			const unsigned int output_neuron_count = output_configuration_specific.get_neuron_count();
 			const unsigned int output_neuron_count_per_feature_map = output_configuration_specific.get_neuron_count_per_feature_map();
-			const std::vector<float>::const_iterator in_it_global = input_buffer->begin() + input_neuron_count * offset_input_entry_id;
-			const std::vector<float>::iterator out_it_global = output_buffer->begin();
+			const additional_buffer::const_iterator in_it_global = input_buffer->begin() + input_neuron_count * offset_input_entry_id;
+			const additional_buffer::iterator out_it_global = output_buffer->begin();
 			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
 
 			std::vector<unsigned int> window_sizes_extended = layer_derived->window_sizes;
@@ -75,6 +214,10 @@ namespace nnforge
 			right_zero_padding_extended.resize(max_dimension_count, 0);
 			const std::vector<unsigned int>& right_zero_padding = right_zero_padding_extended;
 
+			std::vector<unsigned int> strides_extended = layer_derived->strides;
+			strides_extended.resize(max_dimension_count, 1);
+			const std::vector<unsigned int>& strides = strides_extended;
+
 			std::vector<unsigned int> input_dimension_sizes_extended = input_configuration_specific.dimension_sizes;
 			input_dimension_sizes_extended .resize(max_dimension_count, 1);
 			const std::vector<unsigned int>& input_dimension_sizes = input_dimension_sizes_extended ;
@@ -117,7 +260,7 @@ namespace nnforge
 			const std::vector<unsigned int>::const_iterator input_slices_it = input_slices.begin();
 			const std::vector<unsigned int>::const_iterator offset_list_it = offset_list.begin();
 
-			#pragma omp parallel default(none) num_threads(plain_config->openmp_thread_count) shared(window_sizes,left_zero_padding,right_zero_padding,input_dimension_sizes)
+			#pragma omp parallel default(none) num_threads(plain_config->openmp_thread_count) shared(window_sizes,left_zero_padding,right_zero_padding,strides,input_dimension_sizes)
 			{
 				nnforge_array<unsigned int, max_dimension_count> current_output_position;
 				nnforge_array<int, max_dimension_count> current_input_position;
@@ -128,19 +271,19 @@ namespace nnforge
 					int entry_id = workload_id / output_feature_map_count;
 					int output_feature_map_id = workload_id - (entry_id * output_feature_map_count);
 
-					std::vector<float>::iterator out_it_base = out_it_global + (entry_id * output_neuron_count) + (output_feature_map_id * output_neuron_count_per_feature_map);
-					std::vector<float>::const_iterator in_it_base = in_it_global + entry_id * input_neuron_count;
+					additional_buffer::iterator out_it_base = out_it_global + (entry_id * output_neuron_count) + (output_feature_map_id * output_neuron_count_per_feature_map);
+					additional_buffer::const_iterator in_it_base = in_it_global + entry_id * input_neuron_count;
 
 					std::fill_n(current_input_position.begin(), max_dimension_count, 0);
 					std::fill_n(current_output_position.begin(), max_dimension_count, 0);
-					for(std::vector<float>::iterator out_it = out_it_base; out_it != out_it_base + output_neuron_count_per_feature_map; ++out_it)
+					for(additional_buffer::iterator out_it = out_it_base; out_it != out_it_base + output_neuron_count_per_feature_map; ++out_it)
 					{
 						float sum = *(biases + output_feature_map_id);
 						std::vector<float>::const_iterator weights_it = weights + (output_feature_map_id * (const_window_elem_count * input_feature_map_count));
 						int in_it_offset2 = 0;
 
 						for(unsigned int i = 0; i < dimension_count; ++i)
-							current_input_position[i] = static_cast<int>(current_output_position[i]) - static_cast<int>(left_zero_padding[i]);
+							current_input_position[i] = static_cast<int>(current_output_position[i] * strides[i]) - static_cast<int>(left_zero_padding[i]);
 
 						for(unsigned int i = 0; i < dimension_count; ++i)
 							in_it_offset2 += current_input_position[i] * (*(input_slices_it + i));
@@ -201,8 +344,121 @@ namespace nnforge
 			unsigned int updater_count,
 			bool force_deterministic) const
 		{
-			const std::vector<float>::iterator in_err_it_global = input_errors->begin();
-			const std::vector<float>::const_iterator out_err_it_global = output_errors->begin();
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+
+			convolution_gemm_plain gemm_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			if (fully_connected_gemm_plain::is_applicable(layer_derived->window_sizes, layer_derived->left_zero_padding, layer_derived->right_zero_padding, input_configuration_specific))
+			{
+				fully_connected_gemm_plain fully_connected_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+
+				fully_connected_engine.backprop(
+					&(*output_errors->begin()),
+					&(*input_errors->begin()),
+					&(*(*data)[0].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_1x1_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides))
+			{
+				convolution_1x1_plain convolution_1x1_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+
+				convolution_1x1_engine.backprop(
+					&(*output_errors->begin()),
+					&(*input_errors->begin()),
+					&(*(*data)[0].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_winograd_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_winograd_plain winograd_engine = convolution_winograd_plain::create_backprop_engine(
+					input_configuration_specific,
+					output_configuration_specific,
+					layer_derived->left_zero_padding);
+
+				winograd_engine.forward(
+					&(*output_errors->begin()),
+					&(*input_errors->begin()),
+					&(*additional_buffers[2]->begin()),
+					0,
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_fft_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_fft_plain fft_engine(
+					layer_derived->window_sizes,
+					layer_derived->left_zero_padding,
+					input_configuration_specific,
+					output_configuration_specific);
+
+				fft_engine.backprop(
+					&(*output_errors->begin()),
+					&(*input_errors->begin()),
+					&(*additional_buffers[1]->begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (gemm_engine.is_efficient())
+			{
+				gemm_engine.backprop(
+					&(*output_errors->begin()),
+					&(*input_errors->begin()),
+					&(*(*data)[0].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else
+			{
+				backprop_direct(
+					input_errors,
+					input_neurons,
+					output_errors,
+					output_neurons,
+					additional_buffers,
+					plain_config,
+					layer_schema,
+					data,
+					data_custom,
+					input_configuration_specific,
+					output_configuration_specific,
+					updater_count,
+					force_deterministic);
+			}
+		}
+
+		void convolution_layer_updater_plain::backprop_direct(
+			additional_buffer_smart_ptr input_errors,
+			const_additional_buffer_smart_ptr input_neurons,
+			const_additional_buffer_smart_ptr output_errors,
+			const_additional_buffer_smart_ptr output_neurons,
+			std::vector<additional_buffer_smart_ptr>& additional_buffers,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const_layer_data_custom_smart_ptr data_custom,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int updater_count,
+			bool force_deterministic) const
+		{
+			const additional_buffer::iterator in_err_it_global = input_errors->begin();
+			const additional_buffer::const_iterator out_err_it_global = output_errors->begin();
 			const unsigned int input_neuron_count = input_configuration_specific.get_neuron_count();
 			const unsigned int input_neuron_count_per_feature_map = input_configuration_specific.get_neuron_count_per_feature_map();
 			const unsigned int output_neuron_count = output_configuration_specific.get_neuron_count();
@@ -221,6 +477,10 @@ namespace nnforge
 			right_zero_padding_extended.resize(max_dimension_count, 0);
 			const std::vector<unsigned int>& right_zero_padding = right_zero_padding_extended;
 
+			std::vector<unsigned int> strides_extended = layer_derived->strides;
+			strides_extended.resize(max_dimension_count, 1);
+			const std::vector<unsigned int>& strides = strides_extended;
+
 			std::vector<unsigned int> input_dimension_sizes_extended = input_configuration_specific.dimension_sizes;
 			input_dimension_sizes_extended .resize(max_dimension_count, 1);
 			const std::vector<unsigned int>& input_dimension_sizes = input_dimension_sizes_extended ;
@@ -262,7 +522,7 @@ namespace nnforge
 			const std::vector<unsigned int>::const_iterator input_slices_it = input_slices.begin();
 			const std::vector<unsigned int>::const_iterator offset_list_it = offset_list.begin();
 
-			#pragma omp parallel default(none) num_threads(plain_config->openmp_thread_count) shared(window_sizes,left_zero_padding,right_zero_padding,input_dimension_sizes)
+			#pragma omp parallel default(none) num_threads(plain_config->openmp_thread_count) shared(window_sizes,left_zero_padding,right_zero_padding,strides,input_dimension_sizes)
 			{
 				nnforge_array<unsigned int, max_dimension_count> current_output_position;
 				nnforge_array<int, max_dimension_count> current_input_position;
@@ -273,26 +533,26 @@ namespace nnforge
 					int entry_id = workload_id / input_feature_map_count;
 					int input_feature_map_id = workload_id - (entry_id * input_feature_map_count);
 
-					std::vector<float>::const_iterator out_err_it_base = out_err_it_global + (entry_id * output_neuron_count);
-					std::vector<float>::iterator in_err_it_base = in_err_it_global + (entry_id * input_neuron_count) + (input_feature_map_id * input_neuron_count_per_feature_map);
+					additional_buffer::const_iterator out_err_it_base = out_err_it_global + (entry_id * output_neuron_count);
+					additional_buffer::iterator in_err_it_base = in_err_it_global + (entry_id * input_neuron_count) + (input_feature_map_id * input_neuron_count_per_feature_map);
 					std::vector<float>::const_iterator weights_it_base = weights + (const_window_elem_count * input_feature_map_id);
 
 					std::fill_n(in_err_it_base, input_neuron_count_per_feature_map, 0.0F);
 					std::fill_n(current_input_position.begin(), max_dimension_count, 0);
 					std::fill_n(current_output_position.begin(), max_dimension_count, 0);
-					for(std::vector<float>::const_iterator out_err_it_base2 = out_err_it_base; out_err_it_base2 != out_err_it_base + output_neuron_count_per_feature_map; ++out_err_it_base2)
+					for(additional_buffer::const_iterator out_err_it_base2 = out_err_it_base; out_err_it_base2 != out_err_it_base + output_neuron_count_per_feature_map; ++out_err_it_base2)
 					{
 						int in_err_offset = 0;
 
 						for(unsigned int i = 0; i < dimension_count; ++i)
-							current_input_position[i] = static_cast<int>(current_output_position[i]) - static_cast<int>(left_zero_padding[i]);
+							current_input_position[i] = static_cast<int>(current_output_position[i] * strides[i]) - static_cast<int>(left_zero_padding[i]);
 
 						for(unsigned int i = 0; i < dimension_count; ++i)
 							in_err_offset += current_input_position[i] * (*(input_slices_it + i));
 
 						for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
 						{
-							std::vector<float>::const_iterator out_err_it = out_err_it_base2 + (output_feature_map_id * output_neuron_count_per_feature_map);
+							additional_buffer::const_iterator out_err_it = out_err_it_base2 + (output_feature_map_id * output_neuron_count_per_feature_map);
 							std::vector<float>::const_iterator weights_it_base2 = weights_it_base + (output_feature_map_id * (const_window_elem_count * input_feature_map_count));
 							std::vector<float>::const_iterator weights_it = weights_it_base2;
 							float current_err = *out_err_it;
@@ -348,13 +608,150 @@ namespace nnforge
 			unsigned int updater_count,
 			unsigned int offset_input_entry_id,
 			bool force_deterministic) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+
+			convolution_gemm_plain gemm_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			if (fully_connected_gemm_plain::is_applicable(layer_derived->window_sizes, layer_derived->left_zero_padding, layer_derived->right_zero_padding, input_configuration_specific))
+			{
+				fully_connected_gemm_plain fully_connected_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+
+				fully_connected_engine.update_weights(
+					&(*input_neurons->begin()) + input_configuration_specific.get_neuron_count() * offset_input_entry_id,
+					&(*output_errors->begin()),
+					&(*(*gradient)[0].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_1x1_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides))
+			{
+				convolution_1x1_plain convolution_1x1_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+
+				convolution_1x1_engine.update_weights(
+					&(*input_neurons->begin()) + input_configuration_specific.get_neuron_count() * offset_input_entry_id,
+					&(*output_errors->begin()),
+					&(*(*gradient)[0].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_winograd_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_winograd_plain winograd_engine(
+					input_configuration_specific,
+					output_configuration_specific,
+					layer_derived->left_zero_padding);
+
+				winograd_engine.update_weights(
+					&(*input_neurons->begin()) + input_configuration_specific.get_neuron_count() * offset_input_entry_id,
+					&(*output_errors->begin()),
+					&(*(*gradient)[0].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (convolution_fft_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_fft_plain fft_engine(
+					layer_derived->window_sizes,
+					layer_derived->left_zero_padding,
+					input_configuration_specific,
+					output_configuration_specific);
+
+				fft_engine.update_weights(
+					&(*input_neurons->begin()) + input_configuration_specific.get_neuron_count() * offset_input_entry_id,
+					&(*output_errors->begin()),
+					&(*(*gradient)[0].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else if (gemm_engine.is_efficient())
+			{
+				gemm_engine.update_weights(
+					&(*input_neurons->begin()) + input_configuration_specific.get_neuron_count() * offset_input_entry_id,
+					&(*output_errors->begin()),
+					&(*(*gradient)[0].begin()),
+					&(*additional_buffers[0]->begin()),
+					updater_count,
+					plain_config->openmp_thread_count);
+			}
+			else
+			{
+				update_weights_direct(
+					input_neurons,
+					output_errors,
+					additional_buffers,
+					gradient,
+					data_custom,
+					plain_config,
+					layer_schema,
+					input_configuration_specific,
+					output_configuration_specific,
+					updater_count,
+					offset_input_entry_id,
+					force_deterministic);
+			}
+
+			const unsigned int output_neuron_count = output_configuration_specific.get_neuron_count();
+			const unsigned int output_neuron_count_per_feature_map = output_configuration_specific.get_neuron_count_per_feature_map();
+			const additional_buffer::const_iterator out_err_it_global = output_errors->begin();
+			const unsigned int output_feature_map_count = output_configuration_specific.feature_map_count;
+			const std::vector<float>::iterator gradient_biases = (*gradient)[1].begin();
+			const int const_updater_count = updater_count;
+
+			const int total_workload_bias = output_feature_map_count;
+			#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
+			for(int workload_id = 0; workload_id < total_workload_bias; ++workload_id)
+			{
+				int output_feature_map_id = workload_id;
+
+				float sum = 0.0F;
+				for(int entry_id = 0; entry_id < const_updater_count; ++entry_id)
+				{
+					float local_sum = 0.0F;
+					additional_buffer::const_iterator out_err_it_base = out_err_it_global + (entry_id * output_neuron_count) + (output_feature_map_id * output_neuron_count_per_feature_map);
+					for(additional_buffer::const_iterator out_err_it = out_err_it_base; out_err_it != out_err_it_base + output_neuron_count_per_feature_map; ++out_err_it)
+						local_sum += *out_err_it;
+
+					sum += local_sum;
+				}
+
+				*(gradient_biases + output_feature_map_id) += sum;
+			}
+		}
+
+		void convolution_layer_updater_plain::update_weights_direct(
+			const_additional_buffer_smart_ptr input_neurons,
+			const_additional_buffer_smart_ptr output_errors,
+			std::vector<additional_buffer_smart_ptr>& additional_buffers,
+			layer_data_smart_ptr gradient,
+			const_layer_data_custom_smart_ptr data_custom,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int updater_count,
+			unsigned int offset_input_entry_id,
+			bool force_deterministic) const
 		{
 			const unsigned int input_neuron_count = input_configuration_specific.get_neuron_count();
 			const unsigned int input_neuron_count_per_feature_map = input_configuration_specific.get_neuron_count_per_feature_map();
 			const unsigned int output_neuron_count = output_configuration_specific.get_neuron_count();
 			const unsigned int output_neuron_count_per_feature_map = output_configuration_specific.get_neuron_count_per_feature_map();
-			const std::vector<float>::const_iterator in_it_global = input_neurons->begin() + input_neuron_count * offset_input_entry_id;
-			const std::vector<float>::const_iterator out_err_it_global = output_errors->begin();
+			const additional_buffer::const_iterator in_it_global = input_neurons->begin() + input_neuron_count * offset_input_entry_id;
+			const additional_buffer::const_iterator out_err_it_global = output_errors->begin();
 			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
 
 			std::vector<unsigned int> window_sizes_extended = layer_derived->window_sizes;
@@ -369,6 +766,10 @@ namespace nnforge
 			right_zero_padding_extended.resize(max_dimension_count, 0);
 			const std::vector<unsigned int>& right_zero_padding = right_zero_padding_extended;
 
+			std::vector<unsigned int> strides_extended = layer_derived->strides;
+			strides_extended.resize(max_dimension_count, 1);
+			const std::vector<unsigned int>& strides = strides_extended;
+
 			std::vector<unsigned int> input_dimension_sizes_extended = input_configuration_specific.dimension_sizes;
 			input_dimension_sizes_extended .resize(max_dimension_count, 1);
 			const std::vector<unsigned int>& input_dimension_sizes = input_dimension_sizes_extended ;
@@ -384,7 +785,6 @@ namespace nnforge
 			const unsigned int const_window_elem_count = window_elem_count;
 
 			const std::vector<float>::iterator gradient_weights = (*gradient)[0].begin();
-			const std::vector<float>::iterator gradient_biases = (*gradient)[1].begin();
 
 			std::vector<unsigned int> current_local_input_position(dimension_count, 0);
 			std::vector<unsigned int> offset_list(window_elem_count);
@@ -407,13 +807,12 @@ namespace nnforge
 			const unsigned int output_feature_map_count = output_configuration_specific.feature_map_count;
 			const unsigned int input_feature_map_count = input_configuration_specific.feature_map_count;
 			const int total_workload = output_feature_map_count * input_feature_map_count;
-			const unsigned int const_entry_count = updater_count;
 			const std::vector<unsigned int>::const_iterator output_dimension_sizes_it = output_configuration_specific.dimension_sizes.begin();
 			const std::vector<unsigned int>::const_iterator input_slices_it = input_slices.begin();
 			const std::vector<unsigned int>::const_iterator offset_list_it = offset_list.begin();
 			const int const_updater_count = updater_count;
 
-			#pragma omp parallel default(none) num_threads(plain_config->openmp_thread_count) shared(window_sizes,left_zero_padding,right_zero_padding,input_dimension_sizes)
+			#pragma omp parallel default(none) num_threads(plain_config->openmp_thread_count) shared(window_sizes,left_zero_padding,right_zero_padding,strides,input_dimension_sizes)
 			{
 				nnforge_array<unsigned int, max_dimension_count> current_output_position;
 				nnforge_array<int, max_dimension_count> current_input_position;
@@ -431,17 +830,17 @@ namespace nnforge
 
 					for(int entry_id = 0; entry_id < const_updater_count; ++entry_id)
 					{
-						std::vector<float>::const_iterator in_it_base = in_it_global + (entry_id * input_neuron_count) + (input_feature_map_id * input_neuron_count_per_feature_map);
-						std::vector<float>::const_iterator out_err_it_base = out_err_it_global + (entry_id * output_neuron_count) + (output_feature_map_id * output_neuron_count_per_feature_map);
+						additional_buffer::const_iterator in_it_base = in_it_global + (entry_id * input_neuron_count) + (input_feature_map_id * input_neuron_count_per_feature_map);
+						additional_buffer::const_iterator out_err_it_base = out_err_it_global + (entry_id * output_neuron_count) + (output_feature_map_id * output_neuron_count_per_feature_map);
 
 						std::fill_n(current_input_position.begin(), max_dimension_count, 0);
 						std::fill_n(current_output_position.begin(), max_dimension_count, 0);
-						for(std::vector<float>::const_iterator out_err_it = out_err_it_base; out_err_it != out_err_it_base + output_neuron_count_per_feature_map; ++out_err_it)
+						for(additional_buffer::const_iterator out_err_it = out_err_it_base; out_err_it != out_err_it_base + output_neuron_count_per_feature_map; ++out_err_it)
 						{
 							int in_it_offset = 0;
 
 							for(unsigned int i = 0; i < dimension_count; ++i)
-								current_input_position[i] = static_cast<int>(current_output_position[i]) - static_cast<int>(left_zero_padding[i]);
+								current_input_position[i] = static_cast<int>(current_output_position[i] * strides[i]) - static_cast<int>(left_zero_padding[i]);
 
 							for(unsigned int i = 0; i < dimension_count; ++i)
 								in_it_offset += current_input_position[i] * (*(input_slices_it + i));
@@ -487,25 +886,61 @@ namespace nnforge
 						*it += *weights_local_it;
 				}
 			}
+		}
 
-			const int total_workload_bias = output_feature_map_count;
-			#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
-			for(int workload_id = 0; workload_id < total_workload_bias; ++workload_id)
-			{
-				int output_feature_map_id = workload_id;
+		void convolution_layer_updater_plain::update_data_derived_buffers(
+			std::vector<additional_buffer_smart_ptr>& additional_buffers,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
 
-				float sum = 0.0F;
-				for(int entry_id = 0; entry_id < const_updater_count; ++entry_id)
-				{
-					float local_sum = 0.0F;
-					std::vector<float>::const_iterator out_err_it_base = out_err_it_global + (entry_id * output_neuron_count) + (output_feature_map_id * output_neuron_count_per_feature_map);
-					for(std::vector<float>::const_iterator out_err_it = out_err_it_base; out_err_it != out_err_it_base + output_neuron_count_per_feature_map; ++out_err_it)
-						local_sum += *out_err_it;
+			// The same precedence as in test
+			if (fully_connected_gemm_plain::is_applicable(layer_derived->window_sizes, layer_derived->left_zero_padding, layer_derived->right_zero_padding, input_configuration_specific) || convolution_1x1_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides))
+				return;
 
-					sum += local_sum;
+			if (convolution_winograd_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_winograd_plain winograd_engine(
+					input_configuration_specific,
+					output_configuration_specific,
+					layer_derived->left_zero_padding);
+				winograd_engine.transform_weights(
+					&(*(*data)[0].begin()),
+					&(*additional_buffers[1]->begin()),
+					false,
+					plain_config->openmp_thread_count);
+
+				// The buffer is there only when backprop is required
+				if (additional_buffers.size() > 2)
+				{
+					convolution_winograd_plain backprop_winograd_engine = convolution_winograd_plain::create_backprop_engine(
+						input_configuration_specific,
+						output_configuration_specific,
+						layer_derived->left_zero_padding);
+					backprop_winograd_engine.transform_weights(
+						&(*(*data)[0].begin()),
+						&(*additional_buffers[2]->begin()),
+						true,
+						plain_config->openmp_thread_count);
 				}
-
-				*(gradient_biases + output_feature_map_id) += sum;
+			}
+			else if (convolution_fft_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_fft_plain fft_engine(
+					layer_derived->window_sizes,
+					layer_derived->left_zero_padding,
+					input_configuration_specific,
+					output_configuration_specific);
+
+				// Forward and backprop share the spectra
+				fft_engine.transform_weights(
+					&(*(*data)[0].begin()),
+					&(*additional_buffers[1]->begin()),
+					plain_config->openmp_thread_count);
 			}
 		}
 
@@ -513,5 +948,86 @@ namespace nnforge
 		{
 			return false;
 		}
+
+		std::vector<std::pair<unsigned int, bool> > convolution_layer_updater_plain::get_elem_count_and_per_entry_flag_additional_buffers(
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			plain_running_configuration_const_smart_ptr plain_config,
+			bool backprop_required) const
+		{
+			std::vector<std::pair<unsigned int, bool> > res;
+
+			nnforge_shared_ptr<const convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const convolution_layer>(layer_schema);
+			if (!layer_derived)
+				throw neural_network_exception("convolution_layer_updater_plain cannot size buffers for a layer which is not convolution_layer");
+			if (fully_connected_gemm_plain::is_applicable(layer_derived->window_sizes, layer_derived->left_zero_padding, layer_derived->right_zero_padding, input_configuration_specific))
+			{
+				fully_connected_gemm_plain fully_connected_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+				res.push_back(std::make_pair<unsigned int, bool>(fully_connected_engine.get_buffer_elem_count() * plain_config->openmp_thread_count, false));
+			}
+			else if (convolution_1x1_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides))
+			{
+				convolution_1x1_plain convolution_1x1_engine(
+					input_configuration_specific,
+					output_configuration_specific);
+				res.push_back(std::make_pair<unsigned int, bool>(convolution_1x1_engine.get_buffer_elem_count() * plain_config->openmp_thread_count, false));
+			}
+			else if (convolution_winograd_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_winograd_plain winograd_engine(
+					input_configuration_specific,
+					output_configuration_specific,
+					layer_derived->left_zero_padding);
+				unsigned int scratch_elem_count = std::max(
+					winograd_engine.get_buffer_elem_count() * plain_config->openmp_thread_count,
+					winograd_engine.get_update_weights_buffer_elem_count(plain_config->openmp_thread_count));
+				unsigned int backprop_transformed_weights_elem_count = 0;
+				if (backprop_required)
+				{
+					convolution_winograd_plain backprop_winograd_engine = convolution_winograd_plain::create_backprop_engine(
+						input_configuration_specific,
+						output_configuration_specific,
+						layer_derived->left_zero_padding);
+					scratch_elem_count = std::max(scratch_elem_count, backprop_winograd_engine.get_buffer_elem_count() * plain_config->openmp_thread_count);
+					backprop_transformed_weights_elem_count = backprop_winograd_engine.get_transformed_weights_elem_count();
+				}
+
+				// Scratch, transformed weights for forward and for backprop: the weights are transformed once per update
+				res.push_back(std::make_pair(scratch_elem_count, false));
+				res.push_back(std::make_pair(winograd_engine.get_transformed_weights_elem_count(), false));
+				if (backprop_required)
+					res.push_back(std::make_pair(backprop_transformed_weights_elem_count, false));
+			}
+			else if (convolution_fft_plain::is_applicable(layer_derived->window_sizes, layer_derived->strides, input_configuration_specific, output_configuration_specific))
+			{
+				convolution_fft_plain fft_engine(
+					layer_derived->window_sizes,
+					layer_derived->left_zero_padding,
+					input_configuration_specific,
+					output_configuration_specific);
+				unsigned int scratch_elem_count = fft_engine.get_update_weights_buffer_elem_count();
+				unsigned int weights_spectrum_elem_count = fft_engine.get_weights_spectrum_elem_count();
+
+				res.push_back(std::make_pair(scratch_elem_count, false));
+				res.push_back(std::make_pair(weights_spectrum_elem_count, false));
+			}
+			else
+			{
+				convolution_gemm_plain gemm_engine(
+					layer_derived->window_sizes,
+					layer_derived->left_zero_padding,
+					layer_derived->strides,
+					input_configuration_specific,
+					output_configuration_specific);
+				// Column buffer for forward and backprop, column buffer and partial gradient for update_weights
+				if (gemm_engine.is_efficient())
+					res.push_back(std::make_pair<unsigned int, bool>(gemm_engine.get_update_weights_buffer_elem_count() * plain_config->openmp_thread_count, false));
+			}
+
+			return res;
+		}
 	}
 }
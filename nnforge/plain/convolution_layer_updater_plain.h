@@ -74,10 +74,69 @@ namespace nnforge
 				unsigned int offset_input_entry_id,
 				bool force_deterministic) const;
 
+			// Winograd-transformed weights and weight spectra are computed here, once per weight update
+			virtual void update_data_derived_buffers(
+				std::vector<additional_buffer_smart_ptr>& additional_buffers,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_layer_data_smart_ptr data,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
 		protected:
 			virtual bool is_in_place_backprop() const;
 
+			virtual std::vector<std::pair<unsigned int, bool> > get_elem_count_and_per_entry_flag_additional_buffers(
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				plain_running_configuration_const_smart_ptr plain_config,
+				bool backprop_required) const;
+
 		private:
+			void test_direct(
+				const_additional_buffer_smart_ptr input_buffer,
+				additional_buffer_smart_ptr output_buffer,
+				std::vector<additional_buffer_smart_ptr>& additional_buffers,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_layer_data_smart_ptr data,
+				const_layer_data_custom_smart_ptr data_custom,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int updater_count,
+				unsigned int offset_input_entry_id,
+				bool force_deterministic) const;
+
+			void backprop_direct(
+				additional_buffer_smart_ptr input_errors,
+				const_additional_buffer_smart_ptr input_neurons,
+				const_additional_buffer_smart_ptr output_errors,
+				const_additional_buffer_smart_ptr output_neurons,
+				std::vector<additional_buffer_smart_ptr>& additional_buffers,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_layer_data_smart_ptr data,
+				const_layer_data_custom_smart_ptr data_custom,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int updater_count,
+				bool force_deterministic) const;
+
+			void update_weights_direct(
+				const_additional_buffer_smart_ptr input_neurons,
+				const_additional_buffer_smart_ptr output_errors,
+				std::vector<additional_buffer_smart_ptr>& additional_buffers,
+				layer_data_smart_ptr gradient,
+				const_layer_data_custom_smart_ptr data_custom,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int updater_count,
+				unsigned int offset_input_entry_id,
+				bool force_deterministic) const;
+
 			static const int max_dimension_count;
 		};
 	}
@@ -0,0 +1,591 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "convolution_winograd_plain.h"
+
+#include "gemm_plain.h"
+#include "../neural_network_exception.h"
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		const unsigned int convolution_winograd_plain::window_size;
+		const unsigned int convolution_winograd_plain::max_alpha;
+		const unsigned int convolution_winograd_plain::tile_batch_size;
+
+		convolution_winograd_plain::convolution_winograd_plain(
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			const std::vector<unsigned int>& left_zero_padding)
+			: input_feature_map_count(input_configuration_specific.feature_map_count)
+			, output_feature_map_count(output_configuration_specific.feature_map_count)
+			, input_width(static_cast<int>(input_configuration_specific.dimension_sizes[0]))
+			, input_height(static_cast<int>(input_configuration_specific.dimension_sizes[1]))
+			, output_width(static_cast<int>(output_configuration_specific.dimension_sizes[0]))
+			, output_height(static_cast<int>(output_configuration_specific.dimension_sizes[1]))
+			, left_zero_padding_x(static_cast<int>(left_zero_padding[0]))
+			, left_zero_padding_y(static_cast<int>(left_zero_padding[1]))
+		{
+			// F(4x4, 3x3) saves more multiplications but wastes more on partial tiles of small feature maps
+			tile_size = ((output_width >= 8) && (output_height >= 8)) ? 4 : 2;
+			alpha = tile_size + window_size - 1;
+
+			tile_count_x = (output_width + tile_size - 1) / tile_size;
+			tile_count_y = (output_height + tile_size - 1) / tile_size;
+			tile_count = tile_count_x * tile_count_y;
+
+			// Transformed tiles of a block should stay in L2 cache, yet the block should be wide enough for SGEMM
+			const unsigned int tile_block_buffer_budget = 256 * 1024;
+			tile_block_size = tile_block_buffer_budget / (alpha * alpha * (input_feature_map_count + output_feature_map_count));
+			tile_block_size = std::max((tile_block_size / gemm_plain::nr) * gemm_plain::nr, gemm_plain::nr);
+			tile_block_size = std::min(tile_block_size, tile_count);
+
+			// Toom-Cook construction with interpolation points 0, 1, -1, 2, -2 and infinity:
+			// Y = A^T [(G g G^T) . (B^T d B)] A, where A = V(m), G = V(3), B^T = V(alpha)^-T
+			// and V(n) is alpha x n Vandermonde matrix of the points
+			const double points[max_alpha - 1] = {0.0, 1.0, -1.0, 2.0, -2.0};
+			double v[max_alpha][max_alpha];
+			for(unsigned int j = 0; j < alpha; ++j)
+			{
+				double val = 1.0;
+				for(unsigned int k = 0; k < alpha; ++k)
+				{
+					v[j][k] = (j < alpha - 1) ? val : ((k == alpha - 1) ? 1.0 : 0.0);
+					val *= points[std::min(j, alpha - 2)];
+				}
+			}
+
+			a_t.resize(tile_size * alpha);
+			a.resize(alpha * tile_size);
+			for(unsigned int j = 0; j < alpha; ++j)
+				for(unsigned int k = 0; k < tile_size; ++k)
+				{
+					float val = static_cast<float>((j < alpha - 1) ? v[j][k] : ((k == tile_size - 1) ? 1.0 : 0.0));
+					a[j * tile_size + k] = val;
+					a_t[k * alpha + j] = val;
+				}
+
+			g.resize(alpha * window_size);
+			g_t.resize(window_size * alpha);
+			for(unsigned int j = 0; j < alpha; ++j)
+				for(unsigned int k = 0; k < window_size; ++k)
+				{
+					float val = static_cast<float>((j < alpha - 1) ? v[j][k] : ((k == window_size - 1) ? 1.0 : 0.0));
+					g[j * window_size + k] = val;
+					g_t[k * alpha + j] = val;
+				}
+
+			// Gauss-Jordan elimination with partial pivoting
+			double inv[max_alpha][max_alpha];
+			for(unsigned int j = 0; j < alpha; ++j)
+				for(unsigned int k = 0; k < alpha; ++k)
+					inv[j][k] = (j == k) ? 1.0 : 0.0;
+			for(unsigned int col = 0; col < alpha; ++col)
+			{
+				unsigned int pivot = col;
+				for(unsigned int j = col + 1; j < alpha; ++j)
+					if (std::abs(v[j][col]) > std::abs(v[pivot][col]))
+						pivot = j;
+				for(unsigned int k = 0; k < alpha; ++k)
+				{
+					std::swap(v[col][k], v[pivot][k]);
+					std::swap(inv[col][k], inv[pivot][k]);
+				}
+				double mult = 1.0 / v[col][col];
+				for(unsigned int k = 0; k < alpha; ++k)
+				{
+					v[col][k] *= mult;
+					inv[col][k] *= mult;
+				}
+				for(unsigned int j = 0; j < alpha; ++j)
+				{
+					if (j == col)
+						continue;
+					double factor = v[j][col];
+					for(unsigned int k = 0; k < alpha; ++k)
+					{
+						v[j][k] -= factor * v[col][k];
+						inv[j][k] -= factor * inv[col][k];
+					}
+				}
+			}
+
+			b_t.resize(alpha * alpha);
+			for(unsigned int j = 0; j < alpha; ++j)
+				for(unsigned int k = 0; k < alpha; ++k)
+					b_t[j * alpha + k] = static_cast<float>(inv[k][j]);
+		}
+
+		bool convolution_winograd_plain::is_applicable(
+			const std::vector<unsigned int>& window_sizes,
+			const std::vector<unsigned int>& strides,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+		{
+			if (window_sizes.size() != 2)
+				return false;
+			if ((window_sizes[0] != window_size) || (window_sizes[1] != window_size))
+				return false;
+			for(std::vector<unsigned int>::const_iterator it = strides.begin(); it != strides.end(); ++it)
+				if (*it != 1)
+					return false;
+
+			return (input_configuration_specific.feature_map_count >= 4) && (output_configuration_specific.feature_map_count >= 4);
+		}
+
+		convolution_winograd_plain convolution_winograd_plain::create_backprop_engine(
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			const std::vector<unsigned int>& left_zero_padding)
+		{
+			// Input errors are the full convolution of output errors with the rotated window
+			std::vector<unsigned int> backprop_left_zero_padding(left_zero_padding.size());
+			for(unsigned int i = 0; i < left_zero_padding.size(); ++i)
+				backprop_left_zero_padding[i] = window_size - 1 - left_zero_padding[i];
+
+			return convolution_winograd_plain(
+				output_configuration_specific,
+				input_configuration_specific,
+				backprop_left_zero_padding);
+		}
+
+		unsigned int convolution_winograd_plain::get_tile_size() const
+		{
+			return tile_size;
+		}
+
+		unsigned int convolution_winograd_plain::get_transformed_weights_elem_count() const
+		{
+			return alpha * alpha * output_feature_map_count * input_feature_map_count;
+		}
+
+		unsigned int convolution_winograd_plain::get_buffer_elem_count() const
+		{
+			return alpha * alpha * (input_feature_map_count + output_feature_map_count) * tile_block_size
+				+ gemm_plain::get_workspace_elem_count(output_feature_map_count, tile_block_size, input_feature_map_count);
+		}
+
+		unsigned int convolution_winograd_plain::get_update_weights_buffer_elem_count(int thread_count) const
+		{
+			return alpha * alpha * (input_feature_map_count + output_feature_map_count) * tile_block_size
+				+ get_transformed_weights_elem_count()
+				+ gemm_plain::get_workspace_elem_count(output_feature_map_count, input_feature_map_count, tile_block_size) * thread_count;
+		}
+
+		void convolution_winograd_plain::transform(
+			const float * mat,
+			unsigned int rows,
+			unsigned int cols,
+			const float * src,
+			unsigned int src_stride,
+			float * dst,
+			unsigned int dst_stride,
+			unsigned int count)
+		{
+			float tmp[max_alpha * max_alpha * tile_batch_size];
+			for(unsigned int r = 0; r < rows; ++r)
+			{
+				for(unsigned int c = 0; c < cols; ++c)
+				{
+					float * tmp_elem = tmp + (r * cols + c) * tile_batch_size;
+					for(unsigned int t = 0; t < count; ++t)
+						tmp_elem[t] = 0.0F;
+					for(unsigned int k = 0; k < cols; ++k)
+					{
+						// Transform matrices are sparse
+						float mult = mat[r * cols + k];
+						if (mult == 0.0F)
+							continue;
+						const float * src_elem = src + (k * cols + c) * src_stride;
+						for(unsigned int t = 0; t < count; ++t)
+							tmp_elem[t] += mult * src_elem[t];
+					}
+				}
+			}
+
+			for(unsigned int r1 = 0; r1 < rows; ++r1)
+			{
+				for(unsigned int r2 = 0; r2 < rows; ++r2)
+				{
+					float * dst_elem = dst + (r1 * rows + r2) * dst_stride;
+					for(unsigned int t = 0; t < count; ++t)
+						dst_elem[t] = 0.0F;
+					for(unsigned int k = 0; k < cols; ++k)
+					{
+						float mult = mat[r2 * cols + k];
+						if (mult == 0.0F)
+							continue;
+						const float * tmp_elem = tmp + (r1 * cols + k) * tile_batch_size;
+						for(unsigned int t = 0; t < count; ++t)
+							dst_elem[t] += mult * tmp_elem[t];
+					}
+				}
+			}
+		}
+
+		void convolution_winograd_plain::load_tile(
+			const float * feature_map,
+			int x_start,
+			int y_start,
+			int width,
+			int height,
+			int tile_width,
+			int tile_height,
+			float * tile,
+			unsigned int tile_stride) const
+		{
+			for(int y = 0; y < tile_height; ++y)
+			{
+				float * dst = tile + y * tile_width * tile_stride;
+				int src_y = y_start + y;
+				bool fit_y = ((unsigned int)src_y < (unsigned int)height);
+				const float * src = feature_map + src_y * width;
+				for(int x = 0; x < tile_width; ++x)
+				{
+					int src_x = x_start + x;
+					dst[x * tile_stride] = (fit_y && ((unsigned int)src_x < (unsigned int)width)) ? src[src_x] : 0.0F;
+				}
+			}
+		}
+
+		void convolution_winograd_plain::transform_weights(
+			const float * weights,
+			float * transformed_weights,
+			bool flip,
+			int thread_count) const
+		{
+			const unsigned int window_elem_count = window_size * window_size;
+			const unsigned int feature_map_pair_count = output_feature_map_count * input_feature_map_count;
+			const int total_workload = static_cast<int>(feature_map_pair_count);
+
+			#pragma omp parallel for default(none) schedule(guided) num_threads(thread_count) shared(weights,transformed_weights,flip)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				int output_feature_map_id = workload_id / input_feature_map_count;
+				int input_feature_map_id = workload_id - (output_feature_map_id * input_feature_map_count);
+
+				float window[window_size * window_size];
+				if (flip)
+				{
+					const float * src = weights + (input_feature_map_id * output_feature_map_count + output_feature_map_id) * window_elem_count;
+					for(unsigned int i = 0; i < window_elem_count; ++i)
+						window[i] = src[window_elem_count - 1 - i];
+				}
+				else
+				{
+					const float * src = weights + workload_id * window_elem_count;
+					std::copy(src, src + window_elem_count, window);
+				}
+
+				transform(
+					&(*g.begin()),
+					alpha,
+					window_size,
+					window,
+					1,
+					transformed_weights + workload_id,
+					feature_map_pair_count,
+					1);
+			}
+		}
+
+		void convolution_winograd_plain::forward(
+			const float * input,
+			float * output,
+			const float * transformed_weights,
+			const float * biases,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int alpha2 = alpha * alpha;
+			const unsigned int input_neuron_count_per_feature_map = input_width * input_height;
+			const unsigned int output_neuron_count_per_feature_map = output_width * output_height;
+			const unsigned int input_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count;
+			const unsigned int output_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count;
+			const unsigned int buffer_elem_count = get_buffer_elem_count();
+			const unsigned int block_count = (tile_count + tile_block_size - 1) / tile_block_size;
+			const int total_workload = static_cast<int>(entry_count * block_count);
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(input,output,transformed_weights,biases,buffers)
+			{
+				int thread_id = 0;
+				#ifdef _OPENMP
+				thread_id = omp_get_thread_num();
+				#endif
+
+				float * transformed_input = buffers + thread_id * buffer_elem_count;
+				float * transformed_output = transformed_input + alpha2 * input_feature_map_count * tile_block_size;
+				float * workspace = transformed_output + alpha2 * output_feature_map_count * tile_block_size;
+				float tiles[max_alpha * max_alpha * tile_batch_size];
+
+				#pragma omp for schedule(dynamic)
+				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+				{
+					int entry_id = workload_id / block_count;
+					int block_id = workload_id - (entry_id * block_count);
+					unsigned int tile_start = block_id * tile_block_size;
+					unsigned int current_tile_count = std::min(tile_block_size, tile_count - tile_start);
+
+					const float * in_entry = input + entry_id * input_neuron_count;
+					for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count; ++input_feature_map_id)
+					{
+						const float * in_feature_map = in_entry + input_feature_map_id * input_neuron_count_per_feature_map;
+						for(unsigned int batch_start = 0; batch_start < current_tile_count; batch_start += tile_batch_size)
+						{
+							unsigned int batch_size = std::min(tile_batch_size, current_tile_count - batch_start);
+							for(unsigned int t = 0; t < batch_size; ++t)
+							{
+								unsigned int tile_id = tile_start + batch_start + t;
+								unsigned int tile_y = tile_id / tile_count_x;
+								unsigned int tile_x = tile_id - tile_y * tile_count_x;
+								load_tile(
+									in_feature_map,
+									static_cast<int>(tile_x * tile_size) - left_zero_padding_x,
+									static_cast<int>(tile_y * tile_size) - left_zero_padding_y,
+									input_width,
+									input_height,
+									alpha,
+									alpha,
+									tiles + t,
+									tile_batch_size);
+							}
+
+							transform(
+								&(*b_t.begin()),
+								alpha,
+								alpha,
+								tiles,
+								tile_batch_size,
+								transformed_input + input_feature_map_id * current_tile_count + batch_start,
+								input_feature_map_count * current_tile_count,
+								batch_size);
+						}
+					}
+
+					for(unsigned int xi = 0; xi < alpha2; ++xi)
+					{
+						gemm_plain::sgemm(
+							false,
+							false,
+							output_feature_map_count,
+							current_tile_count,
+							input_feature_map_count,
+							transformed_weights + xi * output_feature_map_count * input_feature_map_count,
+							input_feature_map_count,
+							transformed_input + xi * input_feature_map_count * current_tile_count,
+							current_tile_count,
+							transformed_output + xi * output_feature_map_count * current_tile_count,
+							current_tile_count,
+							false,
+							workspace);
+					}
+
+					float * out_entry = output + entry_id * output_neuron_count;
+					for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+					{
+						float * out_feature_map = out_entry + output_feature_map_id * output_neuron_count_per_feature_map;
+						float bias = biases ? biases[output_feature_map_id] : 0.0F;
+						for(unsigned int batch_start = 0; batch_start < current_tile_count; batch_start += tile_batch_size)
+						{
+							unsigned int batch_size = std::min(tile_batch_size, current_tile_count - batch_start);
+							transform(
+								&(*a_t.begin()),
+								tile_size,
+								alpha,
+								transformed_output + output_feature_map_id * current_tile_count + batch_start,
+								output_feature_map_count * current_tile_count,
+								tiles,
+								tile_batch_size,
+								batch_size);
+
+							for(unsigned int t = 0; t < batch_size; ++t)
+							{
+								unsigned int tile_id = tile_start + batch_start + t;
+								unsigned int tile_y = tile_id / tile_count_x;
+								unsigned int tile_x = tile_id - tile_y * tile_count_x;
+								int x_start = tile_x * tile_size;
+								int y_start = tile_y * tile_size;
+								int valid_width = std::min(static_cast<int>(tile_size), output_width - x_start);
+								int valid_height = std::min(static_cast<int>(tile_size), output_height - y_start);
+								for(int y = 0; y < valid_height; ++y)
+								{
+									float * dst = out_feature_map + (y_start + y) * output_width + x_start;
+									const float * src = tiles + (y * tile_size) * tile_batch_size + t;
+									for(int x = 0; x < valid_width; ++x)
+										dst[x] = src[x * tile_batch_size] + bias;
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		void convolution_winograd_plain::update_weights(
+			const float * input,
+			const float * output_errors,
+			float * gradient_weights,
+			float * buffer,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			// The gradient is the correlation of the input with output errors, computed as F(3x3, m x m):
+			// dW = G^T [sum over tiles (A e A^T) . (B^T d B)] G
+			const unsigned int alpha2 = alpha * alpha;
+			const unsigned int window_elem_count = window_size * window_size;
+			const unsigned int input_neuron_count_per_feature_map = input_width * input_height;
+			const unsigned int output_neuron_count_per_feature_map = output_width * output_height;
+			const unsigned int input_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count;
+			const unsigned int output_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count;
+			const unsigned int feature_map_pair_count = output_feature_map_count * input_feature_map_count;
+			const unsigned int block_count = (tile_count + tile_block_size - 1) / tile_block_size;
+
+			float * transformed_input = buffer;
+			float * transformed_output_errors = transformed_input + alpha2 * input_feature_map_count * tile_block_size;
+			float * transformed_gradient = transformed_output_errors + alpha2 * output_feature_map_count * tile_block_size;
+			float * workspaces = transformed_gradient + alpha2 * feature_map_pair_count;
+			const unsigned int workspace_elem_count = gemm_plain::get_workspace_elem_count(output_feature_map_count, input_feature_map_count, tile_block_size);
+			std::fill_n(transformed_gradient, alpha2 * feature_map_pair_count, 0.0F);
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(input,output_errors,gradient_weights,transformed_input,transformed_output_errors,transformed_gradient,workspaces,entry_count)
+			{
+				int thread_id = 0;
+				#ifdef _OPENMP
+				thread_id = omp_get_thread_num();
+				#endif
+
+				float * workspace = workspaces + thread_id * workspace_elem_count;
+				float tiles[max_alpha * max_alpha * tile_batch_size];
+
+				for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+				{
+					const float * in_entry = input + entry_id * input_neuron_count;
+					const float * out_err_entry = output_errors + entry_id * output_neuron_count;
+					for(unsigned int block_id = 0; block_id < block_count; ++block_id)
+					{
+						unsigned int tile_start = block_id * tile_block_size;
+						unsigned int current_tile_count = std::min(tile_block_size, tile_count - tile_start);
+						unsigned int batch_count = (current_tile_count + tile_batch_size - 1) / tile_batch_size;
+						int transform_workload = static_cast<int>((input_feature_map_count + output_feature_map_count) * batch_count);
+
+						#pragma omp for schedule(guided)
+						for(int workload_id = 0; workload_id < transform_workload; ++workload_id)
+						{
+							unsigned int feature_map_id = workload_id / batch_count;
+							unsigned int batch_start = (workload_id - feature_map_id * batch_count) * tile_batch_size;
+							unsigned int batch_size = std::min(tile_batch_size, current_tile_count - batch_start);
+							bool is_input = (feature_map_id < input_feature_map_count);
+							for(unsigned int t = 0; t < batch_size; ++t)
+							{
+								unsigned int tile_id = tile_start + batch_start + t;
+								unsigned int tile_y = tile_id / tile_count_x;
+								unsigned int tile_x = tile_id - tile_y * tile_count_x;
+								if (is_input)
+									load_tile(
+										in_entry + feature_map_id * input_neuron_count_per_feature_map,
+										static_cast<int>(tile_x * tile_size) - left_zero_padding_x,
+										static_cast<int>(tile_y * tile_size) - left_zero_padding_y,
+										input_width,
+										input_height,
+										alpha,
+										alpha,
+										tiles + t,
+										tile_batch_size);
+								else
+									load_tile(
+										out_err_entry + (feature_map_id - input_feature_map_count) * output_neuron_count_per_feature_map,
+										static_cast<int>(tile_x * tile_size),
+										static_cast<int>(tile_y * tile_size),
+										output_width,
+										output_height,
+										tile_size,
+										tile_size,
+										tiles + t,
+										tile_batch_size);
+							}
+
+							if (is_input)
+								transform(
+									&(*b_t.begin()),
+									alpha,
+									alpha,
+									tiles,
+									tile_batch_size,
+									transformed_input + feature_map_id * current_tile_count + batch_start,
+									input_feature_map_count * current_tile_count,
+									batch_size);
+							else
+								transform(
+									&(*a.begin()),
+									alpha,
+									tile_size,
+									tiles,
+									tile_batch_size,
+									transformed_output_errors + (feature_map_id - input_feature_map_count) * current_tile_count + batch_start,
+									output_feature_map_count * current_tile_count,
+									batch_size);
+						}
+
+						#pragma omp for schedule(dynamic)
+						for(int xi = 0; xi < static_cast<int>(alpha2); ++xi)
+						{
+							gemm_plain::sgemm(
+								false,
+								true,
+								output_feature_map_count,
+								input_feature_map_count,
+								current_tile_count,
+								transformed_output_errors + xi * output_feature_map_count * current_tile_count,
+								current_tile_count,
+								transformed_input + xi * input_feature_map_count * current_tile_count,
+								current_tile_count,
+								transformed_gradient + xi * feature_map_pair_count,
+								input_feature_map_count,
+								true,
+								workspace);
+						}
+					}
+				}
+
+				#pragma omp for schedule(guided)
+				for(int workload_id = 0; workload_id < static_cast<int>(feature_map_pair_count); ++workload_id)
+				{
+					transform(
+						&(*g_t.begin()),
+						window_size,
+						alpha,
+						transformed_gradient + workload_id,
+						feature_map_pair_count,
+						tiles,
+						1,
+						1);
+
+					float * dst = gradient_weights + workload_id * window_elem_count;
+					for(unsigned int i = 0; i < window_elem_count; ++i)
+						dst[i] += tiles[i];
+				}
+			}
+		}
+	}
+}
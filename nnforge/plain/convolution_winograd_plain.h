@@ -0,0 +1,147 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../layer_configuration_specific.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Winograd F(m x m, 3 x 3) convolution for 2D layers with 3x3 window, m is either 2 or 4
+		// Weights are transformed into alpha x alpha (alpha = m + 2) matrices of output_feature_map_count x input_feature_map_count,
+		// input tiles are transformed into alpha x alpha matrices of input_feature_map_count x tile_count,
+		// both are multiplied element-wise with alpha x alpha independent SGEMMs
+		class convolution_winograd_plain
+		{
+		public:
+			// left_zero_padding is assumed to be less than window size, as convolution_layer requires
+			convolution_winograd_plain(
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				const std::vector<unsigned int>& left_zero_padding);
+
+			// Returns true if the layer has 2D 3x3 window with unit strides and enough feature maps for the transforms to pay off
+			static bool is_applicable(
+				const std::vector<unsigned int>& window_sizes,
+				const std::vector<unsigned int>& strides,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific);
+
+			// The engine computing input errors from output errors of the layer
+			static convolution_winograd_plain create_backprop_engine(
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				const std::vector<unsigned int>& left_zero_padding);
+
+			unsigned int get_tile_size() const;
+
+			unsigned int get_transformed_weights_elem_count() const;
+
+			// The size of the scratch buffer the caller should provide for each thread running forward
+			unsigned int get_buffer_elem_count() const;
+
+			// The size of the scratch buffer for thread_count threads running update_weights:
+			// transformed blocks and gradient shared by all the threads followed by SGEMM workspace of each thread
+			unsigned int get_update_weights_buffer_elem_count(int thread_count) const;
+
+			// weights are output_feature_map_count x input_feature_map_count x 3 x 3
+			// If flip is true the weights are those of the original layer and the engine is a backprop one,
+			// they are transposed and rotated by 180 degrees on the fly
+			void transform_weights(
+				const float * weights,
+				float * transformed_weights,
+				bool flip,
+				int thread_count) const;
+
+			// biases might be NULL
+			// buffers should have get_buffer_elem_count() elements per thread
+			void forward(
+				const float * input,
+				float * output,
+				const float * transformed_weights,
+				const float * biases,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// Gradient is added to gradient_weights, biases are not touched
+			// buffer should have get_update_weights_buffer_elem_count(thread_count) elements
+			void update_weights(
+				const float * input,
+				const float * output_errors,
+				float * gradient_weights,
+				float * buffer,
+				unsigned int entry_count,
+				int thread_count) const;
+
+		private:
+			// dst = mat * src * transpose(mat) for count matrices processed at once, mat is rows x cols, src is cols x cols
+			// Matrices are interleaved: element (r, c) of matrix t is at src[(r * cols + c) * src_stride + t],
+			// count should not exceed tile_batch_size
+			static void transform(
+				const float * mat,
+				unsigned int rows,
+				unsigned int cols,
+				const float * src,
+				unsigned int src_stride,
+				float * dst,
+				unsigned int dst_stride,
+				unsigned int count);
+
+			// Copies tile_width x tile_height region of the feature map, zero padded, into interleaved tile
+			void load_tile(
+				const float * feature_map,
+				int x_start,
+				int y_start,
+				int width,
+				int height,
+				int tile_width,
+				int tile_height,
+				float * tile,
+				unsigned int tile_stride) const;
+
+			static const unsigned int window_size = 3;
+			static const unsigned int max_alpha = 6;
+			static const unsigned int tile_batch_size = 16;
+
+			unsigned int tile_size;
+			unsigned int alpha;
+			unsigned int input_feature_map_count;
+			unsigned int output_feature_map_count;
+			int input_width;
+			int input_height;
+			int output_width;
+			int output_height;
+			int left_zero_padding_x;
+			int left_zero_padding_y;
+			unsigned int tile_count_x;
+			unsigned int tile_count_y;
+			unsigned int tile_count;
+			unsigned int tile_block_size;
+
+			// Transform matrices, row-major
+			std::vector<float> a_t; // m x alpha
+			std::vector<float> a; // alpha x m
+			std::vector<float> g; // alpha x 3
+			std::vector<float> g_t; // 3 x alpha
+			std::vector<float> b_t; // alpha x alpha
+		};
+	}
+}
@@ -0,0 +1,200 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "data_reader_prefetcher_plain.h"
+
+#include "../neural_network_exception.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		data_reader_prefetcher_plain::prefetch_functor::prefetch_functor(data_reader_prefetcher_plain * prefetcher)
+			: prefetcher(prefetcher)
+		{
+		}
+
+		void data_reader_prefetcher_plain::prefetch_functor::operator()()
+		{
+			prefetcher->run_prefetch();
+		}
+
+		data_reader_prefetcher_plain::data_reader_prefetcher_plain(
+			unsupervised_data_reader& reader,
+			const std::vector<unsigned int>& chunk_entry_count_list,
+			unsigned int queue_depth)
+			: reader(reader)
+			, supervised_reader(0)
+		{
+			init(chunk_entry_count_list, queue_depth);
+		}
+
+		data_reader_prefetcher_plain::data_reader_prefetcher_plain(
+			supervised_data_reader& reader,
+			const std::vector<unsigned int>& chunk_entry_count_list,
+			unsigned int queue_depth)
+			: reader(reader)
+			, supervised_reader(&reader)
+		{
+			init(chunk_entry_count_list, queue_depth);
+		}
+
+		data_reader_prefetcher_plain::~data_reader_prefetcher_plain()
+		{
+			if (prefetch_thread)
+			{
+				{
+					boost::lock_guard<boost::mutex> lock(state_mutex);
+					stop_requested = true;
+				}
+				chunk_released_condition.notify_one();
+				prefetch_thread->join();
+			}
+		}
+
+		void data_reader_prefetcher_plain::init(
+			const std::vector<unsigned int>& chunk_entry_count_list,
+			unsigned int queue_depth)
+		{
+			if (chunk_entry_count_list.empty())
+				throw neural_network_exception("Empty chunk entry count list specified for data_reader_prefetcher_plain");
+
+			this->chunk_entry_count_list = chunk_entry_count_list;
+			input_elem_count_per_entry = reader.get_input_configuration().get_neuron_count() * reader.get_input_neuron_elem_size();
+			output_elem_count_per_entry = supervised_reader ? supervised_reader->get_output_configuration().get_neuron_count() : 0;
+			read_chunk_count = 0;
+			taken_chunk_count = 0;
+			released_chunk_count = 0;
+			end_of_data = false;
+			stop_requested = false;
+
+			const unsigned int max_chunk_entry_count = *std::max_element(chunk_entry_count_list.begin(), chunk_entry_count_list.end());
+			chunks.resize(queue_depth + 1);
+			for(std::vector<chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+			{
+				it->input.resize(input_elem_count_per_entry * max_chunk_entry_count);
+				it->output.resize(output_elem_count_per_entry * max_chunk_entry_count);
+				it->entry_count = 0;
+			}
+
+			if (queue_depth > 0)
+				prefetch_thread = nnforge_shared_ptr<boost::thread>(new boost::thread(prefetch_functor(this)));
+		}
+
+		unsigned int data_reader_prefetcher_plain::get_next_chunk(
+			const unsigned char *& input,
+			const float *& output)
+		{
+			input = 0;
+			output = 0;
+
+			if (!prefetch_thread)
+			{
+				if (end_of_data)
+					return 0;
+				end_of_data = !read_chunk(taken_chunk_count);
+			}
+			else
+			{
+				boost::unique_lock<boost::mutex> lock(state_mutex);
+				// The chunk given by the previous call is not used anymore
+				released_chunk_count = taken_chunk_count;
+				chunk_released_condition.notify_one();
+				while ((read_chunk_count == taken_chunk_count) && !end_of_data && error.empty())
+					chunk_read_condition.wait(lock);
+
+				if (!error.empty())
+					throw neural_network_exception(error);
+
+				if (read_chunk_count == taken_chunk_count)
+					return 0;
+			}
+
+			const chunk& current_chunk = chunks[taken_chunk_count % chunks.size()];
+			++taken_chunk_count;
+
+			if (!current_chunk.input.empty())
+				input = &current_chunk.input[0];
+			if (!current_chunk.output.empty())
+				output = &current_chunk.output[0];
+
+			return current_chunk.entry_count;
+		}
+
+		bool data_reader_prefetcher_plain::read_chunk(unsigned int chunk_id)
+		{
+			chunk& current_chunk = chunks[chunk_id % chunks.size()];
+			const unsigned int entry_count = chunk_entry_count_list[chunk_id % chunk_entry_count_list.size()];
+
+			if (supervised_reader)
+				current_chunk.entry_count = supervised_reader->read_batch(entry_count, &current_chunk.input[0], &current_chunk.output[0]);
+			else
+				current_chunk.entry_count = reader.read_batch(entry_count, &current_chunk.input[0]);
+
+			return (current_chunk.entry_count == entry_count);
+		}
+
+		void data_reader_prefetcher_plain::run_prefetch()
+		{
+			try
+			{
+				for(unsigned int chunk_id = 0; ; ++chunk_id)
+				{
+					{
+						boost::unique_lock<boost::mutex> lock(state_mutex);
+						while (!stop_requested && (chunk_id - released_chunk_count >= chunks.size()))
+							chunk_released_condition.wait(lock);
+						if (stop_requested)
+							return;
+					}
+
+					bool entries_remained = read_chunk(chunk_id);
+
+					{
+						boost::lock_guard<boost::mutex> lock(state_mutex);
+						++read_chunk_count;
+						end_of_data = !entries_remained;
+					}
+					chunk_read_condition.notify_one();
+
+					if (!entries_remained)
+						return;
+				}
+			}
+			catch (const std::exception& e)
+			{
+				{
+					boost::lock_guard<boost::mutex> lock(state_mutex);
+					error = e.what();
+					end_of_data = true;
+				}
+				chunk_read_condition.notify_one();
+			}
+			catch (...)
+			{
+				{
+					boost::lock_guard<boost::mutex> lock(state_mutex);
+					error = "Unknown error reading entries";
+					end_of_data = true;
+				}
+				chunk_read_condition.notify_one();
+			}
+		}
+	}
+}
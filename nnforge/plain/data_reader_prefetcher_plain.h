@@ -0,0 +1,109 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../supervised_data_reader.h"
+
+#include <vector>
+#include <string>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Reads chunks of entries on a background thread, up to queue_depth chunks ahead of the one being processed,
+		// so that reading overlaps with the computations. With queue_depth 0 the chunks are read in the calling thread when requested.
+		// The reader should not be used by others until the object is destroyed
+		class data_reader_prefetcher_plain
+		{
+		public:
+			// The chunks are of chunk_entry_count_list[0], chunk_entry_count_list[1], ... entries, the list is cycled
+			data_reader_prefetcher_plain(
+				unsupervised_data_reader& reader,
+				const std::vector<unsigned int>& chunk_entry_count_list,
+				unsigned int queue_depth);
+
+			// Reads the output neurons too
+			data_reader_prefetcher_plain(
+				supervised_data_reader& reader,
+				const std::vector<unsigned int>& chunk_entry_count_list,
+				unsigned int queue_depth);
+
+			~data_reader_prefetcher_plain();
+
+			// Returns the entry count of the next chunk, 0 when there are no entries left.
+			// input and output point to the entries of the chunk until the next call, output is null for the unsupervised reader.
+			// An exception thrown by the reader on the background thread is rethrown here as neural_network_exception
+			unsigned int get_next_chunk(
+				const unsigned char *& input,
+				const float *& output);
+
+		private:
+			data_reader_prefetcher_plain(const data_reader_prefetcher_plain&);
+			data_reader_prefetcher_plain& operator =(const data_reader_prefetcher_plain&);
+
+			struct chunk
+			{
+				std::vector<unsigned char> input;
+				std::vector<float> output;
+				unsigned int entry_count;
+			};
+
+			struct prefetch_functor
+			{
+				prefetch_functor(data_reader_prefetcher_plain * prefetcher);
+
+				void operator()();
+
+				data_reader_prefetcher_plain * prefetcher;
+			};
+
+			void init(
+				const std::vector<unsigned int>& chunk_entry_count_list,
+				unsigned int queue_depth);
+
+			// Reads the chunk chunk_id, returns false if the end of data is reached
+			bool read_chunk(unsigned int chunk_id);
+
+			void run_prefetch();
+
+			unsupervised_data_reader& reader;
+			supervised_data_reader * supervised_reader;
+			std::vector<unsigned int> chunk_entry_count_list;
+			size_t input_elem_count_per_entry;
+			unsigned int output_elem_count_per_entry;
+
+			// The chunk chunk_id is stored in chunks[chunk_id % chunks.size()]
+			std::vector<chunk> chunks;
+			nnforge_shared_ptr<boost::thread> prefetch_thread;
+
+			boost::mutex state_mutex;
+			boost::condition_variable chunk_read_condition;
+			boost::condition_variable chunk_released_condition;
+			// Chunks read, given to the consumer and released by it
+			unsigned int read_chunk_count;
+			unsigned int taken_chunk_count;
+			unsigned int released_chunk_count;
+			bool end_of_data;
+			bool stop_requested;
+			std::string error;
+		};
+	}
+}
@@ -16,14 +16,25 @@
 
 #include "dropout_layer_updater_plain.h"
 
+#include "philox_plain.h"
 #include "../dropout_layer.h"
 #include "../neural_network_exception.h"
 #include "../nn_types.h"
 
+#include <algorithm>
+
 namespace nnforge
 {
 	namespace plain
 	{
+		const unsigned int dropout_layer_updater_plain::elem_count_per_mask_word;
+
+		const unsigned int dropout_layer_updater_plain::mask_word_bits[elem_count_per_mask_word] = {
+			1U << 0, 1U << 1, 1U << 2, 1U << 3, 1U << 4, 1U << 5, 1U << 6, 1U << 7,
+			1U << 8, 1U << 9, 1U << 10, 1U << 11, 1U << 12, 1U << 13, 1U << 14, 1U << 15,
+			1U << 16, 1U << 17, 1U << 18, 1U << 19, 1U << 20, 1U << 21, 1U << 22, 1U << 23,
+			1U << 24, 1U << 25, 1U << 26, 1U << 27, 1U << 28, 1U << 29, 1U << 30, 1U << 31};
+
 		dropout_layer_updater_plain::dropout_layer_updater_plain()
 			: gen(rnd::get_random_generator())
 		{
@@ -61,29 +72,52 @@ namespace nnforge
 			}
 			else
 			{
-				const std::vector<float>::const_iterator in_it_global = input_buffer->begin();
-				const std::vector<float>::iterator out_it_global = output_buffer->begin();
-				unsigned char * keep_elem_ptr = reinterpret_cast<unsigned char *>(&(additional_buffers[0]->at(0)));
+				const float * const in = &(*input_buffer->begin());
+				float * const out = &(*output_buffer->begin());
+				unsigned int * const keep_mask = reinterpret_cast<unsigned int *>(&(*additional_buffers[0]->begin()));
 
 				nnforge_shared_ptr<const dropout_layer> layer_derived = nnforge_dynamic_pointer_cast<const dropout_layer>(layer_schema);
 				const float dropout_rate = layer_derived->dropout_rate;
 				const float keep_rate = 1.0F - dropout_rate;
 				const float mult = 1.0F / keep_rate;
-
-				const int total_workload = input_configuration_specific.get_neuron_count() * updater_count;
-
-				nnforge_uniform_real_distribution<float> dist(0.0F, 1.0F);
-
-				for(int i = 0; i < total_workload; ++i)
-					keep_elem_ptr[i] = (dist(gen) <= keep_rate ? (unsigned char)1 : (unsigned char)0);
-
-				#pragma omp parallel default(none) num_threads(plain_config->openmp_thread_count) shared(keep_elem_ptr)
+				// The upper 24 bits of a random number are compared with the threshold, so keep_rate = 1 keeps everything
+				const unsigned int keep_threshold = static_cast<unsigned int>(keep_rate * 16777216.0F);
+
+				// A new key for each call, the numbers for each block of mask words are generated from the key and the index of the block,
+				// so the masks do not depend on the thread count
+				nnforge_uniform_int_distribution<unsigned int> dist(0U, 0xFFFFFFFFU);
+				const unsigned int key0 = dist(gen);
+				const unsigned int key1 = dist(gen);
+
+				const unsigned int elem_count = input_configuration_specific.get_neuron_count() * updater_count;
+				const unsigned int mask_word_count = (elem_count + elem_count_per_mask_word - 1) / elem_count_per_mask_word;
+				const unsigned int mask_words_per_block = philox_plain::numbers_per_block / elem_count_per_mask_word;
+				const int total_workload = static_cast<int>((mask_word_count + mask_words_per_block - 1) / mask_words_per_block);
+
+				#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+				for(int block_id = 0; block_id < total_workload; ++block_id)
 				{
-					#pragma omp for schedule(guided)
-					for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+					unsigned int random_numbers[philox_plain::numbers_per_block];
+					philox_plain::generate(key0, key1, 0, block_id, random_numbers);
+
+					const unsigned int mask_word_start = block_id * mask_words_per_block;
+					const unsigned int current_mask_word_count = std::min(mask_words_per_block, mask_word_count - mask_word_start);
+					for(unsigned int i = 0; i < current_mask_word_count; ++i)
 					{
-						int elem_id = workload_id;
-						*(out_it_global + elem_id) = *(in_it_global + elem_id) * (keep_elem_ptr[elem_id] ? mult : 0.0F);
+						const unsigned int * numbers = random_numbers + i * elem_count_per_mask_word;
+						unsigned int keep_mask_word = 0;
+						for(unsigned int j = 0; j < elem_count_per_mask_word; ++j)
+							keep_mask_word |= ((numbers[j] >> 8) < keep_threshold) ? mask_word_bits[j] : 0U;
+
+						const unsigned int mask_word_id = mask_word_start + i;
+						const unsigned int elem_start = mask_word_id * elem_count_per_mask_word;
+						keep_mask[mask_word_id] = keep_mask_word;
+						apply_keep_mask_word(
+							in + elem_start,
+							out + elem_start,
+							keep_mask_word,
+							std::min(elem_count_per_mask_word, elem_count - elem_start),
+							mult);
 					}
 				}
 			}
@@ -107,24 +141,27 @@ namespace nnforge
 			if (force_deterministic)
 				return;
 
-			const std::vector<float>::iterator in_err_it_global = input_errors->begin();
-			unsigned char * keep_elem_ptr = reinterpret_cast<unsigned char *>(&(additional_buffers[0]->at(0)));
+			float * const in_err = &(*input_errors->begin());
+			const unsigned int * const keep_mask = reinterpret_cast<const unsigned int *>(&(*additional_buffers[0]->begin()));
 
 			nnforge_shared_ptr<const dropout_layer> layer_derived = nnforge_dynamic_pointer_cast<const dropout_layer>(layer_schema);
 			const float dropout_rate = layer_derived->dropout_rate;
 			const float keep_rate = 1.0F - dropout_rate;
 			const float mult = 1.0F / keep_rate;
 
-			const int total_workload = input_configuration_specific.get_neuron_count() * updater_count;
+			const unsigned int elem_count = input_configuration_specific.get_neuron_count() * updater_count;
+			const int total_workload = static_cast<int>((elem_count + elem_count_per_mask_word - 1) / elem_count_per_mask_word);
 
-			#pragma omp parallel default(none) num_threads(plain_config->openmp_thread_count) shared(keep_elem_ptr)
+			#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+			for(int mask_word_id = 0; mask_word_id < total_workload; ++mask_word_id)
 			{
-				#pragma omp for schedule(guided)
-				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
-				{
-					int elem_id = workload_id;
-					*(in_err_it_global + elem_id) *= (keep_elem_ptr[elem_id] ? mult : 0.0F);
-				}
+				const unsigned int elem_start = mask_word_id * elem_count_per_mask_word;
+				apply_keep_mask_word(
+					in_err + elem_start,
+					in_err + elem_start,
+					keep_mask[mask_word_id],
+					std::min(elem_count_per_mask_word, elem_count - elem_start),
+					mult);
 			}
 		}
 
@@ -137,11 +174,23 @@ namespace nnforge
 		{
 			std::vector<std::pair<unsigned int, bool> > res;
 
-			res.push_back(std::make_pair<unsigned int, bool>((output_configuration_specific.get_neuron_count() + 3) / 4, true));
+			// Keep mask, a bit per neuron
+			res.push_back(std::make_pair<unsigned int, bool>((output_configuration_specific.get_neuron_count() + elem_count_per_mask_word - 1) / elem_count_per_mask_word, true));
 
 			return res;
 		}
 
+		void dropout_layer_updater_plain::apply_keep_mask_word(
+			const float * input,
+			float * output,
+			unsigned int keep_mask_word,
+			unsigned int elem_count,
+			float mult)
+		{
+			for(unsigned int i = 0; i < elem_count; ++i)
+				output[i] = input[i] * ((keep_mask_word & mask_word_bits[i]) ? mult : 0.0F);
+		}
+
 		bool dropout_layer_updater_plain::is_in_place_backprop() const
 		{
 			return true;
@@ -23,6 +23,7 @@ namespace nnforge
 {
 	namespace plain
 	{
+		// The keep mask is generated with philox_plain in parallel and stored as a bit per neuron, it is applied in the same pass
 		class dropout_layer_updater_plain : public layer_updater_plain
 		{
 		public:
@@ -72,6 +73,20 @@ namespace nnforge
 				bool backprop_required) const;
 
 		private:
+			// output = input * mult for the neurons with their bits set in keep_mask_word, 0 for others; output might be equal to input
+			static void apply_keep_mask_word(
+				const float * input,
+				float * output,
+				unsigned int keep_mask_word,
+				unsigned int elem_count,
+				float mult);
+
+			// Neurons per 32-bit word of the keep mask
+			static const unsigned int elem_count_per_mask_word = 32;
+
+			// 1 << i for each bit of the mask word, SSE2 has no per-lane shifts so the loops over bits are vectorized with the table only
+			static const unsigned int mask_word_bits[elem_count_per_mask_word];
+
 			mutable random_generator gen;
 		};
 	}
@@ -19,8 +19,11 @@
 #include "network_tester_plain_factory.h"
 #include "network_updater_plain_factory.h"
 #include "network_analyzer_plain_factory.h"
+#include "../neural_network_exception.h"
 
 #include <iostream>
+#include <algorithm>
+#include <boost/format.hpp>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -37,6 +40,11 @@ namespace nnforge
 			: plain_openmp_thread_count(1)
 			#endif
 			, plain_max_global_memory_usage(0.5F)
+			, plain_blocked_layout(false)
+			, plain_weight_storage("fp32")
+			, plain_activation_storage("fp32")
+			, plain_huge_pages(false)
+			, plain_prefetch_queue_depth(1)
 		{
 		}
 
@@ -46,7 +54,24 @@ namespace nnforge
 
 		void factory_generator_plain::initialize()
 		{
-			plain_config = plain_running_configuration_const_smart_ptr(new plain_running_configuration(plain_openmp_thread_count, plain_max_global_memory_usage));
+			plain_running_configuration::weight_storage_type weight_storage = get_storage_type(plain_weight_storage, "weight");
+			plain_running_configuration::weight_storage_type activation_storage = get_storage_type(plain_activation_storage, "activation");
+
+			plain_config = plain_running_configuration_const_smart_ptr(new plain_running_configuration(plain_openmp_thread_count, plain_max_global_memory_usage, plain_blocked_layout, weight_storage, plain_huge_pages, static_cast<unsigned int>(std::max(plain_prefetch_queue_depth, 0)), activation_storage));
+		}
+
+		plain_running_configuration::weight_storage_type factory_generator_plain::get_storage_type(
+			const std::string& storage_name,
+			const char * storage_kind)
+		{
+			if (storage_name == "fp32")
+				return plain_running_configuration::weight_storage_fp32;
+			else if (storage_name == "fp16")
+				return plain_running_configuration::weight_storage_fp16;
+			else if (storage_name == "bf16")
+				return plain_running_configuration::weight_storage_bf16;
+			else
+				throw neural_network_exception((boost::format("Unknown plain %1% storage specified: %2%") % storage_kind % storage_name).str());
 		}
 
 		network_tester_factory_smart_ptr factory_generator_plain::create_tester_factory() const
@@ -64,6 +89,16 @@ namespace nnforge
 			return network_analyzer_factory_smart_ptr(new network_analyzer_plain_factory(plain_config));
 		}
 
+		std::vector<bool_option> factory_generator_plain::get_bool_options()
+		{
+			std::vector<bool_option> res;
+
+			res.push_back(bool_option("plain_blocked_layout", &plain_blocked_layout, false, "run chains of convolution and activation layers in the blocked feature map layout when testing, for the convolutions the blocked engine is faster on. Training stays in the planar layout."));
+			res.push_back(bool_option("plain_huge_pages", &plain_huge_pages, false, "advise the buffer arenas of testers and updaters to be backed by transparent huge pages (Linux only)."));
+
+			return res;
+		}
+
 		std::vector<float_option> factory_generator_plain::get_float_options()
 		{
 			std::vector<float_option> res;
@@ -80,6 +115,17 @@ namespace nnforge
 			#ifdef _OPENMP
 			res.push_back(int_option("plain_openmp_thread_count", &plain_openmp_thread_count, omp_get_max_threads(), "count of threads to be used in OpenMP."));
 			#endif
+			res.push_back(int_option("plain_prefetch_queue_depth", &plain_prefetch_queue_depth, 1, "count of chunks of entries read ahead on a background thread when testing and training; 0 means reading in the calling thread."));
+
+			return res;
+		}
+
+		std::vector<string_option> factory_generator_plain::get_string_options()
+		{
+			std::vector<string_option> res;
+
+			res.push_back(string_option("plain_weight_storage", &plain_weight_storage, "fp32", "storage of the weights of convolution layers when testing: fp32, fp16 or bf16."));
+			res.push_back(string_option("plain_activation_storage", &plain_activation_storage, "fp32", "storage of the activations between the layers when testing: fp32, fp16 or bf16."));
 
 			return res;
 		}
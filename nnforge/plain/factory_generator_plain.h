@@ -40,15 +40,29 @@ namespace nnforge
 
 			virtual void info() const;
 
+			virtual std::vector<bool_option> get_bool_options();
+
 			virtual std::vector<float_option> get_float_options();
 
 			virtual std::vector<int_option> get_int_options();
 
+			virtual std::vector<string_option> get_string_options();
+
 		protected:
 			float plain_max_global_memory_usage;
 			int plain_openmp_thread_count;
+			bool plain_blocked_layout;
+			std::string plain_weight_storage;
+			std::string plain_activation_storage;
+			bool plain_huge_pages;
+			int plain_prefetch_queue_depth;
 
 			plain_running_configuration_const_smart_ptr plain_config;
+
+		private:
+			static plain_running_configuration::weight_storage_type get_storage_type(
+				const std::string& storage_name,
+				const char * storage_kind);
 		};
 	}
 }
@@ -0,0 +1,297 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "fully_connected_gemm_plain.h"
+
+#include "gemm_plain.h"
+
+#include <vector>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		static inline const float * get_weight_row(
+			const float * weights,
+			float * row_buffer,
+			unsigned int elem_count)
+		{
+			return weights;
+		}
+
+		static inline const float * get_weight_row(
+			const half_float_plain::fp16 * weights,
+			float * row_buffer,
+			unsigned int elem_count)
+		{
+			for(unsigned int i = 0; i < elem_count; ++i)
+				row_buffer[i] = half_float_plain::to_float(weights[i]);
+			return row_buffer;
+		}
+
+		static inline const float * get_weight_row(
+			const half_float_plain::bf16 * weights,
+			float * row_buffer,
+			unsigned int elem_count)
+		{
+			for(unsigned int i = 0; i < elem_count; ++i)
+				row_buffer[i] = half_float_plain::to_float(weights[i]);
+			return row_buffer;
+		}
+
+		// Independent partial sums hide the latency of the additions
+		static inline float dot_product(
+			const float * a,
+			const float * b,
+			unsigned int elem_count)
+		{
+			const unsigned int lane_count = 16;
+			float sums[lane_count];
+			for(unsigned int j = 0; j < lane_count; ++j)
+				sums[j] = 0.0F;
+
+			unsigned int i = 0;
+			for(; i + lane_count <= elem_count; i += lane_count)
+				for(unsigned int j = 0; j < lane_count; ++j)
+					sums[j] += a[i + j] * b[i + j];
+
+			float sum = 0.0F;
+			for(unsigned int j = 0; j < lane_count; ++j)
+				sum += sums[j];
+			for(; i < elem_count; ++i)
+				sum += a[i] * b[i];
+
+			return sum;
+		}
+
+		static void multiply_by_transposed_weights(
+			const float * input,
+			const float * weights,
+			float * output,
+			float * buffers,
+			unsigned int entry_count,
+			unsigned int output_neuron_count,
+			unsigned int input_neuron_count,
+			int thread_count)
+		{
+			gemm_plain::parallel_sgemm(
+				false,
+				true,
+				entry_count,
+				output_neuron_count,
+				input_neuron_count,
+				input,
+				input_neuron_count,
+				weights,
+				input_neuron_count,
+				output,
+				output_neuron_count,
+				true,
+				buffers,
+				thread_count);
+		}
+
+		// 16-bit weights are converted to fp32 a block of rows at a time: packing transposed B reads it with a stride,
+		// converting it there would be done element by element
+		template<typename weight_type>
+		static void multiply_by_transposed_weights(
+			const float * input,
+			const weight_type * weights,
+			float * output,
+			float * buffers,
+			unsigned int entry_count,
+			unsigned int output_neuron_count,
+			unsigned int input_neuron_count,
+			int thread_count)
+		{
+			const unsigned int block_row_count = 128;
+			std::vector<float> converted_weights(std::min(block_row_count, output_neuron_count) * input_neuron_count);
+			float * const converted_weights_ptr = &(*converted_weights.begin());
+
+			for(unsigned int output_neuron_start = 0; output_neuron_start < output_neuron_count; output_neuron_start += block_row_count)
+			{
+				const unsigned int row_count = std::min(block_row_count, output_neuron_count - output_neuron_start);
+				const int total_workload = static_cast<int>(row_count);
+
+				#pragma omp parallel for default(none) schedule(static) num_threads(thread_count) shared(weights,input_neuron_count,output_neuron_start)
+				for(int row_id = 0; row_id < total_workload; ++row_id)
+					get_weight_row(weights + (output_neuron_start + row_id) * input_neuron_count, converted_weights_ptr + row_id * input_neuron_count, input_neuron_count);
+
+				gemm_plain::parallel_sgemm(
+					false,
+					true,
+					entry_count,
+					row_count,
+					input_neuron_count,
+					input,
+					input_neuron_count,
+					converted_weights_ptr,
+					input_neuron_count,
+					output + output_neuron_start,
+					output_neuron_count,
+					true,
+					buffers,
+					thread_count);
+			}
+		}
+
+		const unsigned int fully_connected_gemm_plain::max_dot_product_entry_count;
+
+		fully_connected_gemm_plain::fully_connected_gemm_plain(
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+			: input_neuron_count(input_configuration_specific.get_neuron_count())
+			, output_neuron_count(output_configuration_specific.get_neuron_count())
+		{
+		}
+
+		bool fully_connected_gemm_plain::is_applicable(
+			const std::vector<unsigned int>& window_sizes,
+			const std::vector<unsigned int>& left_zero_padding,
+			const std::vector<unsigned int>& right_zero_padding,
+			const layer_configuration_specific& input_configuration_specific)
+		{
+			if (window_sizes != input_configuration_specific.dimension_sizes)
+				return false;
+
+			for(std::vector<unsigned int>::const_iterator it = left_zero_padding.begin(); it != left_zero_padding.end(); ++it)
+				if (*it != 0)
+					return false;
+			for(std::vector<unsigned int>::const_iterator it = right_zero_padding.begin(); it != right_zero_padding.end(); ++it)
+				if (*it != 0)
+					return false;
+
+			return true;
+		}
+
+		unsigned int fully_connected_gemm_plain::get_buffer_elem_count() const
+		{
+			// Batch dimension is capped by the blocking of SGEMM
+			return std::max(
+				std::max(
+					gemm_plain::get_workspace_elem_count(gemm_plain::mc, output_neuron_count, input_neuron_count),
+					gemm_plain::get_workspace_elem_count(gemm_plain::mc, input_neuron_count, output_neuron_count)),
+				gemm_plain::get_workspace_elem_count(output_neuron_count, input_neuron_count, gemm_plain::kc));
+		}
+
+		template<typename weight_type>
+		void fully_connected_gemm_plain::forward(
+			const float * input,
+			float * output,
+			const weight_type * weights,
+			const float * biases,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			if (entry_count <= max_dot_product_entry_count)
+			{
+				// SGEMM would spend more time packing the weights than multiplying them
+				const int total_workload = static_cast<int>(output_neuron_count);
+
+				#pragma omp parallel default(none) num_threads(thread_count) shared(input,output,weights,biases,entry_count)
+				{
+					std::vector<float> row_buffer(input_neuron_count);
+
+					#pragma omp for schedule(static)
+					for(int output_neuron_id = 0; output_neuron_id < total_workload; ++output_neuron_id)
+					{
+						const float * weight_row = get_weight_row(weights + output_neuron_id * input_neuron_count, &(*row_buffer.begin()), input_neuron_count);
+						for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+							output[entry_id * output_neuron_count + output_neuron_id] = biases[output_neuron_id] + dot_product(input + entry_id * input_neuron_count, weight_row, input_neuron_count);
+					}
+				}
+
+				return;
+			}
+
+			for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+				std::copy(biases, biases + output_neuron_count, output + entry_id * output_neuron_count);
+
+			// output (entries x outputs) += input (entries x inputs) * transpose(weights (outputs x inputs))
+			multiply_by_transposed_weights(
+				input,
+				weights,
+				output,
+				buffers,
+				entry_count,
+				output_neuron_count,
+				input_neuron_count,
+				thread_count);
+		}
+
+		template void fully_connected_gemm_plain::forward<float>(const float *, float *, const float *, const float *, float *, unsigned int, int) const;
+		template void fully_connected_gemm_plain::forward<half_float_plain::fp16>(const float *, float *, const half_float_plain::fp16 *, const float *, float *, unsigned int, int) const;
+		template void fully_connected_gemm_plain::forward<half_float_plain::bf16>(const float *, float *, const half_float_plain::bf16 *, const float *, float *, unsigned int, int) const;
+
+		void fully_connected_gemm_plain::backprop(
+			const float * output_errors,
+			float * input_errors,
+			const float * weights,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			// input_errors (entries x inputs) = output_errors (entries x outputs) * weights (outputs x inputs)
+			gemm_plain::parallel_sgemm(
+				false,
+				false,
+				entry_count,
+				input_neuron_count,
+				output_neuron_count,
+				output_errors,
+				output_neuron_count,
+				weights,
+				input_neuron_count,
+				input_errors,
+				input_neuron_count,
+				false,
+				buffers,
+				thread_count);
+		}
+
+		void fully_connected_gemm_plain::update_weights(
+			const float * input,
+			const float * output_errors,
+			float * gradient_weights,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			// gradient_weights (outputs x inputs) += transpose(output_errors (entries x outputs)) * input (entries x inputs)
+			gemm_plain::parallel_sgemm(
+				true,
+				false,
+				output_neuron_count,
+				input_neuron_count,
+				entry_count,
+				output_errors,
+				output_neuron_count,
+				input,
+				input_neuron_count,
+				gradient_weights,
+				input_neuron_count,
+				true,
+				buffers,
+				thread_count);
+		}
+	}
+}
@@ -0,0 +1,87 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../layer_configuration_specific.h"
+#include "half_float_plain.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Convolution with the window covering the whole input, expressed as matrix products over the batch:
+		// entries x input neurons times input neurons x output feature maps
+		class fully_connected_gemm_plain
+		{
+		public:
+			fully_connected_gemm_plain(
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific);
+
+			// Returns true if the window matches input dimensions and there is no zero padding
+			static bool is_applicable(
+				const std::vector<unsigned int>& window_sizes,
+				const std::vector<unsigned int>& left_zero_padding,
+				const std::vector<unsigned int>& right_zero_padding,
+				const layer_configuration_specific& input_configuration_specific);
+
+			// The size of SGEMM workspace the caller should provide for each thread, it doesn't depend on the batch size
+			unsigned int get_buffer_elem_count() const;
+
+			// buffers should have get_buffer_elem_count() elements per thread
+			// weight_type is float, half_float_plain::fp16 or half_float_plain::bf16
+			// Small batches are run as dot products of the rows of weights, which are read once and converted to fp32 row by row
+			template<typename weight_type>
+			void forward(
+				const float * input,
+				float * output,
+				const weight_type * weights,
+				const float * biases,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// buffers should have get_buffer_elem_count() elements per thread
+			void backprop(
+				const float * output_errors,
+				float * input_errors,
+				const float * weights,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// Gradient is added to gradient_weights, biases are not touched
+			// buffers should have get_buffer_elem_count() elements per thread
+			void update_weights(
+				const float * input,
+				const float * output_errors,
+				float * gradient_weights,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// The largest batch run with dot products, bigger ones are run with SGEMM
+			static const unsigned int max_dot_product_entry_count = 4;
+
+		private:
+			unsigned int input_neuron_count;
+			unsigned int output_neuron_count;
+		};
+	}
+}
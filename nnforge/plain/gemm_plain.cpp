@@ -0,0 +1,347 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "gemm_plain.h"
+
+#include "instruction_set_plain.h"
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define NNFORGE_PLAIN_TARGET_PRAGMAS
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		namespace gemm_sse2
+		{
+			#include "gemm_plain_kernels.h"
+		}
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+		namespace gemm_avx2
+		{
+			#include "gemm_plain_kernels.h"
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+#endif
+		namespace gemm_avx512
+		{
+			#include "gemm_plain_kernels.h"
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+
+		static inline float to_float(float val)
+		{
+			return val;
+		}
+
+		static inline float to_float(half_float_plain::fp16 val)
+		{
+			return half_float_plain::to_float(val);
+		}
+
+		static inline float to_float(half_float_plain::bf16 val)
+		{
+			return half_float_plain::to_float(val);
+		}
+
+		const unsigned int gemm_plain::mr;
+		const unsigned int gemm_plain::nr;
+		const unsigned int gemm_plain::mc;
+		const unsigned int gemm_plain::kc;
+		const unsigned int gemm_plain::nc;
+
+		template<typename a_element_type, typename b_element_type>
+		void gemm_plain::sgemm(
+			bool transpose_a,
+			bool transpose_b,
+			unsigned int m,
+			unsigned int n,
+			unsigned int k,
+			const a_element_type * a,
+			unsigned int lda,
+			const b_element_type * b,
+			unsigned int ldb,
+			float * c,
+			unsigned int ldc,
+			bool accumulate,
+			float * workspace)
+		{
+			if ((m == 0) || (n == 0))
+				return;
+
+			if (k == 0)
+			{
+				if (!accumulate)
+					for(unsigned int i = 0; i < m; ++i)
+						std::fill_n(c + i * ldc, n, 0.0F);
+				return;
+			}
+
+			const micro_kernel_function micro_kernel = get_micro_kernel();
+			const unsigned int block_m = std::min(mc, ((m + mr - 1) / mr) * mr);
+			const unsigned int block_k = std::min(kc, k);
+			float * const packed_a = workspace;
+			float * const packed_b = workspace + block_m * block_k;
+
+			for(unsigned int jc = 0; jc < n; jc += nc)
+			{
+				const unsigned int current_n = std::min(nc, n - jc);
+				for(unsigned int pc = 0; pc < k; pc += kc)
+				{
+					const unsigned int current_k = std::min(kc, k - pc);
+					const bool current_accumulate = accumulate || (pc > 0);
+
+					pack_b(
+						transpose_b,
+						current_k,
+						current_n,
+						transpose_b ? (b + jc * ldb + pc) : (b + pc * ldb + jc),
+						ldb,
+						packed_b);
+
+					for(unsigned int ic = 0; ic < m; ic += mc)
+					{
+						const unsigned int current_m = std::min(mc, m - ic);
+
+						pack_a(
+							transpose_a,
+							current_m,
+							current_k,
+							transpose_a ? (a + pc * lda + ic) : (a + ic * lda + pc),
+							lda,
+							packed_a);
+
+						for(unsigned int jr = 0; jr < current_n; jr += nr)
+						{
+							const float * packed_b_panel = packed_b + jr * current_k;
+							for(unsigned int ir = 0; ir < current_m; ir += mr)
+							{
+								micro_kernel(
+									current_k,
+									packed_a + ir * current_k,
+									packed_b_panel,
+									c + (ic + ir) * ldc + (jc + jr),
+									ldc,
+									std::min(mr, current_m - ir),
+									std::min(nr, current_n - jr),
+									current_accumulate);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		template<typename a_element_type, typename b_element_type>
+		void gemm_plain::parallel_sgemm(
+			bool transpose_a,
+			bool transpose_b,
+			unsigned int m,
+			unsigned int n,
+			unsigned int k,
+			const a_element_type * a,
+			unsigned int lda,
+			const b_element_type * b,
+			unsigned int ldb,
+			float * c,
+			unsigned int ldc,
+			bool accumulate,
+			float * workspace,
+			int thread_count)
+		{
+			if ((thread_count <= 1) || (m == 0) || (n == 0))
+			{
+				sgemm(transpose_a, transpose_b, m, n, k, a, lda, b, ldb, c, ldc, accumulate, workspace);
+				return;
+			}
+
+			// Split rows first, then columns to get about 2 tiles per thread
+			const unsigned int max_row_tile_count = (m + mr - 1) / mr;
+			const unsigned int max_column_tile_count = (n + nr - 1) / nr;
+			const unsigned int row_tile_count = std::min(max_row_tile_count, static_cast<unsigned int>(thread_count));
+			const unsigned int column_tile_count = std::min(max_column_tile_count, (static_cast<unsigned int>(thread_count) * 2 + row_tile_count - 1) / row_tile_count);
+			const unsigned int row_tile_size = (((m + row_tile_count - 1) / row_tile_count + mr - 1) / mr) * mr;
+			const unsigned int column_tile_size = (((n + column_tile_count - 1) / column_tile_count + nr - 1) / nr) * nr;
+			const unsigned int actual_row_tile_count = (m + row_tile_size - 1) / row_tile_size;
+			const unsigned int actual_column_tile_count = (n + column_tile_size - 1) / column_tile_size;
+			const int total_workload = static_cast<int>(actual_row_tile_count * actual_column_tile_count);
+
+			#pragma omp parallel for default(none) schedule(dynamic) num_threads(thread_count) shared(transpose_a,transpose_b,m,n,k,a,lda,b,ldb,c,ldc,accumulate,workspace)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				#ifdef _OPENMP
+				// Tiles are not larger than the whole matrices, so neither are their workspaces
+				float * thread_workspace = workspace + get_workspace_elem_count(m, n, k) * omp_get_thread_num();
+				#else
+				float * thread_workspace = workspace;
+				#endif
+				unsigned int row_tile_id = workload_id / actual_column_tile_count;
+				unsigned int column_tile_id = workload_id - row_tile_id * actual_column_tile_count;
+				unsigned int row_start = row_tile_id * row_tile_size;
+				unsigned int column_start = column_tile_id * column_tile_size;
+
+				sgemm(
+					transpose_a,
+					transpose_b,
+					std::min(row_tile_size, m - row_start),
+					std::min(column_tile_size, n - column_start),
+					k,
+					transpose_a ? (a + row_start) : (a + row_start * lda),
+					lda,
+					transpose_b ? (b + column_start * ldb) : (b + column_start),
+					ldb,
+					c + row_start * ldc + column_start,
+					ldc,
+					accumulate,
+					thread_workspace);
+			}
+		}
+
+		unsigned int gemm_plain::get_workspace_elem_count(
+			unsigned int m,
+			unsigned int n,
+			unsigned int k)
+		{
+			const unsigned int block_m = std::min(mc, ((m + mr - 1) / mr) * mr);
+			const unsigned int block_n = std::min(nc, ((n + nr - 1) / nr) * nr);
+			const unsigned int block_k = std::min(kc, k);
+			return block_m * block_k + block_k * block_n;
+		}
+
+		template<typename element_type>
+		void gemm_plain::pack_a(
+			bool transpose_a,
+			unsigned int m,
+			unsigned int k,
+			const element_type * a,
+			unsigned int lda,
+			float * packed_a)
+		{
+			for(unsigned int i0 = 0; i0 < m; i0 += mr)
+			{
+				const unsigned int current_m = std::min(mr, m - i0);
+				float * dst = packed_a + i0 * k;
+				if (transpose_a)
+				{
+					for(unsigned int p = 0; p < k; ++p)
+					{
+						const element_type * src = a + p * lda + i0;
+						unsigned int i = 0;
+						for(; i < current_m; ++i)
+							dst[i] = to_float(src[i]);
+						for(; i < mr; ++i)
+							dst[i] = 0.0F;
+						dst += mr;
+					}
+				}
+				else
+				{
+					for(unsigned int p = 0; p < k; ++p)
+					{
+						const element_type * src = a + i0 * lda + p;
+						unsigned int i = 0;
+						for(; i < current_m; ++i)
+							dst[i] = to_float(src[i * lda]);
+						for(; i < mr; ++i)
+							dst[i] = 0.0F;
+						dst += mr;
+					}
+				}
+			}
+		}
+
+		template<typename element_type>
+		void gemm_plain::pack_b(
+			bool transpose_b,
+			unsigned int k,
+			unsigned int n,
+			const element_type * b,
+			unsigned int ldb,
+			float * packed_b)
+		{
+			for(unsigned int j0 = 0; j0 < n; j0 += nr)
+			{
+				const unsigned int current_n = std::min(nr, n - j0);
+				float * dst = packed_b + j0 * k;
+				if (transpose_b)
+				{
+					for(unsigned int p = 0; p < k; ++p)
+					{
+						const element_type * src = b + j0 * ldb + p;
+						unsigned int j = 0;
+						for(; j < current_n; ++j)
+							dst[j] = to_float(src[j * ldb]);
+						for(; j < nr; ++j)
+							dst[j] = 0.0F;
+						dst += nr;
+					}
+				}
+				else
+				{
+					for(unsigned int p = 0; p < k; ++p)
+					{
+						const element_type * src = b + p * ldb + j0;
+						unsigned int j = 0;
+						for(; j < current_n; ++j)
+							dst[j] = to_float(src[j]);
+						for(; j < nr; ++j)
+							dst[j] = 0.0F;
+						dst += nr;
+					}
+				}
+			}
+		}
+
+		template void gemm_plain::sgemm<float, float>(bool, bool, unsigned int, unsigned int, unsigned int, const float *, unsigned int, const float *, unsigned int, float *, unsigned int, bool, float *);
+		template void gemm_plain::sgemm<half_float_plain::fp16, float>(bool, bool, unsigned int, unsigned int, unsigned int, const half_float_plain::fp16 *, unsigned int, const float *, unsigned int, float *, unsigned int, bool, float *);
+		template void gemm_plain::sgemm<half_float_plain::bf16, float>(bool, bool, unsigned int, unsigned int, unsigned int, const half_float_plain::bf16 *, unsigned int, const float *, unsigned int, float *, unsigned int, bool, float *);
+		template void gemm_plain::parallel_sgemm<float, float>(bool, bool, unsigned int, unsigned int, unsigned int, const float *, unsigned int, const float *, unsigned int, float *, unsigned int, bool, float *, int);
+		template void gemm_plain::parallel_sgemm<half_float_plain::fp16, float>(bool, bool, unsigned int, unsigned int, unsigned int, const half_float_plain::fp16 *, unsigned int, const float *, unsigned int, float *, unsigned int, bool, float *, int);
+		template void gemm_plain::parallel_sgemm<half_float_plain::bf16, float>(bool, bool, unsigned int, unsigned int, unsigned int, const half_float_plain::bf16 *, unsigned int, const float *, unsigned int, float *, unsigned int, bool, float *, int);
+
+		gemm_plain::micro_kernel_function gemm_plain::get_micro_kernel()
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				return gemm_avx512::micro_kernel;
+			case instruction_set_plain::instruction_set_avx2:
+				return gemm_avx2::micro_kernel;
+			default:
+				return gemm_sse2::micro_kernel;
+			}
+		}
+	}
+}
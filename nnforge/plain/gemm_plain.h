@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "half_float_plain.h"
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Cache-blocked SGEMM, sgemm runs in the calling thread, parallel_sgemm splits C into tiles between threads
+		class gemm_plain
+		{
+		public:
+			// Computes C = op(A) * op(B), or C += op(A) * op(B) if accumulate is true
+			// All the matrices are row-major, op(A) is m x k, op(B) is k x n, C is m x n
+			// A is stored as k x m when transpose_a is true, B is stored as n x k when transpose_b is true
+			// A might be stored in half_float_plain::fp16 or half_float_plain::bf16, it is converted to fp32 when packed
+			// workspace should have get_workspace_elem_count(m, n, k) elements, the panels of A and B are packed there
+			template<typename a_element_type, typename b_element_type>
+			static void sgemm(
+				bool transpose_a,
+				bool transpose_b,
+				unsigned int m,
+				unsigned int n,
+				unsigned int k,
+				const a_element_type * a,
+				unsigned int lda,
+				const b_element_type * b,
+				unsigned int ldb,
+				float * c,
+				unsigned int ldc,
+				bool accumulate,
+				float * workspace);
+
+			// The same as sgemm, C is split into row and column tiles processed by thread_count threads
+			// workspace should have get_workspace_elem_count(m, n, k) elements per thread
+			template<typename a_element_type, typename b_element_type>
+			static void parallel_sgemm(
+				bool transpose_a,
+				bool transpose_b,
+				unsigned int m,
+				unsigned int n,
+				unsigned int k,
+				const a_element_type * a,
+				unsigned int lda,
+				const b_element_type * b,
+				unsigned int ldb,
+				float * c,
+				unsigned int ldc,
+				bool accumulate,
+				float * workspace,
+				int thread_count);
+
+			// The size of the workspace sgemm needs for op(A) of m x k and op(B) of k x n
+			static unsigned int get_workspace_elem_count(
+				unsigned int m,
+				unsigned int n,
+				unsigned int k);
+
+			// Register tile sizes of the micro-kernel
+			static const unsigned int mr = 6;
+			static const unsigned int nr = 32;
+
+			// Cache block sizes
+			static const unsigned int mc = 72;
+			static const unsigned int kc = 256;
+			static const unsigned int nc = 512;
+
+		private:
+			template<typename element_type>
+			static void pack_a(
+				bool transpose_a,
+				unsigned int m,
+				unsigned int k,
+				const element_type * a,
+				unsigned int lda,
+				float * packed_a);
+
+			template<typename element_type>
+			static void pack_b(
+				bool transpose_b,
+				unsigned int k,
+				unsigned int n,
+				const element_type * b,
+				unsigned int ldb,
+				float * packed_b);
+
+			typedef void (*micro_kernel_function)(
+				unsigned int k,
+				const float * __restrict packed_a,
+				const float * __restrict packed_b,
+				float * __restrict c,
+				unsigned int ldc,
+				unsigned int m,
+				unsigned int n,
+				bool accumulate);
+
+			// Micro-kernel compiled for the widest instruction set available
+			static micro_kernel_function get_micro_kernel();
+
+		private:
+			gemm_plain();
+			~gemm_plain();
+		};
+	}
+}
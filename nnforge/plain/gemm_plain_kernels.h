@@ -0,0 +1,67 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// Body of the SGEMM micro-kernel, there is no include guard on purpose:
+// gemm_plain.cpp includes this file once per instruction set, each time within its own namespace and target options
+
+void micro_kernel(
+	unsigned int k,
+	const float * __restrict packed_a,
+	const float * __restrict packed_b,
+	float * __restrict c,
+	unsigned int ldc,
+	unsigned int m,
+	unsigned int n,
+	bool accumulate)
+{
+	// Fixed trip counts let the compiler keep the whole tile in vector registers
+	float acc[gemm_plain::mr * gemm_plain::nr];
+	for(int i = 0; i < static_cast<int>(gemm_plain::mr * gemm_plain::nr); ++i)
+		acc[i] = 0.0F;
+
+	for(int p = 0; p < static_cast<int>(k); ++p)
+	{
+		for(int i = 0; i < static_cast<int>(gemm_plain::mr); ++i)
+		{
+			const float a_val = packed_a[i];
+			for(int j = 0; j < static_cast<int>(gemm_plain::nr); ++j)
+				acc[i * gemm_plain::nr + j] += a_val * packed_b[j];
+		}
+		packed_a += gemm_plain::mr;
+		packed_b += gemm_plain::nr;
+	}
+
+	if (accumulate)
+	{
+		for(unsigned int i = 0; i < m; ++i)
+		{
+			float * c_row = c + i * ldc;
+			const float * acc_row = acc + i * gemm_plain::nr;
+			for(unsigned int j = 0; j < n; ++j)
+				c_row[j] += acc_row[j];
+		}
+	}
+	else
+	{
+		for(unsigned int i = 0; i < m; ++i)
+		{
+			float * c_row = c + i * ldc;
+			const float * acc_row = acc + i * gemm_plain::nr;
+			for(unsigned int j = 0; j < n; ++j)
+				c_row[j] = acc_row[j];
+		}
+	}
+}
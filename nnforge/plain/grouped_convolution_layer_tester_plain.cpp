@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "grouped_convolution_layer_tester_plain.h"
+
+#include "grouped_convolution_plain.h"
+#include "../grouped_convolution_layer.h"
+#include "../nn_types.h"
+
+namespace nnforge
+{
+	namespace plain
+	{
+		grouped_convolution_layer_tester_plain::grouped_convolution_layer_tester_plain()
+		{
+		}
+
+		grouped_convolution_layer_tester_plain::~grouped_convolution_layer_tester_plain()
+		{
+		}
+
+		const boost::uuids::uuid& grouped_convolution_layer_tester_plain::get_uuid() const
+		{
+			return grouped_convolution_layer::layer_guid;
+		}
+
+		void grouped_convolution_layer_tester_plain::test(
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_set& additional_buffers,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const_layer_data_custom_smart_ptr data_custom,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int entry_count) const
+		{
+			nnforge_shared_ptr<const grouped_convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const grouped_convolution_layer>(layer_schema);
+
+			grouped_convolution_plain grouped_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				layer_derived->group_count,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			grouped_engine.forward(
+				&(*input_buffer->begin()),
+				&(*additional_buffers[0]->begin()),
+				&(*(*data)[0].begin()),
+				&(*(*data)[1].begin()),
+				(additional_buffers.size() > 1) ? &(*additional_buffers[1]->begin()) : 0,
+				entry_count,
+				plain_config->openmp_thread_count);
+		}
+
+		bool grouped_convolution_layer_tester_plain::is_in_place() const
+		{
+			return false;
+		}
+
+		std::vector<std::pair<unsigned int, bool> > grouped_convolution_layer_tester_plain::get_elem_count_and_per_entry_flag_additional_buffers(
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			plain_running_configuration_const_smart_ptr plain_config) const
+		{
+			std::vector<std::pair<unsigned int, bool> > res;
+
+			res.push_back(std::make_pair<unsigned int, bool>(output_configuration_specific.get_neuron_count(), true));
+
+			nnforge_shared_ptr<const grouped_convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const grouped_convolution_layer>(layer_schema);
+			grouped_convolution_plain grouped_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				layer_derived->group_count,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			unsigned int scratch_elem_count = grouped_engine.get_buffer_elem_count() * plain_config->openmp_thread_count;
+			if (scratch_elem_count > 0)
+				res.push_back(std::make_pair(scratch_elem_count, false));
+
+			return res;
+		}
+	}
+}
@@ -0,0 +1,199 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "grouped_convolution_layer_updater_plain.h"
+
+#include "grouped_convolution_plain.h"
+#include "../grouped_convolution_layer.h"
+#include "../nn_types.h"
+
+namespace nnforge
+{
+	namespace plain
+	{
+		grouped_convolution_layer_updater_plain::grouped_convolution_layer_updater_plain()
+		{
+		}
+
+		grouped_convolution_layer_updater_plain::~grouped_convolution_layer_updater_plain()
+		{
+		}
+
+		const boost::uuids::uuid& grouped_convolution_layer_updater_plain::get_uuid() const
+		{
+			return grouped_convolution_layer::layer_guid;
+		}
+
+		void grouped_convolution_layer_updater_plain::test(
+			const_additional_buffer_smart_ptr input_buffer,
+			additional_buffer_smart_ptr output_buffer,
+			std::vector<additional_buffer_smart_ptr>& additional_buffers,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const_layer_data_custom_smart_ptr data_custom,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int updater_count,
+			unsigned int offset_input_entry_id,
+			bool force_deterministic) const
+		{
+			nnforge_shared_ptr<const grouped_convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const grouped_convolution_layer>(layer_schema);
+
+			grouped_convolution_plain grouped_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				layer_derived->group_count,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			grouped_engine.forward(
+				&(*(input_buffer->begin() + input_configuration_specific.get_neuron_count() * offset_input_entry_id)),
+				&(*output_buffer->begin()),
+				&(*(*data)[0].begin()),
+				&(*(*data)[1].begin()),
+				additional_buffers.empty() ? 0 : &(*additional_buffers[0]->begin()),
+				updater_count,
+				plain_config->openmp_thread_count);
+		}
+
+		void grouped_convolution_layer_updater_plain::backprop(
+			additional_buffer_smart_ptr input_errors,
+			const_additional_buffer_smart_ptr input_neurons,
+			const_additional_buffer_smart_ptr output_errors,
+			const_additional_buffer_smart_ptr output_neurons,
+			std::vector<additional_buffer_smart_ptr>& additional_buffers,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const_layer_data_custom_smart_ptr data_custom,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int updater_count,
+			bool force_deterministic) const
+		{
+			nnforge_shared_ptr<const grouped_convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const grouped_convolution_layer>(layer_schema);
+
+			grouped_convolution_plain grouped_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				layer_derived->group_count,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			grouped_engine.backprop(
+				&(*output_errors->begin()),
+				&(*input_errors->begin()),
+				&(*(*data)[0].begin()),
+				additional_buffers.empty() ? 0 : &(*additional_buffers[0]->begin()),
+				updater_count,
+				plain_config->openmp_thread_count);
+		}
+
+		void grouped_convolution_layer_updater_plain::update_weights(
+			const_additional_buffer_smart_ptr input_neurons,
+			const_additional_buffer_smart_ptr output_errors,
+			std::vector<additional_buffer_smart_ptr>& additional_buffers,
+			layer_data_smart_ptr gradient,
+			const_layer_data_custom_smart_ptr data_custom,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int updater_count,
+			unsigned int offset_input_entry_id,
+			bool force_deterministic) const
+		{
+			nnforge_shared_ptr<const grouped_convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const grouped_convolution_layer>(layer_schema);
+
+			grouped_convolution_plain grouped_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				layer_derived->group_count,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			grouped_engine.update_weights(
+				&(*(input_neurons->begin() + input_configuration_specific.get_neuron_count() * offset_input_entry_id)),
+				&(*output_errors->begin()),
+				&(*(*gradient)[0].begin()),
+				additional_buffers.empty() ? 0 : &(*additional_buffers[0]->begin()),
+				updater_count,
+				plain_config->openmp_thread_count);
+
+			const unsigned int output_neuron_count = output_configuration_specific.get_neuron_count();
+			const unsigned int output_neuron_count_per_feature_map = output_configuration_specific.get_neuron_count_per_feature_map();
+			const unsigned int output_feature_map_count = output_configuration_specific.feature_map_count;
+			const additional_buffer::const_iterator out_err_it_global = output_errors->begin();
+			const std::vector<float>::iterator gradient_biases = (*gradient)[1].begin();
+			const int const_updater_count = updater_count;
+
+			const int total_workload_bias = output_feature_map_count;
+			#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
+			for(int workload_id = 0; workload_id < total_workload_bias; ++workload_id)
+			{
+				int output_feature_map_id = workload_id;
+
+				float sum = 0.0F;
+				for(int entry_id = 0; entry_id < const_updater_count; ++entry_id)
+				{
+					float local_sum = 0.0F;
+					additional_buffer::const_iterator out_err_it_base = out_err_it_global + (entry_id * output_neuron_count) + (output_feature_map_id * output_neuron_count_per_feature_map);
+					for(additional_buffer::const_iterator out_err_it = out_err_it_base; out_err_it != out_err_it_base + output_neuron_count_per_feature_map; ++out_err_it)
+						local_sum += *out_err_it;
+
+					sum += local_sum;
+				}
+
+				*(gradient_biases + output_feature_map_id) += sum;
+			}
+		}
+
+		bool grouped_convolution_layer_updater_plain::is_in_place_backprop() const
+		{
+			return false;
+		}
+
+		std::vector<std::pair<unsigned int, bool> > grouped_convolution_layer_updater_plain::get_elem_count_and_per_entry_flag_additional_buffers(
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			plain_running_configuration_const_smart_ptr plain_config,
+			bool backprop_required) const
+		{
+			std::vector<std::pair<unsigned int, bool> > res;
+
+			nnforge_shared_ptr<const grouped_convolution_layer> layer_derived = nnforge_dynamic_pointer_cast<const grouped_convolution_layer>(layer_schema);
+			grouped_convolution_plain grouped_engine(
+				layer_derived->window_sizes,
+				layer_derived->left_zero_padding,
+				layer_derived->strides,
+				layer_derived->group_count,
+				input_configuration_specific,
+				output_configuration_specific);
+
+			// Column buffer per thread, shared by forward, backprop and update_weights
+			unsigned int scratch_elem_count = grouped_engine.get_buffer_elem_count() * plain_config->openmp_thread_count;
+			if (scratch_elem_count > 0)
+				res.push_back(std::make_pair(scratch_elem_count, false));
+
+			return res;
+		}
+	}
+}
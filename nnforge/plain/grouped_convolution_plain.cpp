@@ -0,0 +1,634 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "grouped_convolution_plain.h"
+
+#include "gemm_plain.h"
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		const int grouped_convolution_plain::max_dimension_count;
+
+		grouped_convolution_plain::grouped_convolution_plain(
+			const std::vector<unsigned int>& window_sizes,
+			const std::vector<unsigned int>& left_zero_padding,
+			const std::vector<unsigned int>& strides,
+			unsigned int group_count,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+			: group_count(group_count)
+			, input_feature_map_count(input_configuration_specific.feature_map_count)
+			, output_feature_map_count(output_configuration_specific.feature_map_count)
+			, input_feature_map_count_per_group(input_configuration_specific.feature_map_count / group_count)
+			, output_feature_map_count_per_group(output_configuration_specific.feature_map_count / group_count)
+			, input_neuron_count_per_feature_map(input_configuration_specific.get_neuron_count_per_feature_map())
+			, output_neuron_count_per_feature_map(output_configuration_specific.get_neuron_count_per_feature_map())
+			, group_gemm_engine(
+				window_sizes,
+				left_zero_padding,
+				strides,
+				get_group_configuration(input_configuration_specific, group_count),
+				get_group_configuration(output_configuration_specific, group_count))
+		{
+			use_gemm = group_gemm_engine.is_efficient();
+
+			const unsigned int dimension_count = static_cast<unsigned int>(window_sizes.size());
+			int window_sizes_extended[max_dimension_count];
+			int left_zero_padding_extended[max_dimension_count];
+			int strides_extended[max_dimension_count];
+			int input_dimension_sizes[max_dimension_count];
+			int output_dimension_sizes[max_dimension_count];
+			int input_slices[max_dimension_count];
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+			{
+				window_sizes_extended[i] = (i < dimension_count) ? static_cast<int>(window_sizes[i]) : 1;
+				left_zero_padding_extended[i] = (i < dimension_count) ? static_cast<int>(left_zero_padding[i]) : 0;
+				strides_extended[i] = (i < dimension_count) ? static_cast<int>(strides[i]) : 1;
+				input_dimension_sizes[i] = (i < dimension_count) ? static_cast<int>(input_configuration_specific.dimension_sizes[i]) : 1;
+				output_dimension_sizes[i] = (i < dimension_count) ? static_cast<int>(output_configuration_specific.dimension_sizes[i]) : 1;
+				input_slices[i] = (i == 0) ? 1 : input_slices[i - 1] * input_dimension_sizes[i - 1];
+			}
+
+			window_elem_count = 1;
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+				window_elem_count *= window_sizes_extended[i];
+			window_width = window_sizes_extended[0];
+			window_row_count = window_elem_count / window_width;
+			output_width = output_dimension_sizes[0];
+			output_row_count = output_neuron_count_per_feature_map / output_width;
+			stride_x = strides_extended[0];
+
+			if (use_gemm)
+				return;
+
+			input_row_offsets.resize(output_row_count * window_row_count);
+			for(unsigned int output_row_id = 0; output_row_id < output_row_count; ++output_row_id)
+			{
+				int output_position[max_dimension_count];
+				unsigned int remainder = output_row_id;
+				for(unsigned int i = 1; i < max_dimension_count; ++i)
+				{
+					output_position[i] = remainder % output_dimension_sizes[i];
+					remainder /= output_dimension_sizes[i];
+				}
+
+				for(unsigned int window_row_id = 0; window_row_id < window_row_count; ++window_row_id)
+				{
+					int offset = 0;
+					unsigned int window_remainder = window_row_id;
+					for(unsigned int i = 1; i < max_dimension_count; ++i)
+					{
+						int input_position = output_position[i] * strides_extended[i] + static_cast<int>(window_remainder % window_sizes_extended[i]) - left_zero_padding_extended[i];
+						window_remainder /= window_sizes_extended[i];
+						if ((input_position < 0) || (input_position >= input_dimension_sizes[i]))
+						{
+							offset = -1;
+							break;
+						}
+						offset += input_position * input_slices[i];
+					}
+					input_row_offsets[output_row_id * window_row_count + window_row_id] = offset;
+				}
+			}
+
+			x_offsets.resize(window_width);
+			x_starts.resize(window_width);
+			x_ends.resize(window_width);
+			for(unsigned int window_x = 0; window_x < window_width; ++window_x)
+			{
+				int x_offset = static_cast<int>(window_x) - left_zero_padding_extended[0];
+				x_offsets[window_x] = x_offset;
+				x_starts[window_x] = std::max(0, (stride_x - 1 - x_offset) / stride_x);
+				x_ends[window_x] = std::max(x_starts[window_x], std::min(output_dimension_sizes[0], (input_dimension_sizes[0] - x_offset + stride_x - 1) / stride_x));
+			}
+		}
+
+		layer_configuration_specific grouped_convolution_plain::get_group_configuration(
+			const layer_configuration_specific& configuration_specific,
+			unsigned int group_count)
+		{
+			return layer_configuration_specific(configuration_specific.feature_map_count / group_count, configuration_specific.dimension_sizes);
+		}
+
+		unsigned int grouped_convolution_plain::get_buffer_elem_count() const
+		{
+			return use_gemm ? group_gemm_engine.get_column_buffer_elem_count() : 0;
+		}
+
+		void grouped_convolution_plain::forward(
+			const float * input,
+			float * output,
+			const float * weights,
+			const float * biases,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			if (use_gemm)
+				forward_gemm(input, output, weights, biases, buffers, entry_count, thread_count);
+			else
+				forward_rows(input, output, weights, biases, entry_count, thread_count);
+		}
+
+		void grouped_convolution_plain::backprop(
+			const float * output_errors,
+			float * input_errors,
+			const float * weights,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			if (use_gemm)
+				backprop_gemm(output_errors, input_errors, weights, buffers, entry_count, thread_count);
+			else
+				backprop_rows(output_errors, input_errors, weights, entry_count, thread_count);
+		}
+
+		void grouped_convolution_plain::update_weights(
+			const float * input,
+			const float * output_errors,
+			float * gradient_weights,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			if (use_gemm)
+				update_weights_gemm(input, output_errors, gradient_weights, buffers, entry_count, thread_count);
+			else
+				update_weights_rows(input, output_errors, gradient_weights, entry_count, thread_count);
+		}
+
+		void grouped_convolution_plain::forward_gemm(
+			const float * input,
+			float * output,
+			const float * weights,
+			const float * biases,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count;
+			const unsigned int output_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count;
+			const unsigned int input_group_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count_per_group;
+			const unsigned int output_group_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count_per_group;
+			const unsigned int column_height = group_gemm_engine.get_column_height();
+			const unsigned int group_weight_count = output_feature_map_count_per_group * column_height;
+			const unsigned int block_size = group_gemm_engine.get_block_size();
+			const unsigned int block_count = (output_neuron_count_per_feature_map + block_size - 1) / block_size;
+			const unsigned int buffer_elem_count = get_buffer_elem_count();
+			const int total_workload = static_cast<int>(entry_count * group_count * block_count);
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(input,output,weights,biases,buffers)
+			{
+				int thread_id = 0;
+				#ifdef _OPENMP
+				thread_id = omp_get_thread_num();
+				#endif
+
+				float * columns = buffers + thread_id * buffer_elem_count;
+				float * workspace = columns + column_height * block_size;
+
+				#pragma omp for schedule(dynamic)
+				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+				{
+					int entry_id = workload_id / (group_count * block_count);
+					int remainder = workload_id - (entry_id * group_count * block_count);
+					int group_id = remainder / block_count;
+					int block_id = remainder - (group_id * block_count);
+					unsigned int output_position_start = block_id * block_size;
+					unsigned int output_position_count = std::min(block_size, output_neuron_count_per_feature_map - output_position_start);
+
+					group_gemm_engine.unfold(
+						input + entry_id * input_neuron_count + group_id * input_group_neuron_count,
+						columns,
+						output_position_start,
+						output_position_count);
+
+					float * out = output + entry_id * output_neuron_count + group_id * output_group_neuron_count + output_position_start;
+					const float * group_biases = biases + group_id * output_feature_map_count_per_group;
+					for(unsigned int i = 0; i < output_feature_map_count_per_group; ++i)
+						std::fill_n(out + i * output_neuron_count_per_feature_map, output_position_count, group_biases[i]);
+
+					gemm_plain::sgemm(
+						false,
+						false,
+						output_feature_map_count_per_group,
+						output_position_count,
+						column_height,
+						weights + group_id * group_weight_count,
+						column_height,
+						columns,
+						output_position_count,
+						out,
+						output_neuron_count_per_feature_map,
+						true,
+						workspace);
+				}
+			}
+		}
+
+		void grouped_convolution_plain::backprop_gemm(
+			const float * output_errors,
+			float * input_errors,
+			const float * weights,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count;
+			const unsigned int output_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count;
+			const unsigned int input_group_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count_per_group;
+			const unsigned int output_group_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count_per_group;
+			const unsigned int column_height = group_gemm_engine.get_column_height();
+			const unsigned int group_weight_count = output_feature_map_count_per_group * column_height;
+			const unsigned int block_size = group_gemm_engine.get_block_size();
+			const unsigned int block_count = (output_neuron_count_per_feature_map + block_size - 1) / block_size;
+			const unsigned int buffer_elem_count = get_buffer_elem_count();
+			const int total_workload = static_cast<int>(entry_count * group_count);
+
+			// Input errors of different groups don't overlap, so (entry, group) pairs are independent
+			#pragma omp parallel default(none) num_threads(thread_count) shared(output_errors,input_errors,weights,buffers)
+			{
+				int thread_id = 0;
+				#ifdef _OPENMP
+				thread_id = omp_get_thread_num();
+				#endif
+
+				float * columns = buffers + thread_id * buffer_elem_count;
+				float * workspace = columns + column_height * block_size;
+
+				#pragma omp for schedule(dynamic)
+				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+				{
+					int entry_id = workload_id / group_count;
+					int group_id = workload_id - (entry_id * group_count);
+					float * in_err = input_errors + entry_id * input_neuron_count + group_id * input_group_neuron_count;
+					const float * out_err = output_errors + entry_id * output_neuron_count + group_id * output_group_neuron_count;
+					std::fill_n(in_err, input_group_neuron_count, 0.0F);
+
+					for(unsigned int block_id = 0; block_id < block_count; ++block_id)
+					{
+						unsigned int output_position_start = block_id * block_size;
+						unsigned int output_position_count = std::min(block_size, output_neuron_count_per_feature_map - output_position_start);
+
+						gemm_plain::sgemm(
+							true,
+							false,
+							column_height,
+							output_position_count,
+							output_feature_map_count_per_group,
+							weights + group_id * group_weight_count,
+							column_height,
+							out_err + output_position_start,
+							output_neuron_count_per_feature_map,
+							columns,
+							output_position_count,
+							false,
+							workspace);
+
+						for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count_per_group; ++input_feature_map_id)
+							group_gemm_engine.fold(columns, in_err, output_position_start, output_position_count, input_feature_map_id);
+					}
+				}
+			}
+		}
+
+		void grouped_convolution_plain::update_weights_gemm(
+			const float * input,
+			const float * output_errors,
+			float * gradient_weights,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count;
+			const unsigned int output_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count;
+			const unsigned int input_group_neuron_count = input_neuron_count_per_feature_map * input_feature_map_count_per_group;
+			const unsigned int output_group_neuron_count = output_neuron_count_per_feature_map * output_feature_map_count_per_group;
+			const unsigned int column_height = group_gemm_engine.get_column_height();
+			const unsigned int group_weight_count = output_feature_map_count_per_group * column_height;
+			const unsigned int block_size = group_gemm_engine.get_block_size();
+			const unsigned int block_count = (output_neuron_count_per_feature_map + block_size - 1) / block_size;
+			const unsigned int buffer_elem_count = get_buffer_elem_count();
+
+			// Gradients of different groups don't overlap: with enough groups each thread owns whole groups,
+			// otherwise groups are processed one by one and the product is split between threads
+			if (group_count >= static_cast<unsigned int>(thread_count))
+			{
+				const int total_workload = static_cast<int>(group_count);
+
+				#pragma omp parallel default(none) num_threads(thread_count) shared(input,output_errors,gradient_weights,buffers,entry_count)
+				{
+					int thread_id = 0;
+					#ifdef _OPENMP
+					thread_id = omp_get_thread_num();
+					#endif
+
+					float * columns = buffers + thread_id * buffer_elem_count;
+					float * workspace = columns + column_height * block_size;
+
+					#pragma omp for schedule(dynamic)
+					for(int group_id = 0; group_id < total_workload; ++group_id)
+					{
+						for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+						{
+							for(unsigned int block_id = 0; block_id < block_count; ++block_id)
+							{
+								unsigned int output_position_start = block_id * block_size;
+								unsigned int output_position_count = std::min(block_size, output_neuron_count_per_feature_map - output_position_start);
+
+								group_gemm_engine.unfold(
+									input + entry_id * input_neuron_count + group_id * input_group_neuron_count,
+									columns,
+									output_position_start,
+									output_position_count);
+
+								gemm_plain::sgemm(
+									false,
+									true,
+									output_feature_map_count_per_group,
+									column_height,
+									output_position_count,
+									output_errors + entry_id * output_neuron_count + group_id * output_group_neuron_count + output_position_start,
+									output_neuron_count_per_feature_map,
+									columns,
+									output_position_count,
+									gradient_weights + group_id * group_weight_count,
+									column_height,
+									true,
+									workspace);
+							}
+						}
+					}
+				}
+			}
+			else
+			{
+				for(unsigned int group_id = 0; group_id < group_count; ++group_id)
+				{
+					for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+					{
+						for(unsigned int block_id = 0; block_id < block_count; ++block_id)
+						{
+							unsigned int output_position_start = block_id * block_size;
+							unsigned int output_position_count = std::min(block_size, output_neuron_count_per_feature_map - output_position_start);
+
+							group_gemm_engine.unfold(
+								input + entry_id * input_neuron_count + group_id * input_group_neuron_count,
+								buffers,
+								output_position_start,
+								output_position_count);
+
+							// Product workspaces of all the threads follow the columns, they fit into the buffers of the threads
+							gemm_plain::parallel_sgemm(
+								false,
+								true,
+								output_feature_map_count_per_group,
+								column_height,
+								output_position_count,
+								output_errors + entry_id * output_neuron_count + group_id * output_group_neuron_count + output_position_start,
+								output_neuron_count_per_feature_map,
+								buffers,
+								output_position_count,
+								gradient_weights + group_id * group_weight_count,
+								column_height,
+								true,
+								buffers + column_height * block_size,
+								thread_count);
+						}
+					}
+				}
+			}
+		}
+
+		void grouped_convolution_plain::forward_rows(
+			const float * input,
+			float * output,
+			const float * weights,
+			const float * biases,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_feature_map_count * input_neuron_count_per_feature_map;
+			const unsigned int output_neuron_count = output_feature_map_count * output_neuron_count_per_feature_map;
+			const unsigned int input_group_neuron_count = input_feature_map_count_per_group * input_neuron_count_per_feature_map;
+			const int total_workload = static_cast<int>(entry_count * output_feature_map_count);
+			const int * const input_row_offsets_it = &(*input_row_offsets.begin());
+			const int * const x_offsets_it = &(*x_offsets.begin());
+			const int * const x_starts_it = &(*x_starts.begin());
+			const int * const x_ends_it = &(*x_ends.begin());
+
+			#pragma omp parallel for default(none) schedule(dynamic) num_threads(thread_count) shared(input,output,weights,biases)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				int entry_id = workload_id / output_feature_map_count;
+				int output_feature_map_id = workload_id - (entry_id * output_feature_map_count);
+				int group_id = output_feature_map_id / output_feature_map_count_per_group;
+				const float * in_group_base = input + entry_id * input_neuron_count + group_id * input_group_neuron_count;
+				float * out_fm_base = output + entry_id * output_neuron_count + output_feature_map_id * output_neuron_count_per_feature_map;
+				const float * weights_fm_base = weights + output_feature_map_id * input_feature_map_count_per_group * window_elem_count;
+				const float bias = biases[output_feature_map_id];
+
+				for(unsigned int output_row_id = 0; output_row_id < output_row_count; ++output_row_id)
+				{
+					const int * current_input_row_offsets = input_row_offsets_it + output_row_id * window_row_count;
+					float * out_row = out_fm_base + output_row_id * output_width;
+					std::fill_n(out_row, output_width, bias);
+
+					for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count_per_group; ++input_feature_map_id)
+					{
+						const float * in_fm_base = in_group_base + input_feature_map_id * input_neuron_count_per_feature_map;
+						const float * weights_it = weights_fm_base + input_feature_map_id * window_elem_count;
+						for(unsigned int window_row_id = 0; window_row_id < window_row_count; ++window_row_id, weights_it += window_width)
+						{
+							int input_row_offset = current_input_row_offsets[window_row_id];
+							if (input_row_offset < 0)
+								continue;
+
+							const float * in_row = in_fm_base + input_row_offset;
+							for(unsigned int window_x = 0; window_x < window_width; ++window_x)
+							{
+								const float weight = weights_it[window_x];
+								const int x_start = x_starts_it[window_x];
+								const int x_count = x_ends_it[window_x] - x_start;
+								const float * in_row_shifted = in_row + (x_start * stride_x + x_offsets_it[window_x]);
+								float * out_row_shifted = out_row + x_start;
+								if (stride_x == 1)
+								{
+									for(int x = 0; x < x_count; ++x)
+										out_row_shifted[x] += weight * in_row_shifted[x];
+								}
+								else
+								{
+									for(int x = 0; x < x_count; ++x)
+										out_row_shifted[x] += weight * in_row_shifted[x * stride_x];
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		void grouped_convolution_plain::backprop_rows(
+			const float * output_errors,
+			float * input_errors,
+			const float * weights,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_feature_map_count * input_neuron_count_per_feature_map;
+			const unsigned int output_neuron_count = output_feature_map_count * output_neuron_count_per_feature_map;
+			const unsigned int output_group_neuron_count = output_feature_map_count_per_group * output_neuron_count_per_feature_map;
+			const int total_workload = static_cast<int>(entry_count * input_feature_map_count);
+			const int * const input_row_offsets_it = &(*input_row_offsets.begin());
+			const int * const x_offsets_it = &(*x_offsets.begin());
+			const int * const x_starts_it = &(*x_starts.begin());
+			const int * const x_ends_it = &(*x_ends.begin());
+
+			#pragma omp parallel for default(none) schedule(dynamic) num_threads(thread_count) shared(output_errors,input_errors,weights)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				int entry_id = workload_id / input_feature_map_count;
+				int input_feature_map_id = workload_id - (entry_id * input_feature_map_count);
+				int group_id = input_feature_map_id / input_feature_map_count_per_group;
+				int input_feature_map_id_in_group = input_feature_map_id - (group_id * input_feature_map_count_per_group);
+				float * in_err_fm_base = input_errors + entry_id * input_neuron_count + input_feature_map_id * input_neuron_count_per_feature_map;
+				const float * out_err_group_base = output_errors + entry_id * output_neuron_count + group_id * output_group_neuron_count;
+				const float * weights_group_base = weights + (group_id * output_feature_map_count_per_group * input_feature_map_count_per_group + input_feature_map_id_in_group) * window_elem_count;
+
+				std::fill_n(in_err_fm_base, input_neuron_count_per_feature_map, 0.0F);
+
+				for(unsigned int output_row_id = 0; output_row_id < output_row_count; ++output_row_id)
+				{
+					const int * current_input_row_offsets = input_row_offsets_it + output_row_id * window_row_count;
+					for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count_per_group; ++output_feature_map_id)
+					{
+						const float * out_err_row = out_err_group_base + output_feature_map_id * output_neuron_count_per_feature_map + output_row_id * output_width;
+						const float * weights_it = weights_group_base + output_feature_map_id * input_feature_map_count_per_group * window_elem_count;
+						for(unsigned int window_row_id = 0; window_row_id < window_row_count; ++window_row_id, weights_it += window_width)
+						{
+							int input_row_offset = current_input_row_offsets[window_row_id];
+							if (input_row_offset < 0)
+								continue;
+
+							float * in_err_row = in_err_fm_base + input_row_offset;
+							for(unsigned int window_x = 0; window_x < window_width; ++window_x)
+							{
+								const float weight = weights_it[window_x];
+								const int x_start = x_starts_it[window_x];
+								const int x_count = x_ends_it[window_x] - x_start;
+								float * in_err_row_shifted = in_err_row + (x_start * stride_x + x_offsets_it[window_x]);
+								const float * out_err_row_shifted = out_err_row + x_start;
+								if (stride_x == 1)
+								{
+									for(int x = 0; x < x_count; ++x)
+										in_err_row_shifted[x] += weight * out_err_row_shifted[x];
+								}
+								else
+								{
+									for(int x = 0; x < x_count; ++x)
+										in_err_row_shifted[x * stride_x] += weight * out_err_row_shifted[x];
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		void grouped_convolution_plain::update_weights_rows(
+			const float * input,
+			const float * output_errors,
+			float * gradient_weights,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_feature_map_count * input_neuron_count_per_feature_map;
+			const unsigned int output_neuron_count = output_feature_map_count * output_neuron_count_per_feature_map;
+			const int total_workload = static_cast<int>(output_feature_map_count * input_feature_map_count_per_group);
+			const int * const input_row_offsets_it = &(*input_row_offsets.begin());
+			const int * const x_offsets_it = &(*x_offsets.begin());
+			const int * const x_starts_it = &(*x_starts.begin());
+			const int * const x_ends_it = &(*x_ends.begin());
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(input,output_errors,gradient_weights,entry_count)
+			{
+				std::vector<float> weights_local(window_elem_count);
+
+				#pragma omp for schedule(dynamic)
+				for(int connection_id = 0; connection_id < total_workload; ++connection_id)
+				{
+					const int output_feature_map_id = connection_id / input_feature_map_count_per_group;
+					const int input_feature_map_id_in_group = connection_id - (output_feature_map_id * input_feature_map_count_per_group);
+					const int input_feature_map_id = (output_feature_map_id / output_feature_map_count_per_group) * input_feature_map_count_per_group + input_feature_map_id_in_group;
+					std::fill(weights_local.begin(), weights_local.end(), 0.0F);
+
+					for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+					{
+						const float * in_fm_base = input + entry_id * input_neuron_count + input_feature_map_id * input_neuron_count_per_feature_map;
+						const float * out_err_fm_base = output_errors + entry_id * output_neuron_count + output_feature_map_id * output_neuron_count_per_feature_map;
+						for(unsigned int output_row_id = 0; output_row_id < output_row_count; ++output_row_id)
+						{
+							const int * current_input_row_offsets = input_row_offsets_it + output_row_id * window_row_count;
+							const float * out_err_row = out_err_fm_base + output_row_id * output_width;
+							float * weights_local_it = &(*weights_local.begin());
+							for(unsigned int window_row_id = 0; window_row_id < window_row_count; ++window_row_id, weights_local_it += window_width)
+							{
+								int input_row_offset = current_input_row_offsets[window_row_id];
+								if (input_row_offset < 0)
+									continue;
+
+								const float * in_row = in_fm_base + input_row_offset;
+								for(unsigned int window_x = 0; window_x < window_width; ++window_x)
+								{
+									const int x_start = x_starts_it[window_x];
+									const int x_count = x_ends_it[window_x] - x_start;
+									const float * in_row_shifted = in_row + (x_start * stride_x + x_offsets_it[window_x]);
+									const float * out_err_row_shifted = out_err_row + x_start;
+									float sum = 0.0F;
+									if (stride_x == 1)
+									{
+										for(int x = 0; x < x_count; ++x)
+											sum += in_row_shifted[x] * out_err_row_shifted[x];
+									}
+									else
+									{
+										for(int x = 0; x < x_count; ++x)
+											sum += in_row_shifted[x * stride_x] * out_err_row_shifted[x];
+									}
+									weights_local_it[window_x] += sum;
+								}
+							}
+						}
+					}
+
+					float * gradient_weights_it = gradient_weights + connection_id * window_elem_count;
+					for(unsigned int i = 0; i < window_elem_count; ++i)
+						gradient_weights_it[i] += weights_local[i];
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,158 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "convolution_gemm_plain.h"
+#include "../layer_configuration_specific.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Grouped convolution: feature maps of each group are contiguous both in the input and in the output,
+		// and the weights of each group form a contiguous output_feature_map_count / group_count x column_height matrix,
+		// so wide groups run as im2col + SGEMM per group on the group's slices, without any copying.
+		// Narrow groups, depthwise convolution in particular, run row by row: each window element adds
+		// a single multiply-add over a contiguous output row, the same way sparse_convolution_plain does
+		class grouped_convolution_plain
+		{
+		public:
+			grouped_convolution_plain(
+				const std::vector<unsigned int>& window_sizes,
+				const std::vector<unsigned int>& left_zero_padding,
+				const std::vector<unsigned int>& strides,
+				unsigned int group_count,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific);
+
+			// The size of the scratch buffer the caller should provide for each thread, 0 when the row kernel is used
+			unsigned int get_buffer_elem_count() const;
+
+			// buffers should have get_buffer_elem_count() elements per thread
+			void forward(
+				const float * input,
+				float * output,
+				const float * weights,
+				const float * biases,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// Input errors are overwritten
+			// buffers should have get_buffer_elem_count() elements per thread
+			void backprop(
+				const float * output_errors,
+				float * input_errors,
+				const float * weights,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// Gradient is added to gradient_weights, biases are not touched
+			// buffers should have get_buffer_elem_count() elements per thread
+			void update_weights(
+				const float * input,
+				const float * output_errors,
+				float * gradient_weights,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+		private:
+			static layer_configuration_specific get_group_configuration(
+				const layer_configuration_specific& configuration_specific,
+				unsigned int group_count);
+
+			void forward_gemm(
+				const float * input,
+				float * output,
+				const float * weights,
+				const float * biases,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			void forward_rows(
+				const float * input,
+				float * output,
+				const float * weights,
+				const float * biases,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			void backprop_gemm(
+				const float * output_errors,
+				float * input_errors,
+				const float * weights,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			void backprop_rows(
+				const float * output_errors,
+				float * input_errors,
+				const float * weights,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			void update_weights_gemm(
+				const float * input,
+				const float * output_errors,
+				float * gradient_weights,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			void update_weights_rows(
+				const float * input,
+				const float * output_errors,
+				float * gradient_weights,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			static const int max_dimension_count = 4;
+
+			unsigned int group_count;
+			unsigned int input_feature_map_count;
+			unsigned int output_feature_map_count;
+			unsigned int input_feature_map_count_per_group;
+			unsigned int output_feature_map_count_per_group;
+			unsigned int input_neuron_count_per_feature_map;
+			unsigned int output_neuron_count_per_feature_map;
+			unsigned int window_elem_count;
+			unsigned int window_width;
+			unsigned int window_row_count;
+			unsigned int output_width;
+			unsigned int output_row_count;
+			int stride_x;
+
+			// Single group engine, input and output pointers are shifted to the group's feature maps
+			convolution_gemm_plain group_gemm_engine;
+			bool use_gemm;
+
+			// Offset of the input row for each (output row, window row) pair, -1 if the row is in the padding area
+			std::vector<int> input_row_offsets;
+			// Horizontal offset of the input and the range of valid output positions for each window column,
+			// output position x reads input position x * stride_x + x_offset
+			std::vector<int> x_offsets;
+			std::vector<int> x_starts;
+			std::vector<int> x_ends;
+		};
+	}
+}
@@ -0,0 +1,41 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "half_float_plain.h"
+
+namespace nnforge
+{
+	namespace plain
+	{
+		void half_float_plain::to_fp16(
+			const float * src,
+			fp16 * dst,
+			unsigned int elem_count)
+		{
+			for(unsigned int i = 0; i < elem_count; ++i)
+				dst[i] = to_fp16(src[i]);
+		}
+
+		void half_float_plain::to_bf16(
+			const float * src,
+			bf16 * dst,
+			unsigned int elem_count)
+		{
+			for(unsigned int i = 0; i < elem_count; ++i)
+				dst[i] = to_bf16(src[i]);
+		}
+	}
+}
@@ -0,0 +1,123 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// 16-bit floating point storage types and their conversions to and from fp32
+		// fp16 is IEEE 754 binary16: 5-bit exponent, 10-bit mantissa, its range is limited to about 65504
+		// bf16 is the upper half of fp32: 8-bit exponent, 7-bit mantissa, it keeps the range of fp32 at lower precision
+		class half_float_plain
+		{
+		public:
+			enum format
+			{
+				format_fp16,
+				format_bf16
+			};
+
+			struct fp16
+			{
+				unsigned short bits;
+			};
+
+			struct bf16
+			{
+				unsigned short bits;
+			};
+
+			// Both conversions round to nearest even, fp16 overflows to infinity.
+			// They are inline and branch-free as well, the activations are converted to 16 bits by every layer
+			static inline fp16 to_fp16(float val)
+			{
+				// Scaling the absolute value by 2 ^ 112 and then by 2 ^ -110 overflows the values above the fp16 range to infinity,
+				// adding the power of 2 with the exponent of the value moved by 13 bits rounds the mantissa to 10 bits, denormals included
+				bits_and_float src;
+				src.f = val;
+				const unsigned int doubled_bits = src.i + src.i;
+				const unsigned int exponent_bits = doubled_bits & 0xFF000000U;
+				const unsigned int bias = (exponent_bits < 0x71000000U) ? 0x71000000U : exponent_bits;
+				bits_and_float base;
+				base.i = src.i & 0x7FFFFFFFU;
+				base.f = (base.f * 5.192296858534828e+33F) * 7.703719777548943e-34F;
+				bits_and_float rounding;
+				rounding.i = (bias >> 1) + 0x07800000U;
+				base.f += rounding.f;
+				const unsigned int non_sign_bits = ((base.i >> 13) & 0x7C00U) + (base.i & 0x0FFFU);
+
+				// NaN becomes quiet NaN
+				fp16 res;
+				res.bits = static_cast<unsigned short>(((src.i >> 16) & 0x8000U) | ((doubled_bits > 0xFF000000U) ? 0x7E00U : non_sign_bits));
+				return res;
+			}
+
+			static inline bf16 to_bf16(float val)
+			{
+				bits_and_float src;
+				src.f = val;
+
+				// NaN becomes quiet NaN
+				bf16 res;
+				res.bits = static_cast<unsigned short>((((src.i & 0x7FFFFFFFU) > 0x7F800000U) ? (src.i | 0x00400000U) : (src.i + 0x7FFFU + ((src.i >> 16) & 1U))) >> 16);
+				return res;
+			}
+
+			static void to_fp16(
+				const float * src,
+				fp16 * dst,
+				unsigned int elem_count);
+
+			static void to_bf16(
+				const float * src,
+				bf16 * dst,
+				unsigned int elem_count);
+
+			// The conversions to fp32 are inline and branch-free, so that the loops calling them are vectorized
+			static inline float to_float(fp16 val)
+			{
+				// Exponent and mantissa are moved to their fp32 positions and the exponent bias is fixed with the multiplication,
+				// which handles fp16 denormals as well, infinities and NaNs get the maximum exponent back
+				bits_and_float res;
+				res.i = static_cast<unsigned int>(val.bits & 0x7FFF) << 13;
+				res.f *= 5.192296858534828e+33F; // 2 ^ 112
+				res.i |= ((val.bits & 0x7C00) == 0x7C00) ? 0x7F800000U : 0U;
+				res.i |= static_cast<unsigned int>(val.bits & 0x8000) << 16;
+				return res.f;
+			}
+
+			static inline float to_float(bf16 val)
+			{
+				bits_and_float res;
+				res.i = static_cast<unsigned int>(val.bits) << 16;
+				return res.f;
+			}
+
+		private:
+			union bits_and_float
+			{
+				unsigned int i;
+				float f;
+			};
+
+		private:
+			half_float_plain();
+			~half_float_plain();
+		};
+	}
+}
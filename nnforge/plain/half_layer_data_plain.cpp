@@ -0,0 +1,33 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "half_layer_data_plain.h"
+
+namespace nnforge
+{
+	namespace plain
+	{
+		half_layer_data_plain::half_layer_data_plain()
+			: weight_format(half_float_plain::format_fp16)
+		{
+		}
+
+		size_t half_layer_data_plain::get_size_in_bytes() const
+		{
+			return fp16_weights.size() * sizeof(half_float_plain::fp16) + bf16_weights.size() * sizeof(half_float_plain::bf16) + biases.size() * sizeof(float);
+		}
+	}
+}
@@ -0,0 +1,46 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "half_float_plain.h"
+#include "../nn_types.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// 16-bit representation of the weights of a layer, used by network_tester_plain when weight storage is fp16 or bf16
+		// Only the vector of the weights matching the format is filled, biases stay in fp32
+		class half_layer_data_plain
+		{
+		public:
+			half_layer_data_plain();
+
+			size_t get_size_in_bytes() const;
+
+			half_float_plain::format weight_format;
+			std::vector<half_float_plain::fp16> fp16_weights;
+			std::vector<half_float_plain::bf16> bf16_weights;
+			std::vector<float> biases;
+		};
+
+		typedef nnforge_shared_ptr<half_layer_data_plain> half_layer_data_plain_smart_ptr;
+		typedef nnforge_shared_ptr<const half_layer_data_plain> const_half_layer_data_plain_smart_ptr;
+	}
+}
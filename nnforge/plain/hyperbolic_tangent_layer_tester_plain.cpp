@@ -16,9 +16,13 @@
 
 #include "hyperbolic_tangent_layer_tester_plain.h"
 
+#include "activation_plain.h"
+#include "blocked_layout_plain.h"
 #include "../hyperbolic_tangent_layer.h"
 #include "../nn_types.h"
 
+#include <algorithm>
+
 namespace nnforge
 {
 	namespace plain
@@ -47,20 +51,58 @@ namespace nnforge
 			const layer_configuration_specific& output_configuration_specific,
 			unsigned int entry_count) const
 		{
-			const int elem_count = static_cast<int>(entry_count * input_configuration_specific.get_neuron_count());
-			const std::vector<float>::iterator in_it = input_buffer->begin();
+			const unsigned int elem_count = entry_count * input_configuration_specific.get_neuron_count();
+			float * const in_it = &(*input_buffer->begin());
 
 			nnforge_shared_ptr<const hyperbolic_tangent_layer> layer_derived = nnforge_dynamic_pointer_cast<const hyperbolic_tangent_layer>(layer_schema);
-			const float hyperbolic_tangent_steepness2 = layer_derived->steepness * 2.0F;
-			const float hyperbolic_tangent_major_multiplier = layer_derived->major_multiplier;
+			const float steepness = layer_derived->steepness;
+			const float major_multiplier = layer_derived->major_multiplier;
+
+			const int chunk_count = static_cast<int>((elem_count + activation_plain::chunk_size - 1) / activation_plain::chunk_size);
+
+			#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+			for(int chunk_id = 0; chunk_id < chunk_count; ++chunk_id)
+			{
+				unsigned int chunk_start = chunk_id * activation_plain::chunk_size;
+				unsigned int chunk_elem_count = std::min(activation_plain::chunk_size, elem_count - chunk_start);
+				activation_plain::hyperbolic_tangent(in_it + chunk_start, in_it + chunk_start, chunk_elem_count, steepness, major_multiplier);
+			}
+		}
+
+		layer_tester_plain::blocked_layout_support hyperbolic_tangent_layer_tester_plain::get_blocked_layout_support(
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			return blocked_layout_transparent;
+		}
+
+		void hyperbolic_tangent_layer_tester_plain::test_blocked(
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_smart_ptr output_buffer,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int entry_count) const
+		{
+			const unsigned int elem_count = entry_count * blocked_layout_plain::get_neuron_count(input_configuration_specific);
+			const float * const in_it = &(*input_buffer->begin());
+			float * const out_it = &(*output_buffer->begin());
+
+			nnforge_shared_ptr<const hyperbolic_tangent_layer> layer_derived = nnforge_dynamic_pointer_cast<const hyperbolic_tangent_layer>(layer_schema);
+			const float steepness = layer_derived->steepness;
+			const float major_multiplier = layer_derived->major_multiplier;
+
+			const int chunk_count = static_cast<int>((elem_count + activation_plain::chunk_size - 1) / activation_plain::chunk_size);
 
-			#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
-			for(int i = 0; i < elem_count; ++i)
+			#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+			for(int chunk_id = 0; chunk_id < chunk_count; ++chunk_id)
 			{
-				float inp = *(in_it + i);
-				float inp2 = expf(inp * hyperbolic_tangent_steepness2);
-				float res = (inp2 - 1.0F) / (inp2 + 1.0F) * hyperbolic_tangent_major_multiplier;
-				*(in_it + i) = res;
+				unsigned int chunk_start = chunk_id * activation_plain::chunk_size;
+				unsigned int chunk_elem_count = std::min(activation_plain::chunk_size, elem_count - chunk_start);
+				activation_plain::hyperbolic_tangent(in_it + chunk_start, out_it + chunk_start, chunk_elem_count, steepness, major_multiplier);
 			}
 		}
 	}
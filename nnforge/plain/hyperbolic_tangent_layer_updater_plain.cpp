@@ -16,10 +16,13 @@
 
 #include "hyperbolic_tangent_layer_updater_plain.h"
 
+#include "activation_plain.h"
 #include "../hyperbolic_tangent_layer.h"
 #include "../neural_network_exception.h"
 #include "../nn_types.h"
 
+#include <algorithm>
+
 namespace nnforge
 {
 	namespace plain
@@ -54,21 +57,22 @@ namespace nnforge
 			if (offset_input_entry_id > 0)
 				throw neural_network_exception("hyperbolic_tangent_layer_updater_plain is not able to run using offset");
 
-			const int elem_count = static_cast<int>(updater_count * input_configuration_specific.get_neuron_count());
-			const std::vector<float>::const_iterator in_it = input_buffer->begin();
-			const std::vector<float>::iterator out_it = output_buffer->begin();
+			const unsigned int elem_count = updater_count * input_configuration_specific.get_neuron_count();
+			const float * const in_it = &(*input_buffer->begin());
+			float * const out_it = &(*output_buffer->begin());
 
 			nnforge_shared_ptr<const hyperbolic_tangent_layer> layer_derived = nnforge_dynamic_pointer_cast<const hyperbolic_tangent_layer>(layer_schema);
-			const float hyperbolic_tangent_steepness2 = layer_derived->steepness * 2.0F;
-			const float hyperbolic_tangent_major_multiplier = layer_derived->major_multiplier;
+			const float steepness = layer_derived->steepness;
+			const float major_multiplier = layer_derived->major_multiplier;
+
+			const int chunk_count = static_cast<int>((elem_count + activation_plain::chunk_size - 1) / activation_plain::chunk_size);
 
-			#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
-			for(int i = 0; i < elem_count; ++i)
+			#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+			for(int chunk_id = 0; chunk_id < chunk_count; ++chunk_id)
 			{
-				float inp = *(in_it + i);
-				float inp2 = expf(inp * hyperbolic_tangent_steepness2);
-				float res = (inp2 - 1.0F) / (inp2 + 1.0F) * hyperbolic_tangent_major_multiplier;
-				*(out_it + i) = res;
+				unsigned int chunk_start = chunk_id * activation_plain::chunk_size;
+				unsigned int chunk_elem_count = std::min(activation_plain::chunk_size, elem_count - chunk_start);
+				activation_plain::hyperbolic_tangent(in_it + chunk_start, out_it + chunk_start, chunk_elem_count, steepness, major_multiplier);
 			}
 		}
 
@@ -87,20 +91,22 @@ namespace nnforge
 			unsigned int updater_count,
 			bool force_deterministic) const
 		{
-			const int elem_count = static_cast<int>(updater_count * input_configuration_specific.get_neuron_count());
-			const std::vector<float>::iterator in_err_it = input_errors->begin();
-			const std::vector<float>::const_iterator out_it = output_neurons->begin();
+			const unsigned int elem_count = updater_count * input_configuration_specific.get_neuron_count();
+			float * const in_err_it = &(*input_errors->begin());
+			const float * const out_it = &(*output_neurons->begin());
 
 			nnforge_shared_ptr<const hyperbolic_tangent_layer> layer_derived = nnforge_dynamic_pointer_cast<const hyperbolic_tangent_layer>(layer_schema);
-			const float hyperbolic_tangent_major_multiplier_reverse = 1.0F / layer_derived->major_multiplier;
-			const float hyperbolic_tangent_steepness3 = layer_derived->steepness * layer_derived->major_multiplier;
-			#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
-			for(int i = 0; i < elem_count; ++i)
+			const float steepness = layer_derived->steepness;
+			const float major_multiplier = layer_derived->major_multiplier;
+
+			const int chunk_count = static_cast<int>((elem_count + activation_plain::chunk_size - 1) / activation_plain::chunk_size);
+
+			#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+			for(int chunk_id = 0; chunk_id < chunk_count; ++chunk_id)
 			{
-				float out_neuron = *(out_it + i);
-				float normalized_value = out_neuron * hyperbolic_tangent_major_multiplier_reverse;
-				float der1st = hyperbolic_tangent_steepness3 * (1.0F - (normalized_value * normalized_value));
-				*(in_err_it + i) *= der1st;
+				unsigned int chunk_start = chunk_id * activation_plain::chunk_size;
+				unsigned int chunk_elem_count = std::min(activation_plain::chunk_size, elem_count - chunk_start);
+				activation_plain::hyperbolic_tangent_backprop(in_err_it + chunk_start, out_it + chunk_start, chunk_elem_count, steepness, major_multiplier);
 			}
 		}
 
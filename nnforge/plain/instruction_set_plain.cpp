@@ -0,0 +1,87 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "instruction_set_plain.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		instruction_set_plain::instruction_set instruction_set_plain::get_instruction_set()
+		{
+			static const instruction_set res = detect();
+			return res;
+		}
+
+		const char * instruction_set_plain::get_name(instruction_set set)
+		{
+			switch (set)
+			{
+			case instruction_set_avx512:
+				return "AVX-512";
+			case instruction_set_avx2:
+				return "AVX2";
+			default:
+				return "SSE2";
+			}
+		}
+
+		instruction_set_plain::instruction_set instruction_set_plain::detect()
+		{
+		#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+				return instruction_set_avx512;
+			if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+				return instruction_set_avx2;
+			return instruction_set_sse2;
+		#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+				return instruction_set_sse2;
+
+			__cpuid(info, 1);
+			bool fma = (info[2] & (1 << 12)) != 0;
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			if (!fma || !osxsave)
+				return instruction_set_sse2;
+
+			// The OS should save YMM, and ZMM with opmask registers for AVX-512
+			unsigned long long xcr0 = _xgetbv(0);
+			if ((xcr0 & 0x6) != 0x6)
+				return instruction_set_sse2;
+
+			__cpuidex(info, 7, 0);
+			bool avx2 = (info[1] & (1 << 5)) != 0;
+			bool avx512f = (info[1] & (1 << 16)) != 0;
+			bool avx512bw = (info[1] & (1 << 30)) != 0;
+			if (!avx2)
+				return instruction_set_sse2;
+			if (avx512f && avx512bw && ((xcr0 & 0xe6) == 0xe6))
+				return instruction_set_avx512;
+			return instruction_set_avx2;
+		#else
+			return instruction_set_sse2;
+		#endif
+		}
+	}
+}
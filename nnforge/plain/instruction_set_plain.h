@@ -0,0 +1,49 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Runtime detection of SIMD extensions, compute kernels are compiled for each of them and picked at startup
+		// so that the same binary runs on older CPUs and still uses the widest vector unit available
+		class instruction_set_plain
+		{
+		public:
+			enum instruction_set
+			{
+				instruction_set_sse2 = 0,
+				instruction_set_avx2 = 1,
+				// AVX-512F with AVX-512BW, the 8-bit integer kernels need the latter
+				instruction_set_avx512 = 2
+			};
+
+			// The widest instruction set supported by both CPU and OS, detected once
+			static instruction_set get_instruction_set();
+
+			static const char * get_name(instruction_set set);
+
+		private:
+			static instruction_set detect();
+
+			instruction_set_plain();
+			instruction_set_plain(const instruction_set_plain&);
+			instruction_set_plain& operator =(const instruction_set_plain&);
+		};
+	}
+}
@@ -0,0 +1,427 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "int8_gemm_plain.h"
+
+#include "instruction_set_plain.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define NNFORGE_PLAIN_TARGET_PRAGMAS
+#endif
+
+// There is no portable way to have the compiler emit pmaddwd for a tile of outputs, the SSE2, AVX2 and AVX-512 kernels use intrinsics.
+// They are built by the compilers able to build them for the instruction set picked at runtime, others run the generic kernel
+#if defined(NNFORGE_PLAIN_TARGET_PRAGMAS) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define NNFORGE_PLAIN_INT8_INTRINSICS
+#include <immintrin.h>
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		namespace int8_gemm_generic
+		{
+			#include "int8_gemm_plain_kernels.h"
+		}
+
+#ifdef NNFORGE_PLAIN_INT8_INTRINSICS
+		// The pair of 16-bit input values multiplied by a pair of weights of each output
+		static inline int load_input_pair(const short * input)
+		{
+			int res;
+			memcpy(&res, input, sizeof(res));
+			return res;
+		}
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+		namespace int8_gemm_sse2
+		{
+			// Tiles of 4 input rows by 8 outputs, with 8 accumulators and 2 registers of widened weights
+			void multiply(
+				unsigned int row_count,
+				unsigned int output_count,
+				unsigned int k_pair_count,
+				const short * input,
+				const signed char * packed_weights,
+				const float * output_scales,
+				const float * biases,
+				float * output,
+				unsigned int output_row_stride,
+				unsigned int output_stride)
+			{
+				const unsigned int row_tile_size = 4;
+				const unsigned int output_tile_size = 8;
+				const unsigned int padded_k = k_pair_count * 2;
+				for(unsigned int output_start = 0; output_start < output_count; output_start += output_tile_size)
+				{
+					const unsigned int block_start = output_start - output_start % int8_gemm_plain::output_block_size;
+					const signed char * tile_weights = packed_weights + block_start * padded_k + (output_start - block_start) * 2;
+					const unsigned int tile_output_count = std::min(output_tile_size, output_count - output_start);
+					for(unsigned int row_start = 0; row_start < row_count; row_start += row_tile_size)
+					{
+						// Rows past the end repeat the last one, their results are not stored
+						const unsigned int tile_row_count = std::min(row_tile_size, row_count - row_start);
+						const short * in[row_tile_size];
+						for(unsigned int i = 0; i < row_tile_size; ++i)
+							in[i] = input + (row_start + std::min(i, tile_row_count - 1)) * padded_k;
+
+						__m128i acc[row_tile_size][2];
+						for(unsigned int i = 0; i < row_tile_size; ++i)
+						{
+							acc[i][0] = _mm_setzero_si128();
+							acc[i][1] = _mm_setzero_si128();
+						}
+
+						const signed char * w = tile_weights;
+						for(unsigned int k_pair_id = 0; k_pair_id < k_pair_count; ++k_pair_id)
+						{
+							// SSE2 has no sign extension of bytes, each byte is put into the upper half of a 16-bit value and shifted down
+							const __m128i w_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(w));
+							const __m128i w0 = _mm_srai_epi16(_mm_unpacklo_epi8(w_bytes, w_bytes), 8);
+							const __m128i w1 = _mm_srai_epi16(_mm_unpackhi_epi8(w_bytes, w_bytes), 8);
+							for(unsigned int i = 0; i < row_tile_size; ++i)
+							{
+								const __m128i in_pair = _mm_set1_epi32(load_input_pair(in[i] + k_pair_id * 2));
+								acc[i][0] = _mm_add_epi32(acc[i][0], _mm_madd_epi16(in_pair, w0));
+								acc[i][1] = _mm_add_epi32(acc[i][1], _mm_madd_epi16(in_pair, w1));
+							}
+							w += int8_gemm_plain::output_block_size * 2;
+						}
+
+						for(unsigned int i = 0; i < tile_row_count; ++i)
+						{
+							int sums[output_tile_size];
+							_mm_storeu_si128(reinterpret_cast<__m128i *>(sums), acc[i][0]);
+							_mm_storeu_si128(reinterpret_cast<__m128i *>(sums + 4), acc[i][1]);
+							float * out = output + (row_start + i) * output_row_stride + output_start * output_stride;
+							for(unsigned int j = 0; j < tile_output_count; ++j)
+								out[j * output_stride] = static_cast<float>(sums[j]) * output_scales[output_start + j] + biases[output_start + j];
+						}
+					}
+				}
+			}
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+		namespace int8_gemm_avx2
+		{
+			// Tiles of 4 input rows by 16 outputs, with 8 accumulators and 2 registers of widened weights
+			void multiply(
+				unsigned int row_count,
+				unsigned int output_count,
+				unsigned int k_pair_count,
+				const short * input,
+				const signed char * packed_weights,
+				const float * output_scales,
+				const float * biases,
+				float * output,
+				unsigned int output_row_stride,
+				unsigned int output_stride)
+			{
+				const unsigned int row_tile_size = 4;
+				const unsigned int output_tile_size = 16;
+				const unsigned int padded_k = k_pair_count * 2;
+				for(unsigned int output_start = 0; output_start < output_count; output_start += output_tile_size)
+				{
+					const unsigned int block_start = output_start - output_start % int8_gemm_plain::output_block_size;
+					const signed char * tile_weights = packed_weights + block_start * padded_k + (output_start - block_start) * 2;
+					const unsigned int tile_output_count = std::min(output_tile_size, output_count - output_start);
+					for(unsigned int row_start = 0; row_start < row_count; row_start += row_tile_size)
+					{
+						// Rows past the end repeat the last one, their results are not stored
+						const unsigned int tile_row_count = std::min(row_tile_size, row_count - row_start);
+						const short * in[row_tile_size];
+						for(unsigned int i = 0; i < row_tile_size; ++i)
+							in[i] = input + (row_start + std::min(i, tile_row_count - 1)) * padded_k;
+
+						__m256i acc[row_tile_size][2];
+						for(unsigned int i = 0; i < row_tile_size; ++i)
+						{
+							acc[i][0] = _mm256_setzero_si256();
+							acc[i][1] = _mm256_setzero_si256();
+						}
+
+						const signed char * w = tile_weights;
+						for(unsigned int k_pair_id = 0; k_pair_id < k_pair_count; ++k_pair_id)
+						{
+							const __m256i w0 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(w)));
+							const __m256i w1 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(w + 16)));
+							for(unsigned int i = 0; i < row_tile_size; ++i)
+							{
+								const __m256i in_pair = _mm256_set1_epi32(load_input_pair(in[i] + k_pair_id * 2));
+								acc[i][0] = _mm256_add_epi32(acc[i][0], _mm256_madd_epi16(in_pair, w0));
+								acc[i][1] = _mm256_add_epi32(acc[i][1], _mm256_madd_epi16(in_pair, w1));
+							}
+							w += int8_gemm_plain::output_block_size * 2;
+						}
+
+						for(unsigned int i = 0; i < tile_row_count; ++i)
+						{
+							int sums[output_tile_size];
+							_mm256_storeu_si256(reinterpret_cast<__m256i *>(sums), acc[i][0]);
+							_mm256_storeu_si256(reinterpret_cast<__m256i *>(sums + 8), acc[i][1]);
+							float * out = output + (row_start + i) * output_row_stride + output_start * output_stride;
+							for(unsigned int j = 0; j < tile_output_count; ++j)
+								out[j * output_stride] = static_cast<float>(sums[j]) * output_scales[output_start + j] + biases[output_start + j];
+						}
+					}
+				}
+			}
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx2,fma")
+#endif
+		namespace int8_gemm_avx512
+		{
+			// Tiles of 6 input rows by a block of 32 outputs, with 12 accumulators and 2 registers of widened weights
+			void multiply(
+				unsigned int row_count,
+				unsigned int output_count,
+				unsigned int k_pair_count,
+				const short * input,
+				const signed char * packed_weights,
+				const float * output_scales,
+				const float * biases,
+				float * output,
+				unsigned int output_row_stride,
+				unsigned int output_stride)
+			{
+				const unsigned int row_tile_size = 6;
+				const unsigned int output_tile_size = int8_gemm_plain::output_block_size;
+				const unsigned int padded_k = k_pair_count * 2;
+				for(unsigned int output_start = 0; output_start < output_count; output_start += output_tile_size)
+				{
+					const signed char * tile_weights = packed_weights + output_start * padded_k;
+					const unsigned int tile_output_count = std::min(output_tile_size, output_count - output_start);
+					for(unsigned int row_start = 0; row_start < row_count; row_start += row_tile_size)
+					{
+						// Rows past the end repeat the last one, their results are not stored
+						const unsigned int tile_row_count = std::min(row_tile_size, row_count - row_start);
+						const short * in[row_tile_size];
+						for(unsigned int i = 0; i < row_tile_size; ++i)
+							in[i] = input + (row_start + std::min(i, tile_row_count - 1)) * padded_k;
+
+						__m512i acc[row_tile_size][2];
+						for(unsigned int i = 0; i < row_tile_size; ++i)
+						{
+							acc[i][0] = _mm512_setzero_si512();
+							acc[i][1] = _mm512_setzero_si512();
+						}
+
+						const signed char * w = tile_weights;
+						for(unsigned int k_pair_id = 0; k_pair_id < k_pair_count; ++k_pair_id)
+						{
+							const __m512i w0 = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(w)));
+							const __m512i w1 = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(w + 32)));
+							for(unsigned int i = 0; i < row_tile_size; ++i)
+							{
+								const __m512i in_pair = _mm512_set1_epi32(load_input_pair(in[i] + k_pair_id * 2));
+								acc[i][0] = _mm512_add_epi32(acc[i][0], _mm512_madd_epi16(in_pair, w0));
+								acc[i][1] = _mm512_add_epi32(acc[i][1], _mm512_madd_epi16(in_pair, w1));
+							}
+							w += int8_gemm_plain::output_block_size * 2;
+						}
+
+						for(unsigned int i = 0; i < tile_row_count; ++i)
+						{
+							int sums[output_tile_size];
+							_mm512_storeu_si512(sums, acc[i][0]);
+							_mm512_storeu_si512(sums + 16, acc[i][1]);
+							float * out = output + (row_start + i) * output_row_stride + output_start * output_stride;
+							for(unsigned int j = 0; j < tile_output_count; ++j)
+								out[j * output_stride] = static_cast<float>(sums[j]) * output_scales[output_start + j] + biases[output_start + j];
+						}
+					}
+				}
+			}
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+#endif
+
+		const unsigned int int8_gemm_plain::output_block_size;
+
+		// Rounds to nearest with the halves rounded up: the value is shifted to be positive, so that truncation is rounding down.
+		// It is clamped after the shift, right before the conversion, otherwise compilers keep the loops calling it from being vectorized
+		static inline int quantize_value(
+			float val,
+			float mult)
+		{
+			return static_cast<int>(std::min(std::max(val * mult + 128.5F, 1.5F), 255.5F)) - 128;
+		}
+
+		unsigned int int8_gemm_plain::get_padded_k(unsigned int k)
+		{
+			return (k + 1) & ~1U;
+		}
+
+		unsigned int int8_gemm_plain::get_packed_weights_elem_count(
+			unsigned int output_count,
+			unsigned int k)
+		{
+			return ((output_count + output_block_size - 1) / output_block_size) * output_block_size * get_padded_k(k);
+		}
+
+		void int8_gemm_plain::quantize(
+			const float * input,
+			short * output,
+			unsigned int elem_count,
+			float scale)
+		{
+			const float mult = 1.0F / scale;
+			for(unsigned int i = 0; i < elem_count; ++i)
+				output[i] = static_cast<short>(quantize_value(input[i], mult));
+		}
+
+		void int8_gemm_plain::quantize_transposed(
+			const float * input,
+			short * output,
+			unsigned int row_count,
+			unsigned int column_count,
+			float scale)
+		{
+			const float mult = 1.0F / scale;
+			const unsigned int padded_row_count = get_padded_k(row_count);
+
+			// Pairs of rows are quantized to a contiguous chunk first, then each pair of values is stored with a single write
+			const unsigned int chunk_size = 128;
+			short pairs[chunk_size * 2];
+			unsigned int row_id = 0;
+			for(; row_id + 1 < row_count; row_id += 2)
+			{
+				const float * in0 = input + row_id * column_count;
+				const float * in1 = in0 + column_count;
+				for(unsigned int column_start = 0; column_start < column_count; column_start += chunk_size)
+				{
+					const unsigned int chunk_column_count = std::min(chunk_size, column_count - column_start);
+					for(unsigned int i = 0; i < chunk_column_count; ++i)
+					{
+						pairs[i * 2] = static_cast<short>(quantize_value(in0[column_start + i], mult));
+						pairs[i * 2 + 1] = static_cast<short>(quantize_value(in1[column_start + i], mult));
+					}
+					short * out = output + column_start * padded_row_count + row_id;
+					for(unsigned int i = 0; i < chunk_column_count; ++i)
+						memcpy(out + i * padded_row_count, pairs + i * 2, sizeof(short) * 2);
+				}
+			}
+			if (row_id < row_count)
+			{
+				const float * in = input + row_id * column_count;
+				short * out = output + row_id;
+				for(unsigned int column_id = 0; column_id < column_count; ++column_id)
+					out[column_id * padded_row_count] = static_cast<short>(quantize_value(in[column_id], mult));
+			}
+		}
+
+		void int8_gemm_plain::quantize_rows(
+			const float * input,
+			unsigned int row_count,
+			unsigned int row_elem_count,
+			signed char * output,
+			float * scales)
+		{
+			for(unsigned int row_id = 0; row_id < row_count; ++row_id)
+			{
+				const float * in = input + row_id * row_elem_count;
+				float max_abs_val = 0.0F;
+				for(unsigned int i = 0; i < row_elem_count; ++i)
+					max_abs_val = std::max(max_abs_val, std::max(in[i], -in[i]));
+
+				const float scale = (max_abs_val > 0.0F) ? (max_abs_val * (1.0F / 127.0F)) : 1.0F;
+				const float mult = 1.0F / scale;
+				signed char * out = output + row_id * row_elem_count;
+				for(unsigned int i = 0; i < row_elem_count; ++i)
+					out[i] = static_cast<signed char>(quantize_value(in[i], mult));
+				scales[row_id] = scale;
+			}
+		}
+
+		void int8_gemm_plain::pack_weights(
+			const signed char * weights,
+			unsigned int output_count,
+			unsigned int k,
+			signed char * packed_weights)
+		{
+			// Blocks of outputs, pairs of weights along k, outputs within the block, the 2 weights of the pair
+			const unsigned int padded_k = get_padded_k(k);
+			const unsigned int block_count = (output_count + output_block_size - 1) / output_block_size;
+			std::fill_n(packed_weights, get_packed_weights_elem_count(output_count, k), static_cast<signed char>(0));
+			for(unsigned int block_id = 0; block_id < block_count; ++block_id)
+			{
+				const unsigned int block_output_count = std::min(output_block_size, output_count - block_id * output_block_size);
+				signed char * block_packed_weights = packed_weights + block_id * output_block_size * padded_k;
+				for(unsigned int i = 0; i < block_output_count; ++i)
+				{
+					const signed char * w = weights + (block_id * output_block_size + i) * k;
+					for(unsigned int j = 0; j < k; ++j)
+						block_packed_weights[(j / 2) * (output_block_size * 2) + i * 2 + (j & 1)] = w[j];
+				}
+			}
+		}
+
+		void int8_gemm_plain::multiply(
+			unsigned int row_count,
+			unsigned int output_count,
+			unsigned int k,
+			const short * input,
+			const signed char * packed_weights,
+			const float * output_scales,
+			const float * biases,
+			float * output,
+			unsigned int output_row_stride,
+			unsigned int output_stride)
+		{
+			get_multiply_kernel()(row_count, output_count, get_padded_k(k) / 2, input, packed_weights, output_scales, biases, output, output_row_stride, output_stride);
+		}
+
+		int8_gemm_plain::multiply_kernel_function int8_gemm_plain::get_multiply_kernel()
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+#ifdef NNFORGE_PLAIN_INT8_INTRINSICS
+			case instruction_set_plain::instruction_set_avx512:
+				return int8_gemm_avx512::multiply;
+			case instruction_set_plain::instruction_set_avx2:
+				return int8_gemm_avx2::multiply;
+			default:
+				return int8_gemm_sse2::multiply;
+#else
+			default:
+				return int8_gemm_generic::multiply;
+#endif
+			}
+		}
+	}
+}
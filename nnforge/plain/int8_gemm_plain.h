@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// 8-bit integer matrix product with 32-bit accumulation, used by the quantized inference
+		// Values are quantized symmetrically to [-127, 127], so zero is exact and no zero points are required.
+		// The quantized input is kept in 16 bits and the weights are packed in blocks of output_block_size outputs,
+		// so that the kernels multiply pairs of 16-bit values with 32-bit accumulation (pmaddwd) on a tile of input rows and outputs
+		class int8_gemm_plain
+		{
+		public:
+			// Weights are packed in blocks of this many outputs, the last block is padded with zero weights
+			static const unsigned int output_block_size = 32;
+
+			// Length of the rows of the quantized input and of the packed weights, k rounded up to be even
+			static unsigned int get_padded_k(unsigned int k);
+
+			static unsigned int get_packed_weights_elem_count(
+				unsigned int output_count,
+				unsigned int k);
+
+			// output = round(input / scale), clamped to [-127, 127]
+			static void quantize(
+				const float * input,
+				short * output,
+				unsigned int elem_count,
+				float scale);
+
+			// The same as quantize, input is row_count x column_count, output is its transpose with rows of get_padded_k(row_count) elements.
+			// The padding element is not written
+			static void quantize_transposed(
+				const float * input,
+				short * output,
+				unsigned int row_count,
+				unsigned int column_count,
+				float scale);
+
+			// Quantizes each of row_count rows with its own scale, which is the max absolute value of the row divided by 127
+			static void quantize_rows(
+				const float * input,
+				unsigned int row_count,
+				unsigned int row_elem_count,
+				signed char * output,
+				float * scales);
+
+			// Packs output_count x k row-major weights for multiply, packed_weights should have get_packed_weights_elem_count elements
+			static void pack_weights(
+				const signed char * weights,
+				unsigned int output_count,
+				unsigned int k,
+				signed char * packed_weights);
+
+			// output[row_id * output_row_stride + output_id * output_stride] = dot(input row, weights row) * output_scales[output_id] + biases[output_id]
+			// input is row_count x get_padded_k(k) with zero padding, packed_weights are the ones from pack_weights,
+			// offset by output_start * get_padded_k(k) to start from output_start, which should be a multiple of output_block_size
+			static void multiply(
+				unsigned int row_count,
+				unsigned int output_count,
+				unsigned int k,
+				const short * input,
+				const signed char * packed_weights,
+				const float * output_scales,
+				const float * biases,
+				float * output,
+				unsigned int output_row_stride,
+				unsigned int output_stride);
+
+		private:
+			typedef void (*multiply_kernel_function)(
+				unsigned int row_count,
+				unsigned int output_count,
+				unsigned int k_pair_count,
+				const short * input,
+				const signed char * packed_weights,
+				const float * output_scales,
+				const float * biases,
+				float * output,
+				unsigned int output_row_stride,
+				unsigned int output_stride);
+
+			static multiply_kernel_function get_multiply_kernel();
+		};
+	}
+}
@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// Body of the generic 8-bit integer kernel, there is no include guard on purpose:
+// int8_gemm_plain.cpp includes this file once per instruction set it has no intrinsics kernel for, each time within its own namespace.
+
+// Each input row is multiplied by a block of outputs at a time, the accumulators of the block stay in registers
+void multiply(
+	unsigned int row_count,
+	unsigned int output_count,
+	unsigned int k_pair_count,
+	const short * input,
+	const signed char * packed_weights,
+	const float * output_scales,
+	const float * biases,
+	float * output,
+	unsigned int output_row_stride,
+	unsigned int output_stride)
+{
+	const unsigned int padded_k = k_pair_count * 2;
+	for(unsigned int output_start = 0; output_start < output_count; output_start += int8_gemm_plain::output_block_size)
+	{
+		const signed char * block_weights = packed_weights + output_start * padded_k;
+		const unsigned int block_output_count = std::min(int8_gemm_plain::output_block_size, output_count - output_start);
+		for(unsigned int row_id = 0; row_id < row_count; ++row_id)
+		{
+			const short * in = input + row_id * padded_k;
+			const signed char * w = block_weights;
+
+			// Fixed trip counts let the compiler keep the whole block in vector registers
+			int acc[int8_gemm_plain::output_block_size];
+			for(int i = 0; i < static_cast<int>(int8_gemm_plain::output_block_size); ++i)
+				acc[i] = 0;
+			for(unsigned int k_pair_id = 0; k_pair_id < k_pair_count; ++k_pair_id)
+			{
+				const int in0 = in[k_pair_id * 2];
+				const int in1 = in[k_pair_id * 2 + 1];
+				for(int i = 0; i < static_cast<int>(int8_gemm_plain::output_block_size); ++i)
+					acc[i] += in0 * w[i * 2] + in1 * w[i * 2 + 1];
+				w += int8_gemm_plain::output_block_size * 2;
+			}
+
+			float * out = output + row_id * output_row_stride + output_start * output_stride;
+			for(unsigned int i = 0; i < block_output_count; ++i)
+				out[i * output_stride] = static_cast<float>(acc[i]) * output_scales[output_start + i] + biases[output_start + i];
+		}
+	}
+}
@@ -16,6 +16,8 @@
 
 #include "layer_tester_plain.h"
 
+#include "../neural_network_exception.h"
+
 namespace nnforge
 {
 	namespace plain
@@ -40,7 +42,10 @@ namespace nnforge
 				input_configuration_specific,
 				output_configuration_specific,
 				plain_config);
-			for(std::vector<std::pair<unsigned int, bool> >::const_iterator it = buffer_sizes_per_entry_aligned.begin(); it != buffer_sizes_per_entry_aligned.end(); ++it)
+			std::vector<std::pair<unsigned int, bool> >::const_iterator start_it = buffer_sizes_per_entry_aligned.begin();
+			if (!is_in_place())
+				++start_it;
+			for(std::vector<std::pair<unsigned int, bool> >::const_iterator it = start_it; it != buffer_sizes_per_entry_aligned.end(); ++it)
 			{
 				size_t s = static_cast<size_t>(it->first) * sizeof(float);
 				if (it->second)
@@ -61,6 +66,8 @@ namespace nnforge
 
 		additional_buffer_set layer_tester_plain::allocate_additional_buffers(
 			unsigned int max_entry_count,
+			additional_buffer_smart_ptr output_buffer,
+			buffer_arena_plain& arena,
 			const_layer_smart_ptr layer_schema,
 			const layer_configuration_specific& input_configuration_specific,
 			const layer_configuration_specific& output_configuration_specific,
@@ -74,8 +81,14 @@ namespace nnforge
 				output_configuration_specific,
 				plain_config);
 
-			for(std::vector<std::pair<unsigned int, bool> >::const_iterator it = buffer_sizes_per_entry_aligned.begin(); it != buffer_sizes_per_entry_aligned.end(); ++it)
-				res.push_back(additional_buffer_smart_ptr(new std::vector<float>(it->first * (it->second ? max_entry_count : 1))));
+			std::vector<std::pair<unsigned int, bool> >::const_iterator start_it = buffer_sizes_per_entry_aligned.begin();
+			if (!is_in_place())
+			{
+				res.push_back(output_buffer);
+				++start_it;
+			}
+			for(std::vector<std::pair<unsigned int, bool> >::const_iterator it = start_it; it != buffer_sizes_per_entry_aligned.end(); ++it)
+				res.push_back(arena.create_buffer(it->first * (it->second ? max_entry_count : 1)));
 
 			return res;
 		}
@@ -84,7 +97,125 @@ namespace nnforge
 			additional_buffer_smart_ptr input_buffer,
 			additional_buffer_set& additional_buffers) const
 		{
-			return input_buffer;
+			return is_in_place() ? input_buffer : additional_buffers[0];
+		}
+
+		bool layer_tester_plain::is_in_place() const
+		{
+			return true;
+		}
+
+		const_layer_data_smart_ptr layer_tester_plain::get_data(
+			const_layer_data_smart_ptr host_data,
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			plain_running_configuration_const_smart_ptr plain_config) const
+		{
+			return host_data;
+		}
+
+		const_layer_data_custom_smart_ptr layer_tester_plain::get_data_custom(
+			const_layer_data_custom_smart_ptr host_data_custom,
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			plain_running_configuration_const_smart_ptr plain_config) const
+		{
+			return host_data_custom;
+		}
+
+		layer_tester_plain::blocked_layout_support layer_tester_plain::get_blocked_layout_support(
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			return blocked_layout_unsupported;
+		}
+
+		const_layer_data_smart_ptr layer_tester_plain::get_blocked_data(
+			const_layer_data_smart_ptr host_data,
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			plain_running_configuration_const_smart_ptr plain_config) const
+		{
+			return host_data;
+		}
+
+		void layer_tester_plain::test_blocked(
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_smart_ptr output_buffer,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int entry_count) const
+		{
+			throw neural_network_exception("test_blocked is not implemented for this layer tester");
+		}
+
+		bool layer_tester_plain::is_quantization_supported(
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			return false;
+		}
+
+		const_quantized_layer_data_plain_smart_ptr layer_tester_plain::get_quantized_data(
+			const_layer_data_smart_ptr host_data,
+			float input_scale,
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			throw neural_network_exception("get_quantized_data is not implemented for this layer tester");
+		}
+
+		void layer_tester_plain::test_quantized(
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_set& additional_buffers,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_quantized_layer_data_plain_smart_ptr data,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int entry_count) const
+		{
+			throw neural_network_exception("test_quantized is not implemented for this layer tester");
+		}
+
+		bool layer_tester_plain::is_half_precision_supported(
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			return false;
+		}
+
+		const_half_layer_data_plain_smart_ptr layer_tester_plain::get_half_precision_data(
+			const_layer_data_smart_ptr host_data,
+			half_float_plain::format weight_format,
+			const_layer_smart_ptr layer_schema,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+			throw neural_network_exception("get_half_precision_data is not implemented for this layer tester");
+		}
+
+		void layer_tester_plain::test_half_precision(
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_set& additional_buffers,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_half_layer_data_plain_smart_ptr data,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific,
+			unsigned int entry_count) const
+		{
+			throw neural_network_exception("test_half_precision is not implemented for this layer tester");
 		}
 	}
 }
@@ -24,21 +24,34 @@
 
 #include "plain_running_configuration.h"
 #include "buffer_plain_size_configuration.h"
+#include "additional_buffer_plain.h"
+#include "buffer_arena_plain.h"
+#include "quantized_layer_data_plain.h"
+#include "half_layer_data_plain.h"
 
 namespace nnforge
 {
 	namespace plain
 	{
-		typedef nnforge_shared_ptr<std::vector<float> > additional_buffer_smart_ptr;
-		typedef std::vector<additional_buffer_smart_ptr> additional_buffer_set;
-
 		class layer_tester_plain
 		{
 		public:
+			// Layouts accepted by the tester, see blocked_layout_plain
+			enum blocked_layout_support
+			{
+				// Planar layout only
+				blocked_layout_unsupported,
+				// Element-wise layers working on either layout, they don't benefit from the blocked one by themselves
+				blocked_layout_transparent,
+				// Layers with kernels dedicated to the blocked layout
+				blocked_layout_native
+			};
+
 			virtual ~layer_tester_plain();
 
 			virtual const boost::uuids::uuid& get_uuid() const = 0;
 
+			// The output buffer of out-of-place layers is not included, network_tester_plain plans it along with the other activations
 			void update_buffer_configuration(
 				buffer_plain_size_configuration& buffer_configuration,
 				const_layer_smart_ptr layer_schema,
@@ -46,17 +59,44 @@ namespace nnforge
 				const layer_configuration_specific& output_configuration_specific,
 				plain_running_configuration_const_smart_ptr plain_config) const;
 
+			// output_buffer is put first into the set for out-of-place layers, it is ignored for in-place ones.
+			// It might be larger than the output of the layer and might be shared with other layers.
+			// The other buffers are created by arena
 			additional_buffer_set allocate_additional_buffers(
 				unsigned int max_entry_count,
+				additional_buffer_smart_ptr output_buffer,
+				buffer_arena_plain& arena,
 				const_layer_smart_ptr layer_schema,
 				const layer_configuration_specific& input_configuration_specific,
 				const layer_configuration_specific& output_configuration_specific,
 				plain_running_configuration_const_smart_ptr plain_config) const;
 
-			virtual additional_buffer_smart_ptr get_output_buffer(
+			additional_buffer_smart_ptr get_output_buffer(
 				additional_buffer_smart_ptr input_buffer,
 				additional_buffer_set& additional_buffers) const;
 
+			// In-place layers overwrite their input with the output,
+			// out-of-place layers write it to the first additional buffer, with its size returned first by get_elem_count_and_per_entry_flag_additional_buffers
+			virtual bool is_in_place() const;
+
+			// The method is called each time the data or the layer configuration is changed
+			// The data returned is passed to test instead of the original one,
+			// override it to derive data once per data load, transformed weights for example
+			virtual const_layer_data_smart_ptr get_data(
+				const_layer_data_smart_ptr host_data,
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				plain_running_configuration_const_smart_ptr plain_config) const;
+
+			// The same as get_data, for the custom data, connection lists reordered for the tester for example
+			virtual const_layer_data_custom_smart_ptr get_data_custom(
+				const_layer_data_custom_smart_ptr host_data_custom,
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				plain_running_configuration_const_smart_ptr plain_config) const;
+
 			virtual void test(
 				additional_buffer_smart_ptr input_buffer,
 				additional_buffer_set& additional_buffers,
@@ -68,6 +108,82 @@ namespace nnforge
 				const layer_configuration_specific& output_configuration_specific,
 				unsigned int entry_count) const = 0;
 
+			virtual blocked_layout_support get_blocked_layout_support(
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
+			// The same as get_data, for test_blocked
+			virtual const_layer_data_smart_ptr get_blocked_data(
+				const_layer_data_smart_ptr host_data,
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				plain_running_configuration_const_smart_ptr plain_config) const;
+
+			// Input and output buffers are in the blocked layout, the method is called only for the testers supporting it
+			// data is the one returned by get_blocked_data
+			virtual void test_blocked(
+				additional_buffer_smart_ptr input_buffer,
+				additional_buffer_smart_ptr output_buffer,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_layer_data_smart_ptr data,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int entry_count) const;
+
+			// Returns true for the layers with 8-bit kernels used by the quantized inference
+			virtual bool is_quantization_supported(
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
+			// The method is called each time the data, the layer configuration or the calibration is changed
+			// input_scale is the input neuron value to be represented by 1 in the quantized input
+			virtual const_quantized_layer_data_plain_smart_ptr get_quantized_data(
+				const_layer_data_smart_ptr host_data,
+				float input_scale,
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
+			// The same as test with the data returned by get_quantized_data, the method is called only for the testers supporting it
+			virtual void test_quantized(
+				additional_buffer_smart_ptr input_buffer,
+				additional_buffer_set& additional_buffers,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_quantized_layer_data_plain_smart_ptr data,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int entry_count) const;
+
+			// Returns true for the layers with kernels reading 16-bit weights
+			virtual bool is_half_precision_supported(
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
+			// The method is called each time the data or the layer configuration is changed
+			virtual const_half_layer_data_plain_smart_ptr get_half_precision_data(
+				const_layer_data_smart_ptr host_data,
+				half_float_plain::format weight_format,
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
+			// The same as test with the data returned by get_half_precision_data, the method is called only for the testers supporting it
+			virtual void test_half_precision(
+				additional_buffer_smart_ptr input_buffer,
+				additional_buffer_set& additional_buffers,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_half_layer_data_plain_smart_ptr data,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				unsigned int entry_count) const;
+
 		protected:
 			layer_tester_plain();
 
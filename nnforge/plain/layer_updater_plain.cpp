@@ -99,6 +99,7 @@ namespace nnforge
 
 		updater_additional_buffer_set layer_updater_plain::allocate_additional_buffers(
 			unsigned int updater_entry_count,
+			buffer_arena_plain& arena,
 			const_layer_smart_ptr layer_schema,
 			const layer_configuration_specific& input_configuration_specific,
 			const layer_configuration_specific& output_configuration_specific,
@@ -115,12 +116,12 @@ namespace nnforge
 				backprop_required);
 
 			for(std::vector<std::pair<unsigned int, bool> >::const_iterator it = buffer_sizes_per_entry_aligned.begin(); it != buffer_sizes_per_entry_aligned.end(); ++it)
-				res.additional_buffers.push_back(additional_buffer_smart_ptr(new std::vector<float>(it->first * (it->second ? updater_entry_count : 1))));
+				res.additional_buffers.push_back(arena.create_buffer(it->first * (it->second ? updater_entry_count : 1)));
 
-			res.output_neurons_buffer = additional_buffer_smart_ptr(new std::vector<float>(output_configuration_specific.get_neuron_count() * updater_entry_count));
+			res.output_neurons_buffer = arena.create_buffer(output_configuration_specific.get_neuron_count() * updater_entry_count);
 
 			if (backprop_required && !is_in_place_backprop())
-				res.input_errors_buffer = additional_buffer_smart_ptr(new std::vector<float>(input_configuration_specific.get_neuron_count() * updater_entry_count));
+				res.input_errors_buffer = arena.create_buffer(input_configuration_specific.get_neuron_count() * updater_entry_count);
 
 			return res;
 		}
@@ -140,5 +141,15 @@ namespace nnforge
 			bool force_deterministic) const
 		{
 		}
+
+		void layer_updater_plain::update_data_derived_buffers(
+			std::vector<additional_buffer_smart_ptr>& additional_buffers,
+			plain_running_configuration_const_smart_ptr plain_config,
+			const_layer_smart_ptr layer_schema,
+			const_layer_data_smart_ptr data,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific) const
+		{
+		}
 	}
 }
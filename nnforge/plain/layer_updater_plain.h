@@ -24,13 +24,13 @@
 
 #include "plain_running_configuration.h"
 #include "buffer_plain_size_configuration.h"
+#include "additional_buffer_plain.h"
+#include "buffer_arena_plain.h"
 
 namespace nnforge
 {
 	namespace plain
 	{
-		typedef nnforge_shared_ptr<std::vector<float> > additional_buffer_smart_ptr;
-		typedef nnforge_shared_ptr<const std::vector<float> > const_additional_buffer_smart_ptr;
 		struct updater_additional_buffer_set
 		{
 			additional_buffer_smart_ptr output_neurons_buffer;
@@ -62,8 +62,10 @@ namespace nnforge
 				bool backprop_required,
 				unsigned int updater_entry_count) const;
 
+			// The buffers are created by arena
 			updater_additional_buffer_set allocate_additional_buffers(
 				unsigned int updater_entry_count,
+				buffer_arena_plain& arena,
 				const_layer_smart_ptr layer_schema,
 				const layer_configuration_specific& input_configuration_specific,
 				const layer_configuration_specific& output_configuration_specific,
@@ -113,6 +115,16 @@ namespace nnforge
 				unsigned int offset_input_entry_id,
 				bool force_deterministic) const;
 
+			// The method is called once the weights are set or updated, before test and backprop run with them.
+			// Layers keeping data derived from weights in additional buffers, like transformed weights, refresh it here
+			virtual void update_data_derived_buffers(
+				std::vector<additional_buffer_smart_ptr>& additional_buffers,
+				plain_running_configuration_const_smart_ptr plain_config,
+				const_layer_smart_ptr layer_schema,
+				const_layer_data_smart_ptr data,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific) const;
+
 		protected:
 			layer_updater_plain();
 
@@ -0,0 +1,220 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "local_contrast_subtractive_plain.h"
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		local_contrast_subtractive_plain::local_contrast_subtractive_plain(
+			const std::vector<std::vector<float> >& window_weights_list,
+			const std::vector<unsigned int>& feature_maps_affected,
+			const layer_configuration_specific& input_configuration_specific)
+			: window_weights_list(window_weights_list)
+			, feature_maps_affected(feature_maps_affected)
+			, dimension_sizes(input_configuration_specific.dimension_sizes)
+			, feature_map_count(input_configuration_specific.feature_map_count)
+			, neuron_count_per_feature_map(input_configuration_specific.get_neuron_count_per_feature_map())
+		{
+			for(unsigned int i = 0; i < feature_map_count; ++i)
+				if (!std::binary_search(this->feature_maps_affected.begin(), this->feature_maps_affected.end(), i))
+					feature_maps_unaffected.push_back(i);
+
+			slices.resize(dimension_sizes.size());
+			for(unsigned int i = 0; i < dimension_sizes.size(); ++i)
+				slices[i] = (i == 0) ? 1 : slices[i - 1] * dimension_sizes[i - 1];
+		}
+
+		unsigned int local_contrast_subtractive_plain::get_buffer_elem_count() const
+		{
+			return neuron_count_per_feature_map * ((window_weights_list.size() > 1) ? 2 : 1);
+		}
+
+		void local_contrast_subtractive_plain::filter_rows(
+			const float * input,
+			float * output) const
+		{
+			const std::vector<float>& weights = window_weights_list[0];
+			const float * const w = &(*weights.begin());
+			const int radius = static_cast<int>(weights.size()) - 1;
+			const int width = static_cast<int>(dimension_sizes[0]);
+			const int row_count = static_cast<int>(neuron_count_per_feature_map) / width;
+			const int interior_start = std::min(radius, width);
+			const int interior_end = std::max(interior_start, width - radius);
+			const float w0 = w[0];
+
+			for(int row_id = 0; row_id < row_count; ++row_id)
+			{
+				const float * in = input + row_id * width;
+				float * out = output + row_id * width;
+
+				// Prologue and epilogue mirror the positions outside the row
+				for(int x = 0; x < interior_start; ++x)
+				{
+					float sum = in[x] * w0;
+					for(int k = 1; k <= radius; ++k)
+					{
+						int x_forward = (x + k < width) ? (x + k) : (((width << 1) - 1) - (x + k));
+						int x_backward = (x - k >= 0) ? (x - k) : (-1 - (x - k));
+						sum += (in[x_forward] + in[x_backward]) * w[k];
+					}
+					out[x] = sum;
+				}
+
+				for(int x = interior_start; x < interior_end; ++x)
+					out[x] = in[x] * w0;
+				for(int k = 1; k <= radius; ++k)
+				{
+					const float wk = w[k];
+					const float * in_forward = in + k;
+					const float * in_backward = in - k;
+					for(int x = interior_start; x < interior_end; ++x)
+						out[x] += (in_forward[x] + in_backward[x]) * wk;
+				}
+
+				for(int x = interior_end; x < width; ++x)
+				{
+					float sum = in[x] * w0;
+					for(int k = 1; k <= radius; ++k)
+					{
+						int x_forward = (x + k < width) ? (x + k) : (((width << 1) - 1) - (x + k));
+						int x_backward = (x - k >= 0) ? (x - k) : (-1 - (x - k));
+						sum += (in[x_forward] + in[x_backward]) * w[k];
+					}
+					out[x] = sum;
+				}
+			}
+		}
+
+		void local_contrast_subtractive_plain::filter_slices(
+			unsigned int dimension_id,
+			const float * input,
+			float * output) const
+		{
+			const std::vector<float>& weights = window_weights_list[dimension_id];
+			const float * const w = &(*weights.begin());
+			const int radius = static_cast<int>(weights.size()) - 1;
+			const int size = static_cast<int>(dimension_sizes[dimension_id]);
+			const int slice_size = static_cast<int>(slices[dimension_id]);
+			const int outer_count = static_cast<int>(neuron_count_per_feature_map) / (slice_size * size);
+			const float w0 = w[0];
+
+			for(int outer_id = 0; outer_id < outer_count; ++outer_id)
+			{
+				const float * in_base = input + outer_id * slice_size * size;
+				float * out_base = output + outer_id * slice_size * size;
+				for(int position = 0; position < size; ++position)
+				{
+					const float * in = in_base + position * slice_size;
+					float * out = out_base + position * slice_size;
+					for(int i = 0; i < slice_size; ++i)
+						out[i] = in[i] * w0;
+
+					for(int k = 1; k <= radius; ++k)
+					{
+						int position_forward = (position + k < size) ? (position + k) : (((size << 1) - 1) - (position + k));
+						int position_backward = (position - k >= 0) ? (position - k) : (-1 - (position - k));
+						const float * in_forward = in_base + position_forward * slice_size;
+						const float * in_backward = in_base + position_backward * slice_size;
+						const float wk = w[k];
+						for(int i = 0; i < slice_size; ++i)
+							out[i] += (in_forward[i] + in_backward[i]) * wk;
+					}
+				}
+			}
+		}
+
+		void local_contrast_subtractive_plain::process_feature_map(
+			const float * input,
+			float * output,
+			float * buffer) const
+		{
+			float * blurred = buffer;
+			float * other = buffer + neuron_count_per_feature_map;
+
+			filter_rows(input, blurred);
+			for(unsigned int dimension_id = 1; dimension_id < window_weights_list.size(); ++dimension_id)
+			{
+				filter_slices(dimension_id, blurred, other);
+				std::swap(blurred, other);
+			}
+
+			for(unsigned int i = 0; i < neuron_count_per_feature_map; ++i)
+				output[i] = input[i] - blurred[i];
+		}
+
+		void local_contrast_subtractive_plain::forward(
+			const float * input,
+			float * output,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int feature_maps_affected_count = static_cast<unsigned int>(feature_maps_affected.size());
+			const unsigned int neuron_count = feature_map_count * neuron_count_per_feature_map;
+			const unsigned int buffer_elem_count = get_buffer_elem_count();
+			const int total_workload = static_cast<int>(entry_count * feature_maps_affected_count);
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(input,output,buffers)
+			{
+				int thread_id = 0;
+				#ifdef _OPENMP
+				thread_id = omp_get_thread_num();
+				#endif
+
+				float * buffer = buffers + thread_id * buffer_elem_count;
+
+				#pragma omp for schedule(guided)
+				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+				{
+					int entry_id = workload_id / feature_maps_affected_count;
+					int affected_feature_map_id = workload_id - (entry_id * feature_maps_affected_count);
+					unsigned int offset = entry_id * neuron_count + feature_maps_affected[affected_feature_map_id] * neuron_count_per_feature_map;
+
+					process_feature_map(input + offset, output + offset, buffer);
+				}
+			}
+
+			if (input != output)
+			{
+				for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+				{
+					for(std::vector<unsigned int>::const_iterator it = feature_maps_unaffected.begin(); it != feature_maps_unaffected.end(); ++it)
+					{
+						unsigned int offset = entry_id * neuron_count + *it * neuron_count_per_feature_map;
+						std::copy(input + offset, input + offset + neuron_count_per_feature_map, output + offset);
+					}
+				}
+			}
+		}
+
+		void local_contrast_subtractive_plain::backprop(
+			float * errors,
+			float * buffers,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			forward(errors, errors, buffers, entry_count, thread_count);
+		}
+	}
+}
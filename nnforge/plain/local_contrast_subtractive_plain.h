@@ -0,0 +1,82 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../layer_configuration_specific.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Subtracts separable symmetric blur from the feature maps affected, the input is mirrored at the borders.
+		// The first dimension is filtered row by row: interior elements in a loop vectorized across the row,
+		// elements closer to the border than the window radius in separate prologue and epilogue loops.
+		// Other dimensions are filtered by combining whole contiguous slices, so the inner loops vectorize too
+		class local_contrast_subtractive_plain
+		{
+		public:
+			local_contrast_subtractive_plain(
+				const std::vector<std::vector<float> >& window_weights_list,
+				const std::vector<unsigned int>& feature_maps_affected,
+				const layer_configuration_specific& input_configuration_specific);
+
+			// The size of the scratch buffer the caller should provide for each thread
+			unsigned int get_buffer_elem_count() const;
+
+			// output might be the same as input, unaffected feature maps are copied otherwise
+			// buffers should have get_buffer_elem_count() elements per thread
+			void forward(
+				const float * input,
+				float * output,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// The filter is symmetric, so the errors of affected feature maps are processed the same way as in forward, in place
+			void backprop(
+				float * errors,
+				float * buffers,
+				unsigned int entry_count,
+				int thread_count) const;
+
+		private:
+			void process_feature_map(
+				const float * input,
+				float * output,
+				float * buffer) const;
+
+			void filter_rows(
+				const float * input,
+				float * output) const;
+
+			void filter_slices(
+				unsigned int dimension_id,
+				const float * input,
+				float * output) const;
+
+			std::vector<std::vector<float> > window_weights_list;
+			std::vector<unsigned int> feature_maps_affected;
+			std::vector<unsigned int> feature_maps_unaffected;
+			std::vector<unsigned int> dimension_sizes;
+			std::vector<unsigned int> slices;
+			unsigned int feature_map_count;
+			unsigned int neuron_count_per_feature_map;
+		};
+	}
+}
@@ -0,0 +1,51 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// Math helpers shared by the kernel bodies, there is no include guard on purpose:
+// the file is included into the kernel bodies once per instruction set, each time within the namespace of the kernels.
+
+// exp with Cody-Waite range reduction and degree 6 polynomial, relative error is within 2 ulp
+inline float exp_approx(float x)
+{
+	// The upper clamp is the largest value for which n below rounds to 127 rather than 128, 2 ^ n would overflow to infinity otherwise
+	x = std::min(std::max(x, -87.33654F), 88.37625F);
+
+	// fx is within [-125, 128) after clamping, shifting it makes truncation equal to floor
+	float fx = x * 1.44269504088896341F + 0.5F;
+	int ni = static_cast<int>(fx + 128.0F) - 128;
+	float n = static_cast<float>(ni);
+
+	x -= n * 0.693359375F;
+	x -= n * -2.12194440E-4F;
+
+	float x2 = x * x;
+	float y = 1.9875691500E-4F;
+	y = y * x + 1.3981999507E-3F;
+	y = y * x + 8.3334519073E-3F;
+	y = y * x + 4.1665795894E-2F;
+	y = y * x + 1.6666665459E-1F;
+	y = y * x + 5.0000001201E-1F;
+	y = y * x2 + x + 1.0F;
+
+	union
+	{
+		int i;
+		float f;
+	} scale;
+	scale.i = (ni + 127) << 23;
+
+	return y * scale.f;
+}
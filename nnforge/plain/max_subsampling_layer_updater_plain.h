@@ -69,9 +69,6 @@ namespace nnforge
 				const layer_configuration_specific& output_configuration_specific,
 				plain_running_configuration_const_smart_ptr plain_config,
 				bool backprop_required) const;
-
-		private:
-			static const int max_dimension_count;
 		};
 	}
 }
@@ -56,9 +56,9 @@ namespace nnforge
 			if (offset_input_entry_id > 0)
 				throw neural_network_exception("maxout_layer_updater_plain is not able to run using offset");
 
-			const std::vector<float>::const_iterator in_it_global = input_buffer->begin();
-			const std::vector<float>::iterator out_it_global = output_buffer->begin();
-			const std::vector<float>::iterator max_feature_map_positions_it_global = additional_buffers[0]->begin();
+			const additional_buffer::const_iterator in_it_global = input_buffer->begin();
+			const additional_buffer::iterator out_it_global = output_buffer->begin();
+			const additional_buffer::iterator max_feature_map_positions_it_global = additional_buffers[0]->begin();
 
 			const unsigned int input_neuron_count = input_configuration_specific.get_neuron_count();
 			const unsigned int input_neuron_count_per_feature_map = input_configuration_specific.get_neuron_count_per_feature_map();
@@ -77,14 +77,14 @@ namespace nnforge
 					int entry_id = workload_id / output_feature_map_count;
 					int output_feature_map_id = workload_id - (entry_id * output_feature_map_count);
 
-					std::vector<float>::const_iterator in_it_base = in_it_global + (entry_id * input_neuron_count) + (output_feature_map_id * input_neuron_count_per_feature_map);
+					additional_buffer::const_iterator in_it_base = in_it_global + (entry_id * input_neuron_count) + (output_feature_map_id * input_neuron_count_per_feature_map);
 					int output_offset = (entry_id * output_neuron_count) + (output_feature_map_id * output_neuron_count_per_feature_map);
-					std::vector<float>::iterator out_it_base = out_it_global + output_offset;
-					std::vector<float>::iterator max_feature_map_positions_it = max_feature_map_positions_it_global + output_offset;
+					additional_buffer::iterator out_it_base = out_it_global + output_offset;
+					additional_buffer::iterator max_feature_map_positions_it = max_feature_map_positions_it_global + output_offset;
 
-					for(std::vector<float>::iterator out_it = out_it_base; out_it != out_it_base + output_neuron_count_per_feature_map; ++out_it, ++max_feature_map_positions_it, ++in_it_base)
+					for(additional_buffer::iterator out_it = out_it_base; out_it != out_it_base + output_neuron_count_per_feature_map; ++out_it, ++max_feature_map_positions_it, ++in_it_base)
 					{
-						std::vector<float>::const_iterator in_it = in_it_base;
+						additional_buffer::const_iterator in_it = in_it_base;
 						float current_max = *in_it;
 						int max_feature_map_pos = 0;
 						for(unsigned int i = 1; i < feature_map_subsampling_size; ++i)
@@ -119,9 +119,9 @@ namespace nnforge
 			unsigned int updater_count,
 			bool force_deterministic) const
 		{
-			const std::vector<float>::iterator in_err_it_global = input_errors->begin();
-			const std::vector<float>::const_iterator out_err_it_global = output_errors->begin();
-			const std::vector<float>::const_iterator max_feature_map_positions_it_global = additional_buffers[0]->begin();
+			const additional_buffer::iterator in_err_it_global = input_errors->begin();
+			const additional_buffer::const_iterator out_err_it_global = output_errors->begin();
+			const additional_buffer::const_iterator max_feature_map_positions_it_global = additional_buffers[0]->begin();
 
 			const unsigned int input_neuron_count = input_configuration_specific.get_neuron_count();
 			const unsigned int input_neuron_count_per_feature_map = input_configuration_specific.get_neuron_count_per_feature_map();
@@ -140,14 +140,14 @@ namespace nnforge
 					int entry_id = workload_id / output_feature_map_count;
 					int output_feature_map_id = workload_id - (entry_id * output_feature_map_count);
 
-					std::vector<float>::iterator in_err_it_base = in_err_it_global + (entry_id * input_neuron_count) + (output_feature_map_id * input_neuron_count_per_feature_map);
+					additional_buffer::iterator in_err_it_base = in_err_it_global + (entry_id * input_neuron_count) + (output_feature_map_id * input_neuron_count_per_feature_map);
 					int output_offset = (entry_id * output_neuron_count) + (output_feature_map_id * output_neuron_count_per_feature_map);
-					std::vector<float>::const_iterator out_err_it_base = out_err_it_global + output_offset;
-					std::vector<float>::const_iterator max_feature_map_positions_it = max_feature_map_positions_it_global + output_offset;
+					additional_buffer::const_iterator out_err_it_base = out_err_it_global + output_offset;
+					additional_buffer::const_iterator max_feature_map_positions_it = max_feature_map_positions_it_global + output_offset;
 
-					for(std::vector<float>::const_iterator out_err_it = out_err_it_base; out_err_it != out_err_it_base + output_neuron_count_per_feature_map; ++out_err_it, ++max_feature_map_positions_it, ++in_err_it_base)
+					for(additional_buffer::const_iterator out_err_it = out_err_it_base; out_err_it != out_err_it_base + output_neuron_count_per_feature_map; ++out_err_it, ++max_feature_map_positions_it, ++in_err_it_base)
 					{
-						std::vector<float>::iterator in_err_it = in_err_it_base;
+						additional_buffer::iterator in_err_it = in_err_it_base;
 						float current_err = *out_err_it;
 						unsigned int max_feature_map_position = *((const unsigned int *)(&(*max_feature_map_positions_it)));
 						for(unsigned int i = 0; i < feature_map_subsampling_size; ++i)
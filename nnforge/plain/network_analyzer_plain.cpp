@@ -42,14 +42,25 @@ namespace nnforge
 		}
 
 		void network_analyzer_plain::layer_config_list_modified()
+		{
+			// The first pass only sizes the arena
+			buffer_arena_plain arena(plain_config->huge_pages);
+			create_buffers(arena);
+			arena.allocate();
+			create_buffers(arena);
+
+			update_data_derived_buffers();
+		}
+
+		void network_analyzer_plain::create_buffers(buffer_arena_plain& arena)
 		{
 			input_buffer_and_additional_updater_buffers_pack.clear();
 			output_errors_buffers.clear();
 
 			const unsigned int input_neuron_count = layer_config_list.front().get_neuron_count();
 			const unsigned int output_neuron_count = layer_config_list.back().get_neuron_count();
-			input_converted_buf = additional_buffer_smart_ptr(new std::vector<float>(input_neuron_count));
-			initial_error_buf = additional_buffer_smart_ptr(new std::vector<float>(output_neuron_count));
+			input_converted_buf = arena.create_buffer(input_neuron_count);
+			initial_error_buf = arena.create_buffer(output_neuron_count);
 
 			additional_buffer_smart_ptr output_buffer = input_converted_buf;
 
@@ -60,6 +71,7 @@ namespace nnforge
 			{
 				updater_additional_buffer_set additional_buffers = (*it)->allocate_additional_buffers(
 					1,
+					arena,
 					*layer_it,
 					*input_config_it,
 					*(input_config_it + 1),
@@ -85,6 +97,30 @@ namespace nnforge
 		void network_analyzer_plain::actual_set_data(network_data_smart_ptr data)
 		{
 			this->data = data;
+
+			update_data_derived_buffers();
+		}
+
+		void network_analyzer_plain::update_data_derived_buffers()
+		{
+			if (!data || input_buffer_and_additional_updater_buffers_pack.empty())
+				return;
+
+			const const_layer_list& layer_list = *schema;
+			const_layer_list::const_iterator layer_it = layer_list.begin();
+			layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin();
+			layer_data_list::const_iterator data_it = data->data_list.begin();
+			std::vector<std::pair<additional_buffer_smart_ptr, updater_additional_buffer_set> >::iterator updater_buffers_it = input_buffer_and_additional_updater_buffers_pack.begin();
+			for(std::vector<const_layer_updater_plain_smart_ptr>::const_iterator it = updater_list.begin(); it != updater_list.end(); ++it, ++layer_it, ++input_config_it, ++data_it, ++updater_buffers_it)
+			{
+				(*it)->update_data_derived_buffers(
+					updater_buffers_it->second.additional_buffers,
+					plain_config,
+					*layer_it,
+					*data_it,
+					*input_config_it,
+					*(input_config_it + 1));
+			}
 		}
 
 		void network_analyzer_plain::actual_set_input_data(
@@ -94,7 +130,7 @@ namespace nnforge
 			const unsigned int input_neuron_count = layer_config_list[0].get_neuron_count();
 
 			const int elem_count = static_cast<int>(input_neuron_count);
-			const std::vector<float>::iterator input_converted_buf_it_start = input_converted_buf->begin();
+			const additional_buffer::iterator input_converted_buf_it_start = input_converted_buf->begin();
 			if (type_code == neuron_data_type::type_byte)
 			{
 				const unsigned char * const input_buf_it_start = static_cast<const unsigned char *>(input);
@@ -60,6 +60,12 @@ namespace nnforge
 			network_analyzer_plain(const network_analyzer_plain&);
 			network_analyzer_plain& operator =(const network_analyzer_plain&);
 
+			// Creates the buffers in arena, see buffer_arena_plain for the 2 passes
+			void create_buffers(buffer_arena_plain& arena);
+
+			// Lets the updaters refresh the data they derive from the weights, once both data and buffers are set
+			void update_data_derived_buffers();
+
 			plain_running_configuration_const_smart_ptr plain_config;
 
 			const_layer_updater_plain_list updater_list;
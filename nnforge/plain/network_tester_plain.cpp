@@ -17,11 +17,15 @@
 #include "network_tester_plain.h"
 
 #include "layer_tester_plain_factory.h"
+#include "data_reader_prefetcher_plain.h"
+#include "blocked_layout_plain.h"
+#include "half_float_plain.h"
 #include "../neural_network_exception.h"
 #include "../debug_util.h"
 
 #include <boost/format.hpp>
 #include <boost/filesystem.hpp>
+#include <algorithm>
 
 namespace nnforge
 {
@@ -32,10 +36,24 @@ namespace nnforge
 			plain_running_configuration_const_smart_ptr plain_config)
 			: network_tester(schema)
 			, plain_config(plain_config)
+			, buffers_max_entry_count(0)
 		{
 			const const_layer_list& layer_list = *schema;
 			for(const_layer_list::const_iterator it = layer_list.begin(); it != layer_list.end(); ++it)
 				tester_list.push_back(plain::single_layer_tester_plain_factory::get_const_instance().get_tester_plain_layer((*it)->get_uuid()));
+
+			for(const_layer_list::const_iterator it = layer_list.begin(); it != layer_list.end(); ++it)
+			{
+				unsigned int fused_layer_count = convolution_fused_tester_plain::get_fused_layer_count(it, layer_list.end());
+				if (fused_layer_count > 0)
+				{
+					fused_tester_list.push_back(const_convolution_fused_tester_plain_smart_ptr(new convolution_fused_tester_plain(it, fused_layer_count)));
+					for(unsigned int i = 0; i < fused_layer_count; ++i, ++it)
+						fused_tester_list.push_back(const_convolution_fused_tester_plain_smart_ptr());
+				}
+				else
+					fused_tester_list.push_back(const_convolution_fused_tester_plain_smart_ptr());
+			}
 		}
 
 		network_tester_plain::~network_tester_plain()
@@ -60,66 +78,37 @@ namespace nnforge
 
 			buffer_plain_size_configuration buffers_config;
 			update_buffers_configuration_testing(buffers_config);
-			buffers_config.add_per_entry_buffer(input_neuron_count * input_neuron_elem_size); // input
-			buffers_config.add_per_entry_buffer(input_neuron_count * sizeof(float)); // converted input
+			buffers_config.add_per_entry_buffer(input_neuron_count * input_neuron_elem_size * (plain_config->prefetch_queue_depth + 1)); // input, the chunk processed and the ones read ahead
 
 			const unsigned int max_entry_count = std::min<unsigned int>(plain_config->get_max_entry_count(buffers_config), reader.get_entry_count());
 
-			std::vector<unsigned char> input_buf(input_neuron_count * max_entry_count * input_neuron_elem_size);
-			additional_buffer_smart_ptr input_converted_buf(new std::vector<float>(input_neuron_count * max_entry_count));
+			update_buffers(max_entry_count);
 
-			additional_buffer_smart_ptr output_buffer = input_converted_buf;
-			std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> > input_buffer_and_additional_buffers_pack;
-			{
-				const const_layer_list& layer_list = *schema;
-				const_layer_list::const_iterator layer_it = layer_list.begin();
-				layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin();
-				for(std::vector<const_layer_tester_plain_smart_ptr>::const_iterator it = tester_list.begin(); it != tester_list.end(); ++it, ++layer_it, ++input_config_it)
-				{
-					additional_buffer_set additional_buffers = (*it)->allocate_additional_buffers(
-						max_entry_count,
-						*layer_it,
-						*input_config_it,
-						*(input_config_it + 1),
-						plain_config);
-					input_buffer_and_additional_buffers_pack.push_back(std::make_pair(output_buffer, additional_buffers));
-					output_buffer = (*it)->get_output_buffer(output_buffer, additional_buffers);
-				}
-			}
+			data_reader_prefetcher_plain prefetcher(reader, std::vector<unsigned int>(1, max_entry_count), plain_config->prefetch_queue_depth);
 
-			bool entries_remained_for_loading = true;
 			unsigned int entries_copied_count = 0;
-			while (entries_remained_for_loading)
+			while (true)
 			{
-				unsigned int entries_available_for_processing_count = 0;
-				while(entries_available_for_processing_count < max_entry_count)
-				{
-					bool entry_read = reader.read(&(*(input_buf.begin() + (input_neuron_count * entries_available_for_processing_count * input_neuron_elem_size))));
-					if (!entry_read)
-					{
-						entries_remained_for_loading = false;
-						break;
-					}
-					entries_available_for_processing_count++;
-				}
-
+				const unsigned char * input_chunk;
+				const float * output_chunk;
+				const unsigned int entries_available_for_processing_count = prefetcher.get_next_chunk(input_chunk, output_chunk);
 				if (entries_available_for_processing_count == 0)
 					break;
 
 				// Convert input
 				{
 					const int elem_count = static_cast<int>(entries_available_for_processing_count * input_neuron_count);
-					const std::vector<float>::iterator input_converted_buf_it_start = input_converted_buf->begin();
+					const additional_buffer::iterator input_converted_buf_it_start = input_converted_buf->begin();
 					if (type_code == neuron_data_type::type_byte)
 					{
-						const unsigned char * const input_buf_it_start = &(*input_buf.begin());
+						const unsigned char * const input_buf_it_start = input_chunk;
 						#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
 						for(int i = 0; i < elem_count; ++i)
 							*(input_converted_buf_it_start + i) = static_cast<float>(*(input_buf_it_start + i)) * (1.0F / 255.0F);
 					}
 					else if (type_code == neuron_data_type::type_float)
 					{
-						const float * const input_buf_it_start = reinterpret_cast<float *>(&(*input_buf.begin()));
+						const float * const input_buf_it_start = reinterpret_cast<const float *>(input_chunk);
 						#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
 						for(int i = 0; i < elem_count; ++i)
 							*(input_converted_buf_it_start + i) = *(input_buf_it_start + i);
@@ -129,38 +118,11 @@ namespace nnforge
 
 				// Run ann
 				{
-					const const_layer_list& layer_list = *schema;
-					const_layer_list::const_iterator layer_it = layer_list.begin();
-					layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin();
-					std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> >::iterator buffers_it = input_buffer_and_additional_buffers_pack.begin();
-					layer_data_list::const_iterator data_it = net_data->data_list.begin();
-					layer_data_custom_list::const_iterator data_custom_it = net_data->data_custom_list.begin();
-					unsigned int layer_id = 0;
-					for(std::vector<const_layer_tester_plain_smart_ptr>::const_iterator it = tester_list.begin(); it != tester_list.end(); ++it, ++layer_it, ++input_config_it, ++buffers_it, ++data_it, ++data_custom_it, ++layer_id)
-					{
-						/*
-						{
-							boost::filesystem::path dir = "Debug";
-							dir /= "CPU";
-							boost::filesystem::create_directories(dir);
-							debug_util::dump_list(
-								&(*buffers_it->first->begin()),
-								buffers_it->first->size(),
-								(dir / (boost::format("input_neurons_%1%.txt") % layer_id).str()).string().c_str());
-						}
-						*/
-
-						(*it)->test(
-							buffers_it->first,
-							buffers_it->second,
-							plain_config,
-							*layer_it,
-							*data_it,
-							*data_custom_it,
-							*input_config_it,
-							*(input_config_it + 1),
-							entries_available_for_processing_count);
-					}
+					run_testers(
+						input_buffer_and_additional_buffers_pack,
+						output_buffer,
+						blocked_buffers,
+						entries_available_for_processing_count);
 
 					/*
 					{
@@ -181,7 +143,7 @@ namespace nnforge
 					for(unsigned int i = 0; i < entries_available_for_processing_count; ++i)
 					{
 						std::vector<float>& dst = predicted_output_neuron_value_set->neuron_value_list[(i + entries_copied_count) / sample_count];
-						std::vector<float>::const_iterator src_it = output_buffer->begin() + (i * output_neuron_count);
+						additional_buffer::const_iterator src_it = output_buffer->begin() + (i * output_neuron_count);
 						for(unsigned int j = 0; j < output_neuron_count; ++j)
 							dst[j] += mult * *(src_it + j);
 					}
@@ -196,11 +158,22 @@ namespace nnforge
 		void network_tester_plain::actual_set_data(network_data_smart_ptr data)
 		{
 			net_data = data;
+			input_max_abs_value_list.clear();
+
+			update_data();
 		}
 
 		void network_tester_plain::actual_clear_data()
 		{
 			net_data.reset();
+			tester_data_list.clear();
+			tester_data_custom_list.clear();
+			blocked_run_layer_count_list.clear();
+			tester_blocked_data_list.clear();
+			input_max_abs_value_list.clear();
+			tester_quantized_data_list.clear();
+			tester_half_data_list.clear();
+			release_buffers();
 		}
 
 		std::vector<layer_configuration_specific_snapshot_smart_ptr> network_tester_plain::actual_get_snapshot(
@@ -213,37 +186,21 @@ namespace nnforge
 			const unsigned int input_feature_map_count = layer_config_list[0].feature_map_count;
 			const unsigned int neuron_count_per_input_feature_map = layer_config_list[0].get_neuron_count_per_feature_map();
 
-			additional_buffer_smart_ptr input_converted_buf(new std::vector<float>(input_neuron_count));
+			update_buffers(1);
 
-			additional_buffer_smart_ptr output_buffer = input_converted_buf;
-			std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> > input_buffer_and_additional_buffers_pack;
+			// Layers share the buffers, so the output of each layer is copied right after the layer is run
 			std::vector<additional_buffer_smart_ptr> output_buffer_list;
-			{
-				const const_layer_list& layer_list = *schema;
-				const_layer_list::const_iterator layer_it = layer_list.begin();
-				layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin();
-				for(std::vector<const_layer_tester_plain_smart_ptr>::const_iterator it = tester_list.begin(); it != tester_list.end(); ++it)
-				{
-					additional_buffer_set additional_buffers = (*it)->allocate_additional_buffers(
-						1,
-						*layer_it,
-						*input_config_it,
-						*(input_config_it + 1),
-						plain_config);
-					input_buffer_and_additional_buffers_pack.push_back(std::make_pair(output_buffer, additional_buffers));
-					output_buffer = (*it)->get_output_buffer(output_buffer, additional_buffers);
-					output_buffer_list.push_back(output_buffer);
-					++layer_it;
-					++input_config_it;
-				}
-			}
+			for(unsigned int layer_id = 0; layer_id < tester_list.size(); ++layer_id)
+				output_buffer_list.push_back(tester_list[layer_id]->get_output_buffer(
+					input_buffer_and_additional_buffers_pack[layer_id].first,
+					input_buffer_and_additional_buffers_pack[layer_id].second));
 
 			// Convert input
 			{
 				layer_configuration_specific_snapshot_smart_ptr input_elem(new layer_configuration_specific_snapshot(layer_config_list[0]));
 				res.push_back(input_elem);
 				const int elem_count = static_cast<int>(input_neuron_count);
-				const std::vector<float>::iterator input_converted_buf_it_start = input_converted_buf->begin();
+				const additional_buffer::iterator input_converted_buf_it_start = input_converted_buf->begin();
 				const std::vector<float>::iterator input_elem_it_start = input_elem->data.begin();
 				if (type_code == neuron_data_type::type_byte)
 				{
@@ -274,30 +231,34 @@ namespace nnforge
 
 			// Run ann
 			{
-				const const_layer_list& layer_list = *schema;
-				const_layer_list::const_iterator layer_it = layer_list.begin();
 				layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin();
 				std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> >::iterator buffers_it = input_buffer_and_additional_buffers_pack.begin();
-				layer_data_list::const_iterator data_it = net_data->data_list.begin();
-				layer_data_custom_list::const_iterator data_custom_it = net_data->data_custom_list.begin();
 				std::vector<additional_buffer_smart_ptr>::iterator output_it = output_buffer_list.begin();
-				for(std::vector<const_layer_tester_plain_smart_ptr>::const_iterator it = tester_list.begin(); it != tester_list.end(); ++it, ++layer_it, ++input_config_it, ++buffers_it, ++output_it, ++data_it, ++data_custom_it)
+				for(std::vector<const_layer_tester_plain_smart_ptr>::const_iterator it = tester_list.begin(); it != tester_list.end(); ++it, ++input_config_it, ++buffers_it, ++output_it)
 				{
-					(*it)->test(
+					const unsigned int layer_id = static_cast<unsigned int>(it - tester_list.begin());
+					if (!half_activation_list.empty())
+					{
+						run_layers_with_half_activations(input_buffer_and_additional_buffers_pack, output_buffer, blocked_buffers, layer_id, 1, 1, 1);
+
+						layer_configuration_specific_snapshot_smart_ptr new_elem(new layer_configuration_specific_snapshot(*(input_config_it + 1)));
+						res.push_back(new_elem);
+
+						const additional_buffer& layer_output_buffer = (layer_id + 1 < input_buffer_and_additional_buffers_pack.size()) ? *input_buffer_and_additional_buffers_pack[layer_id + 1].first : *output_buffer;
+						load_activations(layer_output_buffer, half_activation_list[layer_id + 1], 0, &(*new_elem->data.begin()), static_cast<unsigned int>(new_elem->data.size()));
+						continue;
+					}
+
+					run_layer(
+						layer_id,
 						buffers_it->first,
 						buffers_it->second,
-						plain_config,
-						*layer_it,
-						*data_it,
-						*data_custom_it,
-						*input_config_it,
-						*(input_config_it + 1),
 						1);
 
 					layer_configuration_specific_snapshot_smart_ptr new_elem(new layer_configuration_specific_snapshot(*(input_config_it + 1)));
 					res.push_back(new_elem);
 
-					std::copy((*output_it)->begin(), (*output_it)->end(), new_elem->data.begin());
+					std::copy((*output_it)->begin(), (*output_it)->begin() + new_elem->data.size(), new_elem->data.begin());
 				}
 			}
 
@@ -314,33 +275,12 @@ namespace nnforge
 			const unsigned int input_feature_map_count = layer_config_list[0].feature_map_count;
 			const unsigned int neuron_count_per_input_feature_map = layer_config_list[0].get_neuron_count_per_feature_map();
 
-			additional_buffer_smart_ptr input_converted_buf(new std::vector<float>(input_neuron_count));
-
-			additional_buffer_smart_ptr output_buffer = input_converted_buf;
-			std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> > input_buffer_and_additional_buffers_pack;
-			{
-				const const_layer_list& layer_list = *schema;
-				const_layer_list::const_iterator layer_it = layer_list.begin();
-				layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin();
-				for(std::vector<const_layer_tester_plain_smart_ptr>::const_iterator it = tester_list.begin(); it != tester_list.end(); ++it)
-				{
-					additional_buffer_set additional_buffers = (*it)->allocate_additional_buffers(
-						1,
-						*layer_it,
-						*input_config_it,
-						*(input_config_it + 1),
-						plain_config);
-					input_buffer_and_additional_buffers_pack.push_back(std::make_pair(output_buffer, additional_buffers));
-					output_buffer = (*it)->get_output_buffer(output_buffer, additional_buffers);
-					++layer_it;
-					++input_config_it;
-				}
-			}
+			update_buffers(1);
 
 			// Convert input
 			{
 				const int elem_count = static_cast<int>(input_neuron_count);
-				const std::vector<float>::iterator input_converted_buf_it_start = input_converted_buf->begin();
+				const additional_buffer::iterator input_converted_buf_it_start = input_converted_buf->begin();
 				if (type_code == neuron_data_type::type_byte)
 				{
 					const unsigned char * const input_buf_it_start = static_cast<const unsigned char *>(input);
@@ -360,45 +300,763 @@ namespace nnforge
 			}
 
 			// Run ann
+			run_testers(
+				input_buffer_and_additional_buffers_pack,
+				output_buffer,
+				blocked_buffers,
+				1);
+
+			std::copy(output_buffer->begin(), output_buffer->begin() + res->data.size(), res->data.begin());
+
+			return res;
+		}
+
+		void network_tester_plain::layer_config_list_modified()
+		{
+			update_data();
+		}
+
+		void network_tester_plain::actual_calibrate(
+			unsupervised_data_reader& reader,
+			unsigned int max_entry_count)
+		{
+			if (!net_data)
+				throw neural_network_exception("calibrate called before set_data");
+
+			// The ranges are collected with the fp32 data of all the layers, the network might be quantized already
+			input_max_abs_value_list.clear();
+			update_data();
+
+			reader.reset();
+
+			const unsigned int input_neuron_count = reader.get_input_configuration().get_neuron_count();
+			neuron_data_type::input_type type_code = reader.get_input_type();
+			size_t input_neuron_elem_size = reader.get_input_neuron_elem_size();
+
+			buffer_plain_size_configuration buffers_config;
+			update_buffers_configuration_testing(buffers_config);
+			buffers_config.add_per_entry_buffer(input_neuron_count * input_neuron_elem_size); // input
+
+			const unsigned int max_entry_count_in_chunk = std::min<unsigned int>(std::min<unsigned int>(plain_config->get_max_entry_count(buffers_config), reader.get_entry_count()), max_entry_count);
+
+			if (input_buf.size() < input_neuron_count * max_entry_count_in_chunk * input_neuron_elem_size)
+				input_buf.resize(input_neuron_count * max_entry_count_in_chunk * input_neuron_elem_size);
+
+			// The layers are run one by one here, the activations planned for run_testers stay valid as fused chains only extend the lifetimes
+			update_buffers(max_entry_count_in_chunk);
+
+			std::vector<float> max_abs_value_list(tester_list.size(), 0.0F);
+			unsigned int entries_processed_count = 0;
+			while (entries_processed_count < max_entry_count)
 			{
-				const const_layer_list& layer_list = *schema;
-				const_layer_list::const_iterator layer_it = layer_list.begin();
-				layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin();
-				std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> >::iterator buffers_it = input_buffer_and_additional_buffers_pack.begin();
-				layer_data_list::const_iterator data_it = net_data->data_list.begin();
-				layer_data_custom_list::const_iterator data_custom_it = net_data->data_custom_list.begin();
-				for(std::vector<const_layer_tester_plain_smart_ptr>::const_iterator it = tester_list.begin(); it != tester_list.end(); ++it, ++layer_it, ++input_config_it, ++buffers_it, ++data_it, ++data_custom_it)
+				const unsigned int entries_available_for_processing_count = reader.read_batch(
+					std::min(max_entry_count_in_chunk, max_entry_count - entries_processed_count),
+					&(*input_buf.begin()));
+
+				if (entries_available_for_processing_count == 0)
+					break;
+
+				// Convert input
 				{
-					(*it)->test(
-						buffers_it->first,
-						buffers_it->second,
-						plain_config,
-						*layer_it,
-						*data_it,
-						*data_custom_it,
-						*input_config_it,
-						*(input_config_it + 1),
-						1);
+					const unsigned int elem_count = entries_available_for_processing_count * input_neuron_count;
+					if (type_code == neuron_data_type::type_byte)
+					{
+						for(unsigned int i = 0; i < elem_count; ++i)
+							(*input_converted_buf)[i] = static_cast<float>(input_buf[i]) * (1.0F / 255.0F);
+					}
+					else if (type_code == neuron_data_type::type_float)
+					{
+						const float * const input_buf_it_start = reinterpret_cast<float *>(&(*input_buf.begin()));
+						std::copy(input_buf_it_start, input_buf_it_start + elem_count, input_converted_buf->begin());
+					}
+					else throw neural_network_exception((boost::format("actual_calibrate cannot handle input neurons of type %1%") % type_code).str());
 				}
+
+				// Run the layers one by one in fp32, the input of every layer should be available
+				for(unsigned int layer_id = 0; layer_id < tester_list.size(); ++layer_id)
+				{
+					const unsigned int elem_count = entries_available_for_processing_count * layer_config_list[layer_id].get_neuron_count();
+					const float * input_neurons = &(*input_buffer_and_additional_buffers_pack[layer_id].first->begin());
+					std::vector<float> input_neurons_converted;
+					if (!half_activation_list.empty() && half_activation_list[layer_id])
+					{
+						input_neurons_converted.resize(elem_count);
+						load_activations(*input_buffer_and_additional_buffers_pack[layer_id].first, true, 0, &(*input_neurons_converted.begin()), elem_count);
+						input_neurons = &(*input_neurons_converted.begin());
+					}
+
+					float max_abs_value = max_abs_value_list[layer_id];
+					for(unsigned int i = 0; i < elem_count; ++i)
+						max_abs_value = std::max(max_abs_value, std::max(input_neurons[i], -input_neurons[i]));
+					max_abs_value_list[layer_id] = max_abs_value;
+
+					if (!half_activation_list.empty())
+						run_layers_with_half_activations(input_buffer_and_additional_buffers_pack, output_buffer, blocked_buffers, layer_id, 1, 1, entries_available_for_processing_count);
+					else
+						run_layer(
+							layer_id,
+							input_buffer_and_additional_buffers_pack[layer_id].first,
+							input_buffer_and_additional_buffers_pack[layer_id].second,
+							entries_available_for_processing_count);
+				}
+
+				entries_processed_count += entries_available_for_processing_count;
+			}
+
+			reader.reset();
+
+			input_max_abs_value_list = max_abs_value_list;
+			update_data();
+		}
+
+		void network_tester_plain::update_data()
+		{
+			tester_data_list.clear();
+			tester_data_custom_list.clear();
+			blocked_run_layer_count_list.clear();
+			tester_blocked_data_list.clear();
+			tester_quantized_data_list.clear();
+			tester_half_data_list.clear();
+			release_buffers();
+
+			if (!net_data || layer_config_list.empty())
+				return;
+
+			const const_layer_list& layer_list = *schema;
+			const_layer_list::const_iterator layer_it = layer_list.begin();
+			layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin();
+			layer_data_list::const_iterator data_it = net_data->data_list.begin();
+			layer_data_custom_list::const_iterator data_custom_it = net_data->data_custom_list.begin();
+			for(std::vector<const_layer_tester_plain_smart_ptr>::const_iterator it = tester_list.begin(); it != tester_list.end(); ++it, ++layer_it, ++input_config_it, ++data_it, ++data_custom_it)
+			{
+				tester_data_list.push_back((*it)->get_data(
+					*data_it,
+					*layer_it,
+					*input_config_it,
+					*(input_config_it + 1),
+					plain_config));
+				tester_data_custom_list.push_back((*it)->get_data_custom(
+					*data_custom_it,
+					*layer_it,
+					*input_config_it,
+					*(input_config_it + 1),
+					plain_config));
 			}
 
-			std::copy(output_buffer->begin(), output_buffer->end(), res->data.begin());
+			if (!input_max_abs_value_list.empty())
+				update_quantized_data();
+
+			if (plain_config->weight_storage != plain_running_configuration::weight_storage_fp32)
+				update_half_precision_data();
+
+			if (plain_config->blocked_layout)
+				update_blocked_runs();
+		}
+
+		void network_tester_plain::update_quantized_data()
+		{
+			const const_layer_list& layer_list = *schema;
+			const unsigned int layer_count = static_cast<unsigned int>(tester_list.size());
+
+			tester_quantized_data_list.resize(layer_count);
+			for(unsigned int layer_id = 0; layer_id < layer_count; ++layer_id)
+			{
+				// Layers with all-zero input in the calibration sample stay in fp32
+				const float input_max_abs_value = input_max_abs_value_list[layer_id];
+				if ((input_max_abs_value <= 0.0F) || !tester_list[layer_id]->is_quantization_supported(layer_list[layer_id], layer_config_list[layer_id], layer_config_list[layer_id + 1]))
+					continue;
+
+				tester_quantized_data_list[layer_id] = tester_list[layer_id]->get_quantized_data(
+					net_data->data_list[layer_id],
+					input_max_abs_value * (1.0F / 127.0F),
+					layer_list[layer_id],
+					layer_config_list[layer_id],
+					layer_config_list[layer_id + 1]);
+
+				// The fp32 data is not used by the tester anymore, it stays in net_data only
+				tester_data_list[layer_id] = layer_data_smart_ptr(new layer_data());
+			}
+		}
+
+		void network_tester_plain::update_half_precision_data()
+		{
+			const const_layer_list& layer_list = *schema;
+			const unsigned int layer_count = static_cast<unsigned int>(tester_list.size());
+			const half_float_plain::format weight_format = (plain_config->weight_storage == plain_running_configuration::weight_storage_bf16) ? half_float_plain::format_bf16 : half_float_plain::format_fp16;
+
+			tester_half_data_list.resize(layer_count);
+			for(unsigned int layer_id = 0; layer_id < layer_count; ++layer_id)
+			{
+				// Quantized layers have their weights in 8 bits already
+				if (!tester_quantized_data_list.empty() && tester_quantized_data_list[layer_id])
+					continue;
+
+				if (!tester_list[layer_id]->is_half_precision_supported(layer_list[layer_id], layer_config_list[layer_id], layer_config_list[layer_id + 1]))
+					continue;
+
+				tester_half_data_list[layer_id] = tester_list[layer_id]->get_half_precision_data(
+					net_data->data_list[layer_id],
+					weight_format,
+					layer_list[layer_id],
+					layer_config_list[layer_id],
+					layer_config_list[layer_id + 1]);
+
+				// The fp32 data is not used by the tester anymore, it stays in net_data only
+				tester_data_list[layer_id] = layer_data_smart_ptr(new layer_data());
+			}
+		}
+
+		void network_tester_plain::update_blocked_runs()
+		{
+			const const_layer_list& layer_list = *schema;
+			const unsigned int layer_count = static_cast<unsigned int>(tester_list.size());
+
+			std::vector<layer_tester_plain::blocked_layout_support> support_list;
+			for(unsigned int layer_id = 0; layer_id < layer_count; ++layer_id)
+			{
+				// Quantized layers and layers with 16-bit weights run in the planar layout
+				if ((!tester_quantized_data_list.empty() && tester_quantized_data_list[layer_id]) || (!tester_half_data_list.empty() && tester_half_data_list[layer_id]))
+					support_list.push_back(layer_tester_plain::blocked_layout_unsupported);
+				else
+					support_list.push_back(tester_list[layer_id]->get_blocked_layout_support(
+						layer_list[layer_id],
+						layer_config_list[layer_id],
+						layer_config_list[layer_id + 1]));
+			}
+
+			blocked_run_layer_count_list.resize(layer_count, 0);
+			tester_blocked_data_list.resize(layer_count);
+			unsigned int layer_id = 0;
+			while (layer_id < layer_count)
+			{
+				if (support_list[layer_id] != layer_tester_plain::blocked_layout_native)
+				{
+					++layer_id;
+					continue;
+				}
+
+				// Extend the run over supporting layers, then drop the trailing transparent ones: they gain nothing from the layout
+				unsigned int end_layer_id = layer_id + 1;
+				unsigned int last_native_layer_id = layer_id;
+				while ((end_layer_id < layer_count) && (support_list[end_layer_id] != layer_tester_plain::blocked_layout_unsupported))
+				{
+					if (support_list[end_layer_id] == layer_tester_plain::blocked_layout_native)
+						last_native_layer_id = end_layer_id;
+					++end_layer_id;
+				}
+
+				blocked_run_layer_count_list[layer_id] = last_native_layer_id - layer_id + 1;
+				for(unsigned int i = layer_id; i <= last_native_layer_id; ++i)
+					tester_blocked_data_list[i] = tester_list[i]->get_blocked_data(
+						net_data->data_list[i],
+						layer_list[i],
+						layer_config_list[i],
+						layer_config_list[i + 1],
+						plain_config);
+
+				layer_id = last_native_layer_id + 1;
+			}
+		}
+
+		unsigned int network_tester_plain::get_blocked_buffer_elem_count() const
+		{
+			unsigned int res = 0;
+			for(unsigned int layer_id = 0; layer_id < blocked_run_layer_count_list.size(); ++layer_id)
+			{
+				const unsigned int run_layer_count = blocked_run_layer_count_list[layer_id];
+				for(unsigned int i = layer_id; i < layer_id + run_layer_count + ((run_layer_count > 0) ? 1 : 0); ++i)
+					res = std::max(res, blocked_layout_plain::get_neuron_count(layer_config_list[i]));
+			}
 
 			return res;
 		}
 
-		void network_tester_plain::layer_config_list_modified()
+		additional_buffer_set network_tester_plain::allocate_blocked_buffers(
+			buffer_arena_plain& arena,
+			unsigned int max_entry_count) const
+		{
+			additional_buffer_set res;
+
+			const unsigned int elem_count = get_blocked_buffer_elem_count();
+			if (elem_count > 0)
+			{
+				res.push_back(arena.create_buffer(elem_count * max_entry_count));
+				res.push_back(arena.create_buffer(elem_count * max_entry_count));
+			}
+
+			return res;
+		}
+
+		unsigned int network_tester_plain::get_run_layer_count(unsigned int layer_id) const
+		{
+			// Quantized layers and layers with 16-bit weights are run alone
+			if ((!tester_quantized_data_list.empty() && tester_quantized_data_list[layer_id]) || (!tester_half_data_list.empty() && tester_half_data_list[layer_id]))
+				return 1;
+
+			if (!blocked_run_layer_count_list.empty() && (blocked_run_layer_count_list[layer_id] > 0))
+				return blocked_run_layer_count_list[layer_id];
+
+			if (fused_tester_list[layer_id])
+				return fused_tester_list[layer_id]->get_fused_layer_count() + 1;
+
+			return 1;
+		}
+
+		std::vector<unsigned int> network_tester_plain::get_layer_step_list() const
+		{
+			std::vector<unsigned int> res;
+
+			unsigned int layer_id = 0;
+			unsigned int step = 0;
+			while (layer_id < tester_list.size())
+			{
+				const unsigned int run_layer_count = get_run_layer_count(layer_id);
+				if (!blocked_run_layer_count_list.empty() && (blocked_run_layer_count_list[layer_id] == run_layer_count))
+				{
+					// The layers of a blocked run work on the blocked buffers, the planar ones are only read at the start of the run and written at its end
+					for(unsigned int i = 0; i < run_layer_count; ++i)
+						res.push_back(step++);
+				}
+				else
+				{
+					// The layers of a fused chain run interleaved
+					res.insert(res.end(), run_layer_count, step);
+					++step;
+				}
+				layer_id += run_layer_count;
+			}
+
+			return res;
+		}
+
+		activation_memory_planner_plain network_tester_plain::plan_activations(std::vector<unsigned int>& activation_id_list) const
+		{
+			activation_memory_planner_plain res;
+			activation_id_list.clear();
+
+			const std::vector<unsigned int> layer_step_list = get_layer_step_list();
+
+			// The network input and output are fp32 in any case, the output is written by the last out-of-place layer
+			const unsigned int fp32_elem_size = static_cast<unsigned int>(sizeof(float) / get_activation_elem_size());
+			unsigned int network_output_layer_id = static_cast<unsigned int>(tester_list.size());
+			for(unsigned int layer_id = 0; layer_id < tester_list.size(); ++layer_id)
+				if (!tester_list[layer_id]->is_in_place())
+					network_output_layer_id = layer_id;
+
+			unsigned int activation_id = res.add_buffer(layer_config_list[0].get_neuron_count() * fp32_elem_size, 0);
+			for(unsigned int layer_id = 0; layer_id < tester_list.size(); ++layer_id)
+			{
+				activation_id_list.push_back(activation_id);
+				res.use_buffer(activation_id, layer_step_list[layer_id]);
+				if (!tester_list[layer_id]->is_in_place())
+					activation_id = res.add_buffer(layer_config_list[layer_id + 1].get_neuron_count() * ((layer_id == network_output_layer_id) ? fp32_elem_size : 1), layer_step_list[layer_id]);
+			}
+			activation_id_list.push_back(activation_id);
+
+			// The network output is read after all the layers are run
+			res.use_buffer(activation_id, layer_step_list.empty() ? 1 : layer_step_list.back() + 1);
+
+			res.plan();
+
+			return res;
+		}
+
+		void network_tester_plain::update_buffers(unsigned int max_entry_count)
+		{
+			if (max_entry_count <= buffers_max_entry_count)
+				return;
+
+			// Drop the old buffers first, the peak memory usage stays within the budget
+			release_buffers();
+
+			// The first pass only sizes the arena
+			buffer_arena_plain arena(plain_config->huge_pages);
+			create_buffers(arena, max_entry_count);
+			release_buffers();
+			arena.allocate();
+			create_buffers(arena, max_entry_count);
+
+			buffers_max_entry_count = max_entry_count;
+		}
+
+		void network_tester_plain::create_buffers(
+			buffer_arena_plain& arena,
+			unsigned int max_entry_count)
+		{
+			std::vector<unsigned int> activation_id_list;
+			activation_memory_planner_plain planner = plan_activations(activation_id_list);
+
+			// The slabs are placed one after another at the start of the arena. Slabs of 16-bit activations take half the fp32 elements
+			const size_t activation_elem_size = get_activation_elem_size();
+			additional_buffer_set slabs;
+			const std::vector<unsigned int>& slab_elem_count_per_entry_list = planner.get_slab_elem_count_per_entry_list();
+			for(std::vector<unsigned int>::const_iterator it = slab_elem_count_per_entry_list.begin(); it != slab_elem_count_per_entry_list.end(); ++it)
+				slabs.push_back(arena.create_buffer((static_cast<size_t>(*it) * max_entry_count * activation_elem_size + sizeof(float) - 1) / sizeof(float)));
+
+			// With the activations in 16 bits the layers write their fp32 output to the working buffer, for a chunk of entries at a time
+			const bool half_activations = (plain_config->activation_storage != plain_running_configuration::weight_storage_fp32);
+			const unsigned int layer_max_entry_count = half_activations ? std::min(max_entry_count, half_activation_chunk_entry_count) : max_entry_count;
+			if (half_activations)
+			{
+				unsigned int max_neuron_count = 0;
+				for(layer_configuration_specific_list::const_iterator it = layer_config_list.begin(); it != layer_config_list.end(); ++it)
+					max_neuron_count = std::max(max_neuron_count, it->get_neuron_count());
+				half_working_buffers.push_back(arena.create_buffer(max_neuron_count * layer_max_entry_count));
+				half_working_buffers.push_back(arena.create_buffer(max_neuron_count * layer_max_entry_count));
+
+				for(std::vector<unsigned int>::const_iterator it = activation_id_list.begin(); it != activation_id_list.end(); ++it)
+					half_activation_list.push_back((*it != activation_id_list.front()) && (*it != activation_id_list.back()));
+			}
+
+			const const_layer_list& layer_list = *schema;
+			for(unsigned int layer_id = 0; layer_id < tester_list.size(); ++layer_id)
+			{
+				additional_buffer_set additional_buffers = tester_list[layer_id]->allocate_additional_buffers(
+					layer_max_entry_count,
+					half_activations ? half_working_buffers[1] : slabs[planner.get_slab_id(activation_id_list[layer_id + 1])],
+					arena,
+					layer_list[layer_id],
+					layer_config_list[layer_id],
+					layer_config_list[layer_id + 1],
+					plain_config);
+				input_buffer_and_additional_buffers_pack.push_back(std::make_pair(slabs[planner.get_slab_id(activation_id_list[layer_id])], additional_buffers));
+			}
+
+			input_converted_buf = slabs[planner.get_slab_id(activation_id_list.front())];
+			output_buffer = slabs[planner.get_slab_id(activation_id_list.back())];
+			blocked_buffers = allocate_blocked_buffers(arena, layer_max_entry_count);
+		}
+
+		void network_tester_plain::release_buffers()
+		{
+			buffers_max_entry_count = 0;
+			input_buffer_and_additional_buffers_pack.clear();
+			input_converted_buf.reset();
+			output_buffer.reset();
+			blocked_buffers.clear();
+			half_activation_list.clear();
+			half_working_buffers.clear();
+		}
+
+		size_t network_tester_plain::get_activation_elem_size() const
 		{
+			return (plain_config->activation_storage == plain_running_configuration::weight_storage_fp32) ? sizeof(float) : sizeof(half_float_plain::fp16);
+		}
+
+		void network_tester_plain::load_activations(
+			const additional_buffer& src,
+			bool half,
+			unsigned int elem_offset,
+			float * dst,
+			unsigned int elem_count) const
+		{
+			if (!half)
+			{
+				std::copy(src.begin() + elem_offset, src.begin() + elem_offset + elem_count, dst);
+				return;
+			}
+
+			const int elem_count_int = static_cast<int>(elem_count);
+			if (plain_config->activation_storage == plain_running_configuration::weight_storage_bf16)
+			{
+				const half_float_plain::bf16 * const src_half = reinterpret_cast<const half_float_plain::bf16 *>(&(*src.begin())) + elem_offset;
+				#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+				for(int i = 0; i < elem_count_int; ++i)
+					dst[i] = half_float_plain::to_float(src_half[i]);
+			}
+			else
+			{
+				const half_float_plain::fp16 * const src_half = reinterpret_cast<const half_float_plain::fp16 *>(&(*src.begin())) + elem_offset;
+				#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+				for(int i = 0; i < elem_count_int; ++i)
+					dst[i] = half_float_plain::to_float(src_half[i]);
+			}
+		}
+
+		void network_tester_plain::store_activations(
+			const float * src,
+			additional_buffer& dst,
+			bool half,
+			unsigned int elem_offset,
+			unsigned int elem_count) const
+		{
+			if (!half)
+			{
+				std::copy(src, src + elem_count, dst.begin() + elem_offset);
+				return;
+			}
+
+			const int elem_count_int = static_cast<int>(elem_count);
+			if (plain_config->activation_storage == plain_running_configuration::weight_storage_bf16)
+			{
+				half_float_plain::bf16 * const dst_half = reinterpret_cast<half_float_plain::bf16 *>(&(*dst.begin())) + elem_offset;
+				#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+				for(int i = 0; i < elem_count_int; ++i)
+					dst_half[i] = half_float_plain::to_bf16(src[i]);
+			}
+			else
+			{
+				half_float_plain::fp16 * const dst_half = reinterpret_cast<half_float_plain::fp16 *>(&(*dst.begin())) + elem_offset;
+				#pragma omp parallel for default(none) schedule(static) num_threads(plain_config->openmp_thread_count)
+				for(int i = 0; i < elem_count_int; ++i)
+					dst_half[i] = half_float_plain::to_fp16(src[i]);
+			}
+		}
+
+		void network_tester_plain::run_layer(
+			unsigned int layer_id,
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_set& additional_buffers,
+			unsigned int entry_count) const
+		{
+			const const_layer_list& layer_list = *schema;
+			if (!tester_quantized_data_list.empty() && tester_quantized_data_list[layer_id])
+				tester_list[layer_id]->test_quantized(
+					input_buffer,
+					additional_buffers,
+					plain_config,
+					layer_list[layer_id],
+					tester_quantized_data_list[layer_id],
+					layer_config_list[layer_id],
+					layer_config_list[layer_id + 1],
+					entry_count);
+			else if (!tester_half_data_list.empty() && tester_half_data_list[layer_id])
+				tester_list[layer_id]->test_half_precision(
+					input_buffer,
+					additional_buffers,
+					plain_config,
+					layer_list[layer_id],
+					tester_half_data_list[layer_id],
+					layer_config_list[layer_id],
+					layer_config_list[layer_id + 1],
+					entry_count);
+			else
+				tester_list[layer_id]->test(
+					input_buffer,
+					additional_buffers,
+					plain_config,
+					layer_list[layer_id],
+					tester_data_list[layer_id],
+					tester_data_custom_list[layer_id],
+					layer_config_list[layer_id],
+					layer_config_list[layer_id + 1],
+					entry_count);
+		}
+
+		additional_buffer_smart_ptr network_tester_plain::run_layers(
+			std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> >& input_buffer_and_additional_buffers_pack,
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_smart_ptr output_buffer,
+			const additional_buffer_set& blocked_buffers,
+			unsigned int start_layer_id,
+			unsigned int run_layer_count,
+			unsigned int entry_count) const
+		{
+			if (run_layer_count == 1)
+			{
+				run_layer(
+					start_layer_id,
+					input_buffer,
+					input_buffer_and_additional_buffers_pack[start_layer_id].second,
+					entry_count);
+				return tester_list[start_layer_id]->get_output_buffer(input_buffer, input_buffer_and_additional_buffers_pack[start_layer_id].second);
+			}
+
+			if (!blocked_run_layer_count_list.empty() && (blocked_run_layer_count_list[start_layer_id] == run_layer_count))
+				run_blocked(
+					input_buffer,
+					output_buffer,
+					blocked_buffers,
+					start_layer_id,
+					entry_count);
+			else
+				fused_tester_list[start_layer_id]->test(
+					input_buffer,
+					input_buffer_and_additional_buffers_pack[start_layer_id].second,
+					output_buffer,
+					plain_config,
+					tester_data_list[start_layer_id],
+					layer_config_list.begin() + start_layer_id,
+					entry_count);
+
+			return output_buffer;
+		}
+
+		void network_tester_plain::run_layers_with_half_activations(
+			std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> >& input_buffer_and_additional_buffers_pack,
+			additional_buffer_smart_ptr output_buffer,
+			const additional_buffer_set& blocked_buffers,
+			unsigned int start_layer_id,
+			unsigned int run_layer_count,
+			unsigned int layer_count,
+			unsigned int entry_count) const
+		{
+			const unsigned int next_layer_id = start_layer_id + layer_count;
+			additional_buffer_smart_ptr input_buffer = input_buffer_and_additional_buffers_pack[start_layer_id].first;
+			// The layers write to the buffer the next layer reads from
+			additional_buffer_smart_ptr layers_output_buffer = (next_layer_id < input_buffer_and_additional_buffers_pack.size()) ? input_buffer_and_additional_buffers_pack[next_layer_id].first : output_buffer;
+			const unsigned int input_neuron_count = layer_config_list[start_layer_id].get_neuron_count();
+			const unsigned int output_neuron_count = layer_config_list[next_layer_id].get_neuron_count();
+
+			for(unsigned int entry_id = 0; entry_id < entry_count; entry_id += half_activation_chunk_entry_count)
+			{
+				const unsigned int chunk_entry_count = std::min(entry_count - entry_id, half_activation_chunk_entry_count);
+
+				load_activations(*input_buffer, half_activation_list[start_layer_id], entry_id * input_neuron_count, &(*half_working_buffers[0]->begin()), chunk_entry_count * input_neuron_count);
+
+				additional_buffer_smart_ptr working_buffer = run_layers(
+					input_buffer_and_additional_buffers_pack,
+					half_working_buffers[0],
+					half_working_buffers[1],
+					blocked_buffers,
+					start_layer_id,
+					run_layer_count,
+					chunk_entry_count);
+				for(unsigned int layer_id = start_layer_id + run_layer_count; layer_id < next_layer_id; ++layer_id)
+					working_buffer = run_layers(
+						input_buffer_and_additional_buffers_pack,
+						working_buffer,
+						working_buffer,
+						blocked_buffers,
+						layer_id,
+						1,
+						chunk_entry_count);
+
+				store_activations(&(*working_buffer->begin()), *layers_output_buffer, half_activation_list[next_layer_id], entry_id * output_neuron_count, chunk_entry_count * output_neuron_count);
+			}
+		}
+
+		void network_tester_plain::run_blocked(
+			additional_buffer_smart_ptr input_buffer,
+			additional_buffer_smart_ptr output_buffer,
+			const additional_buffer_set& blocked_buffers,
+			unsigned int start_layer_id,
+			unsigned int entry_count) const
+		{
+			const const_layer_list& layer_list = *schema;
+			const unsigned int next_layer_id = start_layer_id + blocked_run_layer_count_list[start_layer_id];
+
+			blocked_layout_plain::to_blocked(
+				&(*input_buffer->begin()),
+				&(*blocked_buffers[0]->begin()),
+				layer_config_list[start_layer_id],
+				entry_count,
+				plain_config->openmp_thread_count);
+
+			unsigned int current_buffer_id = 0;
+			for(unsigned int layer_id = start_layer_id; layer_id < next_layer_id; ++layer_id)
+			{
+				tester_list[layer_id]->test_blocked(
+					blocked_buffers[current_buffer_id],
+					blocked_buffers[1 - current_buffer_id],
+					plain_config,
+					layer_list[layer_id],
+					tester_blocked_data_list[layer_id],
+					layer_config_list[layer_id],
+					layer_config_list[layer_id + 1],
+					entry_count);
+				current_buffer_id = 1 - current_buffer_id;
+			}
+
+			blocked_layout_plain::to_planar(
+				&(*blocked_buffers[current_buffer_id]->begin()),
+				&(*output_buffer->begin()),
+				layer_config_list[next_layer_id],
+				entry_count,
+				plain_config->openmp_thread_count);
+		}
+
+		void network_tester_plain::run_testers(
+			std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> >& input_buffer_and_additional_buffers_pack,
+			additional_buffer_smart_ptr output_buffer,
+			const additional_buffer_set& blocked_buffers,
+			unsigned int entry_count) const
+		{
+			unsigned int layer_id = 0;
+			while (layer_id < tester_list.size())
+			{
+				/*
+				{
+					boost::filesystem::path dir = "Debug";
+					dir /= "CPU";
+					boost::filesystem::create_directories(dir);
+					debug_util::dump_list(
+						&(*input_buffer_and_additional_buffers_pack[layer_id].first->begin()),
+						input_buffer_and_additional_buffers_pack[layer_id].first->size(),
+						(dir / (boost::format("input_neurons_%1%.txt") % layer_id).str()).string().c_str());
+				}
+				*/
+
+				const unsigned int run_layer_count = get_run_layer_count(layer_id);
+				if (!half_activation_list.empty())
+				{
+					// In-place layers are run on the chunk of the layers they follow, their input is not converted back and forth
+					unsigned int layer_count = run_layer_count;
+					while ((layer_id + layer_count < tester_list.size()) && tester_list[layer_id + layer_count]->is_in_place() && (get_run_layer_count(layer_id + layer_count) == 1))
+						++layer_count;
+
+					run_layers_with_half_activations(
+						input_buffer_and_additional_buffers_pack,
+						output_buffer,
+						blocked_buffers,
+						layer_id,
+						run_layer_count,
+						layer_count,
+						entry_count);
+					layer_id += layer_count;
+				}
+				else
+				{
+					// A blocked run or a fused chain writes to the buffer the last layer of it would write to
+					const unsigned int next_layer_id = layer_id + run_layer_count;
+					run_layers(
+						input_buffer_and_additional_buffers_pack,
+						input_buffer_and_additional_buffers_pack[layer_id].first,
+						(next_layer_id < input_buffer_and_additional_buffers_pack.size()) ? input_buffer_and_additional_buffers_pack[next_layer_id].first : output_buffer,
+						blocked_buffers,
+						layer_id,
+						run_layer_count,
+						entry_count);
+					layer_id = next_layer_id;
+				}
+			}
 		}
 
 		void network_tester_plain::update_buffers_configuration_testing(buffer_plain_size_configuration& buffer_configuration) const
 		{
-			for(std::vector<layer_data_smart_ptr>::const_iterator it = net_data->data_list.begin(); it != net_data->data_list.end(); ++it)
+			for(std::vector<const_layer_data_smart_ptr>::const_iterator it = tester_data_list.begin(); it != tester_data_list.end(); ++it)
 				for(layer_data::const_iterator it2 = (*it)->begin(); it2 != (*it)->end(); ++it2)
 					buffer_configuration.add_constant_buffer(it2->size() * sizeof(float));
-			for(std::vector<layer_data_custom_smart_ptr>::const_iterator it = net_data->data_custom_list.begin(); it != net_data->data_custom_list.end(); ++it)
+			for(std::vector<const_layer_data_custom_smart_ptr>::const_iterator it = tester_data_custom_list.begin(); it != tester_data_custom_list.end(); ++it)
 				for(layer_data_custom::const_iterator it2 = (*it)->begin(); it2 != (*it)->end(); ++it2)
 					buffer_configuration.add_constant_buffer(it2->size() * sizeof(float));
+			for(std::vector<const_layer_data_smart_ptr>::const_iterator it = tester_blocked_data_list.begin(); it != tester_blocked_data_list.end(); ++it)
+				if (*it)
+					for(layer_data::const_iterator it2 = (*it)->begin(); it2 != (*it)->end(); ++it2)
+						buffer_configuration.add_constant_buffer(it2->size() * sizeof(float));
+			for(std::vector<const_quantized_layer_data_plain_smart_ptr>::const_iterator it = tester_quantized_data_list.begin(); it != tester_quantized_data_list.end(); ++it)
+				if (*it)
+					buffer_configuration.add_constant_buffer((*it)->get_size_in_bytes());
+			for(std::vector<const_half_layer_data_plain_smart_ptr>::const_iterator it = tester_half_data_list.begin(); it != tester_half_data_list.end(); ++it)
+				if (*it)
+					buffer_configuration.add_constant_buffer((*it)->get_size_in_bytes());
+
+			// With the activations in 16 bits the blocked buffers and the other buffers of the layers are allocated for a chunk of entries
+			const bool half_activations = (plain_config->activation_storage != plain_running_configuration::weight_storage_fp32);
+			buffer_plain_size_configuration layer_buffer_configuration;
+
+			const unsigned int blocked_buffer_elem_count = get_blocked_buffer_elem_count();
+			if (blocked_buffer_elem_count > 0)
+			{
+				(half_activations ? layer_buffer_configuration : buffer_configuration).add_per_entry_buffer(blocked_buffer_elem_count * sizeof(float));
+				(half_activations ? layer_buffer_configuration : buffer_configuration).add_per_entry_buffer(blocked_buffer_elem_count * sizeof(float));
+			}
+
+			// The network input and the outputs of out-of-place layers, the layer testers add their other buffers only
+			{
+				std::vector<unsigned int> activation_id_list;
+				buffer_configuration.add_per_entry_buffer(plan_activations(activation_id_list).get_elem_count_per_entry() * get_activation_elem_size());
+			}
 
 			const const_layer_list& layer_list = *schema;
 			const_layer_list::const_iterator layer_it = layer_list.begin();
@@ -406,12 +1064,21 @@ namespace nnforge
 			for(std::vector<const_layer_tester_plain_smart_ptr>::const_iterator it = tester_list.begin(); it != tester_list.end(); ++it, ++layer_it, ++input_config_it)
 			{
 				(*it)->update_buffer_configuration(
-					buffer_configuration,
+					half_activations ? layer_buffer_configuration : buffer_configuration,
 					*layer_it,
 					*input_config_it,
 					*(input_config_it + 1),
 					plain_config);
 			}
+
+			if (half_activations)
+			{
+				unsigned int max_neuron_count = 0;
+				for(layer_configuration_specific_list::const_iterator it = layer_config_list.begin(); it != layer_config_list.end(); ++it)
+					max_neuron_count = std::max(max_neuron_count, it->get_neuron_count());
+				buffer_configuration.add_constant_buffer(max_neuron_count * half_activation_chunk_entry_count * 2 * sizeof(float)); // fp32 input and output of the chunk
+				buffer_configuration.add_constant_buffer(layer_buffer_configuration.constant_buffer_size + layer_buffer_configuration.per_entry_buffer_size * half_activation_chunk_entry_count);
+			}
 		}
 	}
 }
@@ -19,7 +19,9 @@
 #include "../network_tester.h"
 #include "plain_running_configuration.h"
 #include "layer_tester_plain.h"
+#include "convolution_fused_tester_plain.h"
 #include "buffer_plain_size_configuration.h"
+#include "activation_memory_planner_plain.h"
 
 namespace nnforge
 {
@@ -59,16 +61,159 @@ namespace nnforge
 			// The layer_config_list is guaranteed to be compatible with schema
 			virtual void layer_config_list_modified();
 
+			// Runs the layers one by one in fp32 and records the max absolute value of the input of each layer
+			virtual void actual_calibrate(
+				unsupervised_data_reader& reader,
+				unsigned int max_entry_count);
+
 		private:
 			network_tester_plain(const network_tester_plain&);
 			network_tester_plain& operator =(const network_tester_plain&);
 
 			void update_buffers_configuration_testing(buffer_plain_size_configuration& buffer_configuration) const;
 
+			void update_data();
+
+			void update_blocked_runs();
+
+			void update_quantized_data();
+
+			void update_half_precision_data();
+
+			// Elements per entry in each of the 2 blocked layout buffers, 0 if there are no blocked runs
+			unsigned int get_blocked_buffer_elem_count() const;
+
+			// Runs all the layers, the chains of fused layers are run by their fused testers,
+			// the blocked runs are run in the blocked layout, ping-ponging between the 2 blocked buffers
+			void run_testers(
+				std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> >& input_buffer_and_additional_buffers_pack,
+				additional_buffer_smart_ptr output_buffer,
+				const additional_buffer_set& blocked_buffers,
+				unsigned int entry_count) const;
+
+			// Converts the input of the blocked run starting at start_layer_id to the blocked layout, runs it and converts its output back to output_buffer
+			void run_blocked(
+				additional_buffer_smart_ptr input_buffer,
+				additional_buffer_smart_ptr output_buffer,
+				const additional_buffer_set& blocked_buffers,
+				unsigned int start_layer_id,
+				unsigned int entry_count) const;
+
+			additional_buffer_set allocate_blocked_buffers(
+				buffer_arena_plain& arena,
+				unsigned int max_entry_count) const;
+
+			// Runs the single layer with its quantized, 16-bit or fp32 data
+			void run_layer(
+				unsigned int layer_id,
+				additional_buffer_smart_ptr input_buffer,
+				additional_buffer_set& additional_buffers,
+				unsigned int entry_count) const;
+
+			// Returns the number of layers run together starting at layer_id: the blocked run, the fused chain or the single layer
+			unsigned int get_run_layer_count(unsigned int layer_id) const;
+
+			// Runs run_layer_count layers starting at start_layer_id on input_buffer, see get_run_layer_count.
+			// The blocked run and the fused chain write to output_buffer, the single layer writes where its tester does.
+			// Returns the buffer holding the output
+			additional_buffer_smart_ptr run_layers(
+				std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> >& input_buffer_and_additional_buffers_pack,
+				additional_buffer_smart_ptr input_buffer,
+				additional_buffer_smart_ptr output_buffer,
+				const additional_buffer_set& blocked_buffers,
+				unsigned int start_layer_id,
+				unsigned int run_layer_count,
+				unsigned int entry_count) const;
+
+			// Runs the layers on chunks of at most half_activation_chunk_entry_count entries when the activations are stored in 16 bits:
+			// the input of the chunk is converted to fp32 into the first working buffer, the first run_layer_count layers (see run_layers)
+			// write their fp32 output to the other one, the remaining in-place layers run on it,
+			// and the result is converted back to the storage of the next activation
+			void run_layers_with_half_activations(
+				std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> >& input_buffer_and_additional_buffers_pack,
+				additional_buffer_smart_ptr output_buffer,
+				const additional_buffer_set& blocked_buffers,
+				unsigned int start_layer_id,
+				unsigned int run_layer_count,
+				unsigned int layer_count,
+				unsigned int entry_count) const;
+
+			// Bytes per element of the activations between the layers
+			size_t get_activation_elem_size() const;
+
+			// Copies elem_count activations starting at elem_offset to dst, converting them to fp32 if the activation is stored in 16 bits
+			void load_activations(
+				const additional_buffer& src,
+				bool half,
+				unsigned int elem_offset,
+				float * dst,
+				unsigned int elem_count) const;
+
+			// Copies elem_count fp32 values to the activation starting at elem_offset, converting them to 16 bits if the activation is stored so
+			void store_activations(
+				const float * src,
+				additional_buffer& dst,
+				bool half,
+				unsigned int elem_offset,
+				unsigned int elem_count) const;
+
+			// Returns the step each layer is run at for activation planning, the layers of a fused chain share the step
+			std::vector<unsigned int> get_layer_step_list() const;
+
+			// Plans the activations: the network input and the outputs of out-of-place layers.
+			// activation_id_list receives the buffer id of the input of each layer followed by the one of the network output.
+			// The sizes are in the elements of the activation storage, fp32 buffers take 2 of them when the activations are stored in 16 bits
+			activation_memory_planner_plain plan_activations(std::vector<unsigned int>& activation_id_list) const;
+
+			// Allocates the planned activation slabs, the additional buffers of the layers and the blocked buffers in a single arena
+			// unless the ones allocated already are large enough for max_entry_count entries
+			void update_buffers(unsigned int max_entry_count);
+
+			// Creates the buffers for update_buffers, see buffer_arena_plain for the 2 passes
+			void create_buffers(
+				buffer_arena_plain& arena,
+				unsigned int max_entry_count);
+
+			void release_buffers();
+
 			plain_running_configuration_const_smart_ptr plain_config;
 
 			const_layer_tester_plain_list tester_list;
+			// The fused tester for each layer starting a fused chain, empty pointer for other layers
+			std::vector<const_convolution_fused_tester_plain_smart_ptr> fused_tester_list;
 			network_data_smart_ptr net_data;
+			std::vector<const_layer_data_smart_ptr> tester_data_list;
+			std::vector<const_layer_data_custom_smart_ptr> tester_data_custom_list;
+			// The layer count of the blocked run starting at each layer, 0 if none starts there; empty when the blocked layout is off
+			// A blocked run starts and ends with layers natively supporting the layout, with transparent layers allowed in between
+			std::vector<unsigned int> blocked_run_layer_count_list;
+			// The data returned by get_blocked_data for the layers of blocked runs, empty pointers for other layers
+			std::vector<const_layer_data_smart_ptr> tester_blocked_data_list;
+			// Max absolute value of the input of each layer, empty if the network is not calibrated
+			std::vector<float> input_max_abs_value_list;
+			// The data returned by get_quantized_data for the quantized layers, empty pointers for other layers; empty if the network is not calibrated
+			std::vector<const_quantized_layer_data_plain_smart_ptr> tester_quantized_data_list;
+			// The data returned by get_half_precision_data for the layers with 16-bit weights, empty pointers for other layers; empty if the weight storage is fp32
+			std::vector<const_half_layer_data_plain_smart_ptr> tester_half_data_list;
+
+			// The buffers are kept across runs, they are reallocated when more entries are to be processed at once
+			// and released when the data or the layer configuration changes
+			unsigned int buffers_max_entry_count;
+			std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> > input_buffer_and_additional_buffers_pack;
+			// The converted network input, it is the input buffer of the first layer
+			additional_buffer_smart_ptr input_converted_buf;
+			additional_buffer_smart_ptr output_buffer;
+			additional_buffer_set blocked_buffers;
+			// Whether the input of each layer, followed by the network output, is stored in 16 bits; empty if the activation storage is fp32.
+			// The network input and output stay fp32, so that they are filled and read the same way for all the storages
+			std::vector<bool> half_activation_list;
+			// fp32 input and output of the chunk of entries a layer is run on when the activations are stored in 16 bits
+			additional_buffer_set half_working_buffers;
+			// The entries as they are read for calibration
+			std::vector<unsigned char> input_buf;
+
+			// The layers are run on chunks of this many entries when the activations are stored in 16 bits, only the chunk is kept in fp32
+			static const unsigned int half_activation_chunk_entry_count = 16;
 		};
 	}
 }
@@ -23,6 +23,7 @@
 
 #include "layer_tester_plain_factory.h"
 #include "layer_updater_plain_factory.h"
+#include "data_reader_prefetcher_plain.h"
 
 #include "../neural_network_exception.h"
 #include "../nn_types.h"
@@ -46,6 +47,8 @@ namespace nnforge
 			plain_running_configuration_const_smart_ptr plain_config)
 			: network_updater(schema, ef)
 			, plain_config(plain_config)
+			, buffers_max_entry_read_count(0)
+			, buffers_updater_entry_count(0)
 		{
 			const const_layer_list& layer_list = *schema;
 
@@ -137,9 +140,9 @@ namespace nnforge
 			{
 				buffer_plain_size_configuration buffers_config;
 				update_buffers_configuration(buffers_config, updater_entry_count);
-				buffers_config.add_per_entry_buffer(input_neuron_count * input_neuron_elem_size); // input
+				buffers_config.add_per_entry_buffer(input_neuron_count * input_neuron_elem_size * (plain_config->prefetch_queue_depth + 1)); // input, the chunk processed and the ones read ahead
 				buffers_config.add_per_entry_buffer(input_neuron_count * sizeof(float)); // converted input
-				buffers_config.add_per_entry_buffer(output_neuron_count * sizeof(float)); // output
+				buffers_config.add_per_entry_buffer(output_neuron_count * sizeof(float) * (plain_config->prefetch_queue_depth + 1)); // output, the chunk processed and the ones read ahead
 				buffers_config.add_constant_buffer(output_neuron_count * sizeof(float) * updater_entry_count); // initial error
 				for(std::vector<layer_data_smart_ptr>::iterator it = data->data_list.begin(); it != data->data_list.end(); ++it)
 				{
@@ -169,76 +172,18 @@ namespace nnforge
 				}
 			}
 
-			std::vector<unsigned char> input_buf(max_entry_read_count * input_neuron_count * input_neuron_elem_size);
-			std::vector<float> actual_output_buf(max_entry_read_count * output_neuron_count);
-			additional_buffer_smart_ptr initial_error_buf(new std::vector<float>(updater_entry_count * output_neuron_count));
-			additional_buffer_smart_ptr input_converted_buf(new std::vector<float>(input_neuron_count * max_entry_read_count));
+			update_buffers(max_entry_read_count, updater_entry_count);
+			update_data_derived_buffers(*data);
 
-			additional_buffer_smart_ptr output_buffer = input_converted_buf;
-			std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> > input_buffer_and_additional_testing_buffers_pack;
-			std::vector<std::pair<additional_buffer_smart_ptr, updater_additional_buffer_set> > input_buffer_and_additional_updater_buffers_pack;
-			{
-				const const_layer_list& layer_list = *schema;
-				const_layer_list::const_iterator layer_it = layer_list.begin();
-				layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin();
-				for(std::vector<const_layer_tester_plain_smart_ptr>::const_iterator it = tester_list.begin(); it != tester_list.end(); ++it, ++layer_it, ++input_config_it)
-				{
-					additional_buffer_set additional_buffers = (*it)->allocate_additional_buffers(
-						max_entry_read_count,
-						*layer_it,
-						*input_config_it,
-						*(input_config_it + 1),
-						plain_config);
-					input_buffer_and_additional_testing_buffers_pack.push_back(std::make_pair(output_buffer, additional_buffers));
-					output_buffer = (*it)->get_output_buffer(output_buffer, additional_buffers);
-				}
-				for(const_layer_updater_plain_list::const_iterator it = updater_list.begin(); it != updater_list.end(); ++it, ++layer_it, ++input_config_it)
-				{
-					updater_additional_buffer_set additional_buffers = (*it)->allocate_additional_buffers(
-						updater_entry_count,
-						*layer_it,
-						*input_config_it,
-						*(input_config_it + 1),
-						plain_config,
-						(it != updater_list.begin()));
-					input_buffer_and_additional_updater_buffers_pack.push_back(std::make_pair(output_buffer, additional_buffers));
-					output_buffer = additional_buffers.output_neurons_buffer;
-				}
-			}
-			{
-				additional_buffer_smart_ptr output_errors = initial_error_buf;
-				for(std::vector<std::pair<additional_buffer_smart_ptr, updater_additional_buffer_set> >::reverse_iterator it = input_buffer_and_additional_updater_buffers_pack.rbegin(); it != input_buffer_and_additional_updater_buffers_pack.rend() - 1; ++it)
-				{
-					if (it->second.input_errors_buffer != 0)
-						output_errors = it->second.input_errors_buffer;
-					else
-						it->second.input_errors_buffer = output_errors;
-				}
-			}
+			data_reader_prefetcher_plain prefetcher(reader, entry_read_count_list, plain_config->prefetch_queue_depth);
 
-			bool entries_remained_for_loading = true;
-			unsigned int entry_read_count_index = 0;
 			unsigned int entry_gradient_calculated_count = 0;
 			unsigned int gradient_applied_count = 0;
-			while (entries_remained_for_loading)
+			while (true)
 			{
-				unsigned int entries_available_for_processing_count = 0;
-				while(entries_available_for_processing_count < entry_read_count_list[entry_read_count_index])
-				{
-					bool entry_read = reader.read(
-						&(*(input_buf.begin() + (input_neuron_count * entries_available_for_processing_count * input_neuron_elem_size))),
-						&(*(actual_output_buf.begin() + (output_neuron_count * entries_available_for_processing_count))));
-					if (!entry_read)
-					{
-						entries_remained_for_loading = false;
-						break;
-					}
-					entries_available_for_processing_count++;
-				}
-				entry_read_count_index++;
-				if (entry_read_count_index >= entry_read_count_list.size())
-					entry_read_count_index = 0;
-
+				const unsigned char * input_buf;
+				const float * actual_output_buf;
+				const unsigned int entries_available_for_processing_count = prefetcher.get_next_chunk(input_buf, actual_output_buf);
 				if (entries_available_for_processing_count == 0)
 					break;
 
@@ -247,17 +192,17 @@ namespace nnforge
 				// Convert input
 				{
 					const int elem_count = static_cast<int>(entries_available_for_processing_count * input_neuron_count);
-					const std::vector<float>::iterator input_converted_buf_it_start = input_converted_buf->begin();
+					const additional_buffer::iterator input_converted_buf_it_start = input_converted_buf->begin();
 					if (type_code == neuron_data_type::type_byte)
 					{
-						const unsigned char * const input_buf_it_start = &(*input_buf.begin());
+						const unsigned char * const input_buf_it_start = input_buf;
 						#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
 						for(int i = 0; i < elem_count; ++i)
 							*(input_converted_buf_it_start + i) = static_cast<float>(*(input_buf_it_start + i)) * (1.0F / 255.0F);
 					}
 					else if (type_code == neuron_data_type::type_float)
 					{
-						const float * const input_buf_it_start = reinterpret_cast<float *>(&(*input_buf.begin()));
+						const float * const input_buf_it_start = reinterpret_cast<const float *>(input_buf);
 						#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
 						for(int i = 0; i < elem_count; ++i)
 							*(input_converted_buf_it_start + i) = *(input_buf_it_start + i);
@@ -323,9 +268,9 @@ namespace nnforge
 
 					// Set initial error and accumulate error
 					{
-						const std::vector<float>::iterator initial_error_it = initial_error_buf->begin();
-						const std::vector<float>::const_iterator actual_output_buf_it = actual_output_buf.begin() + (output_neuron_count * base_input_entry_id);
-						const std::vector<float>::const_iterator output_buffer_it = output_buffer->begin();
+						const additional_buffer::iterator initial_error_it = initial_error_buf->begin();
+						const float * const actual_output_buf_it = actual_output_buf + (output_neuron_count * base_input_entry_id);
+						const additional_buffer::const_iterator output_buffer_it = output_buffer->begin();
 						testing_result& tr = *testing_res;
 						const int elem_count = current_updater_entry_count;
 						std::vector<double> errors(plain_config->openmp_thread_count, 0.0);
@@ -431,6 +376,7 @@ namespace nnforge
 							gradient_normalizer,
 							weight_decay,
 							momentum);
+						update_data_derived_buffers(*data);
 						entry_gradient_calculated_count = 0;
 						++gradient_applied_count;
 					}
@@ -474,6 +420,117 @@ namespace nnforge
 
 		void network_updater_plain::layer_config_list_modified()
 		{
+			release_buffers();
+		}
+
+		void network_updater_plain::update_buffers(
+			unsigned int max_entry_read_count,
+			unsigned int updater_entry_count)
+		{
+			if ((max_entry_read_count == buffers_max_entry_read_count) && (updater_entry_count == buffers_updater_entry_count))
+				return;
+
+			// Drop the old buffers first, the peak memory usage stays within the budget
+			release_buffers();
+
+			// The first pass only sizes the arena
+			buffer_arena_plain arena(plain_config->huge_pages);
+			create_buffers(arena, max_entry_read_count, updater_entry_count);
+			release_buffers();
+			arena.allocate();
+			create_buffers(arena, max_entry_read_count, updater_entry_count);
+
+			buffers_max_entry_read_count = max_entry_read_count;
+			buffers_updater_entry_count = updater_entry_count;
+		}
+
+		void network_updater_plain::create_buffers(
+			buffer_arena_plain& arena,
+			unsigned int max_entry_read_count,
+			unsigned int updater_entry_count)
+		{
+			const unsigned int input_neuron_count = layer_config_list.front().get_neuron_count();
+			const unsigned int output_neuron_count = layer_config_list.back().get_neuron_count();
+
+			initial_error_buf = arena.create_buffer(updater_entry_count * output_neuron_count);
+			input_converted_buf = arena.create_buffer(input_neuron_count * max_entry_read_count);
+
+			output_buffer = input_converted_buf;
+			{
+				const const_layer_list& layer_list = *schema;
+				const_layer_list::const_iterator layer_it = layer_list.begin();
+				layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin();
+				for(std::vector<const_layer_tester_plain_smart_ptr>::const_iterator it = tester_list.begin(); it != tester_list.end(); ++it, ++layer_it, ++input_config_it)
+				{
+					// The layers before the trained ones keep an output buffer each
+					additional_buffer_smart_ptr layer_output_buffer;
+					if (!(*it)->is_in_place())
+						layer_output_buffer = arena.create_buffer((input_config_it + 1)->get_neuron_count() * max_entry_read_count);
+					additional_buffer_set additional_buffers = (*it)->allocate_additional_buffers(
+						max_entry_read_count,
+						layer_output_buffer,
+						arena,
+						*layer_it,
+						*input_config_it,
+						*(input_config_it + 1),
+						plain_config);
+					input_buffer_and_additional_testing_buffers_pack.push_back(std::make_pair(output_buffer, additional_buffers));
+					output_buffer = (*it)->get_output_buffer(output_buffer, additional_buffers);
+				}
+				for(const_layer_updater_plain_list::const_iterator it = updater_list.begin(); it != updater_list.end(); ++it, ++layer_it, ++input_config_it)
+				{
+					updater_additional_buffer_set additional_buffers = (*it)->allocate_additional_buffers(
+						updater_entry_count,
+						arena,
+						*layer_it,
+						*input_config_it,
+						*(input_config_it + 1),
+						plain_config,
+						(it != updater_list.begin()));
+					input_buffer_and_additional_updater_buffers_pack.push_back(std::make_pair(output_buffer, additional_buffers));
+					output_buffer = additional_buffers.output_neurons_buffer;
+				}
+			}
+			{
+				additional_buffer_smart_ptr output_errors = initial_error_buf;
+				for(std::vector<std::pair<additional_buffer_smart_ptr, updater_additional_buffer_set> >::reverse_iterator it = input_buffer_and_additional_updater_buffers_pack.rbegin(); it != input_buffer_and_additional_updater_buffers_pack.rend() - 1; ++it)
+				{
+					if (it->second.input_errors_buffer != 0)
+						output_errors = it->second.input_errors_buffer;
+					else
+						it->second.input_errors_buffer = output_errors;
+				}
+			}
+		}
+
+		void network_updater_plain::release_buffers()
+		{
+			buffers_max_entry_read_count = 0;
+			buffers_updater_entry_count = 0;
+			initial_error_buf.reset();
+			input_converted_buf.reset();
+			output_buffer.reset();
+			input_buffer_and_additional_testing_buffers_pack.clear();
+			input_buffer_and_additional_updater_buffers_pack.clear();
+		}
+
+		void network_updater_plain::update_data_derived_buffers(const network_data& data)
+		{
+			const const_layer_list& layer_list = *schema;
+			const_layer_list::const_iterator layer_it = layer_list.begin() + testing_layer_count;
+			layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin() + testing_layer_count;
+			layer_data_list::const_iterator data_it = data.data_list.begin() + testing_layer_count;
+			std::vector<std::pair<additional_buffer_smart_ptr, updater_additional_buffer_set> >::iterator updater_buffers_it = input_buffer_and_additional_updater_buffers_pack.begin();
+			for(std::vector<const_layer_updater_plain_smart_ptr>::const_iterator it = updater_list.begin(); it != updater_list.end(); ++it, ++layer_it, ++input_config_it, ++data_it, ++updater_buffers_it)
+			{
+				(*it)->update_data_derived_buffers(
+					updater_buffers_it->second.additional_buffers,
+					plain_config,
+					*layer_it,
+					*data_it,
+					*input_config_it,
+					*(input_config_it + 1));
+			}
 		}
 
 		void network_updater_plain::apply_gradient(
@@ -561,9 +618,10 @@ namespace nnforge
 		{
 			buffer_plain_size_configuration buffer_configuration;
 
+			// The updaters run for the layers following the testing ones
 			const const_layer_list& layer_list = *schema;
-			const_layer_list::const_iterator layer_it = layer_list.begin();
-			layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin();
+			const_layer_list::const_iterator layer_it = layer_list.begin() + testing_layer_count;
+			layer_configuration_specific_list::const_iterator input_config_it = layer_config_list.begin() + testing_layer_count;
 			for(const_layer_updater_plain_list::const_iterator it = updater_list.begin(); it != updater_list.end(); ++it, ++layer_it, ++input_config_it)
 			{
 				(*it)->update_buffer_configuration(
@@ -593,6 +651,8 @@ namespace nnforge
 					*input_config_it,
 					*(input_config_it + 1),
 					plain_config);
+				if (!(*it)->is_in_place())
+					buffer_configuration.add_per_entry_buffer((input_config_it + 1)->get_neuron_count() * sizeof(float));
 			}
 			for(const_layer_updater_plain_list::const_iterator it = updater_list.begin(); it != updater_list.end(); ++it, ++layer_it, ++input_config_it)
 			{
@@ -58,6 +58,22 @@ namespace nnforge
 
 			unsigned int get_updater_max_count() const;
 
+			// Allocates the buffers in a single arena unless the ones allocated already are for the same entry counts
+			void update_buffers(
+				unsigned int max_entry_read_count,
+				unsigned int updater_entry_count);
+
+			// Creates the buffers for update_buffers, see buffer_arena_plain for the 2 passes
+			void create_buffers(
+				buffer_arena_plain& arena,
+				unsigned int max_entry_read_count,
+				unsigned int updater_entry_count);
+
+			void release_buffers();
+
+			// Lets the updaters refresh the data they derive from the weights
+			void update_data_derived_buffers(const network_data& data);
+
 			void update_buffers_configuration(
 				buffer_plain_size_configuration& buffer_configuration,
 				unsigned int updater_entry_count) const;
@@ -82,6 +98,18 @@ namespace nnforge
 
 			bool error_function_fused_with_activation;
 
+			// The buffers are kept across the calls to actual_update, they are reallocated when the entry counts change
+			// and released when the layer configuration changes
+			unsigned int buffers_max_entry_read_count;
+			unsigned int buffers_updater_entry_count;
+			additional_buffer_smart_ptr initial_error_buf;
+			// The converted network input, it is the input buffer of the first layer
+			additional_buffer_smart_ptr input_converted_buf;
+			// The network output, it is the output buffer of the last layer
+			additional_buffer_smart_ptr output_buffer;
+			std::vector<std::pair<additional_buffer_smart_ptr, additional_buffer_set> > input_buffer_and_additional_testing_buffers_pack;
+			std::vector<std::pair<additional_buffer_smart_ptr, updater_additional_buffer_set> > input_buffer_and_additional_updater_buffers_pack;
+
 			static unsigned int max_entry_count_in_single_batch;
 		};
 	}
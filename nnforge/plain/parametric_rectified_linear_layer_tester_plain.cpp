@@ -16,6 +16,7 @@
 
 #include "parametric_rectified_linear_layer_tester_plain.h"
 
+#include "activation_plain.h"
 #include "../parametric_rectified_linear_layer.h"
 
 namespace nnforge
@@ -47,7 +48,7 @@ namespace nnforge
 			unsigned int entry_count) const
 		{
 			const int total_workload = static_cast<int>(entry_count * input_configuration_specific.feature_map_count);
-			const std::vector<float>::iterator in_it = input_buffer->begin();
+			const additional_buffer::iterator in_it = input_buffer->begin();
 			const unsigned int input_neuron_count = input_configuration_specific.get_neuron_count();
 			const unsigned int input_neuron_count_per_feature_map = input_configuration_specific.get_neuron_count_per_feature_map();
 			const unsigned int feature_map_count = input_configuration_specific.feature_map_count;
@@ -59,17 +60,8 @@ namespace nnforge
 				int entry_id = workload_id / feature_map_count;
 				int feature_map_id = workload_id - entry_id * feature_map_count;
 
-				float a = weights[feature_map_id];
-
-				std::vector<float>::iterator current_it = in_it + (entry_id * input_neuron_count) + (feature_map_id * input_neuron_count_per_feature_map);
-				std::vector<float>::const_iterator current_it_end = current_it + input_neuron_count_per_feature_map;
-
-				for(; current_it != current_it_end; ++current_it)
-				{
-					float input_val = *current_it;
-					float output_val = input_val * (input_val >= 0.0F ? 1.0F : a);
-					*current_it = output_val;
-				}
+				float * current_it = &(*(in_it + (entry_id * input_neuron_count) + (feature_map_id * input_neuron_count_per_feature_map)));
+				activation_plain::parametric_rectified_linear(current_it, current_it, input_neuron_count_per_feature_map, weights[feature_map_id]);
 			}
 		}
 	}
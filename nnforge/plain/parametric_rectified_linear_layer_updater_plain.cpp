@@ -16,6 +16,7 @@
 
 #include "parametric_rectified_linear_layer_updater_plain.h"
 
+#include "activation_plain.h"
 #include "../parametric_rectified_linear_layer.h"
 #include "../neural_network_exception.h"
 
@@ -55,8 +56,8 @@ namespace nnforge
 			const unsigned int feature_map_count = input_configuration_specific.feature_map_count;
 
 			const int total_workload = static_cast<int>(updater_count * feature_map_count);
-			const std::vector<float>::const_iterator in_it = input_buffer->begin() + input_neuron_count * offset_input_entry_id;
-			const std::vector<float>::iterator out_it = output_buffer->begin();
+			const additional_buffer::const_iterator in_it = input_buffer->begin() + input_neuron_count * offset_input_entry_id;
+			const additional_buffer::iterator out_it = output_buffer->begin();
 			const std::vector<float>::const_iterator weights = (*data)[0].begin();
 
 			#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
@@ -65,18 +66,8 @@ namespace nnforge
 				int entry_id = workload_id / feature_map_count;
 				int feature_map_id = workload_id - entry_id * feature_map_count;
 
-				float a = weights[feature_map_id];
-
-				std::vector<float>::const_iterator current_in_it = in_it + (entry_id * input_neuron_count) + (feature_map_id * input_neuron_count_per_feature_map);
-				std::vector<float>::const_iterator current_in_it_end = current_in_it + input_neuron_count_per_feature_map;
-				std::vector<float>::iterator current_out_it = out_it + (entry_id * input_neuron_count) + (feature_map_id * input_neuron_count_per_feature_map);
-
-				for(; current_in_it != current_in_it_end; ++current_in_it, ++current_out_it)
-				{
-					float input_val = *current_in_it;
-					float output_val = input_val * (input_val >= 0.0F ? 1.0F : a);
-					*current_out_it = output_val;
-				}
+				unsigned int offset = (entry_id * input_neuron_count) + (feature_map_id * input_neuron_count_per_feature_map);
+				activation_plain::parametric_rectified_linear(&(*(in_it + offset)), &(*(out_it + offset)), input_neuron_count_per_feature_map, weights[feature_map_id]);
 			}
 		}
 
@@ -100,8 +91,8 @@ namespace nnforge
 			const unsigned int feature_map_count = input_configuration_specific.feature_map_count;
 
 			const int total_workload = static_cast<int>(updater_count * feature_map_count);
-			const std::vector<float>::const_iterator in_neurons_it = input_neurons->begin();
-			const std::vector<float>::iterator err_it = input_errors->begin();
+			const additional_buffer::const_iterator in_neurons_it = input_neurons->begin();
+			const additional_buffer::iterator err_it = input_errors->begin();
 			const std::vector<float>::const_iterator weights = (*data)[0].begin();
 
 			#pragma omp parallel for default(none) schedule(guided) num_threads(plain_config->openmp_thread_count)
@@ -110,19 +101,8 @@ namespace nnforge
 				int entry_id = workload_id / feature_map_count;
 				int feature_map_id = workload_id - entry_id * feature_map_count;
 
-				float a = weights[feature_map_id];
-
-				std::vector<float>::const_iterator current_in_neurons_it = in_neurons_it + (entry_id * input_neuron_count) + (feature_map_id * input_neuron_count_per_feature_map);
-				std::vector<float>::const_iterator current_in_neurons_it_end = current_in_neurons_it + input_neuron_count_per_feature_map;
-				std::vector<float>::iterator current_err_it = err_it + (entry_id * input_neuron_count) + (feature_map_id * input_neuron_count_per_feature_map);
-
-				for(; current_in_neurons_it != current_in_neurons_it_end; ++current_in_neurons_it, ++current_err_it)
-				{
-					float output_err = *current_err_it;
-					float input_val = *current_in_neurons_it;
-					float input_err = output_err * (input_val >= 0.0F ? 1.0F : a);
-					*current_err_it = input_err;
-				}
+				unsigned int offset = (entry_id * input_neuron_count) + (feature_map_id * input_neuron_count_per_feature_map);
+				activation_plain::parametric_rectified_linear_backprop(&(*(err_it + offset)), &(*(in_neurons_it + offset)), input_neuron_count_per_feature_map, weights[feature_map_id]);
 			}
 		}
 
@@ -144,8 +124,8 @@ namespace nnforge
 			const unsigned int input_neuron_count_per_feature_map = input_configuration_specific.get_neuron_count_per_feature_map();
 			const unsigned int feature_map_count = input_configuration_specific.feature_map_count;
 
-			const std::vector<float>::const_iterator in_neurons_it = input_neurons->begin() + input_neuron_count * offset_input_entry_id;
-			const std::vector<float>::const_iterator err_it = output_errors->begin();
+			const additional_buffer::const_iterator in_neurons_it = input_neurons->begin() + input_neuron_count * offset_input_entry_id;
+			const additional_buffer::const_iterator err_it = output_errors->begin();
 			const std::vector<float>::iterator gradients = (*gradient)[0].begin();
 
 			const int total_workload = feature_map_count;
@@ -159,20 +139,8 @@ namespace nnforge
 				float sum = 0.0F;
 				for(int entry_id = 0; entry_id < const_updater_count; ++entry_id)
 				{
-					std::vector<float>::const_iterator current_in_neurons_it = in_neurons_it + (entry_id * input_neuron_count) + (feature_map_id * input_neuron_count_per_feature_map);
-					std::vector<float>::const_iterator current_in_neurons_it_end = current_in_neurons_it + input_neuron_count_per_feature_map;
-					std::vector<float>::const_iterator current_err_it = err_it + (entry_id * input_neuron_count) + (feature_map_id * input_neuron_count_per_feature_map);
-
-					float local_sum = 0.0F;
-					for(; current_in_neurons_it != current_in_neurons_it_end; ++current_in_neurons_it, ++current_err_it)
-					{
-						float output_err = *current_err_it;
-						float input_val = *current_in_neurons_it;
-						float gr = output_err * (input_val >= 0.0F ? 0.0F : input_val);
-						local_sum += gr;
-					}
-
-					sum += local_sum;
+					unsigned int offset = (entry_id * input_neuron_count) + (feature_map_id * input_neuron_count_per_feature_map);
+					sum += activation_plain::parametric_rectified_linear_gradient(&(*(err_it + offset)), &(*(in_neurons_it + offset)), input_neuron_count_per_feature_map);
 				}
 
 				*(gradients + feature_map_id) += sum;
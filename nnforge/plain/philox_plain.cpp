@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "philox_plain.h"
+
+namespace nnforge
+{
+	namespace plain
+	{
+		const unsigned int philox_plain::numbers_per_counter;
+		const unsigned int philox_plain::counters_per_block;
+		const unsigned int philox_plain::numbers_per_block;
+
+		void philox_plain::generate(
+			unsigned int key0,
+			unsigned int key1,
+			unsigned int counter_high,
+			unsigned int block_id,
+			unsigned int * res)
+		{
+			const unsigned int multiplier0 = 0xD2511F53;
+			const unsigned int multiplier1 = 0xCD9E8D57;
+			const unsigned int key_increment0 = 0x9E3779B9;
+			const unsigned int key_increment1 = 0xBB67AE85;
+
+			// The state of all the counters is updated round by round, the loops over the counters are vectorized
+			unsigned int c0[counters_per_block];
+			unsigned int c1[counters_per_block];
+			unsigned int c2[counters_per_block];
+			unsigned int c3[counters_per_block];
+			for(unsigned int j = 0; j < counters_per_block; ++j)
+			{
+				c0[j] = block_id * counters_per_block + j;
+				c1[j] = counter_high;
+				c2[j] = 0;
+				c3[j] = 0;
+			}
+
+			unsigned int k0 = key0;
+			unsigned int k1 = key1;
+			for(unsigned int round_id = 0; round_id < 10; ++round_id)
+			{
+				for(unsigned int j = 0; j < counters_per_block; ++j)
+				{
+					// High and low halves of the 64-bit products are computed separately, which is the form the compiler vectorizes
+					const unsigned int high0 = static_cast<unsigned int>((static_cast<unsigned long long>(multiplier0) * c0[j]) >> 32);
+					const unsigned int high1 = static_cast<unsigned int>((static_cast<unsigned long long>(multiplier1) * c2[j]) >> 32);
+					const unsigned int low0 = multiplier0 * c0[j];
+					const unsigned int low1 = multiplier1 * c2[j];
+					c0[j] = high1 ^ c1[j] ^ k0;
+					c2[j] = high0 ^ c3[j] ^ k1;
+					c1[j] = low1;
+					c3[j] = low0;
+				}
+				k0 += key_increment0;
+				k1 += key_increment1;
+			}
+
+			for(unsigned int j = 0; j < counters_per_block; ++j)
+			{
+				res[j] = c0[j];
+				res[counters_per_block + j] = c1[j];
+				res[counters_per_block * 2 + j] = c2[j];
+				res[counters_per_block * 3 + j] = c3[j];
+			}
+		}
+	}
+}
@@ -0,0 +1,52 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Philox4x32-10 counter-based random number generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+		// Each 64-bit counter is mapped to 4 independent 32-bit numbers with the 64-bit key,
+		// so any part of the sequence can be generated by any thread without generating the preceding numbers
+		class philox_plain
+		{
+		public:
+			// Numbers generated for a single counter
+			static const unsigned int numbers_per_counter = 4;
+
+			// Counters processed at once, enough for the loops over them to be vectorized rather than unrolled
+			static const unsigned int counters_per_block = 64;
+
+			// Numbers generated by generate
+			static const unsigned int numbers_per_block = numbers_per_counter * counters_per_block;
+
+			// Writes the numbers for the counters [block_id * counters_per_block, (block_id + 1) * counters_per_block) with the high 32 bits equal to counter_high
+			// res[i * counters_per_block + j] is the number i of the counter j of the block
+			static void generate(
+				unsigned int key0,
+				unsigned int key1,
+				unsigned int counter_high,
+				unsigned int block_id,
+				unsigned int * res);
+
+		private:
+			philox_plain();
+			~philox_plain();
+		};
+	}
+}
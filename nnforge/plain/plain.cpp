@@ -25,6 +25,7 @@
 #include "local_contrast_subtractive_layer_tester_plain.h"
 #include "convolution_layer_tester_plain.h"
 #include "sparse_convolution_layer_tester_plain.h"
+#include "grouped_convolution_layer_tester_plain.h"
 #include "rectified_linear_layer_tester_plain.h"
 #include "softmax_layer_tester_plain.h"
 #include "maxout_layer_tester_plain.h"
@@ -41,6 +42,7 @@
 #include "local_contrast_subtractive_layer_updater_plain.h"
 #include "convolution_layer_updater_plain.h"
 #include "sparse_convolution_layer_updater_plain.h"
+#include "grouped_convolution_layer_updater_plain.h"
 #include "rectified_linear_layer_updater_plain.h"
 #include "softmax_layer_updater_plain.h"
 #include "maxout_layer_updater_plain.h"
@@ -63,6 +65,7 @@ namespace nnforge
 			single_layer_tester_plain_factory::get_mutable_instance().register_layer_tester_plain(layer_tester_plain_smart_ptr(new local_contrast_subtractive_layer_tester_plain()));
 			single_layer_tester_plain_factory::get_mutable_instance().register_layer_tester_plain(layer_tester_plain_smart_ptr(new convolution_layer_tester_plain()));
 			single_layer_tester_plain_factory::get_mutable_instance().register_layer_tester_plain(layer_tester_plain_smart_ptr(new sparse_convolution_layer_tester_plain()));
+			single_layer_tester_plain_factory::get_mutable_instance().register_layer_tester_plain(layer_tester_plain_smart_ptr(new grouped_convolution_layer_tester_plain()));
 			single_layer_tester_plain_factory::get_mutable_instance().register_layer_tester_plain(layer_tester_plain_smart_ptr(new rectified_linear_layer_tester_plain()));
 			single_layer_tester_plain_factory::get_mutable_instance().register_layer_tester_plain(layer_tester_plain_smart_ptr(new softmax_layer_tester_plain()));
 			single_layer_tester_plain_factory::get_mutable_instance().register_layer_tester_plain(layer_tester_plain_smart_ptr(new maxout_layer_tester_plain()));
@@ -78,6 +81,7 @@ namespace nnforge
 			single_layer_updater_plain_factory::get_mutable_instance().register_layer_updater_plain(layer_updater_plain_smart_ptr(new local_contrast_subtractive_layer_updater_plain()));
 			single_layer_updater_plain_factory::get_mutable_instance().register_layer_updater_plain(layer_updater_plain_smart_ptr(new convolution_layer_updater_plain()));
 			single_layer_updater_plain_factory::get_mutable_instance().register_layer_updater_plain(layer_updater_plain_smart_ptr(new sparse_convolution_layer_updater_plain()));
+			single_layer_updater_plain_factory::get_mutable_instance().register_layer_updater_plain(layer_updater_plain_smart_ptr(new grouped_convolution_layer_updater_plain()));
 			single_layer_updater_plain_factory::get_mutable_instance().register_layer_updater_plain(layer_updater_plain_smart_ptr(new rectified_linear_layer_updater_plain()));
 			single_layer_updater_plain_factory::get_mutable_instance().register_layer_updater_plain(layer_updater_plain_smart_ptr(new softmax_layer_updater_plain()));
 			single_layer_updater_plain_factory::get_mutable_instance().register_layer_updater_plain(layer_updater_plain_smart_ptr(new maxout_layer_updater_plain()));
@@ -16,6 +16,8 @@
 
 #include "plain_running_configuration.h"
 
+#include "instruction_set_plain.h"
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -26,9 +28,19 @@ namespace nnforge
 	{
 		plain_running_configuration::plain_running_configuration(
 			int openmp_thread_count,
-			float max_memory_usage_gigabytes)
+			float max_memory_usage_gigabytes,
+			bool blocked_layout,
+			weight_storage_type weight_storage,
+			bool huge_pages,
+			unsigned int prefetch_queue_depth,
+			weight_storage_type activation_storage)
 			: openmp_thread_count(openmp_thread_count)
 			, max_memory_usage_gigabytes(max_memory_usage_gigabytes)
+			, blocked_layout(blocked_layout)
+			, weight_storage(weight_storage)
+			, huge_pages(huge_pages)
+			, prefetch_queue_depth(prefetch_queue_depth)
+			, activation_storage(activation_storage)
 		{
 			#ifndef _OPENMP
 			this->openmp_thread_count = 1;
@@ -53,11 +65,17 @@ namespace nnforge
 			#else
 			out << "Built without OpenMP support" << std::endl;
 			#endif
+			out << "Instruction set = " << instruction_set_plain::get_name(instruction_set_plain::get_instruction_set()) << std::endl;
 
 			out << "--- Settings ---" << std::endl;
 
 			out << "Max memory usage = " << running_configuration.max_memory_usage_gigabytes << " GB" << std::endl;
 			out << "OpenMP thread count = " << running_configuration.openmp_thread_count << std::endl;
+			out << "Blocked layout = " << (running_configuration.blocked_layout ? "On" : "Off") << std::endl;
+			out << "Huge pages = " << (running_configuration.huge_pages ? "On" : "Off") << std::endl;
+			out << "Prefetch queue depth = " << running_configuration.prefetch_queue_depth << std::endl;
+			out << "Weight storage = " << ((running_configuration.weight_storage == plain_running_configuration::weight_storage_fp16) ? "fp16" : ((running_configuration.weight_storage == plain_running_configuration::weight_storage_bf16) ? "bf16" : "fp32")) << std::endl;
+			out << "Activation storage = " << ((running_configuration.activation_storage == plain_running_configuration::weight_storage_fp16) ? "fp16" : ((running_configuration.activation_storage == plain_running_configuration::weight_storage_bf16) ? "bf16" : "fp32")) << std::endl;
 
 			return out;
 		}
@@ -29,9 +29,21 @@ namespace nnforge
 		class plain_running_configuration
 		{
 		public:
+			enum weight_storage_type
+			{
+				weight_storage_fp32,
+				weight_storage_fp16,
+				weight_storage_bf16
+			};
+
 			plain_running_configuration(
 				int openmp_thread_count,
-				float max_memory_usage_gigabytes);
+				float max_memory_usage_gigabytes,
+				bool blocked_layout = false,
+				weight_storage_type weight_storage = weight_storage_fp32,
+				bool huge_pages = false,
+				unsigned int prefetch_queue_depth = 1,
+				weight_storage_type activation_storage = weight_storage_fp32);
 
 			unsigned int get_max_entry_count(
 				const buffer_plain_size_configuration& buffers_config,
@@ -39,6 +51,17 @@ namespace nnforge
 
 			float max_memory_usage_gigabytes;
 			int openmp_thread_count;
+			// Testers run chains of layers supporting it in the blocked feature map layout, see blocked_layout_plain
+			bool blocked_layout;
+			// Testers keep the weights of layers supporting it in 16 bits, converting them to fp32 on the fly
+			weight_storage_type weight_storage;
+			// The buffer arenas of the testers and updaters are advised to be backed by transparent huge pages, see buffer_arena_plain
+			bool huge_pages;
+			// Testers and updaters read up to this many chunks of entries ahead on a background thread, see data_reader_prefetcher_plain;
+			// 0 means reading in the calling thread
+			unsigned int prefetch_queue_depth;
+			// Testers keep the activations between the layers in 16 bits, see network_tester_plain; the formats are the ones of the weights
+			weight_storage_type activation_storage;
 
 		private:
 			plain_running_configuration();
@@ -0,0 +1,49 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../nn_types.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// 8-bit representation of the weights of a layer, used by the quantized inference of network_tester_plain
+		// Input neurons are quantized symmetrically with a single scale per layer, weights with a scale per output feature map:
+		// output = sum(input_q * weight_q) * output_scales[output feature map] + biases[output feature map]
+		class quantized_layer_data_plain
+		{
+		public:
+			quantized_layer_data_plain();
+
+			size_t get_size_in_bytes() const;
+
+			// Input neuron value corresponding to 1 in the quantized input
+			float input_scale;
+			// Packed with int8_gemm_plain::pack_weights
+			std::vector<signed char> weights;
+			// input_scale multiplied by the scale of the weights of each output feature map
+			std::vector<float> output_scales;
+			std::vector<float> biases;
+		};
+
+		typedef nnforge_shared_ptr<quantized_layer_data_plain> quantized_layer_data_plain_smart_ptr;
+		typedef nnforge_shared_ptr<const quantized_layer_data_plain> const_quantized_layer_data_plain_smart_ptr;
+	}
+}
@@ -16,10 +16,7 @@
 
 #include "softmax_layer_updater_plain.h"
 
-#ifdef _OPENMP
-#include <omp.h>
-#endif
-
+#include "softmax_plain.h"
 #include "../softmax_layer.h"
 #include "../neural_network_exception.h"
 
@@ -57,53 +54,13 @@ namespace nnforge
 			if (offset_input_entry_id > 0)
 				throw neural_network_exception("softmax_layer_updater_plain is not able to run using offset");
 
-			const unsigned int input_neuron_count = input_configuration_specific.get_neuron_count();
-			const unsigned int input_neuron_count_per_feature_map = input_configuration_specific.get_neuron_count_per_feature_map();
-			const unsigned int feature_map_count = static_cast<unsigned int>(input_configuration_specific.feature_map_count);
-
-			const std::vector<float>::const_iterator input_buffer_it = input_buffer->begin();
-			const std::vector<float>::iterator output_buffer_it = output_buffer->begin();
-
-			const int total_workload = updater_count * input_neuron_count_per_feature_map;
-			const int openmp_thread_count = plain_config->openmp_thread_count;
-			
-			#pragma omp parallel default(none) shared(additional_buffers) num_threads(openmp_thread_count)
-			{
-				int thread_id = 0;
-				#ifdef _OPENMP
-				thread_id = omp_get_thread_num();
-				#endif
-
-				std::vector<float>& local_additional_buffer = *(additional_buffers[thread_id]);
-
-				#pragma omp for schedule(guided)
-				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
-				{
-					int entry_id = workload_id / input_neuron_count_per_feature_map;
-					int neuron_id = workload_id - (entry_id * input_neuron_count_per_feature_map);
-
-					const std::vector<float>::const_iterator in_it = input_buffer_it + (entry_id * input_neuron_count) + neuron_id;
-					const std::vector<float>::iterator out_it = output_buffer_it + (entry_id * input_neuron_count) + neuron_id;
-
-					float max_val = -1.0e+37F;
-					for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
-					{
-						float val = *(in_it + (feature_map_id * input_neuron_count_per_feature_map));
-						max_val = std::max(max_val, val);
-					}
-
-					float sum = 0.0F;
-					for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
-					{
-						float val = expf((*(in_it + (feature_map_id * input_neuron_count_per_feature_map))) - max_val);
-						sum += val;
-						local_additional_buffer[feature_map_id] = val;
-					}
-					float mult = 1.0F / sum;
-					for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
-						*(out_it + (feature_map_id * input_neuron_count_per_feature_map)) = local_additional_buffer[feature_map_id] * mult;
-				} // for(int workload_id
-			} // #pragma parallel
+			softmax_plain::forward(
+				&(*input_buffer->begin()),
+				&(*output_buffer->begin()),
+				input_configuration_specific.feature_map_count,
+				input_configuration_specific.get_neuron_count_per_feature_map(),
+				updater_count,
+				plain_config->openmp_thread_count);
 		}
 
 		void softmax_layer_updater_plain::backprop(
@@ -121,68 +78,18 @@ namespace nnforge
 			unsigned int updater_count,
 			bool force_deterministic) const
 		{
-			const unsigned int input_neuron_count = input_configuration_specific.get_neuron_count();
-			const unsigned int input_neuron_count_per_feature_map = input_configuration_specific.get_neuron_count_per_feature_map();
-			const unsigned int feature_map_count = static_cast<unsigned int>(input_configuration_specific.feature_map_count);
-
-			const std::vector<float>::iterator input_errors_it = input_errors->begin();
-			const std::vector<float>::const_iterator output_errors_it = output_errors->begin();
-			const std::vector<float>::const_iterator output_neurons_it = output_neurons->begin();
-
-			const int total_workload = updater_count * input_neuron_count_per_feature_map;
-			const int openmp_thread_count = plain_config->openmp_thread_count;
-			
-			#pragma omp parallel default(none) shared(additional_buffers) num_threads(openmp_thread_count)
-			{
-				int thread_id = 0;
-				#ifdef _OPENMP
-				thread_id = omp_get_thread_num();
-				#endif
-
-				#pragma omp for schedule(guided)
-				for(int workload_id = 0; workload_id < total_workload; ++workload_id)
-				{
-					int entry_id = workload_id / input_neuron_count_per_feature_map;
-					int neuron_id = workload_id - (entry_id * input_neuron_count_per_feature_map);
-
-					const std::vector<float>::iterator in_errors_it = input_errors_it + (entry_id * input_neuron_count) + neuron_id;
-					const std::vector<float>::const_iterator out_errors_it = output_errors_it + (entry_id * input_neuron_count) + neuron_id;
-					const std::vector<float>::const_iterator out_neurons_it = output_neurons_it + (entry_id * input_neuron_count) + neuron_id;
-
-					float sum = 0.0F;
-					for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
-					{
-						unsigned int offset = feature_map_id * input_neuron_count_per_feature_map;
-						sum += (*(out_errors_it + offset)) * (*(out_neurons_it + offset));
-					}
-
-					for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
-					{
-						unsigned int offset = feature_map_id * input_neuron_count_per_feature_map;
-						*(in_errors_it + offset) = (*(out_neurons_it + offset)) * (*(out_errors_it + offset) - sum);
-					}
-				} // for(int workload_id
-			} // #pragma parallel
+			softmax_plain::backprop(
+				&(*input_errors->begin()),
+				&(*output_neurons->begin()),
+				input_configuration_specific.feature_map_count,
+				input_configuration_specific.get_neuron_count_per_feature_map(),
+				updater_count,
+				plain_config->openmp_thread_count);
 		}
 
 		bool softmax_layer_updater_plain::is_in_place_backprop() const
 		{
 			return true;
 		}
-
-		std::vector<std::pair<unsigned int, bool> > softmax_layer_updater_plain::get_elem_count_and_per_entry_flag_additional_buffers(
-			const_layer_smart_ptr layer_schema,
-			const layer_configuration_specific& input_configuration_specific,
-			const layer_configuration_specific& output_configuration_specific,
-			plain_running_configuration_const_smart_ptr plain_config,
-			bool backprop_required) const
-		{
-			std::vector<std::pair<unsigned int, bool> > res;
-
-			for(int i = 0; i < plain_config->openmp_thread_count; ++i)
-				res.push_back(std::make_pair(input_configuration_specific.feature_map_count, false));
-
-			return res;
-		}
 	}
 }
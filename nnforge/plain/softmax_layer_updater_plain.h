@@ -62,13 +62,6 @@ namespace nnforge
 
 		protected:
 			virtual bool is_in_place_backprop() const;
-
-			virtual std::vector<std::pair<unsigned int, bool> > get_elem_count_and_per_entry_flag_additional_buffers(
-				const_layer_smart_ptr layer_schema,
-				const layer_configuration_specific& input_configuration_specific,
-				const layer_configuration_specific& output_configuration_specific,
-				plain_running_configuration_const_smart_ptr plain_config,
-				bool backprop_required) const;
 		};
 	}
 }
@@ -0,0 +1,200 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "softmax_plain.h"
+
+#include "instruction_set_plain.h"
+
+#include <algorithm>
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define NNFORGE_PLAIN_TARGET_PRAGMAS
+#endif
+
+namespace nnforge
+{
+	namespace plain
+	{
+		namespace softmax_sse2
+		{
+			#include "softmax_plain_kernels.h"
+		}
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+		namespace softmax_avx2
+		{
+			#include "softmax_plain_kernels.h"
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+#endif
+		namespace softmax_avx512
+		{
+			#include "softmax_plain_kernels.h"
+		}
+#ifdef NNFORGE_PLAIN_TARGET_PRAGMAS
+#pragma GCC pop_options
+#endif
+
+		const unsigned int softmax_plain::block_size;
+
+		void softmax_plain::forward(
+			const float * input,
+			float * output,
+			unsigned int feature_map_count,
+			unsigned int neuron_count_per_feature_map,
+			unsigned int entry_count,
+			int thread_count)
+		{
+			const unsigned int neuron_count = feature_map_count * neuron_count_per_feature_map;
+
+			if (neuron_count_per_feature_map == 1)
+			{
+				const forward_contiguous_function forward_contiguous = get_forward_contiguous();
+				const int total_workload = static_cast<int>(entry_count);
+
+				#pragma omp parallel for default(none) schedule(guided) num_threads(thread_count) shared(input,output,feature_map_count,neuron_count_per_feature_map)
+				for(int entry_id = 0; entry_id < total_workload; ++entry_id)
+					forward_contiguous(input + entry_id * neuron_count, output + entry_id * neuron_count, feature_map_count);
+
+				return;
+			}
+
+			const forward_block_function forward_block = get_forward_block();
+			const unsigned int block_count = (neuron_count_per_feature_map + block_size - 1) / block_size;
+			const int total_workload = static_cast<int>(entry_count * block_count);
+
+			#pragma omp parallel for default(none) schedule(guided) num_threads(thread_count) shared(input,output,feature_map_count,neuron_count_per_feature_map)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				int entry_id = workload_id / block_count;
+				int block_id = workload_id - (entry_id * block_count);
+				unsigned int position_start = block_id * block_size;
+				unsigned int offset = entry_id * neuron_count + position_start;
+
+				forward_block(
+					input + offset,
+					output + offset,
+					feature_map_count,
+					neuron_count_per_feature_map,
+					std::min(block_size, neuron_count_per_feature_map - position_start));
+			}
+		}
+
+		void softmax_plain::backprop(
+			float * errors,
+			const float * output_neurons,
+			unsigned int feature_map_count,
+			unsigned int neuron_count_per_feature_map,
+			unsigned int entry_count,
+			int thread_count)
+		{
+			const unsigned int neuron_count = feature_map_count * neuron_count_per_feature_map;
+
+			if (neuron_count_per_feature_map == 1)
+			{
+				const backprop_contiguous_function backprop_contiguous = get_backprop_contiguous();
+				const int total_workload = static_cast<int>(entry_count);
+
+				#pragma omp parallel for default(none) schedule(guided) num_threads(thread_count) shared(errors,output_neurons,feature_map_count,neuron_count_per_feature_map)
+				for(int entry_id = 0; entry_id < total_workload; ++entry_id)
+					backprop_contiguous(errors + entry_id * neuron_count, output_neurons + entry_id * neuron_count, feature_map_count);
+
+				return;
+			}
+
+			const backprop_block_function backprop_block = get_backprop_block();
+			const unsigned int block_count = (neuron_count_per_feature_map + block_size - 1) / block_size;
+			const int total_workload = static_cast<int>(entry_count * block_count);
+
+			#pragma omp parallel for default(none) schedule(guided) num_threads(thread_count) shared(errors,output_neurons,feature_map_count,neuron_count_per_feature_map)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				int entry_id = workload_id / block_count;
+				int block_id = workload_id - (entry_id * block_count);
+				unsigned int position_start = block_id * block_size;
+				unsigned int offset = entry_id * neuron_count + position_start;
+
+				backprop_block(
+					errors + offset,
+					output_neurons + offset,
+					feature_map_count,
+					neuron_count_per_feature_map,
+					std::min(block_size, neuron_count_per_feature_map - position_start));
+			}
+		}
+
+		softmax_plain::forward_block_function softmax_plain::get_forward_block()
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				return softmax_avx512::forward_block;
+			case instruction_set_plain::instruction_set_avx2:
+				return softmax_avx2::forward_block;
+			default:
+				return softmax_sse2::forward_block;
+			}
+		}
+
+		softmax_plain::forward_contiguous_function softmax_plain::get_forward_contiguous()
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				return softmax_avx512::forward_contiguous;
+			case instruction_set_plain::instruction_set_avx2:
+				return softmax_avx2::forward_contiguous;
+			default:
+				return softmax_sse2::forward_contiguous;
+			}
+		}
+
+		softmax_plain::backprop_block_function softmax_plain::get_backprop_block()
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				return softmax_avx512::backprop_block;
+			case instruction_set_plain::instruction_set_avx2:
+				return softmax_avx2::backprop_block;
+			default:
+				return softmax_sse2::backprop_block;
+			}
+		}
+
+		softmax_plain::backprop_contiguous_function softmax_plain::get_backprop_contiguous()
+		{
+			switch (instruction_set_plain::get_instruction_set())
+			{
+			case instruction_set_plain::instruction_set_avx512:
+				return softmax_avx512::backprop_contiguous;
+			case instruction_set_plain::instruction_set_avx2:
+				return softmax_avx2::backprop_contiguous;
+			default:
+				return softmax_sse2::backprop_contiguous;
+			}
+		}
+	}
+}
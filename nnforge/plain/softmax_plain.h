@@ -0,0 +1,66 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Softmax across feature maps, vectorized for SSE2, AVX2 and AVX-512, the variant is picked at runtime
+		// with instruction_set_plain. Each entry is split into blocks of block_size contiguous spatial positions,
+		// max, exp and sum are computed across feature maps for the whole block at once.
+		// Entries with a single position per feature map are processed as contiguous vectors instead
+		class softmax_plain
+		{
+		public:
+			// output might be the same as input
+			static void forward(
+				const float * input,
+				float * output,
+				unsigned int feature_map_count,
+				unsigned int neuron_count_per_feature_map,
+				unsigned int entry_count,
+				int thread_count);
+
+			// errors are output errors on entry and input errors on exit
+			static void backprop(
+				float * errors,
+				const float * output_neurons,
+				unsigned int feature_map_count,
+				unsigned int neuron_count_per_feature_map,
+				unsigned int entry_count,
+				int thread_count);
+
+			// Number of spatial positions processed together
+			static const unsigned int block_size = 64;
+
+		private:
+			softmax_plain();
+			~softmax_plain();
+
+			typedef void (*forward_block_function)(const float *, float *, unsigned int, unsigned int, unsigned int);
+			typedef void (*forward_contiguous_function)(const float *, float *, unsigned int);
+			typedef void (*backprop_block_function)(float *, const float *, unsigned int, unsigned int, unsigned int);
+			typedef void (*backprop_contiguous_function)(float *, const float *, unsigned int);
+
+			static forward_block_function get_forward_block();
+			static forward_contiguous_function get_forward_contiguous();
+			static backprop_block_function get_backprop_block();
+			static backprop_contiguous_function get_backprop_contiguous();
+		};
+	}
+}
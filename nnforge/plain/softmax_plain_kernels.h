@@ -0,0 +1,135 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// Bodies of the softmax kernels, there is no include guard on purpose:
+// softmax_plain.cpp includes this file once per instruction set, each time within its own namespace and target options.
+// Spatial positions are the inner loops, so that the compiler vectorizes across them for the current target.
+
+#include "math_plain_kernels.h"
+
+// Softmax across feature_map_count feature maps for position_count (up to softmax_plain::block_size) contiguous positions,
+// feature maps are feature_map_stride elements apart. output might be the same as input
+void forward_block(
+	const float * input,
+	float * output,
+	unsigned int feature_map_count,
+	unsigned int feature_map_stride,
+	unsigned int position_count)
+{
+	float max_vals[softmax_plain::block_size];
+	float sums[softmax_plain::block_size];
+
+	for(unsigned int i = 0; i < position_count; ++i)
+		max_vals[i] = input[i];
+	for(unsigned int feature_map_id = 1; feature_map_id < feature_map_count; ++feature_map_id)
+	{
+		const float * in = input + feature_map_id * feature_map_stride;
+		for(unsigned int i = 0; i < position_count; ++i)
+		{
+			float val = in[i];
+			float max_val = max_vals[i];
+			max_vals[i] = (val > max_val) ? val : max_val;
+		}
+	}
+
+	for(unsigned int i = 0; i < position_count; ++i)
+		sums[i] = 0.0F;
+	for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
+	{
+		const float * in = input + feature_map_id * feature_map_stride;
+		float * out = output + feature_map_id * feature_map_stride;
+		for(unsigned int i = 0; i < position_count; ++i)
+		{
+			float val = exp_approx(in[i] - max_vals[i]);
+			out[i] = val;
+			sums[i] += val;
+		}
+	}
+
+	for(unsigned int i = 0; i < position_count; ++i)
+		sums[i] = 1.0F / sums[i];
+	for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
+	{
+		float * out = output + feature_map_id * feature_map_stride;
+		for(unsigned int i = 0; i < position_count; ++i)
+			out[i] *= sums[i];
+	}
+}
+
+// Softmax across elem_count contiguous values, used when there is a single position per feature map
+void forward_contiguous(
+	const float * input,
+	float * output,
+	unsigned int elem_count)
+{
+	float max_val = input[0];
+	for(unsigned int i = 1; i < elem_count; ++i)
+		max_val = std::max(max_val, input[i]);
+
+	float sum = 0.0F;
+	for(unsigned int i = 0; i < elem_count; ++i)
+	{
+		float val = exp_approx(input[i] - max_val);
+		output[i] = val;
+		sum += val;
+	}
+
+	float mult = 1.0F / sum;
+	for(unsigned int i = 0; i < elem_count; ++i)
+		output[i] *= mult;
+}
+
+// errors are output errors on entry and input errors on exit
+void backprop_block(
+	float * errors,
+	const float * output_neurons,
+	unsigned int feature_map_count,
+	unsigned int feature_map_stride,
+	unsigned int position_count)
+{
+	float sums[softmax_plain::block_size];
+
+	for(unsigned int i = 0; i < position_count; ++i)
+		sums[i] = 0.0F;
+	for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
+	{
+		const float * err = errors + feature_map_id * feature_map_stride;
+		const float * out = output_neurons + feature_map_id * feature_map_stride;
+		for(unsigned int i = 0; i < position_count; ++i)
+			sums[i] += err[i] * out[i];
+	}
+
+	for(unsigned int feature_map_id = 0; feature_map_id < feature_map_count; ++feature_map_id)
+	{
+		float * err = errors + feature_map_id * feature_map_stride;
+		const float * out = output_neurons + feature_map_id * feature_map_stride;
+		for(unsigned int i = 0; i < position_count; ++i)
+			err[i] = out[i] * (err[i] - sums[i]);
+	}
+}
+
+void backprop_contiguous(
+	float * errors,
+	const float * output_neurons,
+	unsigned int elem_count)
+{
+	float sum = 0.0F;
+	for(unsigned int i = 0; i < elem_count; ++i)
+		sum += errors[i] * output_neurons[i];
+
+	for(unsigned int i = 0; i < elem_count; ++i)
+		errors[i] = output_neurons[i] * (errors[i] - sum);
+}
@@ -42,9 +42,14 @@ namespace nnforge
 				const layer_configuration_specific& output_configuration_specific,
 				unsigned int entry_count) const;
 
-			virtual additional_buffer_smart_ptr get_output_buffer(
-				additional_buffer_smart_ptr input_buffer,
-				additional_buffer_set& additional_buffers) const;
+			virtual bool is_in_place() const;
+
+			virtual const_layer_data_custom_smart_ptr get_data_custom(
+				const_layer_data_custom_smart_ptr host_data_custom,
+				const_layer_smart_ptr layer_schema,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific,
+				plain_running_configuration_const_smart_ptr plain_config) const;
 
 		protected:
 			virtual std::vector<std::pair<unsigned int, bool> > get_elem_count_and_per_entry_flag_additional_buffers(
@@ -52,9 +57,6 @@ namespace nnforge
 				const layer_configuration_specific& input_configuration_specific,
 				const layer_configuration_specific& output_configuration_specific,
 				plain_running_configuration_const_smart_ptr plain_config) const;
-
-		private:
-			static const int max_dimension_count;
 		};
 	}
 }
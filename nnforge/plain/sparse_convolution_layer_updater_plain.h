@@ -76,9 +76,6 @@ namespace nnforge
 
 		protected:
 			virtual bool is_in_place_backprop() const;
-
-		private:
-			static const int max_dimension_count;
 		};
 	}
 }
@@ -0,0 +1,385 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "sparse_convolution_plain.h"
+
+#include <algorithm>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		const unsigned int sparse_convolution_plain::output_feature_map_block_size;
+		const int sparse_convolution_plain::max_dimension_count;
+
+		sparse_convolution_plain::sparse_convolution_plain(
+			const std::vector<unsigned int>& window_sizes,
+			const std::vector<unsigned int>& left_zero_padding,
+			const std::vector<unsigned int>& strides,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+			: input_feature_map_count(input_configuration_specific.feature_map_count)
+			, output_feature_map_count(output_configuration_specific.feature_map_count)
+			, input_neuron_count_per_feature_map(input_configuration_specific.get_neuron_count_per_feature_map())
+			, output_neuron_count_per_feature_map(output_configuration_specific.get_neuron_count_per_feature_map())
+		{
+			const unsigned int dimension_count = static_cast<unsigned int>(window_sizes.size());
+			int window_sizes_extended[max_dimension_count];
+			int left_zero_padding_extended[max_dimension_count];
+			int strides_extended[max_dimension_count];
+			int input_dimension_sizes[max_dimension_count];
+			int output_dimension_sizes[max_dimension_count];
+			int input_slices[max_dimension_count];
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+			{
+				window_sizes_extended[i] = (i < dimension_count) ? static_cast<int>(window_sizes[i]) : 1;
+				left_zero_padding_extended[i] = (i < dimension_count) ? static_cast<int>(left_zero_padding[i]) : 0;
+				strides_extended[i] = (i < dimension_count) ? static_cast<int>(strides[i]) : 1;
+				input_dimension_sizes[i] = (i < dimension_count) ? static_cast<int>(input_configuration_specific.dimension_sizes[i]) : 1;
+				output_dimension_sizes[i] = (i < dimension_count) ? static_cast<int>(output_configuration_specific.dimension_sizes[i]) : 1;
+				input_slices[i] = (i == 0) ? 1 : input_slices[i - 1] * input_dimension_sizes[i - 1];
+			}
+
+			window_elem_count = 1;
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+				window_elem_count *= window_sizes_extended[i];
+			window_width = window_sizes_extended[0];
+			window_row_count = window_elem_count / window_width;
+			output_width = output_dimension_sizes[0];
+			output_row_count = output_neuron_count_per_feature_map / output_width;
+			stride_x = strides_extended[0];
+
+			input_row_offsets.resize(output_row_count * window_row_count);
+			for(unsigned int output_row_id = 0; output_row_id < output_row_count; ++output_row_id)
+			{
+				int output_position[max_dimension_count];
+				unsigned int remainder = output_row_id;
+				for(unsigned int i = 1; i < max_dimension_count; ++i)
+				{
+					output_position[i] = remainder % output_dimension_sizes[i];
+					remainder /= output_dimension_sizes[i];
+				}
+
+				for(unsigned int window_row_id = 0; window_row_id < window_row_count; ++window_row_id)
+				{
+					int offset = 0;
+					unsigned int window_remainder = window_row_id;
+					for(unsigned int i = 1; i < max_dimension_count; ++i)
+					{
+						int input_position = output_position[i] * strides_extended[i] + static_cast<int>(window_remainder % window_sizes_extended[i]) - left_zero_padding_extended[i];
+						window_remainder /= window_sizes_extended[i];
+						if ((input_position < 0) || (input_position >= input_dimension_sizes[i]))
+						{
+							offset = -1;
+							break;
+						}
+						offset += input_position * input_slices[i];
+					}
+					input_row_offsets[output_row_id * window_row_count + window_row_id] = offset;
+				}
+			}
+
+			x_offsets.resize(window_width);
+			x_starts.resize(window_width);
+			x_ends.resize(window_width);
+			for(unsigned int window_x = 0; window_x < window_width; ++window_x)
+			{
+				int x_offset = static_cast<int>(window_x) - left_zero_padding_extended[0];
+				x_offsets[window_x] = x_offset;
+				x_starts[window_x] = std::max(0, (stride_x - 1 - x_offset) / stride_x);
+				x_ends[window_x] = std::max(x_starts[window_x], std::min(output_dimension_sizes[0], (input_dimension_sizes[0] - x_offset + stride_x - 1) / stride_x));
+			}
+		}
+
+		void sparse_convolution_plain::fill_blocked_connections(
+			const int * column_indices,
+			const int * row_indices,
+			std::vector<int>& block_row_indices,
+			std::vector<int>& block_input_feature_maps,
+			std::vector<int>& block_column_indices) const
+		{
+			const unsigned int block_count = (output_feature_map_count + output_feature_map_block_size - 1) / output_feature_map_block_size;
+			block_row_indices.resize(block_count + 1);
+			block_input_feature_maps.clear();
+			block_column_indices.clear();
+
+			std::vector<int> column_index_list(input_feature_map_count * output_feature_map_block_size);
+			for(unsigned int block_id = 0; block_id < block_count; ++block_id)
+			{
+				block_row_indices[block_id] = static_cast<int>(block_input_feature_maps.size());
+
+				std::fill(column_index_list.begin(), column_index_list.end(), -1);
+				const unsigned int output_feature_map_start = block_id * output_feature_map_block_size;
+				const unsigned int current_block_size = std::min(output_feature_map_block_size, output_feature_map_count - output_feature_map_start);
+				for(unsigned int i = 0; i < current_block_size; ++i)
+					for(int column_index = row_indices[output_feature_map_start + i]; column_index < row_indices[output_feature_map_start + i + 1]; ++column_index)
+						column_index_list[column_indices[column_index] * output_feature_map_block_size + i] = column_index;
+
+				// Input feature maps in ascending order, so that the block walks the input of the entry sequentially
+				for(unsigned int input_feature_map_id = 0; input_feature_map_id < input_feature_map_count; ++input_feature_map_id)
+				{
+					std::vector<int>::const_iterator it = column_index_list.begin() + input_feature_map_id * output_feature_map_block_size;
+					if (std::count(it, it + output_feature_map_block_size, -1) == static_cast<int>(output_feature_map_block_size))
+						continue;
+
+					block_input_feature_maps.push_back(static_cast<int>(input_feature_map_id));
+					block_column_indices.insert(block_column_indices.end(), it, it + output_feature_map_block_size);
+				}
+			}
+			block_row_indices[block_count] = static_cast<int>(block_input_feature_maps.size());
+		}
+
+		void sparse_convolution_plain::forward(
+			const float * input,
+			float * output,
+			const float * weights,
+			const float * biases,
+			const int * block_row_indices,
+			const int * block_input_feature_maps,
+			const int * block_column_indices,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const unsigned int input_neuron_count = input_feature_map_count * input_neuron_count_per_feature_map;
+			const unsigned int output_neuron_count = output_feature_map_count * output_neuron_count_per_feature_map;
+			const unsigned int block_count = (output_feature_map_count + output_feature_map_block_size - 1) / output_feature_map_block_size;
+			const int total_workload = static_cast<int>(entry_count * block_count);
+			const int * const input_row_offsets_it = &(*input_row_offsets.begin());
+			const int * const x_offsets_it = &(*x_offsets.begin());
+			const int * const x_starts_it = &(*x_starts.begin());
+			const int * const x_ends_it = &(*x_ends.begin());
+
+			#pragma omp parallel for default(none) schedule(dynamic) num_threads(thread_count) shared(input,output,weights,biases,block_row_indices,block_input_feature_maps,block_column_indices)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				int entry_id = workload_id / block_count;
+				int block_id = workload_id - (entry_id * block_count);
+				const unsigned int output_feature_map_start = block_id * output_feature_map_block_size;
+				const unsigned int current_block_size = std::min(output_feature_map_block_size, output_feature_map_count - output_feature_map_start);
+				const float * in_it_base = input + entry_id * input_neuron_count;
+				float * out_it_base = output + entry_id * output_neuron_count + output_feature_map_start * output_neuron_count_per_feature_map;
+
+				for(unsigned int output_row_id = 0; output_row_id < output_row_count; ++output_row_id)
+				{
+					const int * current_input_row_offsets = input_row_offsets_it + output_row_id * window_row_count;
+					float * out_row_base = out_it_base + output_row_id * output_width;
+					for(unsigned int i = 0; i < current_block_size; ++i)
+						std::fill_n(out_row_base + i * output_neuron_count_per_feature_map, output_width, biases[output_feature_map_start + i]);
+
+					for(int block_column_id = block_row_indices[block_id]; block_column_id < block_row_indices[block_id + 1]; ++block_column_id)
+					{
+						const float * in_fm_base = in_it_base + block_input_feature_maps[block_column_id] * input_neuron_count_per_feature_map;
+						for(unsigned int i = 0; i < current_block_size; ++i)
+						{
+							int column_index = block_column_indices[block_column_id * output_feature_map_block_size + i];
+							if (column_index < 0)
+								continue;
+
+							float * out_row = out_row_base + i * output_neuron_count_per_feature_map;
+							const float * weights_it = weights + column_index * window_elem_count;
+							for(unsigned int window_row_id = 0; window_row_id < window_row_count; ++window_row_id, weights_it += window_width)
+							{
+								int input_row_offset = current_input_row_offsets[window_row_id];
+								if (input_row_offset < 0)
+									continue;
+
+								const float * in_row = in_fm_base + input_row_offset;
+								for(unsigned int window_x = 0; window_x < window_width; ++window_x)
+								{
+									const float weight = weights_it[window_x];
+									const int x_start = x_starts_it[window_x];
+									const int x_count = x_ends_it[window_x] - x_start;
+									const float * in_row_shifted = in_row + (x_start * stride_x + x_offsets_it[window_x]);
+									float * out_row_shifted = out_row + x_start;
+									if (stride_x == 1)
+									{
+										for(int x = 0; x < x_count; ++x)
+											out_row_shifted[x] += weight * in_row_shifted[x];
+									}
+									else
+									{
+										for(int x = 0; x < x_count; ++x)
+											out_row_shifted[x] += weight * in_row_shifted[x * stride_x];
+									}
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		void sparse_convolution_plain::backprop(
+			const float * output_errors,
+			float * input_errors,
+			const float * weights,
+			const int * column_indices,
+			const int * row_indices,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			// Transposed connection lists: output feature map and connection index for each input feature map
+			std::vector<int> input_row_indices(input_feature_map_count + 1, 0);
+			for(int column_index = 0; column_index < row_indices[output_feature_map_count]; ++column_index)
+				++input_row_indices[column_indices[column_index] + 1];
+			for(unsigned int i = 0; i < input_feature_map_count; ++i)
+				input_row_indices[i + 1] += input_row_indices[i];
+			std::vector<std::pair<int, int> > output_feature_map_column_index_list(row_indices[output_feature_map_count]);
+			{
+				std::vector<int> current_positions(input_row_indices.begin(), input_row_indices.end() - 1);
+				for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+					for(int column_index = row_indices[output_feature_map_id]; column_index < row_indices[output_feature_map_id + 1]; ++column_index)
+						output_feature_map_column_index_list[current_positions[column_indices[column_index]]++] = std::make_pair(static_cast<int>(output_feature_map_id), column_index);
+			}
+
+			const unsigned int input_neuron_count = input_feature_map_count * input_neuron_count_per_feature_map;
+			const unsigned int output_neuron_count = output_feature_map_count * output_neuron_count_per_feature_map;
+			const int total_workload = static_cast<int>(entry_count * input_feature_map_count);
+			const int * const input_row_offsets_it = &(*input_row_offsets.begin());
+			const int * const x_offsets_it = &(*x_offsets.begin());
+			const int * const x_starts_it = &(*x_starts.begin());
+			const int * const x_ends_it = &(*x_ends.begin());
+			const int * const input_row_indices_it = &(*input_row_indices.begin());
+			const std::pair<int, int> * const output_feature_map_column_index_it = output_feature_map_column_index_list.empty() ? 0 : &(*output_feature_map_column_index_list.begin());
+
+			#pragma omp parallel for default(none) schedule(dynamic) num_threads(thread_count) shared(output_errors,input_errors,weights)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				int entry_id = workload_id / input_feature_map_count;
+				int input_feature_map_id = workload_id - (entry_id * input_feature_map_count);
+				float * in_err_fm_base = input_errors + entry_id * input_neuron_count + input_feature_map_id * input_neuron_count_per_feature_map;
+				const float * out_err_it_base = output_errors + entry_id * output_neuron_count;
+
+				std::fill_n(in_err_fm_base, input_neuron_count_per_feature_map, 0.0F);
+
+				for(unsigned int output_row_id = 0; output_row_id < output_row_count; ++output_row_id)
+				{
+					const int * current_input_row_offsets = input_row_offsets_it + output_row_id * window_row_count;
+					for(int i = input_row_indices_it[input_feature_map_id]; i < input_row_indices_it[input_feature_map_id + 1]; ++i)
+					{
+						const float * out_err_row = out_err_it_base + output_feature_map_column_index_it[i].first * output_neuron_count_per_feature_map + output_row_id * output_width;
+						const float * weights_it = weights + output_feature_map_column_index_it[i].second * window_elem_count;
+						for(unsigned int window_row_id = 0; window_row_id < window_row_count; ++window_row_id, weights_it += window_width)
+						{
+							int input_row_offset = current_input_row_offsets[window_row_id];
+							if (input_row_offset < 0)
+								continue;
+
+							float * in_err_row = in_err_fm_base + input_row_offset;
+							for(unsigned int window_x = 0; window_x < window_width; ++window_x)
+							{
+								const float weight = weights_it[window_x];
+								const int x_start = x_starts_it[window_x];
+								const int x_count = x_ends_it[window_x] - x_start;
+								float * in_err_row_shifted = in_err_row + (x_start * stride_x + x_offsets_it[window_x]);
+								const float * out_err_row_shifted = out_err_row + x_start;
+								if (stride_x == 1)
+								{
+									for(int x = 0; x < x_count; ++x)
+										in_err_row_shifted[x] += weight * out_err_row_shifted[x];
+								}
+								else
+								{
+									for(int x = 0; x < x_count; ++x)
+										in_err_row_shifted[x * stride_x] += weight * out_err_row_shifted[x];
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		void sparse_convolution_plain::update_weights(
+			const float * input,
+			const float * output_errors,
+			float * gradient_weights,
+			const int * column_indices,
+			const int * row_indices,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			std::vector<int> output_feature_map_list(row_indices[output_feature_map_count]);
+			for(unsigned int output_feature_map_id = 0; output_feature_map_id < output_feature_map_count; ++output_feature_map_id)
+				std::fill(output_feature_map_list.begin() + row_indices[output_feature_map_id], output_feature_map_list.begin() + row_indices[output_feature_map_id + 1], static_cast<int>(output_feature_map_id));
+
+			const unsigned int input_neuron_count = input_feature_map_count * input_neuron_count_per_feature_map;
+			const unsigned int output_neuron_count = output_feature_map_count * output_neuron_count_per_feature_map;
+			const int total_workload = row_indices[output_feature_map_count];
+			const int * const input_row_offsets_it = &(*input_row_offsets.begin());
+			const int * const x_offsets_it = &(*x_offsets.begin());
+			const int * const x_starts_it = &(*x_starts.begin());
+			const int * const x_ends_it = &(*x_ends.begin());
+			const int * const output_feature_map_it = output_feature_map_list.empty() ? 0 : &(*output_feature_map_list.begin());
+
+			#pragma omp parallel default(none) num_threads(thread_count) shared(input,output_errors,gradient_weights,column_indices,entry_count)
+			{
+				std::vector<float> weights_local(window_elem_count);
+
+				#pragma omp for schedule(dynamic)
+				for(int column_index = 0; column_index < total_workload; ++column_index)
+				{
+					const int output_feature_map_id = output_feature_map_it[column_index];
+					const int input_feature_map_id = column_indices[column_index];
+					std::fill(weights_local.begin(), weights_local.end(), 0.0F);
+
+					for(unsigned int entry_id = 0; entry_id < entry_count; ++entry_id)
+					{
+						const float * in_fm_base = input + entry_id * input_neuron_count + input_feature_map_id * input_neuron_count_per_feature_map;
+						const float * out_err_fm_base = output_errors + entry_id * output_neuron_count + output_feature_map_id * output_neuron_count_per_feature_map;
+						for(unsigned int output_row_id = 0; output_row_id < output_row_count; ++output_row_id)
+						{
+							const int * current_input_row_offsets = input_row_offsets_it + output_row_id * window_row_count;
+							const float * out_err_row = out_err_fm_base + output_row_id * output_width;
+							float * weights_local_it = &(*weights_local.begin());
+							for(unsigned int window_row_id = 0; window_row_id < window_row_count; ++window_row_id, weights_local_it += window_width)
+							{
+								int input_row_offset = current_input_row_offsets[window_row_id];
+								if (input_row_offset < 0)
+									continue;
+
+								const float * in_row = in_fm_base + input_row_offset;
+								for(unsigned int window_x = 0; window_x < window_width; ++window_x)
+								{
+									const int x_start = x_starts_it[window_x];
+									const int x_count = x_ends_it[window_x] - x_start;
+									const float * in_row_shifted = in_row + (x_start * stride_x + x_offsets_it[window_x]);
+									const float * out_err_row_shifted = out_err_row + x_start;
+									float sum = 0.0F;
+									if (stride_x == 1)
+									{
+										for(int x = 0; x < x_count; ++x)
+											sum += in_row_shifted[x] * out_err_row_shifted[x];
+									}
+									else
+									{
+										for(int x = 0; x < x_count; ++x)
+											sum += in_row_shifted[x * stride_x] * out_err_row_shifted[x];
+									}
+									weights_local_it[window_x] += sum;
+								}
+							}
+						}
+					}
+
+					float * gradient_weights_it = gradient_weights + column_index * window_elem_count;
+					for(unsigned int i = 0; i < window_elem_count; ++i)
+						gradient_weights_it[i] += weights_local[i];
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,109 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../layer_configuration_specific.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Sparse convolution computed row by row: for each connection and each window element the contribution
+		// to the whole output row is a single multiply-add over contiguous spatial positions, which is vectorized,
+		// the bounds are checked once per row instead of once per window element
+		// Forward pass runs over blocked CSR: output feature maps are grouped into blocks of output_feature_map_block_size,
+		// each input feature map connected to the block is visited once for all the output feature maps of the block
+		class sparse_convolution_plain
+		{
+		public:
+			sparse_convolution_plain(
+				const std::vector<unsigned int>& window_sizes,
+				const std::vector<unsigned int>& left_zero_padding,
+				const std::vector<unsigned int>& strides,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific);
+
+			// Builds blocked CSR from the CSR of the layer (column_indices, row_indices):
+			// block_row_indices - offsets into block_input_feature_maps for each block, block_count + 1 elements
+			// block_input_feature_maps - sorted input feature maps connected to at least one output feature map of the block
+			// block_column_indices - output_feature_map_block_size connection indices for each element of block_input_feature_maps, -1 if not connected
+			void fill_blocked_connections(
+				const int * column_indices,
+				const int * row_indices,
+				std::vector<int>& block_row_indices,
+				std::vector<int>& block_input_feature_maps,
+				std::vector<int>& block_column_indices) const;
+
+			void forward(
+				const float * input,
+				float * output,
+				const float * weights,
+				const float * biases,
+				const int * block_row_indices,
+				const int * block_input_feature_maps,
+				const int * block_column_indices,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// Input errors are overwritten
+			void backprop(
+				const float * output_errors,
+				float * input_errors,
+				const float * weights,
+				const int * column_indices,
+				const int * row_indices,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// Gradient is added to gradient_weights, biases are not touched
+			void update_weights(
+				const float * input,
+				const float * output_errors,
+				float * gradient_weights,
+				const int * column_indices,
+				const int * row_indices,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			static const unsigned int output_feature_map_block_size = 4;
+
+		private:
+			static const int max_dimension_count = 4;
+
+			unsigned int input_feature_map_count;
+			unsigned int output_feature_map_count;
+			unsigned int input_neuron_count_per_feature_map;
+			unsigned int output_neuron_count_per_feature_map;
+			unsigned int window_elem_count;
+			unsigned int window_width;
+			unsigned int window_row_count;
+			unsigned int output_width;
+			unsigned int output_row_count;
+			int stride_x;
+
+			// Offset of the input row for each (output row, window row) pair, -1 if the row is in the padding area
+			std::vector<int> input_row_offsets;
+			// Horizontal offset of the input and the range of valid output positions for each window column,
+			// output position x reads input position x * stride_x + x_offset
+			std::vector<int> x_offsets;
+			std::vector<int> x_starts;
+			std::vector<int> x_ends;
+		};
+	}
+}
@@ -0,0 +1,328 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "subsampling_plain.h"
+
+#include "../nn_types.h"
+
+#include <array>
+#include <algorithm>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		const int subsampling_plain::max_dimension_count;
+
+		subsampling_plain::subsampling_plain(
+			const std::vector<unsigned int>& subsampling_sizes,
+			const layer_configuration_specific& input_configuration_specific,
+			const layer_configuration_specific& output_configuration_specific)
+			: dimension_count(static_cast<unsigned int>(subsampling_sizes.size()))
+			, feature_map_count(output_configuration_specific.feature_map_count)
+			, input_neuron_count_per_feature_map(input_configuration_specific.get_neuron_count_per_feature_map())
+			, output_neuron_count_per_feature_map(output_configuration_specific.get_neuron_count_per_feature_map())
+		{
+			window_elem_count = 1;
+			for(unsigned int i = 0; i < max_dimension_count; ++i)
+			{
+				this->subsampling_sizes[i] = (i < dimension_count) ? subsampling_sizes[i] : 1;
+				output_dimension_sizes[i] = (i < dimension_count) ? output_configuration_specific.dimension_sizes[i] : 1;
+				input_slices[i] = (i == 0) ? 1 : input_slices[i - 1] * ((i - 1 < dimension_count) ? input_configuration_specific.dimension_sizes[i - 1] : 1);
+				window_elem_count *= this->subsampling_sizes[i];
+			}
+			input_width = input_configuration_specific.dimension_sizes[0];
+			max_index_elem_size = (window_elem_count <= 256) ? sizeof(unsigned char) : sizeof(unsigned int);
+
+			kernel = kernel_generic;
+			if (dimension_count == 2)
+			{
+				if ((subsampling_sizes[0] == 2) && (subsampling_sizes[1] == 2))
+					kernel = kernel_2x2;
+				else if ((subsampling_sizes[0] == 3) && (subsampling_sizes[1] == 3))
+					kernel = kernel_3x3;
+			}
+
+			offset_list.resize(window_elem_count);
+			for(unsigned int i = 0; i < window_elem_count; ++i)
+			{
+				unsigned int remainder = i;
+				unsigned int offset = 0;
+				for(unsigned int j = 0; j < max_dimension_count; ++j)
+				{
+					offset += (remainder % this->subsampling_sizes[j]) * input_slices[j];
+					remainder /= this->subsampling_sizes[j];
+				}
+				offset_list[i] = offset;
+			}
+		}
+
+		unsigned int subsampling_plain::get_max_indexes_elem_count_per_entry() const
+		{
+			return static_cast<unsigned int>((output_neuron_count_per_feature_map * feature_map_count * max_index_elem_size + sizeof(float) - 1) / sizeof(float));
+		}
+
+		int subsampling_plain::get_window_offset(const unsigned int * output_position) const
+		{
+			int res = 0;
+			for(unsigned int i = 0; i < dimension_count; ++i)
+				res += output_position[i] * subsampling_sizes[i] * input_slices[i];
+			return res;
+		}
+
+		template<unsigned int window_width, unsigned int window_height, bool store_max_indexes>
+		void subsampling_plain::max_2d(
+			const float * input,
+			float * output,
+			unsigned char * max_indexes) const
+		{
+			const int output_width = static_cast<int>(output_dimension_sizes[0]);
+			const int output_height = static_cast<int>(output_dimension_sizes[1]);
+			for(int y = 0; y < output_height; ++y)
+			{
+				const float * in_rows[window_height];
+				for(unsigned int window_y = 0; window_y < window_height; ++window_y)
+					in_rows[window_y] = input + (y * window_height + window_y) * input_width;
+				float * out_row = output + y * output_width;
+				unsigned char * max_indexes_row = max_indexes + (store_max_indexes ? y * output_width : 0);
+				for(int x = 0; x < output_width; ++x)
+				{
+					float best_val = in_rows[0][x * window_width];
+					unsigned int max_index = 0;
+					for(unsigned int window_y = 0; window_y < window_height; ++window_y)
+					{
+						for(unsigned int window_x = 0; window_x < window_width; ++window_x)
+						{
+							float new_val = in_rows[window_y][x * window_width + window_x];
+							bool greater = (new_val > best_val);
+							best_val = greater ? new_val : best_val;
+							if (store_max_indexes)
+								max_index = greater ? (window_y * window_width + window_x) : max_index;
+						}
+					}
+					out_row[x] = best_val;
+					if (store_max_indexes)
+						max_indexes_row[x] = static_cast<unsigned char>(max_index);
+				}
+			}
+		}
+
+		template<typename index_type>
+		void subsampling_plain::max_generic(
+			const float * input,
+			float * output,
+			index_type * max_indexes) const
+		{
+			nnforge_array<unsigned int, max_dimension_count> current_output_position;
+			std::fill_n(current_output_position.begin(), max_dimension_count, 0);
+			const unsigned int * offset_list_it = &(*offset_list.begin());
+			for(unsigned int output_id = 0; output_id < output_neuron_count_per_feature_map; ++output_id)
+			{
+				const float * in_window = input + get_window_offset(&(*current_output_position.begin()));
+				float best_val = in_window[0];
+				unsigned int max_index = 0;
+				for(unsigned int i = 1; i < window_elem_count; ++i)
+				{
+					float new_val = in_window[offset_list_it[i]];
+					if (new_val > best_val)
+					{
+						best_val = new_val;
+						max_index = i;
+					}
+				}
+				output[output_id] = best_val;
+				if (max_indexes)
+					max_indexes[output_id] = static_cast<index_type>(max_index);
+
+				for(unsigned int i = 0; i < dimension_count; ++i)
+				{
+					if ((++current_output_position[i]) < output_dimension_sizes[i])
+						break;
+					current_output_position[i] = 0;
+				}
+			}
+		}
+
+		template<typename index_type>
+		void subsampling_plain::max_backprop_feature_map(
+			const float * output_errors,
+			float * input_errors,
+			const index_type * max_indexes) const
+		{
+			std::fill_n(input_errors, input_neuron_count_per_feature_map, 0.0F);
+
+			nnforge_array<unsigned int, max_dimension_count> current_output_position;
+			std::fill_n(current_output_position.begin(), max_dimension_count, 0);
+			const unsigned int * offset_list_it = &(*offset_list.begin());
+			for(unsigned int output_id = 0; output_id < output_neuron_count_per_feature_map; ++output_id)
+			{
+				input_errors[get_window_offset(&(*current_output_position.begin())) + offset_list_it[max_indexes[output_id]]] = output_errors[output_id];
+
+				for(unsigned int i = 0; i < dimension_count; ++i)
+				{
+					if ((++current_output_position[i]) < output_dimension_sizes[i])
+						break;
+					current_output_position[i] = 0;
+				}
+			}
+		}
+
+		template<unsigned int window_width, unsigned int window_height>
+		void subsampling_plain::average_2d(
+			const float * input,
+			float * output) const
+		{
+			const int output_width = static_cast<int>(output_dimension_sizes[0]);
+			const int output_height = static_cast<int>(output_dimension_sizes[1]);
+			const float mult = 1.0F / static_cast<float>(window_width * window_height);
+			for(int y = 0; y < output_height; ++y)
+			{
+				const float * in_rows[window_height];
+				for(unsigned int window_y = 0; window_y < window_height; ++window_y)
+					in_rows[window_y] = input + (y * window_height + window_y) * input_width;
+				float * out_row = output + y * output_width;
+				for(int x = 0; x < output_width; ++x)
+				{
+					float sum = 0.0F;
+					for(unsigned int window_y = 0; window_y < window_height; ++window_y)
+						for(unsigned int window_x = 0; window_x < window_width; ++window_x)
+							sum += in_rows[window_y][x * window_width + window_x];
+					out_row[x] = sum * mult;
+				}
+			}
+		}
+
+		void subsampling_plain::average_generic(
+			const float * input,
+			float * output) const
+		{
+			nnforge_array<unsigned int, max_dimension_count> current_output_position;
+			std::fill_n(current_output_position.begin(), max_dimension_count, 0);
+			const unsigned int * offset_list_it = &(*offset_list.begin());
+			const float mult = 1.0F / static_cast<float>(window_elem_count);
+			for(unsigned int output_id = 0; output_id < output_neuron_count_per_feature_map; ++output_id)
+			{
+				const float * in_window = input + get_window_offset(&(*current_output_position.begin()));
+				float sum = 0.0F;
+				for(unsigned int i = 0; i < window_elem_count; ++i)
+					sum += in_window[offset_list_it[i]];
+				output[output_id] = sum * mult;
+
+				for(unsigned int i = 0; i < dimension_count; ++i)
+				{
+					if ((++current_output_position[i]) < output_dimension_sizes[i])
+						break;
+					current_output_position[i] = 0;
+				}
+			}
+		}
+
+		void subsampling_plain::max_forward(
+			const float * input,
+			float * output,
+			float * max_indexes,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const int total_workload = static_cast<int>(entry_count * feature_map_count);
+			unsigned char * const max_indexes_bytes = reinterpret_cast<unsigned char *>(max_indexes);
+
+			#pragma omp parallel for default(none) schedule(guided) num_threads(thread_count) shared(input,output)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				const float * in_fm = input + workload_id * input_neuron_count_per_feature_map;
+				float * out_fm = output + workload_id * output_neuron_count_per_feature_map;
+				unsigned char * max_indexes_fm = max_indexes_bytes ? (max_indexes_bytes + workload_id * output_neuron_count_per_feature_map * max_index_elem_size) : 0;
+
+				if ((kernel == kernel_2x2) && (max_index_elem_size == sizeof(unsigned char)))
+				{
+					if (max_indexes_fm)
+						max_2d<2, 2, true>(in_fm, out_fm, max_indexes_fm);
+					else
+						max_2d<2, 2, false>(in_fm, out_fm, 0);
+				}
+				else if ((kernel == kernel_3x3) && (max_index_elem_size == sizeof(unsigned char)))
+				{
+					if (max_indexes_fm)
+						max_2d<3, 3, true>(in_fm, out_fm, max_indexes_fm);
+					else
+						max_2d<3, 3, false>(in_fm, out_fm, 0);
+				}
+				else if (max_index_elem_size == sizeof(unsigned char))
+					max_generic<unsigned char>(in_fm, out_fm, max_indexes_fm);
+				else
+					max_generic<unsigned int>(in_fm, out_fm, reinterpret_cast<unsigned int *>(max_indexes_fm));
+			}
+		}
+
+		void subsampling_plain::max_backprop(
+			const float * output_errors,
+			float * input_errors,
+			const float * max_indexes,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const int total_workload = static_cast<int>(entry_count * feature_map_count);
+			const unsigned char * const max_indexes_bytes = reinterpret_cast<const unsigned char *>(max_indexes);
+
+			#pragma omp parallel for default(none) schedule(guided) num_threads(thread_count) shared(output_errors,input_errors)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+			{
+				const float * out_err_fm = output_errors + workload_id * output_neuron_count_per_feature_map;
+				float * in_err_fm = input_errors + workload_id * input_neuron_count_per_feature_map;
+				const unsigned char * max_indexes_fm = max_indexes_bytes + workload_id * output_neuron_count_per_feature_map * max_index_elem_size;
+
+				if (max_index_elem_size == sizeof(unsigned char))
+					max_backprop_feature_map<unsigned char>(out_err_fm, in_err_fm, max_indexes_fm);
+				else
+					max_backprop_feature_map<unsigned int>(out_err_fm, in_err_fm, reinterpret_cast<const unsigned int *>(max_indexes_fm));
+			}
+		}
+
+		void subsampling_plain::average_forward_feature_map(
+			const float * input,
+			float * output) const
+		{
+			switch (kernel)
+			{
+			case kernel_2x2:
+				average_2d<2, 2>(input, output);
+				break;
+			case kernel_3x3:
+				average_2d<3, 3>(input, output);
+				break;
+			default:
+				average_generic(input, output);
+				break;
+			}
+		}
+
+		void subsampling_plain::average_forward(
+			const float * input,
+			float * output,
+			unsigned int entry_count,
+			int thread_count) const
+		{
+			const int total_workload = static_cast<int>(entry_count * feature_map_count);
+
+			#pragma omp parallel for default(none) schedule(guided) num_threads(thread_count) shared(input,output)
+			for(int workload_id = 0; workload_id < total_workload; ++workload_id)
+				average_forward_feature_map(
+					input + workload_id * input_neuron_count_per_feature_map,
+					output + workload_id * output_neuron_count_per_feature_map);
+		}
+	}
+}
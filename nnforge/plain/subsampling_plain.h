@@ -0,0 +1,127 @@
+/*
+ *  Copyright 2011-2015 Maxim Milakov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "../layer_configuration_specific.h"
+
+#include <vector>
+
+namespace nnforge
+{
+	namespace plain
+	{
+		// Max and average subsampling with non-overlapping windows
+		// 2D 2x2 and 3x3 windows run template-specialized kernels, vectorized across output columns,
+		// other windows run the generic kernel
+		// Max indexes are stored as offsets inside the window: 1 byte per output neuron for windows
+		// of up to 256 elements, 4 bytes otherwise
+		class subsampling_plain
+		{
+		public:
+			subsampling_plain(
+				const std::vector<unsigned int>& subsampling_sizes,
+				const layer_configuration_specific& input_configuration_specific,
+				const layer_configuration_specific& output_configuration_specific);
+
+			// The size of the max indexes buffer per entry, in float elements
+			unsigned int get_max_indexes_elem_count_per_entry() const;
+
+			// max_indexes might be null, indexes are not stored then
+			void max_forward(
+				const float * input,
+				float * output,
+				float * max_indexes,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// Input errors are overwritten
+			void max_backprop(
+				const float * output_errors,
+				float * input_errors,
+				const float * max_indexes,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			void average_forward(
+				const float * input,
+				float * output,
+				unsigned int entry_count,
+				int thread_count) const;
+
+			// A single feature map, for callers fusing subsampling with other layers
+			void average_forward_feature_map(
+				const float * input,
+				float * output) const;
+
+		private:
+			enum kernel_type
+			{
+				kernel_generic,
+				kernel_2x2,
+				kernel_3x3
+			};
+
+			template<unsigned int window_width, unsigned int window_height, bool store_max_indexes>
+			void max_2d(
+				const float * input,
+				float * output,
+				unsigned char * max_indexes) const;
+
+			template<typename index_type>
+			void max_generic(
+				const float * input,
+				float * output,
+				index_type * max_indexes) const;
+
+			template<typename index_type>
+			void max_backprop_feature_map(
+				const float * output_errors,
+				float * input_errors,
+				const index_type * max_indexes) const;
+
+			template<unsigned int window_width, unsigned int window_height>
+			void average_2d(
+				const float * input,
+				float * output) const;
+
+			void average_generic(
+				const float * input,
+				float * output) const;
+
+			// Offset of the window start in the input feature map, for the output neuron at output_position
+			int get_window_offset(const unsigned int * output_position) const;
+
+			static const int max_dimension_count = 4;
+
+			unsigned int dimension_count;
+			unsigned int feature_map_count;
+			unsigned int input_neuron_count_per_feature_map;
+			unsigned int output_neuron_count_per_feature_map;
+			unsigned int window_elem_count;
+			unsigned int max_index_elem_size;
+			kernel_type kernel;
+
+			unsigned int subsampling_sizes[max_dimension_count];
+			unsigned int output_dimension_sizes[max_dimension_count];
+			unsigned int input_slices[max_dimension_count];
+			unsigned int input_width;
+
+			// Offsets of window elements relative to the window start
+			std::vector<unsigned int> offset_list;
+		};
+	}
+}
@@ -27,8 +27,16 @@
 
 namespace nnforge
 {
-	// {228C72EF-B260-493C-AEFD-24A13D455696}
+	// {D7E2D57D-991F-496C-96E9-3C58A81ACEB1}
 	const boost::uuids::uuid sparse_convolution_layer::layer_guid =
+		{ 0xd7, 0xe2, 0xd5, 0x7d
+		, 0x99, 0x1f
+		, 0x49, 0x6c
+		, 0x96, 0xe9
+		, 0x3c, 0x58, 0xa8, 0x1a, 0xce, 0xb1 };
+
+	// {228C72EF-B260-493C-AEFD-24A13D455696}
+	const boost::uuids::uuid sparse_convolution_layer::layer_guid_v2 =
 		{ 0x22, 0x8c, 0x72, 0xef
 		, 0xb2, 0x60
 		, 0x49, 0x3c
@@ -49,13 +57,15 @@ namespace nnforge
 		unsigned int output_feature_map_count,
 		unsigned int feature_map_connection_count,
 		const std::vector<unsigned int>& left_zero_padding,
-		const std::vector<unsigned int>& right_zero_padding)
+		const std::vector<unsigned int>& right_zero_padding,
+		const std::vector<unsigned int>& strides)
 		: window_sizes(window_sizes),
 		input_feature_map_count(input_feature_map_count),
 		output_feature_map_count(output_feature_map_count),
 		feature_map_connection_count(feature_map_connection_count),
 		left_zero_padding(left_zero_padding),
-		right_zero_padding(right_zero_padding)
+		right_zero_padding(right_zero_padding),
+		strides(strides)
 	{
 		check_consistency();
 	}
@@ -66,13 +76,15 @@ namespace nnforge
 		unsigned int output_feature_map_count,
 		float feature_map_connection_sparsity_ratio,
 		const std::vector<unsigned int>& left_zero_padding,
-		const std::vector<unsigned int>& right_zero_padding)
+		const std::vector<unsigned int>& right_zero_padding,
+		const std::vector<unsigned int>& strides)
 		: window_sizes(window_sizes),
 		input_feature_map_count(input_feature_map_count),
 		output_feature_map_count(output_feature_map_count),
 		feature_map_connection_count(static_cast<unsigned int>(input_feature_map_count * output_feature_map_count * feature_map_connection_sparsity_ratio + 0.5F)),
 		left_zero_padding(left_zero_padding),
-		right_zero_padding(right_zero_padding)
+		right_zero_padding(right_zero_padding),
+		strides(strides)
 	{
 		check_consistency();
 	}
@@ -117,6 +129,18 @@ namespace nnforge
 				if (right_zero_padding[i] >= window_sizes[i])
 					throw neural_network_exception((boost::format("right zero padding %1% of dimension (%2%) is greater or equal than layer window size (%3%)") % right_zero_padding[i] % i % window_sizes[i]).str());
 		}
+
+		if ((strides.size() != 0) && (strides.size() != window_sizes.size()))
+			throw std::runtime_error((boost::format("Invalid dimension count %1% for strides") % strides.size()).str());
+
+		if (strides.empty())
+			strides.resize(window_sizes.size(), 1);
+		else
+		{
+			for(unsigned int i = 0; i < window_sizes.size(); i++)
+				if (strides[i] == 0)
+					throw neural_network_exception((boost::format("stride of dimension (%1%) for sparse convolution layer may not be zero") % i).str());
+		}
 	}
 
 	const boost::uuids::uuid& sparse_convolution_layer::get_uuid() const
@@ -156,7 +180,7 @@ namespace nnforge
 			if (total_input_dimension_size < window_sizes[i])
 				throw neural_network_exception((boost::format("Too small total dimension size (with padding) %1% of dimension (%2%) is smaller than layer window size (%3%)") % total_input_dimension_size % i % window_sizes[i]).str());
 
-			res.dimension_sizes.push_back(total_input_dimension_size + 1 - window_sizes[i]);
+			res.dimension_sizes.push_back((total_input_dimension_size - window_sizes[i]) / strides[i] + 1);
 		}
 
 		return res;
@@ -172,8 +196,8 @@ namespace nnforge
 		for(unsigned int i = 0; i < window_sizes.size(); ++i)
 			res.push_back(
 				std::make_pair(
-					static_cast<unsigned int>(std::max(0, static_cast<int>(output_rectangle_borders[i].first) - static_cast<int>(left_zero_padding[i]))),
-					(output_rectangle_borders[i].second + window_sizes[i] - 1) - left_zero_padding[i]
+					static_cast<unsigned int>(std::max(0, static_cast<int>(output_rectangle_borders[i].first * strides[i]) - static_cast<int>(left_zero_padding[i]))),
+					(output_rectangle_borders[i].second * strides[i] + window_sizes[i] - 1) - left_zero_padding[i]
 				)
 			);
 
@@ -191,6 +215,7 @@ namespace nnforge
 		binary_stream_to_write_to.write(reinterpret_cast<const char*>(&(*window_sizes.begin())), sizeof(unsigned int) * dimension_count);
 		binary_stream_to_write_to.write(reinterpret_cast<const char*>(&(*left_zero_padding.begin())), sizeof(unsigned int) * dimension_count);
 		binary_stream_to_write_to.write(reinterpret_cast<const char*>(&(*right_zero_padding.begin())), sizeof(unsigned int) * dimension_count);
+		binary_stream_to_write_to.write(reinterpret_cast<const char*>(&(*strides.begin())), sizeof(unsigned int) * dimension_count);
 	}
 
 	void sparse_convolution_layer::read(
@@ -213,6 +238,10 @@ namespace nnforge
 			binary_stream_to_read_from.read(reinterpret_cast<char*>(&(*left_zero_padding.begin())), sizeof(unsigned int) * dimension_count);
 			binary_stream_to_read_from.read(reinterpret_cast<char*>(&(*right_zero_padding.begin())), sizeof(unsigned int) * dimension_count);
 		}
+
+		strides.assign(dimension_count, 1);
+		if ((layer_read_guid != layer_guid_v1) && (layer_read_guid != layer_guid_v2))
+			binary_stream_to_read_from.read(reinterpret_cast<char*>(&(*strides.begin())), sizeof(unsigned int) * dimension_count);
 	}
 
 	data_config sparse_convolution_layer::get_data_config() const
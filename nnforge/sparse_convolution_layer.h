@@ -31,7 +31,8 @@ namespace nnforge
 			unsigned int output_feature_map_count,
 			unsigned int feature_map_connection_count,
 			const std::vector<unsigned int>& left_zero_padding = std::vector<unsigned int>(),
-			const std::vector<unsigned int>& right_zero_padding = std::vector<unsigned int>());
+			const std::vector<unsigned int>& right_zero_padding = std::vector<unsigned int>(),
+			const std::vector<unsigned int>& strides = std::vector<unsigned int>());
 
 		sparse_convolution_layer(
 			const std::vector<unsigned int>& window_sizes,
@@ -39,7 +40,8 @@ namespace nnforge
 			unsigned int output_feature_map_count,
 			float feature_map_connection_sparsity_ratio,
 			const std::vector<unsigned int>& left_zero_padding = std::vector<unsigned int>(),
-			const std::vector<unsigned int>& right_zero_padding = std::vector<unsigned int>());
+			const std::vector<unsigned int>& right_zero_padding = std::vector<unsigned int>(),
+			const std::vector<unsigned int>& strides = std::vector<unsigned int>());
 
 		virtual layer_smart_ptr clone() const;
 
@@ -74,6 +76,8 @@ namespace nnforge
 
 		static const boost::uuids::uuid layer_guid;
 
+		static const boost::uuids::uuid layer_guid_v2;
+
 		static const boost::uuids::uuid layer_guid_v1;
 
 	protected:
@@ -100,5 +104,6 @@ namespace nnforge
 		unsigned int feature_map_connection_count;
 		std::vector<unsigned int> left_zero_padding;
 		std::vector<unsigned int> right_zero_padding;
+		std::vector<unsigned int> strides;
 	};
 }
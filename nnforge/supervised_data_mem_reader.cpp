@@ -19,6 +19,7 @@
 
 #include <boost/format.hpp>
 #include <cstring>
+#include <algorithm>
 
 namespace nnforge
 {
@@ -67,16 +68,48 @@ namespace nnforge
 		if (!entry_available())
 			return false;
 
+		copy_entry(entry_read_count, input_neurons, output_neurons);
+
+		entry_read_count++;
+
+		return true;
+	}
+
+	unsigned int supervised_data_mem_reader::read_batch(
+		unsigned int max_entry_count,
+		void * input_neurons,
+		float * output_neurons)
+	{
+		const unsigned int entries_to_read_count = std::min(max_entry_count, entry_count - entry_read_count);
+		const size_t input_entry_size = input_neuron_count * neuron_data_type::get_input_size(type_code);
+		unsigned char * input_ptr = static_cast<unsigned char *>(input_neurons);
+
+		for(unsigned int i = 0; i < entries_to_read_count; ++i)
+			copy_entry(
+				entry_read_count + i,
+				input_ptr ? input_ptr + input_entry_size * i : 0,
+				output_neurons ? output_neurons + output_neuron_count * i : 0);
+
+		entry_read_count += entries_to_read_count;
+
+		return entries_to_read_count;
+	}
+
+	void supervised_data_mem_reader::copy_entry(
+		unsigned int entry_id,
+		void * input_neurons,
+		float * output_neurons) const
+	{
 		if (input_neurons)
 		{
 			const void * input_src;
 			switch (type_code)
 			{
 			case neuron_data_type::type_byte:
-				input_src = &(*input_data_list_byte[entry_read_count]->begin());
+				input_src = &(*input_data_list_byte[entry_id]->begin());
 				break;
 			case neuron_data_type::type_float:
-				input_src = &(*input_data_list_float[entry_read_count]->begin());
+				input_src = &(*input_data_list_float[entry_id]->begin());
 				break;
 			}
 			memcpy(input_neurons, input_src, input_neuron_count * neuron_data_type::get_input_size(type_code));
@@ -84,12 +117,8 @@ namespace nnforge
 
 		if (output_neurons)
 		{
-			const float * output_src = &(*output_data_list[entry_read_count]->begin());
-			memcpy(output_neurons, output_src, input_neuron_count * sizeof(float));
+			const float * output_src = &(*output_data_list[entry_id]->begin());
+			memcpy(output_neurons, output_src, output_neuron_count * sizeof(float));
 		}
-
-		entry_read_count++;
-
-		return true;
 	}
 }
@@ -51,6 +51,11 @@ namespace nnforge
 			void * input_neurons,
 			float * output_neurons);
 
+		virtual unsigned int read_batch(
+			unsigned int max_entry_count,
+			void * input_neurons,
+			float * output_neurons);
+
 		virtual layer_configuration_specific get_input_configuration() const
 		{
 			return input_configuration;
@@ -77,6 +82,11 @@ namespace nnforge
 			return (entry_read_count < entry_count);
 		}
 
+		void copy_entry(
+			unsigned int entry_id,
+			void * input_neurons,
+			float * output_neurons) const;
+
 	protected:
 		layer_configuration_specific input_configuration;
 		layer_configuration_specific output_configuration;
@@ -40,6 +40,19 @@ namespace nnforge
 
 		virtual bool read(void * input_elems);
 
+		// The method reads up to max_entry_count entries stored one after another and returns the number of entries read,
+		// it is less than max_entry_count only if there are no more entries available.
+		// If any parameter is null the method should just discard corresponding data.
+		// The default implementation calls read for each entry, readers override it when they can read entries in bulk
+		virtual unsigned int read_batch(
+			unsigned int max_entry_count,
+			void * input_elems,
+			float * output_elems);
+
+		virtual unsigned int read_batch(
+			unsigned int max_entry_count,
+			void * input_elems);
+
 		virtual layer_configuration_specific get_output_configuration() const = 0;
 
 		output_neuron_value_set_smart_ptr get_output_neuron_value_set(unsigned int sample_count);
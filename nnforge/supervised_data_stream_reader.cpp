@@ -20,6 +20,8 @@
 
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/format.hpp>
+#include <algorithm>
+#include <cstring>
 
 namespace nnforge
 {
@@ -82,6 +84,45 @@ namespace nnforge
 		return true;
 	}
 
+	unsigned int supervised_data_stream_reader::read_batch(
+		unsigned int max_entry_count,
+		void * input_neurons,
+		float * output_neurons)
+	{
+		const unsigned int entries_to_read_count = std::min(max_entry_count, entry_count - entry_read_count);
+		const size_t input_entry_size = get_input_neuron_elem_size() * input_neuron_count;
+		const size_t output_entry_size = sizeof(*output_neurons) * output_neuron_count;
+		const size_t entry_size = input_entry_size + output_entry_size;
+
+		if (input_neurons || output_neurons)
+		{
+			unsigned char * input_ptr = static_cast<unsigned char *>(input_neurons);
+			const unsigned int max_entry_count_per_read = std::max(static_cast<unsigned int>(max_batch_buf_size / entry_size), 1U);
+			for(unsigned int start_entry_id = 0; start_entry_id < entries_to_read_count; start_entry_id += max_entry_count_per_read)
+			{
+				const unsigned int current_entry_count = std::min(entries_to_read_count - start_entry_id, max_entry_count_per_read);
+				if (batch_buf.size() < entry_size * current_entry_count)
+					batch_buf.resize(entry_size * current_entry_count);
+				in_stream->read(reinterpret_cast<char*>(&(*batch_buf.begin())), entry_size * current_entry_count);
+
+				const unsigned char * src = &(*batch_buf.begin());
+				for(unsigned int entry_id = start_entry_id; entry_id < start_entry_id + current_entry_count; ++entry_id, src += entry_size)
+				{
+					if (input_ptr)
+						memcpy(input_ptr + input_entry_size * entry_id, src, input_entry_size);
+					if (output_neurons)
+						memcpy(output_neurons + output_neuron_count * entry_id, src + input_entry_size, output_entry_size);
+				}
+			}
+		}
+		else
+			in_stream->seekg(entry_size * entries_to_read_count, std::ios_base::cur);
+
+		entry_read_count += entries_to_read_count;
+
+		return entries_to_read_count;
+	}
+
 	bool supervised_data_stream_reader::raw_read(std::vector<unsigned char>& all_elems)
 	{
 		if (!entry_available())
@@ -42,6 +42,11 @@ namespace nnforge
 			void * input_neurons,
 			float * output_neurons);
 
+		virtual unsigned int read_batch(
+			unsigned int max_entry_count,
+			void * input_neurons,
+			float * output_neurons);
+
 		virtual bool raw_read(std::vector<unsigned char>& all_elems);
 
 		virtual layer_configuration_specific get_input_configuration() const
@@ -81,6 +86,10 @@ namespace nnforge
 		unsigned int entry_read_count;
 		std::istream::pos_type reset_pos;
 
+		// Input and output of the entries are interleaved in the stream, read_batch reads them here with a single call and then splits
+		std::vector<unsigned char> batch_buf;
+		static const size_t max_batch_buf_size = 4 * 1024 * 1024;
+
 	private:
 		supervised_data_stream_reader(const supervised_data_stream_reader&);
 		supervised_data_stream_reader& operator =(const supervised_data_stream_reader&);
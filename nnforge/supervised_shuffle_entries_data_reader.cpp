@@ -17,6 +17,7 @@
 #include "supervised_shuffle_entries_data_reader.h"
 
 #include <cstring>
+#include <algorithm>
 
 namespace nnforge
 {
@@ -62,6 +63,40 @@ namespace nnforge
 		return entry_read;
 	}
 
+	unsigned int supervised_shuffle_entries_data_reader::read_batch(
+		unsigned int max_entry_count,
+		void * input_elems,
+		float * output_elems)
+	{
+		const size_t input_entry_size = original_reader->get_input_configuration().get_neuron_count() * original_reader->get_input_neuron_elem_size();
+		const unsigned int output_neuron_count = original_reader->get_output_configuration().get_neuron_count();
+		unsigned char * input_ptr = static_cast<unsigned char *>(input_elems);
+
+		unsigned int entries_read_count = 0;
+		while (entries_read_count < max_entry_count)
+		{
+			const unsigned int entries_to_read_count = std::min(max_entry_count - entries_read_count, block_size - current_position_in_block);
+			const unsigned int entries_read_from_block_count = original_reader->read_batch(
+				entries_to_read_count,
+				input_ptr ? input_ptr + input_entry_size * entries_read_count : 0,
+				output_elems ? output_elems + output_neuron_count * entries_read_count : 0);
+			entries_read_count += entries_read_from_block_count;
+
+			current_position_in_block += entries_read_from_block_count;
+			if (current_position_in_block >= block_size)
+			{
+				current_position_in_block = 0;
+				++current_block_id;
+				rewind_original();
+			}
+
+			if (entries_read_from_block_count < entries_to_read_count)
+				break;
+		}
+
+		return entries_read_count;
+	}
+
 	void supervised_shuffle_entries_data_reader::reset()
 	{
 		rewind(0);
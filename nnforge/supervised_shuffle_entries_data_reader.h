@@ -39,6 +39,12 @@ namespace nnforge
 			void * input_elems,
 			float * output_elems);
 
+		// Reads the entries up to the end of the current block with a single call to the original reader
+		virtual unsigned int read_batch(
+			unsigned int max_entry_count,
+			void * input_elems,
+			float * output_elems);
+
 		virtual bool raw_read(std::vector<unsigned char>& all_elems);
 
 		virtual void rewind(unsigned int entry_id);
@@ -38,6 +38,12 @@ namespace nnforge
 			void * input_elems,
 			float * output_elems);
 
+		// Reads the original entries with a single call and transforms them one by one, unless the transformer produces several samples per entry
+		virtual unsigned int read_batch(
+			unsigned int max_entry_count,
+			void * input_elems,
+			float * output_elems);
+
 		virtual bool raw_read(std::vector<unsigned char>& all_elems);
 
 		virtual void rewind(unsigned int entry_id);
@@ -70,5 +76,9 @@ namespace nnforge
 		size_t output_buf_size;
 		unsigned int current_sample_id;
 		unsigned int transformer_sample_count;
+
+		// Original entries read by read_batch when the transformer is not in-place
+		std::vector<unsigned char> batch_input_buf;
+		static const size_t max_batch_input_buf_size = 4 * 1024 * 1024;
 	};
 }
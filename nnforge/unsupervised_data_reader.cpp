@@ -32,6 +32,20 @@ namespace nnforge
 	{
 	}
 
+	unsigned int unsupervised_data_reader::read_batch(
+		unsigned int max_entry_count,
+		void * input_elems)
+	{
+		const size_t input_entry_size = get_input_configuration().get_neuron_count() * get_input_neuron_elem_size();
+		unsigned char * input_ptr = static_cast<unsigned char *>(input_elems);
+
+		unsigned int entries_read_count = 0;
+		while ((entries_read_count < max_entry_count) && read(input_ptr ? input_ptr + input_entry_size * entries_read_count : 0))
+			++entries_read_count;
+
+		return entries_read_count;
+	}
+
 	size_t unsupervised_data_reader::get_input_neuron_elem_size() const
 	{
 		return neuron_data_type::get_input_size(get_input_type());
@@ -35,6 +35,13 @@ namespace nnforge
 		// The method should return true in case entry is read and false if there is no more entries available (and no entry is read in this case)
 		virtual bool read(void * input_elems) = 0;
 
+		// The method reads up to max_entry_count entries stored one after another and returns the number of entries read,
+		// it is less than max_entry_count only if there are no more entries available.
+		// The default implementation calls read for each entry, readers override it when they can read entries in bulk
+		virtual unsigned int read_batch(
+			unsigned int max_entry_count,
+			void * input_elems);
+
 		// The method should return true in case entry is read and false if there is no more entries available (and no entry is read in this case)
 		virtual bool raw_read(std::vector<unsigned char>& all_elems) = 0;
 
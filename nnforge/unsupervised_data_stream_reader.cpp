@@ -20,6 +20,7 @@
 
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/format.hpp>
+#include <algorithm>
 
 namespace nnforge
 {
@@ -73,6 +74,27 @@ namespace nnforge
 		return true;
 	}
 
+	unsigned int unsupervised_data_stream_reader::read_batch(
+		unsigned int max_entry_count,
+		void * input_neurons)
+	{
+		const unsigned int entries_to_read_count = std::min(max_entry_count, entry_count - entry_read_count);
+		const size_t bytes_to_read = get_input_neuron_elem_size() * input_neuron_count * entries_to_read_count;
+
+		// The entries are stored one after another in the stream, so they are read with a single call
+		if (input_neurons)
+		{
+			if (bytes_to_read > 0)
+				in_stream->read(reinterpret_cast<char*>(input_neurons), bytes_to_read);
+		}
+		else
+			in_stream->seekg(bytes_to_read, std::ios_base::cur);
+
+		entry_read_count += entries_to_read_count;
+
+		return entries_to_read_count;
+	}
+
 	bool unsupervised_data_stream_reader::raw_read(std::vector<unsigned char>& all_elems)
 	{
 		if (!entry_available())
@@ -16,6 +16,8 @@
 
 #include "unsupervised_transformed_input_data_reader.h"
 
+#include <algorithm>
+
 namespace nnforge
 {
 	unsupervised_transformed_input_data_reader::unsupervised_transformed_input_data_reader(
@@ -67,6 +69,58 @@ namespace nnforge
 		return true;
 	}
 
+	unsigned int unsupervised_transformed_input_data_reader::read_batch(
+		unsigned int max_entry_count,
+		void * input_elems)
+	{
+		// Samples of the same original entry are read one by one
+		if (transformer_sample_count > 1)
+			return unsupervised_data_reader::read_batch(max_entry_count, input_elems);
+
+		if (input_elems == 0)
+			return original_reader->read_batch(max_entry_count, 0);
+
+		const layer_configuration_specific original_input_configuration = original_reader->get_input_configuration();
+		const neuron_data_type::input_type original_input_type = original_reader->get_input_type();
+		const size_t original_input_entry_size = original_input_configuration.get_neuron_count() * neuron_data_type::get_input_size(original_input_type);
+		const size_t input_entry_size = get_input_configuration().get_neuron_count() * get_input_neuron_elem_size();
+		const unsigned int max_entry_count_per_read = (local_input_ptr != 0) ? std::max(static_cast<unsigned int>(max_batch_input_buf_size / original_input_entry_size), 1U) : max_entry_count;
+		unsigned char * input_ptr = static_cast<unsigned char *>(input_elems);
+
+		unsigned int entries_read_count = 0;
+		while (entries_read_count < max_entry_count)
+		{
+			const unsigned int entries_to_read_count = std::min(max_entry_count - entries_read_count, max_entry_count_per_read);
+			unsigned char * original_input_ptr = input_ptr + input_entry_size * entries_read_count;
+			if (local_input_ptr != 0)
+			{
+				if (batch_input_buf.size() < original_input_entry_size * entries_to_read_count)
+					batch_input_buf.resize(original_input_entry_size * entries_to_read_count);
+				original_input_ptr = &(*batch_input_buf.begin());
+			}
+
+			const unsigned int current_entries_read_count = original_reader->read_batch(
+				entries_to_read_count,
+				original_input_ptr);
+
+			for(unsigned int i = 0; i < current_entries_read_count; ++i)
+			{
+				transformer->transform(
+					(local_input_ptr != 0) ? original_input_ptr + original_input_entry_size * i : 0,
+					input_ptr + input_entry_size * (entries_read_count + i),
+					original_input_type,
+					original_input_configuration,
+					0);
+			}
+
+			entries_read_count += current_entries_read_count;
+			if (current_entries_read_count < entries_to_read_count)
+				break;
+		}
+
+		return entries_read_count;
+	}
+
 	void unsupervised_transformed_input_data_reader::reset()
 	{
 		current_sample_id = 0;
@@ -36,6 +36,11 @@ namespace nnforge
 		// If any parameter is null the method should just discard corresponding data
 		virtual bool read(void * input_elems);
 
+		// Reads the original entries with a single call and transforms them one by one, unless the transformer produces several samples per entry
+		virtual unsigned int read_batch(
+			unsigned int max_entry_count,
+			void * input_elems);
+
 		virtual bool raw_read(std::vector<unsigned char>& all_elems);
 
 		virtual void rewind(unsigned int entry_id);
@@ -63,5 +68,9 @@ namespace nnforge
 		void * local_input_ptr;
 		unsigned int current_sample_id;
 		unsigned int transformer_sample_count;
+
+		// Original entries read by read_batch when the transformer is not in-place
+		std::vector<unsigned char> batch_input_buf;
+		static const size_t max_batch_input_buf_size = 4 * 1024 * 1024;
 	};
 }